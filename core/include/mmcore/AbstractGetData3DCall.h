@@ -140,6 +140,17 @@ namespace core {
             this->frameID = frameID;
         }
 
+        /**
+         * Re-issues 'funcs' for the frame the caller is expected to request
+         * next, i.e. the current frame advanced by the step between the last
+         * two replays. The requested frame is restored afterwards.
+         *
+         * @param funcs The function ids to call in order.
+         *
+         * @return 'true' if all functions succeeded.
+         */
+        bool Replay(std::vector<unsigned int> const& funcs) override;
+
         /**
          * Assignment operator.
          * Makes a deep copy of all members. While for data these are only
@@ -188,6 +199,9 @@ namespace core {
         /** The requested/stored frameID */
         unsigned int frameID;
 
+        /** The frameID requested at the last replay, UINT_MAX if none, see 'Replay' */
+        unsigned int replayedFrameID;
+
         /** the coordinate extents */
         BoundingBoxes bboxs;
 
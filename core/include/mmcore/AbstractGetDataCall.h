@@ -67,6 +67,15 @@ namespace core {
             return this->datahash;
         }
 
+        /**
+         * Reports the data hash to the call profiler.
+         *
+         * @return The unique hash number of the returned data
+         */
+        size_t ProfilingDataHash(void) const override {
+            return this->datahash;
+        }
+
         /**
          * Answer the unlocker
          *
@@ -115,6 +124,16 @@ namespace core {
             }
         }
 
+        /**
+         * Re-issues 'funcs' and unlocks the data the callee returned, since
+         * no caller will use the prefetched data through this call.
+         *
+         * @param funcs The function ids to call in order.
+         *
+         * @return 'true' if all functions succeeded.
+         */
+        bool Replay(std::vector<unsigned int> const& funcs) override;
+
         /**
          * Assignment operator.
          * Makes a deep copy of all members. While for data these are only
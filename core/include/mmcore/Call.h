@@ -12,6 +12,7 @@
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
 #include <memory>
+#include <vector>
 
 #include "mmcore/api/MegaMolCore.std.h"
 
@@ -96,8 +97,76 @@ namespace core {
             return this->className;
         }
 
+        /**
+         * Answer the name of the callback function 'func' is mapped to.
+         *
+         * @param func The function id.
+         *
+         * @return The name of the function, empty if not connected.
+         */
+        const char* FunctionName(unsigned int func) const;
+
+        /**
+         * Answer a hash of the data currently provided through this call.
+         * Used by the call profiler to count data changes.
+         *
+         * @return The data hash, 0 if unknown.
+         */
+        virtual size_t ProfilingDataHash(void) const {
+            return 0;
+        }
+
+        /**
+         * Answer the number of bytes currently provided through this call.
+         * Used by the call profiler.
+         *
+         * @return The data size in bytes, 0 if unknown.
+         */
+        virtual size_t ProfilingDataSize(void) const {
+            return 0;
+        }
+
+        /**
+         * Answer whether this call may be issued from a worker thread of the
+         * graph prefetch. This is the case if the module owning the callee
+         * opted in (see 'Module::IsThreadSafe'). Issuing such a call locks
+         * the callee module.
+         *
+         * @return 'true' if the call may be prefetched, 'false' otherwise.
+         */
+        virtual bool IsThreadSafe(void) const;
+
+        /**
+         * Answers the functions issued on this call since the last time this
+         * method was called, in order of their first invocation. Only
+         * recorded for calls answering 'true' on 'IsThreadSafe'.
+         *
+         * @return The recorded function ids.
+         */
+        std::vector<unsigned int> TakeRecordedFunctions(void);
+
+        /**
+         * Re-issues 'funcs' without recording them. Derived calls adjust
+         * their request state to the one expected for the next frame and
+         * release whatever the callee handed out during the replay.
+         *
+         * @param funcs The function ids to call in order.
+         *
+         * @return 'true' if all functions succeeded.
+         */
+        virtual bool Replay(std::vector<unsigned int> const& funcs);
+
     private:
 
+        /**
+         * Forwards function 'func' to the callee.
+         *
+         * @param func The function to be called.
+         *
+         * @return The return value of the function.
+         */
+        bool dispatch(unsigned int func);
+
         /** The callee connected by this call */
         CalleeSlot *callee;
 
@@ -109,6 +178,9 @@ namespace core {
         /** The function id mapping */
         unsigned int *funcMap;
 
+        /** Functions issued since the last 'TakeRecordedFunctions' */
+        std::vector<unsigned int> recordedFunctions;
+
     };
 
 
@@ -2,7 +2,9 @@
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mmcore/factories/CallDescriptionManager.h"
@@ -18,6 +20,7 @@
 #include "mmcore/MegaMolGraph_Convenience.h"
 
 #include "mmcore/RootModuleNamespace.h"
+#include "mmcore/utility/sys/WorkStealingThreadPool.h"
 
 #include "FrontendResource.h"
 #include "ImagePresentationEntryPoints.h"
@@ -141,6 +144,33 @@ public:
     // shut down all calls, modules, graph entry points
     void Clear();
 
+    // scheduling of data-only call subtrees, i.e. thread-safe calls (see Call::IsThreadSafe) whose callee
+    // subtree consists of thread-safe calls only and contains no view or renderer.
+    // independent subtrees (also below different entry points) are prefetched concurrently on a work-stealing pool
+    // by re-issuing the functions the callers issued in the previous frame, so that the following serial GL pass
+    // finds the callee caches up to date.
+    // the entry points still render one after another, since they share the GL context. before an entry point
+    // renders, only the groups below it are joined, so the data of later entry points is computed while the earlier
+    // ones render. the prefetch is always joined before the frame ends, since services may change parameters and the
+    // graph after rendering (GUI, Lua).
+    enum class ExecutionMode {
+        Serial,        // no prefetch, everything runs in the render thread
+        ParallelJoined // prefetch right before rendering, join each entry point's groups before it renders
+    };
+
+    void SetExecutionMode(ExecutionMode mode, unsigned int threads = 0);
+
+    ExecutionMode GetExecutionMode() const { return execution_mode; }
+
+    // start prefetching all data-only subtrees on the pool. no-op in serial mode
+    void PrefetchDataSubtrees();
+
+    // block until the running prefetch finished. must be called before the graph or its parameters are touched
+    void JoinDataSubtrees();
+
+    // block until the prefetch of the subtrees below the graph entry point 'entry_point' finished
+    void JoinDataSubtrees(void const* entry_point);
+
     MegaMolGraph_Convenience& Convenience();
 
     // Create View ?
@@ -173,6 +203,11 @@ private:
 
     std::vector<megamol::frontend::FrontendResource> get_requested_resources(std::vector<std::string> resource_requests);
 
+    // joins running prefetch and marks the prefetch groups outdated, called on every graph change
+    void invalidate_prefetch_groups();
+
+    void update_prefetch_groups();
+
 
     // the dummy_namespace must be above the call_list_ and module_list_ because it needs to be destroyed AFTER all
     // calls and modules during ~MegaMolGraph()
@@ -194,6 +229,16 @@ private:
 
     MegaMolGraph_Convenience convenience_functions;
 
+    ExecutionMode execution_mode = ExecutionMode::Serial;
+    // root calls of data-only subtrees, grouped so that no two groups share a module
+    std::vector<std::vector<Call*>> prefetch_groups;
+    // indices into prefetch_groups below each graph entry point
+    std::unordered_map<Module const*, std::vector<size_t>> entry_point_groups;
+    bool prefetch_groups_dirty = true;
+    // declared after module and call lists: destroyed first, finishing tasks while modules still exist
+    std::unique_ptr<utility::sys::WorkStealingThreadPool> prefetch_pool;
+    std::vector<utility::sys::WorkStealingThreadPool::TaskGroup> prefetch_running;
+
     ////////////////////////// old interface stuff //////////////////////////////////////////////
 public:
     // TODO: pull necessary 'old' functions to active section above
@@ -11,6 +11,7 @@
 #    pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include "mmcore/AbstractNamedObjectContainer.h"
@@ -163,6 +164,27 @@ public:
 
     bool isCreated() const { return this->created; }
 
+    /**
+     * Answer whether the callbacks of this module may be re-issued from a
+     * prefetch thread of the graph. Modules answering 'true' promise that
+     * their data callbacks only update their own caches and do not touch
+     * the graph or GL state. The default is 'false'; modules opt in
+     * explicitly.
+     *
+     * @return 'true' if the module may be prefetched, 'false' otherwise.
+     */
+    virtual bool IsThreadSafe(void) const {
+        return false;
+    }
+
+    /**
+     * Answer the lock serializing thread-safe calls into this module.
+     * See 'Call::IsThreadSafe'.
+     *
+     * @return The call lock of this module.
+     */
+    inline std::recursive_mutex& CallLock(void) const { return this->callLock; }
+
 protected:
     /**
      * Implementation of 'Create'.
@@ -216,6 +238,9 @@ private:
 
     const char* className;
 
+    /** Serializes thread-safe calls issued from different threads */
+    mutable std::recursive_mutex callLock;
+
     /* Allow the container to access the internal create flag */
     friend class ::megamol::core::AbstractNamedObjectContainer;
 
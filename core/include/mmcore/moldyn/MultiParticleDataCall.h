@@ -43,10 +43,20 @@ public:
     /** Dtor. */
     virtual ~MultiParticleDataCall(void);
 
+    /**
+     * Answer the bytes of all particle lists. Interleaved attributes are
+     * counted once.
+     *
+     * @return The data size in bytes
+     */
+    size_t ProfilingDataSize(void) const override;
+
     /**
      * Assignment operator.
      * Makes a deep copy of all members. While for data these are only
      * pointers, the pointer to the unlocker object is also copied.
+     * Attribute streams with a storage stay shared, so a manipulator only
+     * needs to allocate the streams it replaces.
      *
      * @param rhs The right hand side operand
      *
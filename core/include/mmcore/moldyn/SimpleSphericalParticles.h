@@ -283,6 +283,13 @@ public:
         return this->colStride == ColorDataSize[this->colDataType] ? 0 : this->colStride;
     }
 
+    /**
+     * Answer the storage owning the colour data, if any.
+     *
+     * @return The colour data storage or nullptr
+     */
+    inline std::shared_ptr<const void> const& GetColourDataStorage(void) const { return this->colStorage; }
+
     /**
      * Answer the direction data type
      *
@@ -306,6 +313,13 @@ public:
         return this->dirStride == DirDataSize[this->dirDataType] ? 0 : this->dirStride;
     }
 
+    /**
+     * Answer the storage owning the direction data, if any.
+     *
+     * @return The direction data storage or nullptr
+     */
+    inline std::shared_ptr<const void> const& GetDirDataStorage(void) const { return this->dirStorage; }
+
     /**
      * Answer the number of stored objects
      *
@@ -373,6 +387,13 @@ public:
         return this->vertStride == VertexDataSize[this->vertDataType] ? 0 : this->vertStride;
     }
 
+    /**
+     * Answer the storage owning the vertex data, if any.
+     *
+     * @return The vertex data storage or nullptr
+     */
+    inline std::shared_ptr<const void> const& GetVertexDataStorage(void) const { return this->vertStorage; }
+
     /**
      * Answer the id data type
      *
@@ -397,6 +418,13 @@ public:
         return this->idStride == IDDataSize[this->idDataType] ? 0 : this->idStride;
     }
 
+    /**
+     * Answer the storage owning the id data, if any.
+     *
+     * @return The id data storage or nullptr
+     */
+    inline std::shared_ptr<const void> const& GetIDDataStorage(void) const { return this->idStorage; }
+
     /**
      * Sets the colour data
      *
@@ -404,15 +432,19 @@ public:
      * @param p The pointer to the colour data (must not be NULL if t
      *          is not 'COLDATA_NONE'
      * @param s The stride of the colour data
+     * @param storage The optional storage owning the colour data, copies of
+     *                this list keep it alive
      */
-    void SetColourData(ColourDataType t, const void* p, unsigned int s = 0) {
+    void SetColourData(
+        ColourDataType t, const void* p, unsigned int s = 0, std::shared_ptr<const void> storage = nullptr) {
         //    ASSERT((p != NULL) || (t == COLDATA_NONE));
         this->colDataType = t;
         this->colPtr = p;
         this->colStride = s == 0 ? ColorDataSize[t] : s;
+        this->colStorage = std::move(storage);
 
-        this->par_store_->SetColorData(t, reinterpret_cast<char const*>(p), this->colStride, this->col[0], this->col[1],
-            this->col[2], this->col[3]);
+        this->writableStore().SetColorData(t, reinterpret_cast<char const*>(p), this->colStride, this->col[0],
+            this->col[1], this->col[2], this->col[3]);
     }
 
     /**
@@ -433,14 +465,17 @@ public:
      * @param p The pointer to the direction data (must not be NULL if t
      *          is not 'DIRDATA_NONE'
      * @param s The stride of the direction data
+     * @param storage The optional storage owning the direction data, copies of
+     *                this list keep it alive
      */
-    void SetDirData(DirDataType t, const void* p, unsigned int s = 0) {
+    void SetDirData(DirDataType t, const void* p, unsigned int s = 0, std::shared_ptr<const void> storage = nullptr) {
         ASSERT((p != NULL) || (t == DIRDATA_NONE));
         this->dirDataType = t;
         this->dirPtr = p;
         this->dirStride = s == 0 ? DirDataSize[t] : s;
+        this->dirStorage = std::move(storage);
 
-        this->par_store_->SetDirData(t, reinterpret_cast<char const*>(p), this->dirStride);
+        this->writableStore().SetDirData(t, reinterpret_cast<char const*>(p), this->dirStride);
     }
 
     /**
@@ -457,11 +492,16 @@ public:
         this->dirPtr = nullptr; // DO NOT DELETE
         this->idDataType = IDDATA_NONE;
         this->idPtr = nullptr; // DO NOT DELETE
+        this->colStorage.reset();
+        this->vertStorage.reset();
+        this->dirStorage.reset();
+        this->idStorage.reset();
 
-        this->par_store_->SetVertexData(VERTDATA_NONE, nullptr);
-        this->par_store_->SetColorData(COLDATA_NONE, nullptr);
-        this->par_store_->SetDirData(DIRDATA_NONE, nullptr);
-        this->par_store_->SetIDData(IDDATA_NONE, nullptr);
+        ParticleStore& store = this->writableStore();
+        store.SetVertexData(VERTDATA_NONE, nullptr);
+        store.SetColorData(COLDATA_NONE, nullptr);
+        store.SetDirData(DIRDATA_NONE, nullptr);
+        store.SetIDData(IDDATA_NONE, nullptr);
 
         this->count = cnt;
     }
@@ -480,8 +520,8 @@ public:
         this->col[2] = b;
         this->col[3] = a;
 
-        this->par_store_->SetColorData(this->colDataType, reinterpret_cast<char const*>(this->colPtr), this->colStride,
-            this->col[0], this->col[1], this->col[2], this->col[3]);
+        this->writableStore().SetColorData(this->colDataType, reinterpret_cast<char const*>(this->colPtr),
+            this->colStride, this->col[0], this->col[1], this->col[2], this->col[3]);
     }
 
     /**
@@ -491,7 +531,7 @@ public:
      */
     void SetGlobalRadius(float r) {
         this->radius = r;
-        this->par_store_->SetVertexData(
+        this->writableStore().SetVertexData(
             this->vertDataType, reinterpret_cast<char const*>(this->vertPtr), this->vertStride, this->radius);
     }
 
@@ -509,14 +549,18 @@ public:
      * @param p The pointer to the vertex data (must not be NULL if t
      *          is not 'VERTDATA_NONE'
      * @param s The stride of the vertex data
+     * @param storage The optional storage owning the vertex data, copies of
+     *                this list keep it alive
      */
-    void SetVertexData(VertexDataType t, const void* p, unsigned int s = 0) {
+    void SetVertexData(
+        VertexDataType t, const void* p, unsigned int s = 0, std::shared_ptr<const void> storage = nullptr) {
         ASSERT(this->disabledNullChecks || (p != NULL) || (t == VERTDATA_NONE));
         this->vertDataType = t;
         this->vertPtr = p;
         this->vertStride = s == 0 ? VertexDataSize[t] : s;
+        this->vertStorage = std::move(storage);
 
-        this->par_store_->SetVertexData(t, reinterpret_cast<char const*>(p), this->vertStride, this->radius);
+        this->writableStore().SetVertexData(t, reinterpret_cast<char const*>(p), this->vertStride, this->radius);
     }
 
     /**
@@ -526,14 +570,17 @@ public:
      * @param p The pointer to the ID data (must not be NULL if t
      *          is not 'IDDATA_NONE'
      * @param s The stride of the ID data
+     * @param storage The optional storage owning the ID data, copies of
+     *                this list keep it alive
      */
-    void SetIDData(IDDataType t, const void* p, unsigned int s = 0) {
+    void SetIDData(IDDataType t, const void* p, unsigned int s = 0, std::shared_ptr<const void> storage = nullptr) {
         ASSERT(this->disabledNullChecks || (p != NULL) || (t == IDDATA_NONE));
         this->idDataType = t;
         this->idPtr = p;
         this->idStride = s == 0 ? IDDataSize[t] : s;
+        this->idStorage = std::move(storage);
 
-        this->par_store_->SetIDData(t, reinterpret_cast<char const*>(p), this->idStride);
+        this->writableStore().SetIDData(t, reinterpret_cast<char const*>(p), this->idStride);
     }
 
     /**
@@ -708,6 +755,31 @@ private:
     /** The particle ID stride */
     unsigned int idStride;
 
+    /** The storage owning the colour data, nullptr if not owned by any list */
+    std::shared_ptr<const void> colStorage;
+
+    /** The storage owning the vertex data, nullptr if not owned by any list */
+    std::shared_ptr<const void> vertStorage;
+
+    /** The storage owning the direction data, nullptr if not owned by any list */
+    std::shared_ptr<const void> dirStorage;
+
+    /** The storage owning the ID data, nullptr if not owned by any list */
+    std::shared_ptr<const void> idStorage;
+
+    /**
+     * Answer the particle store for modification. Copies of a list share
+     * the store until one of them changes its data.
+     *
+     * @return The particle store of this list only
+     */
+    ParticleStore& writableStore(void) {
+        if (this->par_store_.use_count() > 1) {
+            this->par_store_ = std::make_shared<ParticleStore>(*this->par_store_);
+        }
+        return *this->par_store_;
+    }
+
 protected:
     /** Instance of the particle store */
     std::shared_ptr<ParticleStore> par_store_ = std::make_shared<ParticleStore>();
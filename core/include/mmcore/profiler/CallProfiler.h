@@ -0,0 +1,253 @@
+/*
+ * profiler/CallProfiler.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+#include "CallProfiling.h"
+
+namespace megamol {
+namespace core {
+
+class Call;
+
+namespace profiler {
+
+/**
+ * Always-available instrumentation of Call::operator().
+ *
+ * Every issued call function produces one event (CPU wall time, data hash
+ * and bytes reported by the call) that is written into a lock-free ring
+ * buffer owned by the issuing thread. The main thread drains all buffers
+ * once per frame ('EndFrame') and aggregates the events per call and
+ * function. Calls into renderers and views can additionally be timed with
+ * GL timestamp queries, which are resolved a few frames later.
+ *
+ * When disabled, the only overhead in Call::operator() is one relaxed
+ * atomic load.
+ */
+class MEGAMOLCORE_API CallProfiler {
+public:
+    /**
+     * Answer the only instance of this class
+     *
+     * @return The only instance of this class
+     */
+    static CallProfiler& Instance(void);
+
+    /**
+     * Answer whether events are recorded.
+     *
+     * @return 'true' if events are recorded
+     */
+    inline bool IsEnabled(void) const {
+        return this->enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Answer whether GL timer queries are issued for render calls.
+     *
+     * @return 'true' if GL timers are enabled
+     */
+    inline bool IsGLTimingEnabled(void) const {
+        return this->glTimers.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool enable);
+
+    void SetGLTimingEnabled(bool enable);
+
+    /**
+     * Answer the current time stamp used for events.
+     *
+     * @return Nanoseconds since an arbitrary epoch.
+     */
+    static inline int64_t Now(void) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * Records one finished call function. Called by Call::operator().
+     *
+     * @param call  The issued call
+     * @param func  The issued function id
+     * @param start Time stamp before dispatching
+     * @param end   Time stamp after the callee returned
+     */
+    void Record(Call const& call, unsigned int func, int64_t start, int64_t end);
+
+    /** Begin and end timestamp query objects */
+    using GLTimer = std::pair<unsigned int, unsigned int>;
+
+    /**
+     * Issues the GL timestamp query before a render call.
+     *
+     * @return The query objects, 0 if no query could be created.
+     */
+    GLTimer BeginGLTimer(void);
+
+    /**
+     * Issues the GL timestamp query after a render call.
+     *
+     * @param call  The issued call
+     * @param func  The issued function id
+     * @param timer The queries returned by 'BeginGLTimer'
+     */
+    void EndGLTimer(Call const& call, unsigned int func, GLTimer const& timer);
+
+    /**
+     * Drains all ring buffers and resolves available GL queries. Must be
+     * called from the thread owning the GL context, once per frame.
+     *
+     * @param frame The id of the frame that just finished
+     */
+    void EndFrame(uint64_t frame);
+
+    /**
+     * Drops all aggregates of 'call'. Called when the call is destroyed.
+     * Events of 'call' still in the ring buffers are discarded by the next
+     * drain, so this does not drain itself.
+     *
+     * @param call The call going away
+     */
+    void ForgetCall(Call const* call);
+
+    /**
+     * Answer the aggregated statistics, sorted by total CPU time.
+     *
+     * @return The statistics of all recorded call functions
+     */
+    std::vector<frontend_resources::CallStatistics> Statistics(void);
+
+    /** Drops all aggregates and recent events */
+    void Reset(void);
+
+    bool ExportCSV(std::string const& filename);
+
+    bool ExportChromeTrace(std::string const& filename);
+
+    /**
+     * Answer the frontend resource exposing this profiler.
+     *
+     * @return The frontend resource
+     */
+    inline frontend_resources::CallProfiling const& Resource(void) const {
+        return this->resource;
+    }
+
+private:
+    /** One issued call function */
+    struct Event {
+        Call const* call;
+        unsigned int func;
+        uint32_t thread;
+        int64_t start;
+        int64_t duration;
+        size_t hash;
+        size_t bytes;
+        uint64_t generation; //< 'forgetCount' when recorded, see 'ForgetCall'
+    };
+
+    /**
+     * Ring buffer slot. 'seq' is 2 * index + 1 while event 'index' is
+     * written and 2 * index + 2 once it is complete, so the consumer can
+     * detect slots overwritten while it copied them.
+     */
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        Event event;
+    };
+
+    /** Single producer, single consumer ring buffer, oldest events are overwritten */
+    struct RingBuffer {
+        static constexpr size_t Capacity = 1 << 14;
+        std::array<Slot, Capacity> slots;
+        std::atomic<uint64_t> head{0};
+        uint64_t tail = 0; // only touched by the consumer
+        uint32_t thread = 0;
+    };
+
+    /** Key of the aggregates: call and function id */
+    using Key = std::pair<Call const*, unsigned int>;
+
+    struct Aggregate {
+        frontend_resources::CallStatistics stats;
+        size_t lastHash = 0;
+        uint64_t generation = 0; //< generation of the first event
+        bool resolved = false;
+    };
+
+    struct PendingGLTimer {
+        Key key;
+        unsigned int begin;
+        unsigned int end;
+    };
+
+    CallProfiler(void);
+
+    ~CallProfiler(void);
+
+    RingBuffer& localBuffer(void);
+
+    void drain(void);
+
+    void aggregate(Event const& e);
+
+    void resolveNames(Key const& key, Aggregate& agg);
+
+    std::atomic<bool> enabled{false};
+
+    std::atomic<bool> glTimers{false};
+
+    /** Protects the list of buffers */
+    std::mutex buffersLock;
+
+    std::vector<std::shared_ptr<RingBuffer>> buffers;
+
+    /** Protects everything the consumer touches */
+    std::recursive_mutex consumerLock;
+
+    std::map<Key, Aggregate> aggregates;
+
+    /** Incremented by every 'ForgetCall' */
+    std::atomic<uint64_t> forgetCount{0};
+
+    /** Calls forgotten since the last drain, with the generation they were forgotten in */
+    std::map<Call const*, uint64_t> forgotten;
+
+    /** Most recent events for the trace export */
+    std::deque<Event> recent;
+
+    static constexpr size_t MaxRecentEvents = 1 << 18;
+
+    std::vector<PendingGLTimer> pendingGLTimers;
+
+    uint64_t currentFrame = 0;
+
+    int64_t epoch;
+
+    frontend_resources::CallProfiling resource;
+};
+
+} /* end namespace profiler */
+} /* end namespace core */
+} /* end namespace megamol */
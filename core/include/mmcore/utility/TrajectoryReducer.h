@@ -0,0 +1,318 @@
+/*
+ * TrajectoryReducer.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace megamol {
+namespace core {
+namespace utility {
+
+/**
+ * Reduces a per-frame computation over a range of trajectory frames.
+ *
+ * Every worker thread owns one partial result, initialised as a copy of an
+ * identity value. Frames are accumulated into the partial of whichever worker
+ * picks them up, and after the last frame the partials are merged in worker
+ * order. Floating-point sums may therefore differ in the last bits between
+ * runs.
+ *
+ * By default frames are loaded by the calling thread, strictly in ascending
+ * order, into a bounded set of frame buffers, while the workers accumulate
+ * the frames loaded before. This matches data sources like
+ * MolecularDataCall, which hold exactly one frame and must not be called
+ * concurrently. Sources that can be read concurrently may enable
+ * SetConcurrentLoading, then every worker loads its own frames.
+ *
+ * Progress is reported per frame from the calling thread. Returning false
+ * from the progress callback or calling Cancel stops the reduction at frame
+ * granularity without touching the result.
+ *
+ * @param Frame   Buffer holding the data of one frame, default constructible.
+ * @param Partial Accumulator type, copy constructible.
+ */
+template<typename Frame, typename Partial>
+class TrajectoryReducer {
+public:
+    /** Loads frame 'frameID' into 'frame', answers false on failure */
+    using LoadFunc = std::function<bool(unsigned int frameID, Frame& frame)>;
+
+    /** Adds frame 'frameID' to 'partial' */
+    using AccumulateFunc = std::function<void(unsigned int frameID, Frame const& frame, Partial& partial)>;
+
+    /** Adds 'partial' to 'result' */
+    using MergeFunc = std::function<void(Partial& result, Partial const& partial)>;
+
+    /** Reports the number of accumulated frames, answers false to cancel */
+    using ProgressFunc = std::function<bool(unsigned int framesDone, unsigned int frameCount)>;
+
+    enum class Result { Finished, Cancelled, Failed };
+
+    /**
+     * Ctor.
+     *
+     * @param threadCount Number of worker threads. 0 selects
+     *                    std::thread::hardware_concurrency().
+     */
+    explicit TrajectoryReducer(unsigned int threadCount = 0)
+            : threadCount(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    /** Sets whether LoadFunc may be called concurrently and out of order. */
+    inline void SetConcurrentLoading(bool concurrent) {
+        this->concurrentLoading = concurrent;
+    }
+
+    /**
+     * Sets the number of frame buffers for sequential loading. The number is
+     * raised to at least one more than the number of workers.
+     */
+    inline void SetFramesInFlight(unsigned int frames) {
+        this->framesInFlight = frames;
+    }
+
+    /** Sets the progress callback, which is invoked from the calling thread. */
+    inline void SetProgressCallback(ProgressFunc progress) {
+        this->progress = std::move(progress);
+    }
+
+    /** Requests cancellation of a running reduction. Thread-safe. */
+    inline void Cancel() {
+        this->cancelled.store(true);
+    }
+
+    /** Answer the number of worker threads. */
+    inline unsigned int ThreadCount() const {
+        return this->threadCount;
+    }
+
+    /**
+     * Runs the reduction. Exceptions thrown by LoadFunc or AccumulateFunc
+     * stop the reduction and are rethrown after all workers finished.
+     *
+     * @param firstFrame The first frame to process.
+     * @param frameCount The number of frames to process.
+     * @param load       Loads one frame.
+     * @param accumulate Adds one frame to a partial result.
+     * @param merge      Adds a partial result to the final one.
+     * @param identity   The initial value of every partial result.
+     * @param result     Receives the merged result if the reduction finished.
+     *
+     * @return Finished, Cancelled, or Failed if a frame could not be loaded.
+     */
+    Result Run(unsigned int firstFrame, unsigned int frameCount, LoadFunc const& load,
+        AccumulateFunc const& accumulate, MergeFunc const& merge, Partial const& identity, Partial& result) {
+        this->cancelled.store(false);
+        this->failed.store(false);
+        this->error = nullptr;
+        this->framesDone = 0;
+        if (frameCount == 0) {
+            result = identity;
+            return Result::Finished;
+        }
+
+        unsigned int const workerCount = std::min(this->threadCount, frameCount);
+        std::vector<Partial> partials(workerCount, identity);
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+
+        if (this->concurrentLoading) {
+            std::atomic<unsigned int> next{0};
+            for (unsigned int w = 0; w < workerCount; ++w) {
+                workers.emplace_back([&, w]() {
+                    Frame frame;
+                    unsigned int idx;
+                    while (!this->stopped() && (idx = next.fetch_add(1)) < frameCount) {
+                        if (!this->guarded([&]() { return load(firstFrame + idx, frame); })) break;
+                        if (!this->guarded([&]() {
+                                accumulate(firstFrame + idx, frame, partials[w]);
+                                return true;
+                            }))
+                            break;
+                        this->frameFinished();
+                    }
+                });
+            }
+            this->reportUntil(frameCount, frameCount);
+        } else {
+            std::vector<Frame> buffers(std::max(this->framesInFlight, workerCount + 1));
+            this->freeBuffers.clear();
+            this->readyFrames.clear();
+            for (size_t b = 0; b < buffers.size(); ++b) this->freeBuffers.push_back(b);
+            this->loadingDone = false;
+
+            for (unsigned int w = 0; w < workerCount; ++w) {
+                workers.emplace_back([&, w]() {
+                    for (;;) {
+                        std::pair<unsigned int, size_t> item;
+                        {
+                            std::unique_lock<std::mutex> guard(this->lock);
+                            this->changed.wait(guard, [this]() {
+                                return !this->readyFrames.empty() || this->loadingDone || this->stopped();
+                            });
+                            if (this->readyFrames.empty() || this->stopped()) return;
+                            item = this->readyFrames.front();
+                            this->readyFrames.pop_front();
+                        }
+                        if (!this->guarded([&]() {
+                                accumulate(item.first, buffers[item.second], partials[w]);
+                                return true;
+                            }))
+                            return;
+                        {
+                            std::lock_guard<std::mutex> guard(this->lock);
+                            this->freeBuffers.push_back(item.second);
+                        }
+                        this->frameFinished();
+                    }
+                });
+            }
+
+            unsigned int loaded = 0;
+            for (; loaded < frameCount; ++loaded) {
+                size_t buffer;
+                {
+                    std::unique_lock<std::mutex> guard(this->lock);
+                    this->changed.wait(guard, [this]() { return !this->freeBuffers.empty() || this->stopped(); });
+                    if (this->stopped()) break;
+                    buffer = this->freeBuffers.front();
+                    this->freeBuffers.pop_front();
+                }
+                if (!this->guarded([&]() { return load(firstFrame + loaded, buffers[buffer]); })) break;
+                {
+                    std::lock_guard<std::mutex> guard(this->lock);
+                    this->readyFrames.emplace_back(firstFrame + loaded, buffer);
+                }
+                this->changed.notify_all();
+                if (!this->reportProgress(frameCount)) break;
+            }
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                this->loadingDone = true;
+            }
+            this->changed.notify_all();
+            this->reportUntil(loaded, frameCount);
+        }
+
+        for (auto& t : workers) t.join();
+
+        if (this->error) std::rethrow_exception(this->error);
+        if (this->failed.load()) return Result::Failed;
+        if (this->cancelled.load()) return Result::Cancelled;
+
+        result = std::move(partials[0]);
+        for (unsigned int w = 1; w < workerCount; ++w) merge(result, partials[w]);
+        return Result::Finished;
+    }
+
+private:
+    inline bool stopped() const {
+        return this->cancelled.load() || this->failed.load();
+    }
+
+    /** Runs fn, marks the reduction as failed if it answers false or throws */
+    template<typename Fn>
+    bool guarded(Fn&& fn) {
+        bool ok = false;
+        try {
+            ok = fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if (!this->error) this->error = std::current_exception();
+        }
+        if (!ok) {
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                this->failed.store(true);
+            }
+            this->changed.notify_all();
+        }
+        return ok;
+    }
+
+    inline void frameFinished() {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            ++this->framesDone;
+        }
+        this->changed.notify_all();
+    }
+
+    /** Invokes the progress callback, cancels if it answers false */
+    bool reportProgress(unsigned int frameCount) {
+        if (!this->progress) return true;
+        unsigned int done;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            done = this->framesDone;
+        }
+        if (!this->progress(done, frameCount)) {
+            this->Cancel();
+            this->changed.notify_all();
+            return false;
+        }
+        return true;
+    }
+
+    /** Reports progress until 'target' frames are accumulated or the reduction stopped */
+    void reportUntil(unsigned int target, unsigned int frameCount) {
+        unsigned int reported = ~0u;
+        for (;;) {
+            unsigned int done;
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->changed.wait(guard, [&]() {
+                    return this->framesDone != reported || this->framesDone >= target || this->stopped();
+                });
+                done = this->framesDone;
+            }
+            if (done >= target || this->stopped()) break;
+            reported = done;
+            if (!this->reportProgress(frameCount)) break;
+        }
+        if (!this->stopped()) this->reportProgress(frameCount);
+    }
+
+    unsigned int threadCount;
+
+    unsigned int framesInFlight = 0;
+
+    bool concurrentLoading = false;
+
+    ProgressFunc progress;
+
+    std::atomic<bool> cancelled{false};
+
+    /** State shared with the workers, guarded by 'lock' */
+    std::mutex lock;
+
+    std::condition_variable changed;
+
+    std::deque<size_t> freeBuffers;
+
+    std::deque<std::pair<unsigned int, size_t>> readyFrames;
+
+    unsigned int framesDone = 0;
+
+    bool loadingDone = false;
+
+    std::atomic<bool> failed{false};
+
+    std::exception_ptr error;
+};
+
+} // namespace utility
+} // namespace core
+} // namespace megamol
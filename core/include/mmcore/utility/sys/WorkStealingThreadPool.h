@@ -0,0 +1,136 @@
+/*
+ * WorkStealingThreadPool.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+namespace megamol {
+namespace core {
+namespace utility {
+namespace sys {
+
+/**
+ * Fixed-size pool of worker threads with one task deque per worker.
+ *
+ * Workers pop tasks from the back of their own deque and steal from the
+ * front of the other deques once their own one runs dry. Tasks submitted
+ * from outside the pool are distributed round-robin. Tasks spawned from
+ * within a worker go to that worker's deque, which keeps nested work local.
+ *
+ * The pool is meant for coarse tasks (e.g. whole call subtrees), so the
+ * deques are protected by plain mutexes instead of a lock-free Chase-Lev
+ * structure.
+ */
+class MEGAMOLCORE_API WorkStealingThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * Handle to wait for a batch of tasks submitted together.
+     */
+    class MEGAMOLCORE_API TaskGroup {
+    public:
+        TaskGroup() = default;
+
+        /** Block until all tasks of the group finished. */
+        void Wait();
+
+        /** Answer whether all tasks of the group finished. */
+        bool Done() const;
+
+    private:
+        friend class WorkStealingThreadPool;
+
+        struct State {
+            std::atomic<size_t> pending{0};
+            std::mutex lock;
+            std::condition_variable finished;
+        };
+
+        std::shared_ptr<State> state;
+    };
+
+    /**
+     * Ctor.
+     *
+     * @param threadCount Number of worker threads. 0 selects
+     *                    std::thread::hardware_concurrency().
+     */
+    explicit WorkStealingThreadPool(unsigned int threadCount = 0);
+
+    /** Dtor. Finishes all queued tasks and joins the workers. */
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(WorkStealingThreadPool const&) = delete;
+    WorkStealingThreadPool& operator=(WorkStealingThreadPool const&) = delete;
+
+    /**
+     * Queues a single task. Exceptions escaping the task are swallowed.
+     *
+     * @param task The task to execute.
+     */
+    void Submit(Task task);
+
+    /**
+     * Queues a batch of tasks and returns a group handle to join them.
+     *
+     * @param tasks The tasks to execute.
+     *
+     * @return The group handle.
+     */
+    TaskGroup SubmitGroup(std::vector<Task> tasks);
+
+    /**
+     * Answer the number of worker threads.
+     *
+     * @return The number of worker threads.
+     */
+    inline unsigned int ThreadCount() const {
+        return static_cast<unsigned int>(this->workers.size());
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task task);
+
+    bool tryPop(size_t self, Task& task);
+
+    void workerMain(size_t self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::vector<std::thread> workers;
+
+    std::mutex sleepLock;
+
+    std::condition_variable wakeup;
+
+    std::atomic<size_t> queued{0};
+
+    std::atomic<size_t> nextQueue{0};
+
+    std::atomic<bool> running{true};
+};
+
+} // namespace sys
+} // namespace utility
+} // namespace core
+} // namespace megamol
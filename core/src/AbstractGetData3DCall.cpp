@@ -7,6 +7,7 @@
 
 #include "stdafx.h"
 #include "mmcore/AbstractGetData3DCall.h"
+#include <climits>
 
 using namespace megamol::core;
 
@@ -15,7 +16,7 @@ using namespace megamol::core;
  * AbstractGetData3DCall::AbstractGetData3DCall
  */
 AbstractGetData3DCall::AbstractGetData3DCall(void) : AbstractGetDataCall(),
-        forceFrame(false), frameCnt(0), frameID(0), bboxs() {
+        forceFrame(false), frameCnt(0), frameID(0), replayedFrameID(UINT_MAX), bboxs() {
     // intentionally empty
 }
 
@@ -40,3 +41,27 @@ AbstractGetData3DCall& AbstractGetData3DCall::operator=(
     this->bboxs = rhs.bboxs;
     return *this;
 }
+
+
+/*
+ * AbstractGetData3DCall::Replay
+ */
+bool AbstractGetData3DCall::Replay(std::vector<unsigned int> const& funcs) {
+    const unsigned int requested = this->frameID;
+    const bool force = this->forceFrame;
+
+    // the callers did not issue the calls of the next frame yet, so the
+    // request state still holds the frame of the current one
+    unsigned int next = requested;
+    if ((this->frameCnt > 1) && (this->replayedFrameID != UINT_MAX)) {
+        const unsigned int step =
+            (requested % this->frameCnt + this->frameCnt - this->replayedFrameID % this->frameCnt) % this->frameCnt;
+        next = (requested + step) % this->frameCnt;
+    }
+    this->replayedFrameID = requested;
+
+    this->SetFrameID(next, force);
+    const bool res = AbstractGetDataCall::Replay(funcs);
+    this->SetFrameID(requested, force);
+    return res;
+}
@@ -36,3 +36,13 @@ AbstractGetDataCall& AbstractGetDataCall::operator=(
     this->unlocker = rhs.unlocker; // this is dangerous but documented!
     return *this;
 }
+
+
+/*
+ * AbstractGetDataCall::Replay
+ */
+bool AbstractGetDataCall::Replay(std::vector<unsigned int> const& funcs) {
+    const bool res = Call::Replay(funcs);
+    this->Unlock();
+    return res;
+}
@@ -10,16 +10,34 @@
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
 #ifdef RIG_RENDERCALLS_WITH_DEBUGGROUPS
 #    include "mmcore/view/Renderer2DModule.h"
 #    include "mmcore/view/Renderer3DModule.h"
 #    include "mmcore/view/Renderer3DModuleGL.h"
 #    include "vislib/graphics/gl/IncludeAllGL.h"
 #endif
+#include "mmcore/profiler/CallProfiler.h"
 #include "mmcore/utility/log/Log.h"
+#include "AbstractInputScope.h"
+
+#include <algorithm>
+#include <mutex>
 
 using namespace megamol::core;
 
+namespace {
+
+/** Set while the current thread replays recorded functions */
+thread_local bool replaying = false;
+
+/** Answers the module owning 'slot', nullptr if the slot does not belong to a module */
+const Module* owningModule(const AbstractSlot* slot) {
+    return (slot == nullptr) ? nullptr : dynamic_cast<const Module*>(slot->Parent().get());
+}
+
+} // namespace
+
 /*
  * Call::Call
  */
@@ -32,6 +50,7 @@ Call::Call(void) : callee(nullptr), caller(nullptr), className(nullptr), funcMap
  * Call::~Call
  */
 Call::~Call(void) {
+    profiler::CallProfiler::Instance().ForgetCall(this);
     if (this->caller != nullptr) {
         CallerSlot* cr = this->caller;
         this->caller = nullptr; // DO NOT DELETE
@@ -50,8 +69,50 @@ Call::~Call(void) {
  * Call::operator()
  */
 bool Call::operator()(unsigned int func) {
+    auto& profiler = profiler::CallProfiler::Instance();
+    if ((this->callee == nullptr) || !profiler.IsEnabled()) {
+        return this->dispatch(func);
+    }
+
+    // only calls into renderers and views are worth a GL timer
+    const bool gl_timing = profiler.IsGLTimingEnabled() &&
+                           (dynamic_cast<megamol::frontend_resources::AbstractInputScope const*>(
+                                owningModule(this->callee)) != nullptr);
+    profiler::CallProfiler::GLTimer timer{0, 0};
+    if (gl_timing) timer = profiler.BeginGLTimer();
+    const auto start = profiler::CallProfiler::Now();
+    const bool res = this->dispatch(func);
+    profiler.Record(*this, func, start, profiler::CallProfiler::Now());
+    if (gl_timing) profiler.EndGLTimer(*this, func, timer);
+    return res;
+}
+
+
+/*
+ * Call::FunctionName
+ */
+const char* Call::FunctionName(unsigned int func) const {
+    if (this->callee == nullptr) return "";
+    return this->callee->GetCallbackFuncName(this->funcMap[func]);
+}
+
+
+/*
+ * Call::dispatch
+ */
+bool Call::dispatch(unsigned int func) {
     bool res = false;
     if (this->callee != nullptr) {
+        // thread-safe calls may be replayed from a prefetch thread, so they serialize on the callee module
+        std::unique_lock<std::recursive_mutex> guard;
+        const Module* owner = owningModule(this->callee);
+        if ((owner != nullptr) && this->IsThreadSafe()) {
+            guard = std::unique_lock<std::recursive_mutex>(owner->CallLock());
+            if (!replaying && (std::find(this->recordedFunctions.begin(), this->recordedFunctions.end(), func) ==
+                                  this->recordedFunctions.end())) {
+                this->recordedFunctions.push_back(func);
+            }
+        }
 #ifdef RIG_RENDERCALLS_WITH_DEBUGGROUPS
         auto f = this->callee->GetCallbackFuncName(func);
         auto parent = callee->Parent().get();
@@ -75,3 +136,41 @@ bool Call::operator()(unsigned int func) {
     //    res ? "true" : "false", this->callee == nullptr ? "no callee" : "from callee");
     return res;
 }
+
+
+/*
+ * Call::IsThreadSafe
+ */
+bool Call::IsThreadSafe(void) const {
+    const Module* owner = owningModule(this->callee);
+    return (owner != nullptr) && owner->IsThreadSafe();
+}
+
+
+/*
+ * Call::TakeRecordedFunctions
+ */
+std::vector<unsigned int> Call::TakeRecordedFunctions(void) {
+    std::vector<unsigned int> funcs;
+    const Module* owner = owningModule(this->callee);
+    if (owner != nullptr) {
+        std::lock_guard<std::recursive_mutex> guard(owner->CallLock());
+        funcs.swap(this->recordedFunctions);
+    }
+    return funcs;
+}
+
+
+/*
+ * Call::Replay
+ */
+bool Call::Replay(std::vector<unsigned int> const& funcs) {
+    const bool outer = !replaying;
+    replaying = true;
+    bool res = true;
+    for (auto func : funcs) {
+        res = (*this)(func) && res;
+    }
+    if (outer) replaying = false;
+    return res;
+}
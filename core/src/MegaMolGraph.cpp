@@ -5,12 +5,15 @@
 
 #include "mmcore/AbstractSlot.h"
 
+#include "AbstractInputScope.h"
+
 #include "mmcore/utility/log/Log.h"
 
 #include <algorithm>
 #include <cctype>
 #include <string>
 #include <numeric> // std::accumulate
+#include <unordered_map>
 
 // splits a string of the form "::one::two::three::" into an array of strings {"one", "two", "three"}
 static std::vector<std::string> splitPathName(std::string const& path) {
@@ -100,6 +103,7 @@ megamol::core::MegaMolGraph& megamol::core::MegaMolGraph::operator=(MegaMolGraph
 
 /** dtor */
 megamol::core::MegaMolGraph::~MegaMolGraph() {
+    JoinDataSubtrees();
     moduleProvider_ptr = nullptr;
     callProvider_ptr = nullptr;
 }
@@ -219,6 +223,7 @@ megamol::core::CallList_t::const_iterator megamol::core::MegaMolGraph::find_call
 
 
 bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const& request) {
+    invalidate_prefetch_groups();
     factories::ModuleDescription::ptr module_description = this->ModuleProvider().Find(request.className.c_str());
     if (!module_description) {
         log_error("error. module factory could not find module class name: " + request.className);
@@ -275,6 +280,7 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
 }
 
 bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& request) {
+    invalidate_prefetch_groups();
 
     factories::CallDescription::ptr call_description = this->CallProvider().Find(request.className.c_str());
 
@@ -378,6 +384,7 @@ static std::list<megamol::core::CallList_t::iterator> find_all_of(
 
 
 bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& request) {
+    invalidate_prefetch_groups();
 
     auto module_it = find_module(request);
     if (module_it == this->module_list_.end()) {
@@ -420,6 +427,7 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
 
 
 bool megamol::core::MegaMolGraph::delete_call(CallDeletionRequest_t const& request) {
+    invalidate_prefetch_groups();
 
     auto call_it = find_call(request.from, request.to);
 
@@ -609,6 +617,7 @@ bool megamol::core::MegaMolGraph::SetGraphEntryPoint(std::string moduleName)
         return false;
     }
 
+    invalidate_prefetch_groups();
     this->graph_entry_points.push_back(module_shared_ptr);
 
     module_it->isGraphEntryPoint = true;
@@ -635,6 +644,7 @@ bool megamol::core::MegaMolGraph::RemoveGraphEntryPoint(std::string moduleName)
         return false;
     }
 
+    invalidate_prefetch_groups();
     this->graph_entry_points.remove_if(
         [&](Module::ptr_type& module) { return std::string{module->Name().PeekBuffer()} == moduleName; });
 
@@ -667,6 +677,7 @@ megamol::core::MegaMolGraph_Convenience& megamol::core::MegaMolGraph::Convenienc
 }
 
 void megamol::core::MegaMolGraph::Clear() {
+    invalidate_prefetch_groups();
     // currently entry points are expected to be graph modules, i.e. views
     // therefore it is ok for us to clear all entry points if the graph shuts down
     call_list_.clear();
@@ -692,3 +703,177 @@ std::vector<megamol::frontend::FrontendResource> megamol::core::MegaMolGraph::ge
     return result;
 }
 
+
+void megamol::core::MegaMolGraph::SetExecutionMode(ExecutionMode mode, unsigned int threads) {
+    JoinDataSubtrees();
+
+    execution_mode = mode;
+    if (mode == ExecutionMode::Serial) {
+        prefetch_pool.reset();
+        return;
+    }
+
+    if (!prefetch_pool || (threads != 0 && prefetch_pool->ThreadCount() != threads)) {
+        prefetch_pool.reset();
+        prefetch_pool = std::make_unique<utility::sys::WorkStealingThreadPool>(threads);
+    }
+    log("parallel graph execution with " + std::to_string(prefetch_pool->ThreadCount()) + " threads");
+}
+
+void megamol::core::MegaMolGraph::PrefetchDataSubtrees() {
+    if (execution_mode == ExecutionMode::Serial || !prefetch_pool)
+        return;
+
+    JoinDataSubtrees();
+    update_prefetch_groups();
+
+    // every group is a task of its own, so that each entry point waits only for the groups below it
+    prefetch_running.resize(prefetch_groups.size());
+    for (size_t i = 0; i < prefetch_groups.size(); ++i) {
+        auto& group = prefetch_groups[i];
+        prefetch_running[i] = prefetch_pool->SubmitGroup({[&group]() {
+            for (auto* call : group) {
+                auto funcs = call->TakeRecordedFunctions();
+                if (!funcs.empty())
+                    call->Replay(funcs);
+            }
+        }});
+    }
+}
+
+void megamol::core::MegaMolGraph::JoinDataSubtrees() {
+    for (auto& running : prefetch_running) {
+        running.Wait();
+    }
+    prefetch_running.clear();
+}
+
+void megamol::core::MegaMolGraph::JoinDataSubtrees(void const* entry_point) {
+    auto it = entry_point_groups.find(static_cast<Module const*>(entry_point));
+    if (it == entry_point_groups.end())
+        return;
+    for (auto i : it->second) {
+        if (i < prefetch_running.size())
+            prefetch_running[i].Wait();
+    }
+}
+
+void megamol::core::MegaMolGraph::invalidate_prefetch_groups() {
+    JoinDataSubtrees();
+    prefetch_groups_dirty = true;
+}
+
+void megamol::core::MegaMolGraph::update_prefetch_groups() {
+    if (!prefetch_groups_dirty)
+        return;
+
+    prefetch_groups.clear();
+    entry_point_groups.clear();
+    prefetch_groups_dirty = false;
+
+    const auto owner = [](AbstractSlot const* slot) -> Module const* {
+        return (slot == nullptr) ? nullptr : dynamic_cast<Module const*>(slot->Parent().get());
+    };
+
+    // outgoing calls per module
+    std::unordered_map<Module const*, std::vector<Call*>> outgoing;
+    for (auto& call : call_list_) {
+        outgoing[owner(call.callPtr->PeekCallerSlot())].push_back(call.callPtr.get());
+    }
+
+    // a module is data-only if it does not render and all calls it issues are thread-safe into data-only modules
+    enum class State { Visiting, DataOnly, Other };
+    std::unordered_map<Module const*, State> state;
+    std::function<bool(Module const*)> is_data_only = [&](Module const* module) -> bool {
+        if (module == nullptr)
+            return false;
+        auto it = state.find(module);
+        if (it != state.end())
+            return it->second == State::DataOnly; // cycles count as not data-only
+
+        state[module] = State::Visiting;
+        bool data_only = dynamic_cast<megamol::frontend_resources::AbstractInputScope const*>(module) == nullptr;
+        for (auto* call : outgoing[module]) {
+            data_only = data_only && call->IsThreadSafe() && is_data_only(owner(call->PeekCalleeSlot()));
+        }
+        state[module] = data_only ? State::DataOnly : State::Other;
+        return data_only;
+    };
+
+    // union-find over modules: roots whose subtrees share a module must run in the same task
+    std::unordered_map<Module const*, Module const*> parent;
+    std::function<Module const*(Module const*)> find = [&](Module const* m) -> Module const* {
+        auto it = parent.find(m);
+        if (it == parent.end() || it->second == m) {
+            parent[m] = m;
+            return m;
+        }
+        auto root = find(it->second);
+        parent[m] = root;
+        return root;
+    };
+    const auto unite = [&](Module const* a, Module const* b) { parent[find(a)] = find(b); };
+
+    std::vector<Call*> roots;
+    for (auto& call : call_list_) {
+        auto* c = call.callPtr.get();
+        auto* callee = owner(c->PeekCalleeSlot());
+        if (c->IsThreadSafe() && is_data_only(callee) && !is_data_only(owner(c->PeekCallerSlot()))) {
+            roots.push_back(c);
+
+            // join every module of the subtree with the callee
+            std::vector<Module const*> stack = {callee};
+            std::vector<Module const*> visited;
+            while (!stack.empty()) {
+                auto* m = stack.back();
+                stack.pop_back();
+                if (std::find(visited.begin(), visited.end(), m) != visited.end())
+                    continue;
+                visited.push_back(m);
+                unite(m, callee);
+                for (auto* out : outgoing[m]) {
+                    stack.push_back(owner(out->PeekCalleeSlot()));
+                }
+            }
+        }
+    }
+
+    std::unordered_map<Module const*, size_t> group_index;
+    std::unordered_map<Call const*, size_t> root_group;
+    for (auto* c : roots) {
+        auto* rep = find(owner(c->PeekCalleeSlot()));
+        auto it = group_index.find(rep);
+        if (it == group_index.end()) {
+            it = group_index.emplace(rep, prefetch_groups.size()).first;
+            prefetch_groups.emplace_back();
+        }
+        prefetch_groups[it->second].push_back(c);
+        root_group[c] = it->second;
+    }
+
+    // the groups each entry point reaches, i.e. must wait for before it renders
+    for (auto& entry_point : graph_entry_points) {
+        auto& groups = entry_point_groups[entry_point.get()];
+        std::vector<Module const*> stack = {entry_point.get()};
+        std::vector<Module const*> visited;
+        while (!stack.empty()) {
+            auto* m = stack.back();
+            stack.pop_back();
+            if (m == nullptr || std::find(visited.begin(), visited.end(), m) != visited.end())
+                continue;
+            visited.push_back(m);
+            for (auto* out : outgoing[m]) {
+                auto it = root_group.find(out);
+                if (it != root_group.end()) {
+                    if (std::find(groups.begin(), groups.end(), it->second) == groups.end())
+                        groups.push_back(it->second);
+                } else {
+                    stack.push_back(owner(out->PeekCalleeSlot()));
+                }
+            }
+        }
+    }
+
+    log("found " + std::to_string(roots.size()) + " data-only call subtrees in " +
+        std::to_string(prefetch_groups.size()) + " independent groups");
+}
@@ -37,3 +37,25 @@ moldyn::MultiParticleDataCall& moldyn::MultiParticleDataCall::operator=(
     AbstractParticleDataCall<SimpleSphericalParticles>::operator =(rhs);
     return *this;
 }
+
+
+/*
+ * moldyn::MultiParticleDataCall::ProfilingDataSize
+ */
+size_t moldyn::MultiParticleDataCall::ProfilingDataSize(void) const {
+    size_t bytes = 0;
+    for (unsigned int i = 0; i < this->GetParticleListCount(); ++i) {
+        auto const& p = this->AccessParticles(i);
+        const size_t cnt = static_cast<size_t>(p.GetCount());
+        const auto vert = static_cast<const char*>(p.GetVertexData());
+        const size_t vertStride = p.GetVertexDataStride();
+        const auto separate = [&](const void* ptr) {
+            auto c = static_cast<const char*>(ptr);
+            return (c != nullptr) && ((vert == nullptr) || (c < vert) || (c >= vert + vertStride));
+        };
+        bytes += cnt * vertStride;
+        if (separate(p.GetColourData())) bytes += cnt * p.GetColourDataStride();
+        if (separate(p.GetDirData())) bytes += cnt * p.GetDirDataStride();
+    }
+    return bytes;
+}
@@ -101,6 +101,10 @@ moldyn::SimpleSphericalParticles& moldyn::SimpleSphericalParticles::operator=(
     this->idDataType = rhs.idDataType;
     this->idPtr = rhs.idPtr;
     this->idStride = rhs.idStride;
+    this->colStorage = rhs.colStorage;
+    this->vertStorage = rhs.vertStorage;
+    this->dirStorage = rhs.dirStorage;
+    this->idStorage = rhs.idStorage;
     this->par_store_ = rhs.par_store_;
     this->wsBBox = rhs.wsBBox;
     return *this;
@@ -0,0 +1,366 @@
+/*
+ * profiler/CallProfiler.cpp
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "mmcore/profiler/CallProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/utility/log/Log.h"
+#include "vislib/graphics/gl/IncludeAllGL.h"
+
+using namespace megamol::core;
+using namespace megamol::core::profiler;
+
+
+/*
+ * CallProfiler::Instance
+ */
+CallProfiler& CallProfiler::Instance(void) {
+    static CallProfiler inst;
+    return inst;
+}
+
+
+/*
+ * CallProfiler::CallProfiler
+ */
+CallProfiler::CallProfiler(void) : epoch(Now()) {
+    this->resource.set_enabled = [&](bool enable) { this->SetEnabled(enable); };
+    this->resource.is_enabled = [&]() -> bool { return this->IsEnabled(); };
+    this->resource.set_gl_timers = [&](bool enable) { this->SetGLTimingEnabled(enable); };
+    this->resource.statistics = [&]() { return this->Statistics(); };
+    this->resource.reset = [&]() { this->Reset(); };
+    this->resource.export_csv = [&](std::string const& filename) { return this->ExportCSV(filename); };
+    this->resource.export_chrome_trace = [&](std::string const& filename) {
+        return this->ExportChromeTrace(filename);
+    };
+}
+
+
+/*
+ * CallProfiler::~CallProfiler
+ */
+CallProfiler::~CallProfiler(void) {
+    // GL objects of pending queries are gone with the context at this point
+    this->pendingGLTimers.clear();
+}
+
+
+/*
+ * CallProfiler::SetEnabled
+ */
+void CallProfiler::SetEnabled(bool enable) {
+    this->enabled.store(enable);
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+        "CallProfiler: call profiling %s", enable ? "enabled" : "disabled");
+}
+
+
+/*
+ * CallProfiler::SetGLTimingEnabled
+ */
+void CallProfiler::SetGLTimingEnabled(bool enable) {
+    this->glTimers.store(enable);
+}
+
+
+/*
+ * CallProfiler::Record
+ */
+void CallProfiler::Record(Call const& call, unsigned int func, int64_t start, int64_t end) {
+    auto& buf = this->localBuffer();
+    const uint64_t h = buf.head.load(std::memory_order_relaxed);
+    Slot& slot = buf.slots[h % RingBuffer::Capacity];
+    slot.seq.store(2 * h + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event& e = slot.event;
+    e.call = &call;
+    e.func = func;
+    e.thread = buf.thread;
+    e.start = start;
+    e.duration = end - start;
+    e.hash = call.ProfilingDataHash();
+    e.bytes = call.ProfilingDataSize();
+    e.generation = this->forgetCount.load(std::memory_order_relaxed);
+    slot.seq.store(2 * h + 2, std::memory_order_release);
+    buf.head.store(h + 1, std::memory_order_release);
+}
+
+
+/*
+ * CallProfiler::BeginGLTimer
+ */
+CallProfiler::GLTimer CallProfiler::BeginGLTimer(void) {
+    GLuint queries[2] = {0, 0};
+    glGenQueries(2, queries);
+    glQueryCounter(queries[0], GL_TIMESTAMP);
+    return GLTimer{queries[0], queries[1]};
+}
+
+
+/*
+ * CallProfiler::EndGLTimer
+ */
+void CallProfiler::EndGLTimer(Call const& call, unsigned int func, GLTimer const& timer) {
+    if (timer.first == 0 || timer.second == 0) return;
+    glQueryCounter(timer.second, GL_TIMESTAMP);
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    this->pendingGLTimers.push_back(PendingGLTimer{Key{&call, func}, timer.first, timer.second});
+}
+
+
+/*
+ * CallProfiler::EndFrame
+ */
+void CallProfiler::EndFrame(uint64_t frame) {
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    this->drain();
+    this->currentFrame = frame;
+
+    if (this->pendingGLTimers.empty()) return;
+
+    auto it = std::remove_if(this->pendingGLTimers.begin(), this->pendingGLTimers.end(), [&](PendingGLTimer& t) {
+        GLint available = 0;
+        glGetQueryObjectiv(t.end, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+
+        GLuint64 tb = 0, te = 0;
+        glGetQueryObjectui64v(t.begin, GL_QUERY_RESULT, &tb);
+        glGetQueryObjectui64v(t.end, GL_QUERY_RESULT, &te);
+        GLuint queries[2] = {t.begin, t.end};
+        glDeleteQueries(2, queries);
+
+        auto agg = this->aggregates.find(t.key);
+        if (agg != this->aggregates.end()) {
+            agg->second.stats.last_gpu_ms = static_cast<double>(te - tb) * 1.0e-6;
+        }
+        return true;
+    });
+    this->pendingGLTimers.erase(it, this->pendingGLTimers.end());
+}
+
+
+/*
+ * CallProfiler::ForgetCall
+ */
+void CallProfiler::ForgetCall(Call const* call) {
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    // events still in flight reference 'call', drain skips them instead of resolving the dangling pointer.
+    // a call created later at the same address records events of a newer generation.
+    this->forgotten[call] = this->forgetCount.fetch_add(1) + 1;
+    for (auto it = this->aggregates.lower_bound(Key{call, 0});
+         (it != this->aggregates.end()) && (it->first.first == call);) {
+        it = this->aggregates.erase(it);
+    }
+    for (auto& t : this->pendingGLTimers) {
+        if (t.key.first == call) t.key.first = nullptr;
+    }
+}
+
+
+/*
+ * CallProfiler::Statistics
+ */
+std::vector<megamol::frontend_resources::CallStatistics> CallProfiler::Statistics(void) {
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    this->drain();
+
+    std::vector<frontend_resources::CallStatistics> result;
+    result.reserve(this->aggregates.size());
+    for (auto& agg : this->aggregates) {
+        result.push_back(agg.second.stats);
+    }
+    std::sort(result.begin(), result.end(),
+        [](auto const& a, auto const& b) { return a.total_cpu_ms > b.total_cpu_ms; });
+    return result;
+}
+
+
+/*
+ * CallProfiler::Reset
+ */
+void CallProfiler::Reset(void) {
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    this->drain();
+    this->aggregates.clear();
+    this->recent.clear();
+}
+
+
+/*
+ * CallProfiler::ExportCSV
+ */
+bool CallProfiler::ExportCSV(std::string const& filename) {
+    std::ofstream out(filename);
+    if (!out) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "CallProfiler: cannot write \"%s\"", filename.c_str());
+        return false;
+    }
+
+    out << "caller;callee;call;function;count;total_cpu_ms;last_cpu_ms;max_cpu_ms;last_gpu_ms;hash_changes;"
+           "last_bytes;last_frame\n";
+    out << std::setprecision(6) << std::fixed;
+    for (auto const& s : this->Statistics()) {
+        out << s.caller << ";" << s.callee << ";" << s.call_class << ";" << s.function << ";" << s.call_count << ";"
+            << s.total_cpu_ms << ";" << s.last_cpu_ms << ";" << s.max_cpu_ms << ";" << s.last_gpu_ms << ";"
+            << s.data_hash_changes << ";" << s.last_bytes_produced << ";" << s.last_frame << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+
+/*
+ * CallProfiler::ExportChromeTrace
+ */
+bool CallProfiler::ExportChromeTrace(std::string const& filename) {
+    std::lock_guard<std::recursive_mutex> guard(this->consumerLock);
+    this->drain();
+
+    std::ofstream out(filename);
+    if (!out) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "CallProfiler: cannot write \"%s\"", filename.c_str());
+        return false;
+    }
+
+    const auto escape = [](std::string s) {
+        std::string r;
+        r.reserve(s.size());
+        for (char c : s) {
+            if (c == '"' || c == '\\') r.push_back('\\');
+            r.push_back(c);
+        }
+        return r;
+    };
+
+    out << "{\"traceEvents\":[\n";
+    out << std::setprecision(3) << std::fixed;
+    bool first = true;
+    for (auto const& e : this->recent) {
+        auto agg = this->aggregates.find(Key{e.call, e.func});
+        // older generations belong to a forgotten call at the same address
+        if ((agg == this->aggregates.end()) || (e.generation < agg->second.generation)) continue;
+        auto const& s = agg->second.stats;
+        if (!first) out << ",\n";
+        first = false;
+        // chrome trace time stamps are microseconds
+        out << "{\"name\":\"" << escape(s.callee + "::" + s.function) << "\",\"cat\":\"" << escape(s.call_class)
+            << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread << ",\"ts\":" << (e.start - this->epoch) * 1.0e-3
+            << ",\"dur\":" << e.duration * 1.0e-3 << ",\"args\":{\"caller\":\"" << escape(s.caller)
+            << "\",\"bytes\":" << e.bytes << "}}";
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+
+/*
+ * CallProfiler::localBuffer
+ */
+CallProfiler::RingBuffer& CallProfiler::localBuffer(void) {
+    // the profiler owns the buffers, so events survive the exit of short-lived threads
+    thread_local std::shared_ptr<RingBuffer> buffer;
+    if (buffer == nullptr) {
+        buffer = std::make_shared<RingBuffer>();
+        std::lock_guard<std::mutex> guard(this->buffersLock);
+        buffer->thread = static_cast<uint32_t>(this->buffers.size());
+        this->buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+
+/*
+ * CallProfiler::drain
+ */
+void CallProfiler::drain(void) {
+    std::vector<std::shared_ptr<RingBuffer>> bufs;
+    {
+        std::lock_guard<std::mutex> guard(this->buffersLock);
+        bufs = this->buffers;
+    }
+
+    for (auto& buf : bufs) {
+        const uint64_t head = buf->head.load(std::memory_order_acquire);
+        if (head - buf->tail >= RingBuffer::Capacity) {
+            // the producer lapped us or is about to overwrite slot 'tail', the oldest events are lost
+            buf->tail = head - RingBuffer::Capacity + 1;
+        }
+        for (; buf->tail < head; ++buf->tail) {
+            Slot const& slot = buf->slots[buf->tail % RingBuffer::Capacity];
+            const uint64_t expected = 2 * buf->tail + 2;
+            if (slot.seq.load(std::memory_order_acquire) != expected) continue;
+            Event e = slot.event;
+            // the slot might have been overwritten while we copied it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != expected) continue;
+
+            auto f = this->forgotten.find(e.call);
+            if ((f != this->forgotten.end()) && (e.generation < f->second)) continue;
+            this->aggregate(e);
+        }
+    }
+
+    // all events recorded before the calls were destroyed are consumed now
+    this->forgotten.clear();
+}
+
+
+/*
+ * CallProfiler::aggregate
+ */
+void CallProfiler::aggregate(Event const& e) {
+    const Key key{e.call, e.func};
+    auto& agg = this->aggregates[key];
+    if (!agg.resolved) {
+        agg.generation = e.generation;
+        this->resolveNames(key, agg);
+    }
+
+    const double ms = static_cast<double>(e.duration) * 1.0e-6;
+    auto& s = agg.stats;
+    s.call_count++;
+    s.total_cpu_ms += ms;
+    s.last_cpu_ms = ms;
+    s.max_cpu_ms = std::max(s.max_cpu_ms, ms);
+    if (e.hash != agg.lastHash) {
+        if (s.call_count > 1) s.data_hash_changes++;
+        agg.lastHash = e.hash;
+    }
+    s.last_bytes_produced = e.bytes;
+    s.last_frame = this->currentFrame;
+
+    this->recent.push_back(e);
+    if (this->recent.size() > MaxRecentEvents) {
+        this->recent.pop_front();
+    }
+}
+
+
+/*
+ * CallProfiler::resolveNames
+ */
+void CallProfiler::resolveNames(Key const& key, Aggregate& agg) {
+    auto const* call = key.first;
+    auto& s = agg.stats;
+    s.call_class = (call->ClassName() != nullptr) ? call->ClassName() : "";
+    if (auto const* caller = call->PeekCallerSlot(); caller != nullptr) {
+        s.caller = caller->FullName().PeekBuffer();
+    }
+    if (auto const* callee = call->PeekCalleeSlot(); callee != nullptr) {
+        s.callee = callee->FullName().PeekBuffer();
+    }
+    s.function = call->FunctionName(key.second);
+    agg.resolved = true;
+}
@@ -0,0 +1,187 @@
+/*
+ * WorkStealingThreadPool.cpp
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "mmcore/utility/sys/WorkStealingThreadPool.h"
+
+#include <algorithm>
+
+using namespace megamol::core::utility::sys;
+
+namespace {
+
+/** Pool the current thread works for, nullptr for threads outside any pool */
+thread_local WorkStealingThreadPool const* currentPool = nullptr;
+
+/** Index of the current worker within 'currentPool' */
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+
+/*
+ * WorkStealingThreadPool::TaskGroup::Wait
+ */
+void WorkStealingThreadPool::TaskGroup::Wait() {
+    if (this->state == nullptr) return;
+    std::unique_lock<std::mutex> guard(this->state->lock);
+    this->state->finished.wait(guard, [this]() { return this->state->pending.load() == 0; });
+}
+
+
+/*
+ * WorkStealingThreadPool::TaskGroup::Done
+ */
+bool WorkStealingThreadPool::TaskGroup::Done() const {
+    return (this->state == nullptr) || (this->state->pending.load() == 0);
+}
+
+
+/*
+ * WorkStealingThreadPool::WorkStealingThreadPool
+ */
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->queues.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        this->queues.emplace_back(std::make_unique<Queue>());
+    }
+    this->workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        this->workers.emplace_back(&WorkStealingThreadPool::workerMain, this, static_cast<size_t>(i));
+    }
+}
+
+
+/*
+ * WorkStealingThreadPool::~WorkStealingThreadPool
+ */
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(this->sleepLock);
+        this->running.store(false);
+    }
+    this->wakeup.notify_all();
+    for (auto& w : this->workers) {
+        if (w.joinable()) w.join();
+    }
+}
+
+
+/*
+ * WorkStealingThreadPool::Submit
+ */
+void WorkStealingThreadPool::Submit(Task task) {
+    this->push([t = std::move(task)]() {
+        try {
+            t();
+        } catch (...) {
+            // a failing task must not take down the worker
+        }
+    });
+}
+
+
+/*
+ * WorkStealingThreadPool::SubmitGroup
+ */
+WorkStealingThreadPool::TaskGroup WorkStealingThreadPool::SubmitGroup(std::vector<Task> tasks) {
+    TaskGroup group;
+    group.state = std::make_shared<TaskGroup::State>();
+    group.state->pending.store(tasks.size());
+
+    for (auto& task : tasks) {
+        this->push([t = std::move(task), state = group.state]() {
+            try {
+                t();
+            } catch (...) {
+                // a failing task must not take down the worker
+            }
+            if (state->pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> guard(state->lock);
+                state->finished.notify_all();
+            }
+        });
+    }
+
+    return group;
+}
+
+
+/*
+ * WorkStealingThreadPool::push
+ */
+void WorkStealingThreadPool::push(Task task) {
+    size_t target = (currentPool == this) ? currentWorker
+                                          : (this->nextQueue.fetch_add(1) % this->queues.size());
+    // count first, so 'queued' never underflows when a worker pops the task right away
+    {
+        std::lock_guard<std::mutex> guard(this->sleepLock);
+        this->queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> guard(this->queues[target]->lock);
+        this->queues[target]->tasks.push_back(std::move(task));
+    }
+    this->wakeup.notify_one();
+}
+
+
+/*
+ * WorkStealingThreadPool::tryPop
+ */
+bool WorkStealingThreadPool::tryPop(size_t self, Task& task) {
+    // own queue: LIFO for locality
+    {
+        auto& q = *this->queues[self];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            this->queued.fetch_sub(1);
+            return true;
+        }
+    }
+    // steal: FIFO from the other queues
+    const size_t cnt = this->queues.size();
+    for (size_t i = 1; i < cnt; ++i) {
+        auto& q = *this->queues[(self + i) % cnt];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            this->queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*
+ * WorkStealingThreadPool::workerMain
+ */
+void WorkStealingThreadPool::workerMain(size_t self) {
+    currentPool = this;
+    currentWorker = self;
+
+    Task task;
+    while (true) {
+        if (this->tryPop(self, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(this->sleepLock);
+        this->wakeup.wait(guard, [this]() { return !this->running.load() || this->queued.load() > 0; });
+        if (!this->running.load() && this->queued.load() == 0) break;
+    }
+
+    currentPool = nullptr;
+}
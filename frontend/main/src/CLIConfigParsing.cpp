@@ -118,6 +118,10 @@ static std::string remote_rendernode_zmq_source_option = "rendernode-zmq-source"
 static std::string remote_headnode_broadcast_quit_option    = "headnode-broadcast-quit";
 static std::string remote_headnode_broadcast_project_option = "headnode-broadcast-project";
 static std::string remote_headnode_connect_at_start_option  = "headnode-connect-at-start";
+static std::string graph_threads_option  = "graph-threads";
+static std::string graph_prefetch_option = "graph-prefetch";
+static std::string profile_calls_option    = "profile-calls";
+static std::string profile_calls_gl_option = "profile-calls-gl";
 static std::string help_option          = "h,help";
 
 static void files_exist(std::vector<std::string> vec, std::string const& type) {
@@ -155,6 +159,34 @@ static void privacynote_handler(std::string const& option_name, cxxopts::ParseRe
     config.screenshot_show_privacy_note = parsed_options[option_name].as<bool>();
 };
 
+static void graph_threads_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
+{
+    config.graph_execution_threads = parsed_options[option_name].as<unsigned int>();
+};
+
+static void graph_prefetch_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
+{
+    auto s = parsed_options[option_name].as<std::string>();
+    if (s == "off") {
+        config.graph_prefetch = RuntimeConfig::GraphPrefetch::off;
+    } else if (s == "joined") {
+        config.graph_prefetch = RuntimeConfig::GraphPrefetch::joined;
+    } else {
+        exit("graph-prefetch option accepts: off, joined");
+    }
+};
+
+static void profile_calls_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
+{
+    config.profile_calls = parsed_options[option_name].as<bool>();
+};
+
+static void profile_calls_gl_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
+{
+    config.profile_calls_gl = parsed_options[option_name].as<bool>();
+    config.profile_calls = config.profile_calls || config.profile_calls_gl;
+};
+
 static void remote_head_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
 {
     config.remote_headnode = parsed_options[option_name].as<bool>();
@@ -446,6 +478,10 @@ std::vector<OptionsListEntry> cli_options_list =
         , {remote_headnode_broadcast_quit_option,   "Headnode broadcasts mmQuit to rendernodes on shutdown",                    cxxopts::value<bool>(), remote_head_broadcast_quit_handler}
         , {remote_headnode_broadcast_project_option,"Headnode broadcasts initial graph state after project loading at startup", cxxopts::value<bool>(), remote_head_broadcast_project_handler}
         , {remote_headnode_connect_at_start_option, "Headnode starts sender thread at startup",                                 cxxopts::value<bool>(), remote_head_connect_at_start_handler}
+        , {graph_threads_option, "Number of threads for prefetching data-only call subtrees, 0 => all cores",       cxxopts::value<unsigned int>(),             graph_threads_handler}
+        , {graph_prefetch_option,"Prefetch data-only call subtrees in parallel: off, joined",                       cxxopts::value<std::string>(),              graph_prefetch_handler}
+        , {profile_calls_option, "Record CPU time, data changes and sizes of every call in the graph",              cxxopts::value<bool>(),                     profile_calls_handler}
+        , {profile_calls_gl_option,"Additionally record GPU time of render calls via GL timer queries",             cxxopts::value<bool>(),                     profile_calls_gl_handler}
         , {help_option,          "Print help message",                                                              cxxopts::value<bool>(),                     empty_handler}
     };
 
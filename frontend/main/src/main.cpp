@@ -6,6 +6,7 @@
 
 #include "mmcore/CoreInstance.h"
 #include "mmcore/MegaMolGraph.h"
+#include "mmcore/profiler/CallProfiler.h"
 
 #include "RuntimeConfig.h"
 #include "GlobalValueStore.h"
@@ -177,12 +178,25 @@ int main(const int argc, const char** argv) {
     const megamol::core::factories::CallDescriptionManager& callProvider = core.GetCallDescriptionManager();
 
     megamol::core::MegaMolGraph graph(core, moduleProvider, callProvider);
+    switch (config.graph_prefetch) {
+    case RuntimeConfig::GraphPrefetch::joined:
+        graph.SetExecutionMode(megamol::core::MegaMolGraph::ExecutionMode::ParallelJoined, config.graph_execution_threads);
+        break;
+    default:
+        break;
+    }
 
     // Graph and Config are also a resources that may be accessed by services
     services.getProvidedResources().push_back({"MegaMolGraph", graph});
     services.getProvidedResources().push_back({"RuntimeConfig", config});
     services.getProvidedResources().push_back({"GlobalValueStore", global_value_store});
 
+    // per-call timings recorded in Call::operator(), read by GUI and Lua
+    auto& call_profiler = megamol::core::profiler::CallProfiler::Instance();
+    call_profiler.SetEnabled(config.profile_calls);
+    call_profiler.SetGLTimingEnabled(config.profile_calls_gl);
+    services.getProvidedResources().push_back({"CallProfiling", call_profiler.Resource()});
+
     // proof of concept: a resource that returns a list of names of available resources
     // used by Lua Wrapper and LuaAPI to return list of available resources via remoteconsole
     const std::function<std::vector<std::string>()> resource_lister = [&]() -> std::vector<std::string> {
@@ -195,6 +209,10 @@ int main(const int argc, const char** argv) {
     };
     services.getProvidedResources().push_back({"FrontendResourcesList", resource_lister});
 
+    const std::function<void(void*)> join_entry_point_data = [&](void* entry_point) {
+        graph.JoinDataSubtrees(entry_point);
+    };
+
     uint32_t frameID = 0;
     const auto render_next_frame = [&]() -> bool {
         // set global Frame Counter
@@ -216,13 +234,23 @@ int main(const int argc, const char** argv) {
         {
             services.preGraphRender(); // e.g. start frame timer, clear render buffers
 
-            imagepresentation_service.RenderNextFrame(); // executes graph views, those digest input events like keyboard/mouse, then render
+            // run independent data-only subtrees in parallel, each entry point waits for its own subtrees only,
+            // so the data of later entry points is computed while the earlier ones render
+            graph.PrefetchDataSubtrees();
+
+            imagepresentation_service.RenderNextFrame(join_entry_point_data); // executes graph views, those digest input events like keyboard/mouse, then render
+
+            // subtrees below no entry point must be done before services may change the graph
+            graph.JoinDataSubtrees();
 
             services.postGraphRender(); // render GUI, glfw swap buffers, stop frame timer
         }
 
         services.resetProvidedResources(); // clear buffers holding glfw keyboard+mouse input
 
+        // collect call timings of this frame from all threads
+        call_profiler.EndFrame(frameID);
+
         return true;
     };
 
@@ -281,6 +309,7 @@ int main(const int argc, const char** argv) {
         run_megamol = render_next_frame();
     }
 
+    graph.JoinDataSubtrees();
     graph.Clear();
 
     // close glfw context, network connections, other system resources
@@ -0,0 +1,60 @@
+/*
+ * CallProfiling.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace frontend_resources {
+
+// aggregated timings of one function of one call in the graph
+struct CallStatistics {
+    std::string caller;     // "module::slot" issuing the call
+    std::string callee;     // "module::slot" answering the call
+    std::string call_class; // e.g. "MultiParticleDataCall"
+    std::string function;   // e.g. "GetData"
+
+    uint64_t call_count = 0;
+    double total_cpu_ms = 0.0;
+    double last_cpu_ms = 0.0;
+    double max_cpu_ms = 0.0;
+    double last_gpu_ms = 0.0; // only for render calls with GL timers enabled
+
+    uint64_t data_hash_changes = 0;
+    uint64_t last_bytes_produced = 0;
+
+    uint64_t last_frame = 0; // frame in which the function was issued last
+};
+
+// per-call timing and memory instrumentation of the MegaMol graph
+// recording happens in Call::operator() into per-thread ring buffers,
+// all functions here are meant to be used from the main thread
+struct CallProfiling {
+    std::function<void(bool)> set_enabled;
+    std::function<bool()> is_enabled;
+
+    // GL timer queries for calls into renderers and views
+    std::function<void(bool)> set_gl_timers;
+
+    // drains the ring buffers and returns the aggregates, sorted by total CPU time
+    std::function<std::vector<CallStatistics>()> statistics;
+
+    std::function<void()> reset;
+
+    // aggregates as CSV table
+    std::function<bool(std::string const& /*filename*/)> export_csv;
+
+    // recent individual events in Chrome trace event format (chrome://tracing, Perfetto)
+    std::function<bool(std::string const& /*filename*/)> export_chrome_trace;
+};
+
+} /* end namespace frontend_resources */
+} /* end namespace megamol */
@@ -63,6 +63,17 @@ struct RuntimeConfig {
     float gui_scale = 1.0f;
     bool screenshot_show_privacy_note = true;
 
+    // data-only call subtrees of the graph may be prefetched on a thread pool, see MegaMolGraph::ExecutionMode
+    enum class GraphPrefetch {
+        off,    // everything runs serially in the render thread
+        joined, // prefetch right before rendering, join before GL submission
+    };
+    GraphPrefetch graph_prefetch = GraphPrefetch::off;
+    unsigned int graph_execution_threads = 0; // 0 => all cores
+
+    bool profile_calls = false;    // record per-call timings, see CallProfiling resource
+    bool profile_calls_gl = false; // additionally issue GL timer queries for render calls
+
     bool remote_headnode                        = false;
     bool remote_rendernode                      = false;
     bool remote_mpirendernode                   = false;
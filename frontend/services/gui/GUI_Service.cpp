@@ -13,6 +13,7 @@
 #include "ScriptPaths.h"
 #include "ProjectLoader.h"
 #include "FrameStatistics.h"
+#include "CallProfiling.h"
 #include "RuntimeConfig.h"
 #include "WindowManipulation.h"
 #include "mmcore/utility/log/Log.h"
@@ -54,7 +55,8 @@ bool GUI_Service::init(const Config& config) {
         "ProjectLoader",                         // 8 - trigger loading of new running project
         "FrameStatistics",                       // 9 - current fps and ms value
         "RuntimeConfig",                         // 10 - resource paths
-        "WindowManipulation"                     // 11 - GLFW window pointer
+        "WindowManipulation",                    // 11 - GLFW window pointer
+        "CallProfiling"                          // 12 - per-call timings
     };
 
     // init gui
@@ -238,6 +240,10 @@ void GUI_Service::digestChangedRequestedResources() {
     auto& frame_statistics =  this->m_requestedResourceReferences[9].getResource<megamol::frontend_resources::FrameStatistics>();
     gui->SetFrameStatistics(frame_statistics.last_averaged_fps, frame_statistics.last_averaged_mspf, frame_statistics.rendered_frames_count);
 
+    /// Get per-call timings = resource index 12
+    gui->SetCallProfiling(
+        &this->m_requestedResourceReferences[12].getResource<megamol::frontend_resources::CallProfiling>());
+
     /// Get window manipulation resource = resource index 11
     auto& window_manipulation = this->m_requestedResourceReferences[11].getResource<megamol::frontend_resources::WindowManipulation>();
     window_manipulation.set_mouse_cursor(gui->GetMouseCursor());
@@ -104,8 +104,10 @@ void ImagePresentation_Service::preGraphRender() {
 void ImagePresentation_Service::postGraphRender() {
 }
 
-void ImagePresentation_Service::RenderNextFrame() {
+void ImagePresentation_Service::RenderNextFrame(std::function<void(void*)> const& before_entry_point) {
     for (auto& entry : m_entry_points) {
+        if (before_entry_point)
+            before_entry_point(entry.modulePtr);
         entry.execute(entry.modulePtr, entry.entry_point_resources, entry.execution_result_image.get());
     }
 }
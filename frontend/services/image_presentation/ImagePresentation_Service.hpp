@@ -12,6 +12,7 @@
 #include "ImagePresentationEntryPoints.h"
 #include "ImageWrapper.h"
 
+#include <functional>
 #include <list>
 
 namespace megamol {
@@ -45,7 +46,9 @@ public:
     // the Image Presentation Service is special in that it manages the objects (Graph Entry Points, or possibly other objects)
     // that are triggered to render something into images.
     // The resulting images are then presented in some appropriate way: drawn into a window, written to disk, sent via network, ...
-    void RenderNextFrame();
+    // 'before_entry_point' is called with the module pointer of each entry point right before it renders,
+    // e.g. to wait for data the entry point needs that is computed on other threads
+    void RenderNextFrame(std::function<void(void*)> const& before_entry_point = nullptr);
     // int setPriority(const int p) // priority initially 0
     // int getPriority() const;
     //
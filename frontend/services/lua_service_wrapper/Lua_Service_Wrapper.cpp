@@ -14,6 +14,7 @@
 
 #include "Screenshots.h"
 #include "FrameStatistics.h"
+#include "CallProfiling.h"
 #include "WindowManipulation.h"
 #include "GUIState.h"
 #include "GlobalValueStore.h"
@@ -99,7 +100,8 @@ bool Lua_Service_Wrapper::init(const Config& config) {
         "GUIState", // propagate GUI state and visibility
         "MegaMolGraph", // LuaAPI manipulates graph
         "RenderNextFrame", // LuaAPI can render one frame
-        "GlobalValueStore" // LuaAPI can read and set global values
+        "GlobalValueStore", // LuaAPI can read and set global values
+        "CallProfiling" // per-call timings
     }; //= {"ZMQ_Context"};
 
     m_network_host_pimpl = std::unique_ptr<void, std::function<void(void*)>>(
@@ -399,6 +401,45 @@ void Lua_Service_Wrapper::fill_frontend_resources_callbacks(void* callbacks_coll
             return StringResult{""};
         }});
 
+    callbacks.add<VoidResult, bool>(
+        "mmSetCallProfiling",
+        "(bool state)\n\tEnable (true) or disable (false) recording of per-call timings.",
+        {[&](bool state) -> VoidResult
+        {
+            auto& profiling = m_requestedResourceReferences[8].getResource<megamol::frontend_resources::CallProfiling>();
+            profiling.set_enabled(state);
+            return VoidResult{};
+        }});
+
+    callbacks.add<StringResult>(
+        "mmGetCallProfiling",
+        "()\n\tReturns the aggregated per-call timings as CSV: caller;callee;call;function;count;total_ms;last_ms;max_ms;gpu_ms;hash_changes;bytes",
+        {[&]() -> StringResult
+        {
+            auto& profiling = m_requestedResourceReferences[8].getResource<megamol::frontend_resources::CallProfiling>();
+            std::ostringstream answer;
+            for (auto const& s : profiling.statistics()) {
+                answer << s.caller << ";" << s.callee << ";" << s.call_class << ";" << s.function << ";"
+                       << s.call_count << ";" << s.total_cpu_ms << ";" << s.last_cpu_ms << ";" << s.max_cpu_ms << ";"
+                       << s.last_gpu_ms << ";" << s.data_hash_changes << ";" << s.last_bytes_produced << std::endl;
+            }
+            return StringResult{answer.str()};
+        }});
+
+    callbacks.add<VoidResult, std::string>(
+        "mmExportCallProfiling",
+        "(string filename)\n\tWrite per-call timings to 'filename'. '.json' writes a Chrome trace of the recent calls, anything else a CSV table.",
+        {[&](std::string file) -> VoidResult
+        {
+            auto& profiling = m_requestedResourceReferences[8].getResource<megamol::frontend_resources::CallProfiling>();
+            const bool trace = file.size() >= 5 && file.compare(file.size() - 5, 5, ".json") == 0;
+            const bool ok = trace ? profiling.export_chrome_trace(file) : profiling.export_csv(file);
+            if (!ok) {
+                return Error{"could not write call profiling to " + file};
+            }
+            return VoidResult{};
+        }});
+
     // mmLoadProject ?
     // the ProjectLoader resource immediately executes the file contents as lua code
     // -> what happens if this is done inside a lua callback?
@@ -22,9 +22,9 @@ bool megamol::frontend::Remote_Service::HeadNode::send(megamol::remote::Message_
     // the Remote_Service fills the message data according to the used convention
     // we are only responsible to send the data here
 
+    // messages are framed, so append: commands must not be dropped if the comm thread lags behind
+    // periodic parameter updates are held back by the Remote_Service while has_pending_data(), which bounds the buffer
     std::lock_guard<std::mutex> guard(send_buffer_guard_);
-    send_buffer_.clear();
-    send_buffer_.reserve(data.size());
     send_buffer_.insert(send_buffer_.end(), data.begin(), data.end());
     send_buffer_has_changed_.store(true);
 
@@ -21,6 +21,11 @@ struct megamol::frontend::Remote_Service::HeadNode {
     // "Sends custom lua command to the RendernodeView"
     bool send(megamol::remote::Message_t const& data);
 
+    // whether data handed to send() has not been taken by the comm thread yet
+    bool has_pending_data() const {
+        return send_buffer_has_changed_.load();
+    }
+
     // "Start listening to port."
     // "Address of headnode in ZMQ syntax (e.g. \"tcp://127.0.0.1:33333\")"
     bool start_server(std::string const& send_to_address);
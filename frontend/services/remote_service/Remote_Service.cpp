@@ -13,6 +13,15 @@
 #include "MPI_Context.h"
 
 #include "mmcore/MegaMolGraph.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/ButtonParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/Vector3fParam.h"
+#include "mmcore/param/Vector4fParam.h"
+
+#include <cstring>
+#include <unordered_map>
 
 #include "GUIRegisterWindow.h" // register UI window for remote control
 #include "imgui_stdlib.h"
@@ -36,6 +45,97 @@ static void log_warning(std::string const& text) {
 }
 
 
+namespace {
+
+template<typename T>
+void put_value(megamol::remote::ParamValue& val, megamol::remote::ParamValueType type, T const* v, size_t count) {
+    val.type = type;
+    val.data.assign(reinterpret_cast<char const*>(v), sizeof(T) * count);
+}
+
+template<typename T>
+bool get_value(megamol::remote::ParamValue const& val, T* v, size_t count) {
+    if (val.data.size() != sizeof(T) * count)
+        return false;
+    std::memcpy(v, val.data.data(), val.data.size());
+    return true;
+}
+
+// binary encoding for the common numeric params, keeps floats exact and skips formatting and parsing
+void encode_param(megamol::core::param::AbstractParam& param, megamol::remote::ParamValue& val) {
+    using megamol::remote::ParamValueType;
+    if (auto* p = dynamic_cast<megamol::core::param::FloatParam*>(&param)) {
+        auto const v = p->Value();
+        put_value(val, ParamValueType::FLOAT, &v, 1);
+    } else if (auto* p = dynamic_cast<megamol::core::param::IntParam*>(&param)) {
+        auto const v = static_cast<int32_t>(p->Value());
+        put_value(val, ParamValueType::INT, &v, 1);
+    } else if (auto* p = dynamic_cast<megamol::core::param::BoolParam*>(&param)) {
+        auto const v = static_cast<uint8_t>(p->Value() ? 1 : 0);
+        put_value(val, ParamValueType::BOOL, &v, 1);
+    } else if (auto* p = dynamic_cast<megamol::core::param::Vector3fParam*>(&param)) {
+        put_value(val, ParamValueType::VEC3F, p->Value().PeekComponents(), 3);
+    } else if (auto* p = dynamic_cast<megamol::core::param::Vector4fParam*>(&param)) {
+        put_value(val, ParamValueType::VEC4F, p->Value().PeekComponents(), 4);
+    } else {
+        val.type = ParamValueType::STRING;
+        val.data = param.ValueString().PeekBuffer();
+    }
+}
+
+bool decode_param(megamol::remote::ParamValue const& val, megamol::core::param::AbstractParam& param) {
+    using megamol::remote::ParamValueType;
+    switch (val.type) {
+    case ParamValueType::FLOAT: {
+        auto* p = dynamic_cast<megamol::core::param::FloatParam*>(&param);
+        float v = 0.0f;
+        if (p == nullptr || !get_value(val, &v, 1))
+            return false;
+        p->SetValue(v);
+    } break;
+    case ParamValueType::INT: {
+        auto* p = dynamic_cast<megamol::core::param::IntParam*>(&param);
+        int32_t v = 0;
+        if (p == nullptr || !get_value(val, &v, 1))
+            return false;
+        p->SetValue(v);
+    } break;
+    case ParamValueType::BOOL: {
+        auto* p = dynamic_cast<megamol::core::param::BoolParam*>(&param);
+        uint8_t v = 0;
+        if (p == nullptr || !get_value(val, &v, 1))
+            return false;
+        p->SetValue(v != 0);
+    } break;
+    case ParamValueType::VEC3F: {
+        auto* p = dynamic_cast<megamol::core::param::Vector3fParam*>(&param);
+        float v[3];
+        if (p == nullptr || !get_value(val, v, 3))
+            return false;
+        p->SetValue(vislib::math::Vector<float, 3>(v));
+    } break;
+    case ParamValueType::VEC4F: {
+        auto* p = dynamic_cast<megamol::core::param::Vector4fParam*>(&param);
+        float v[4];
+        if (p == nullptr || !get_value(val, v, 4))
+            return false;
+        p->SetValue(vislib::math::Vector<float, 4>(v));
+    } break;
+    case ParamValueType::STRING:
+        return param.ParseValue(val.data.c_str());
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool same_value(megamol::remote::ParamValue const& lhs, megamol::remote::ParamValue const& rhs) {
+    return lhs.type == rhs.type && lhs.data == rhs.data;
+}
+
+} // namespace
+
+
 namespace megamol {
 namespace frontend {
 
@@ -86,6 +186,24 @@ struct Remote_Service::PimplData {
     MpiNode mpi;
     MPI_Context mpi_context;
     megamol::remote::Message_t message;
+
+    uint64_t message_id = 0;
+
+    // head node: last value sent per parameter, diffs are computed against it
+    std::unordered_map<std::string, megamol::remote::ParamValue> sent_param_values;
+    // head node: changes the comm thread has not taken yet, only the latest value per parameter is kept
+    std::unordered_map<std::string, megamol::remote::ParamValue> pending_param_values;
+    bool pending_param_keyframe = false;
+    bool force_param_keyframe = true;
+    uint64_t param_frame_id = 0;
+    unsigned int frames_since_keyframe = 0;
+
+    // render node: frame of the last applied diff, to detect gaps
+    uint64_t received_param_frame_id = 0;
+
+    megamol::remote::ParamDiff param_diff;
+    megamol::remote::Message_t param_diff_body;
+    megamol::remote::Message message_parsed;
 };
 #define m_head (m_pimpl->head)
 #define m_is_headnode_running (m_pimpl->is_headnode_running)
@@ -93,6 +211,7 @@ struct Remote_Service::PimplData {
 #define m_mpi (m_pimpl->mpi)
 #define m_mpi_context (m_pimpl->mpi_context)
 #define m_message (m_pimpl->message)
+#define m_message_id (m_pimpl->message_id)
 
 Remote_Service::Remote_Service() {
     // init members to default states
@@ -242,9 +361,15 @@ void Remote_Service::do_headnode_things() {
     switch (command) {
     case HeadNodeRemoteControl::Command::ClearGraph:
         head_send_message("mmClearGraph()");
+        m_pimpl->force_param_keyframe = true;
         break;
     case HeadNodeRemoteControl::Command::SendGraph:
         head_send_message(const_cast<megamol::core::MegaMolGraph&>(graph).Convenience().SerializeGraph());
+        m_pimpl->force_param_keyframe = true;
+        break;
+    case HeadNodeRemoteControl::Command::SetParamSendingModules:
+    case HeadNodeRemoteControl::Command::KeepSendingParams:
+        m_pimpl->force_param_keyframe = true;
         break;
     case HeadNodeRemoteControl::Command::SendLuaCommand:
         head_send_message(m_headnode_remote_control.lua_command);
@@ -269,7 +394,15 @@ void Remote_Service::do_headnode_things() {
         }
     };
 
-    if (m_headnode_remote_control.keep_sending_params) {
+    if (m_headnode_remote_control.keep_sending_params && m_headnode_remote_control.binary_param_sync) {
+        static std::vector<std::string> module_list;
+        module_list.clear();
+
+        if (m_headnode_remote_control.modules_to_send_params_of != "all")
+            split_module_names(m_headnode_remote_control.modules_to_send_params_of, module_list);
+
+        head_send_param_diff(module_list);
+    } else if (m_headnode_remote_control.keep_sending_params) {
         static std::string send_params;
         send_params.clear();
 
@@ -285,7 +418,9 @@ void Remote_Service::do_headnode_things() {
                 send_params += const_cast<megamol::core::MegaMolGraph&>(graph).Convenience().SerializeModuleParameters(module);
         }
 
-        head_send_message(send_params);
+        // every message carries the full state, so skip it while the previous one is still queued
+        if (!m_head.has_pending_data())
+            head_send_message(send_params);
     }
 }
 
@@ -369,6 +504,9 @@ void Remote_Service::remote_control_window() {
         if (ImGui::InputText("Sync Modules", &param_send_modules, ImGuiInputTextFlags_EnterReturnsTrue)) {
             add_headnode_remote_command(HeadNodeRemoteControl::Command::SetParamSendingModules, param_send_modules);
         }
+        if (ImGui::Checkbox("Binary Param Diffs", &m_headnode_remote_control.binary_param_sync)) {
+            m_pimpl->force_param_keyframe = true;
+        }
 
         if (ImGui::Button("Send Lua Command")) {
             add_headnode_remote_command(HeadNodeRemoteControl::Command::SendLuaCommand, lua_command);
@@ -424,8 +562,79 @@ void Remote_Service::do_mpi_things() {
 }
 
 void Remote_Service::head_send_message(std::string const& string) {
-    m_message.resize(string.size());
-    std::memcpy(m_message.data(), string.data(), string.size());
+    m_message.clear();
+    megamol::remote::append_msg(
+        m_message, megamol::remote::MessageType::PARAM_UPD_MSG, ++m_message_id, string.data(), string.size());
+    m_head.send(m_message);
+}
+
+void Remote_Service::head_send_param_diff(std::vector<std::string> const& modules) {
+    auto& graph = m_requestedResourceReferences[0].getResource<megamol::core::MegaMolGraph>();
+    auto& sent = m_pimpl->sent_param_values;
+    auto& pending = m_pimpl->pending_param_values;
+    auto& diff = m_pimpl->param_diff;
+
+    // ZMQ push/pull gives us no acknowledgement channel, so render nodes that connect late
+    // or restart catch up with the next keyframe carrying all values
+    const bool keyframe = m_pimpl->force_param_keyframe ||
+                          ++m_pimpl->frames_since_keyframe >= m_headnode_remote_control.param_keyframe_interval;
+    if (keyframe) {
+        sent.clear();
+        pending.clear();
+        m_pimpl->pending_param_keyframe = true;
+        m_pimpl->frames_since_keyframe = 0;
+        m_pimpl->force_param_keyframe = false;
+    }
+
+    static megamol::remote::ParamValue value;
+    auto collect = [&](std::vector<megamol::core::param::ParamSlot*> const& slots) {
+        for (auto* slot : slots) {
+            // same as Lua serialization: setting button params is illegal
+            if (slot->Param<megamol::core::param::ButtonParam>() != nullptr)
+                continue;
+
+            value.name = std::string{slot->FullName().PeekBuffer()};
+            value.name = "::" + value.name.substr(value.name.find_first_not_of(':'));
+            encode_param(*slot->Parameter(), value);
+
+            auto it = sent.find(value.name);
+            if (it != sent.end() && same_value(it->second, value))
+                continue;
+
+            sent[value.name] = value;
+            pending[value.name] = value;
+        }
+    };
+
+    if (modules.empty()) {
+        collect(graph.ListParameterSlots());
+    } else {
+        for (auto const& module : modules)
+            collect(graph.EnumerateModuleParameterSlots(module));
+    }
+
+    // while the comm thread lags behind, changes are merged into the pending values instead of queueing
+    // one diff per frame, so the send buffer holds at most one value per parameter
+    if (m_head.has_pending_data())
+        return;
+
+    // camera state is exposed as view parameters (cam::*), so camera updates travel in the same diff
+    if (pending.empty() && !m_pimpl->pending_param_keyframe)
+        return;
+
+    diff.frame_id = ++m_pimpl->param_frame_id;
+    diff.keyframe = m_pimpl->pending_param_keyframe;
+    diff.values.clear();
+    diff.values.reserve(pending.size());
+    for (auto& val : pending)
+        diff.values.push_back(std::move(val.second));
+    pending.clear();
+    m_pimpl->pending_param_keyframe = false;
+
+    megamol::remote::serialize_param_diff(diff, m_pimpl->param_diff_body);
+    m_message.clear();
+    megamol::remote::append_msg(m_message, megamol::remote::MessageType::PARAM_DIFF_MSG, ++m_message_id,
+        m_pimpl->param_diff_body.data(), m_pimpl->param_diff_body.size());
     m_head.send(m_message);
 }
 
@@ -433,10 +642,40 @@ void Remote_Service::execute_message(std::vector<char> const& message) {
     if (message.empty())
         return;
 
+    // the render node concatenates everything received since the last frame
+    size_t offset = 0;
+    auto& msg = m_pimpl->message_parsed;
+    while (megamol::remote::next_msg(message, offset, msg)) {
+        switch (msg.type) {
+        case megamol::remote::MessageType::PRJ_FILE_MSG:
+        case megamol::remote::MessageType::PARAM_UPD_MSG:
+            execute_lua(msg.msg_body);
+            break;
+        case megamol::remote::MessageType::PARAM_DIFF_MSG:
+            apply_param_diff(msg.msg_body);
+            break;
+        case megamol::remote::MessageType::NULL_MSG:
+        case megamol::remote::MessageType::HEAD_DISC_MSG:
+            break;
+        default:
+            log_warning("unknown message type " + std::to_string(static_cast<unsigned int>(msg.type)));
+            break;
+        }
+    }
+
+    if (offset != message.size()) {
+        log_error("received truncated message, dropped " + std::to_string(message.size() - offset) + " bytes");
+    }
+}
+
+void Remote_Service::execute_lua(std::vector<char> const& lua) {
+    if (lua.empty())
+        return;
+
     static std::string commands_string;
-    commands_string.resize(message.size());
-    std::memcpy(commands_string.data(), message.data(), message.size());
-    
+    commands_string.resize(lua.size());
+    std::memcpy(commands_string.data(), lua.data(), lua.size());
+
     auto& executeLua = m_requestedResourceReferences[1].getResource<std::function<std::tuple<bool,std::string>(std::string const&)>>();
     auto result = executeLua(commands_string);
 
@@ -445,6 +684,35 @@ void Remote_Service::execute_message(std::vector<char> const& message) {
     }
 }
 
+void Remote_Service::apply_param_diff(std::vector<char> const& body) {
+    auto& diff = m_pimpl->param_diff;
+    if (!megamol::remote::deserialize_param_diff(body, diff)) {
+        log_error("could not decode parameter diff");
+        return;
+    }
+
+    auto& last_frame = m_pimpl->received_param_frame_id;
+    if (!diff.keyframe && last_frame != 0 && diff.frame_id != last_frame + 1) {
+        log_warning("missed parameter diffs between frame " + std::to_string(last_frame) + " and " +
+                    std::to_string(diff.frame_id) + ", values may be stale until the next keyframe");
+    }
+    last_frame = diff.frame_id;
+
+    // apply directly to the param slots, no Lua involved
+    auto& graph = m_requestedResourceReferences[0].getResource<megamol::core::MegaMolGraph>();
+    for (auto const& value : diff.values) {
+        auto* param = graph.FindParameter(value.name);
+        if (param == nullptr) {
+            // modules might not be created yet, the next keyframe will catch up
+            continue;
+        }
+        if (!decode_param(value, *param)) {
+            log_error("parameter could not be set from value of type " +
+                      std::to_string(static_cast<unsigned int>(value.type)) + ": " + value.name);
+        }
+    }
+}
+
 
 
 // ===================================================================================================
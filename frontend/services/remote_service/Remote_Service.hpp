@@ -91,7 +91,10 @@ private:
     void do_mpi_things();
 
     void head_send_message(std::string const& string);
+    void head_send_param_diff(std::vector<std::string> const& modules);
     void execute_message(std::vector<char> const& message);
+    void execute_lua(std::vector<char> const& lua);
+    void apply_param_diff(std::vector<char> const& body);
 
     struct PimplData;
     std::unique_ptr<PimplData, std::function<void(PimplData*)>> m_pimpl;
@@ -112,6 +115,8 @@ private:
             , Count // not a commnd, gives number of enum entries
         };
         bool keep_sending_params = false;
+        bool binary_param_sync = false; // send changed values as binary diffs instead of Lua commands
+        unsigned int param_keyframe_interval = 300; // frames between full param states for late render nodes
         std::string modules_to_send_params_of = "all";
         std::string lua_command = "";
 
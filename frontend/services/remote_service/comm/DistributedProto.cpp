@@ -0,0 +1,95 @@
+#include "DistributedProto.h"
+
+#include <cstring>
+
+
+namespace {
+
+template<typename T>
+void put(megamol::remote::Message_t& buf, T const& val) {
+    auto const ptr = reinterpret_cast<char const*>(&val);
+    buf.insert(buf.end(), ptr, ptr + sizeof(T));
+}
+
+void put_string(megamol::remote::Message_t& buf, std::string const& str) {
+    put(buf, static_cast<uint32_t>(str.size()));
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+template<typename T>
+bool get(megamol::remote::Message_t const& buf, size_t& offset, T& val) {
+    if (buf.size() - offset < sizeof(T))
+        return false;
+    std::memcpy(&val, buf.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool get_string(megamol::remote::Message_t const& buf, size_t& offset, std::string& str) {
+    uint32_t len = 0;
+    if (!get(buf, offset, len) || buf.size() - offset < len)
+        return false;
+    str.assign(buf.data() + offset, len);
+    offset += len;
+    return true;
+}
+
+} // namespace
+
+
+void megamol::remote::append_msg(
+    Message_t& buffer, MessageType type, uint64_t id, char const* body, size_t body_size) {
+    buffer.reserve(buffer.size() + MessageHeaderSize + body_size);
+    put(buffer, type);
+    put(buffer, static_cast<uint64_t>(body_size));
+    put(buffer, id);
+    buffer.insert(buffer.end(), body, body + body_size);
+}
+
+
+bool megamol::remote::next_msg(Message_t const& buffer, size_t& offset, Message& msg) {
+    if (offset >= buffer.size() || buffer.size() - offset < MessageHeaderSize)
+        return false;
+
+    size_t pos = offset;
+    get(buffer, pos, msg.type);
+    get(buffer, pos, msg.size);
+    get(buffer, pos, msg.id);
+    if (buffer.size() - pos < msg.size)
+        return false;
+
+    msg.msg_body.assign(buffer.begin() + pos, buffer.begin() + pos + msg.size);
+    offset = pos + msg.size;
+    return true;
+}
+
+
+void megamol::remote::serialize_param_diff(ParamDiff const& diff, Message_t& body) {
+    body.clear();
+    put(body, diff.frame_id);
+    put(body, static_cast<uint8_t>(diff.keyframe ? 1 : 0));
+    put(body, static_cast<uint32_t>(diff.values.size()));
+    for (auto const& val : diff.values) {
+        put_string(body, val.name);
+        put(body, val.type);
+        put_string(body, val.data);
+    }
+}
+
+
+bool megamol::remote::deserialize_param_diff(Message_t const& body, ParamDiff& diff) {
+    size_t offset = 0;
+    uint8_t keyframe = 0;
+    uint32_t count = 0;
+    if (!get(body, offset, diff.frame_id) || !get(body, offset, keyframe) || !get(body, offset, count))
+        return false;
+
+    diff.keyframe = keyframe != 0;
+    diff.values.resize(count);
+    for (auto& val : diff.values) {
+        if (!get_string(body, offset, val.name) || !get(body, offset, val.type) ||
+            !get_string(body, offset, val.data))
+            return false;
+    }
+    return true;
+}
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace megamol {
 namespace remote {
-enum class MessageType : unsigned char { NULL_MSG = 0u, PRJ_FILE_MSG, CAM_UPD_MSG, PARAM_UPD_MSG, HEAD_DISC_MSG };
+enum class MessageType : unsigned char {
+    NULL_MSG = 0u,
+    PRJ_FILE_MSG,
+    CAM_UPD_MSG,
+    PARAM_UPD_MSG,
+    HEAD_DISC_MSG,
+    PARAM_DIFF_MSG // binary parameter values, see ParamDiff
+};
 
 using Message_t = std::vector<char>;
 
@@ -20,6 +29,43 @@ constexpr size_t MessageSizeSize = sizeof(uint64_t);
 constexpr size_t MessageIDSize = sizeof(uint64_t);
 constexpr size_t MessageHeaderSize = MessageIDSize + MessageTypeSize + MessageSizeSize;
 
+// encoding of a parameter value in a ParamDiff
+enum class ParamValueType : unsigned char {
+    STRING = 0u, // value string, for all params without a binary encoding
+    FLOAT,       // float
+    INT,         // int32
+    BOOL,        // uint8
+    VEC3F,       // 3 * float
+    VEC4F        // 4 * float
+};
+
+struct ParamValue {
+    std::string name; // full parameter name
+    ParamValueType type = ParamValueType::STRING;
+    std::string data; // raw bytes of the value as given by 'type'
+};
+
+// parameter values that changed on the head node since the previous diff
+// a keyframe carries all synchronized parameters, e.g. for render nodes that (re)connected late
+struct ParamDiff {
+    uint64_t frame_id = 0;
+    bool keyframe = false;
+    std::vector<ParamValue> values;
+};
+
+// appends one message (header + body) to 'buffer', several messages may be concatenated
+void append_msg(Message_t& buffer, MessageType type, uint64_t id, char const* body, size_t body_size);
+
+// reads the message starting at 'offset' and advances 'offset' behind it
+// returns false at the end of the buffer or if the remaining data is truncated
+bool next_msg(Message_t const& buffer, size_t& offset, Message& msg);
+
+// body layout (little endian, as all peers run the same build):
+// uint64 frame id | uint8 keyframe | uint32 count | count * (uint32 len, name, uint8 type, uint32 len, data)
+void serialize_param_diff(ParamDiff const& diff, Message_t& body);
+
+bool deserialize_param_diff(Message_t const& body, ParamDiff& diff);
+
 //Message_t prepare_null_msg() {
 //    Message_t msg(MessageHeaderSize);
 //    auto const type = MessageType::NULL_MSG;
@@ -8,7 +8,12 @@
 #include "stdafx.h"
 #include "Contest2019DataLoader.h"
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
 #include "astro/AstroDataCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
@@ -21,6 +26,36 @@ using namespace megamol::astro;
 
 #define MAX_MISSED_FILE_NUMBER 5
 
+namespace {
+/** Identification of the column cache files */
+const char columnCacheMagic[8] = {'M', 'M', 'A', 'S', 'T', 'C', 'O', 'L'};
+
+/** Version of the column cache format, increase on every change of the column layout */
+constexpr uint32_t columnCacheVersion = 1;
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 columns are stored as packed floats");
+
+/** Packs 'flags' into 64 bit words, bit i % 64 of word i / 64 holding flag i */
+void packFlags(const std::vector<bool>& flags, std::vector<uint64_t>& words) {
+    words.assign((flags.size() + 63) / 64, 0);
+    for (size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i]) words[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+/** Inverse of packFlags */
+void unpackFlags(const std::vector<uint64_t>& words, std::vector<bool>& flags) {
+    for (size_t w = 0; w < words.size(); ++w) {
+        size_t const first = w * 64;
+        size_t const last = std::min(first + 64, flags.size());
+        uint64_t const bits = words[w];
+        for (size_t i = first; i < last; ++i) {
+            flags[i] = ((bits >> (i - first)) & 0x1) != 0;
+        }
+    }
+}
+} // namespace
+
 /*
  * Contest2019DataLoader::Frame::Frame
  */
@@ -38,11 +73,36 @@ Contest2019DataLoader::Frame::~Frame(void) {
 /*
  * Contest2019DataLoader::Frame::LoadFrame
  */
-bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int frameIdx, float redshift) {
+bool Contest2019DataLoader::Frame::LoadFrame(
+    std::string filepath, unsigned int frameIdx, float redshift, bool useColumnCache) {
     if (filepath.empty()) return false;
     this->frame = frameIdx;
     std::vector<SavedData> readDataVec;
 
+    // the cache is valid as long as the snapshot keeps its size and modification time
+    std::string const cachePath = filepath + ".mmcol";
+    ColumnCacheHeader cacheHeader;
+    if (useColumnCache) {
+        std::error_code ec;
+        auto const sourceSize = std::filesystem::file_size(filepath, ec);
+        auto const sourceTime = std::filesystem::last_write_time(filepath, ec);
+        useColumnCache = !ec;
+        if (useColumnCache) {
+            std::memset(&cacheHeader, 0, sizeof(ColumnCacheHeader));
+            std::memcpy(cacheHeader.magic, columnCacheMagic, sizeof(cacheHeader.magic));
+            cacheHeader.version = columnCacheVersion;
+            cacheHeader.headerSize = sizeof(ColumnCacheHeader);
+            cacheHeader.particleCount = sourceSize / sizeof(SavedData);
+            cacheHeader.sourceSize = sourceSize;
+            cacheHeader.sourceTime = static_cast<int64_t>(sourceTime.time_since_epoch().count());
+            cacheHeader.redshift = redshift;
+            if (this->readColumnCache(cachePath, cacheHeader)) {
+                this->redshift = redshift;
+                return true;
+            }
+        }
+    }
+
     std::ifstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("Could not open input file \"%s\"", filepath.c_str());
@@ -58,6 +118,63 @@ bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int
     file.seekg(0, std::ios_base::beg);
     file.read(reinterpret_cast<char*>(readDataVec.data()), sizeof(SavedData) * partCount);
 
+    this->allocateArrays(partCount);
+
+    // copy the data over
+
+    this->redshift = redshift;
+    for (uint64_t i = 0; i < partCount; ++i) {
+        const auto& s = readDataVec[i];
+        this->positions->operator[](i) = glm::vec3(s.x, s.y, s.z);
+        this->velocities->operator[](i) = glm::vec3(s.vx, s.vy, s.vz);
+        this->temperatures->operator[](i) = 0.0f; // oops, we do not have temperatures
+        this->masses->operator[](i) = s.mass;
+        this->internalEnergies->operator[](i) = s.internalEnergy;
+        this->smoothingLengths->operator[](i) = s.smoothingLength;
+        this->molecularWeights->operator[](i) = s.molecularWeight;
+        this->densities->operator[](i) = s.density;
+        this->gravitationalPotentials->operator[](i) = s.gravitationalPotential;
+        this->entropy->operator[](i) = 0.0f; // we calculate it later
+        this->isBaryonFlags->operator[](i) = (s.bitmask >> 1) & 0x1;
+        this->isStarFlags->operator[](i) = (s.bitmask >> 5) & 0x1;
+        this->isWindFlags->operator[](i) = (s.bitmask >> 6) & 0x1;
+        this->isStarFormingGasFlags->operator[](i) = (s.bitmask >> 7) & 0x1;
+        this->isAGNFlags->operator[](i) = (s.bitmask >> 8) & 0x1;
+        this->particleIDs->operator[](i) = s.particleID;
+
+        // calculate the temperature ourselves
+        // formula out of the mail of J.D Emberson 20.6.2019
+        if (this->isBaryonFlags->at(i)) {
+            this->temperatures->operator[](i) =
+                4.8e5f * this->internalEnergies->at(i) / std::pow(1.0f + redshift, 3.0f);
+        }
+
+        // calculate the entropy ourselves
+        // formula directly from the contest description
+        if (this->isBaryonFlags->at(i) && this->temperatures->at(i) > 0.0f && this->densities->at(i) > 0.0f) {
+            auto t = (*this->temperatures)[i];
+            auto p = (*this->densities)[i];
+            this->entropy->operator[](i) = std::log(t / std::pow(p, 2.0f / 3.0f));
+
+            // This is Juhans formula:
+            // auto mu = (*this->masses)[i];
+            // auto eps = (*this->internalEnergies)[i];
+            //(*this->entropy)[i] = std::log((mu * eps) / std::pow(p, 2.0f / 3.0f));
+        }
+
+        // the derivatives will be calculated later, when the frame before and after are known
+    }
+
+    if (useColumnCache) {
+        this->writeColumnCache(cachePath, cacheHeader);
+    }
+    return true;
+}
+
+/*
+ * Contest2019DataLoader::Frame::allocateArrays
+ */
+void Contest2019DataLoader::Frame::allocateArrays(uint64_t partCount) {
     // init the fields if necessary
     if (this->positions == nullptr) {
         this->positions = std::make_shared<std::vector<glm::vec3>>();
@@ -161,52 +278,109 @@ bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int
     this->densityDerivatives->resize(partCount);
     this->gravitationalPotentialDerivatives->resize(partCount);
     this->entropyDerivatives->resize(partCount);
+}
 
-    // copy the data over
+/*
+ * Contest2019DataLoader::Frame::readColumnCache
+ */
+bool Contest2019DataLoader::Frame::readColumnCache(const std::string& cachePath, const ColumnCacheHeader& expected) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) return false;
+    ColumnCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(ColumnCacheHeader)) ||
+        std::memcmp(&header, &expected, sizeof(ColumnCacheHeader)) != 0) {
+        return false;
+    }
 
-    this->redshift = redshift;
-    for (uint64_t i = 0; i < partCount; ++i) {
-        const auto& s = readDataVec[i];
-        this->positions->operator[](i) = glm::vec3(s.x, s.y, s.z);
-        this->velocities->operator[](i) = glm::vec3(s.vx, s.vy, s.vz);
-        this->temperatures->operator[](i) = 0.0f; // oops, we do not have temperatures
-        this->masses->operator[](i) = s.mass;
-        this->internalEnergies->operator[](i) = s.internalEnergy;
-        this->smoothingLengths->operator[](i) = s.smoothingLength;
-        this->molecularWeights->operator[](i) = s.molecularWeight;
-        this->densities->operator[](i) = s.density;
-        this->gravitationalPotentials->operator[](i) = s.gravitationalPotential;
-        this->entropy->operator[](i) = 0.0f; // we calculate it later
-        this->isBaryonFlags->operator[](i) = (s.bitmask >> 1) & 0x1;
-        this->isStarFlags->operator[](i) = (s.bitmask >> 5) & 0x1;
-        this->isWindFlags->operator[](i) = (s.bitmask >> 6) & 0x1;
-        this->isStarFormingGasFlags->operator[](i) = (s.bitmask >> 7) & 0x1;
-        this->isAGNFlags->operator[](i) = (s.bitmask >> 8) & 0x1;
-        this->particleIDs->operator[](i) = s.particleID;
+    uint64_t const partCount = header.particleCount;
+    this->allocateArrays(partCount);
+
+    uint64_t offset = sizeof(ColumnCacheHeader);
+    auto readColumn = [&file, &offset](void* data, uint64_t bytes) {
+        offset = (offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+        file.seekg(offset, std::ios_base::beg);
+        file.read(static_cast<char*>(data), bytes);
+        offset += bytes;
+        return file.good();
+    };
+    bool ok = readColumn(this->positions->data(), partCount * sizeof(glm::vec3)) &&
+              readColumn(this->velocities->data(), partCount * sizeof(glm::vec3)) &&
+              readColumn(this->masses->data(), partCount * sizeof(float)) &&
+              readColumn(this->internalEnergies->data(), partCount * sizeof(float)) &&
+              readColumn(this->smoothingLengths->data(), partCount * sizeof(float)) &&
+              readColumn(this->molecularWeights->data(), partCount * sizeof(float)) &&
+              readColumn(this->densities->data(), partCount * sizeof(float)) &&
+              readColumn(this->gravitationalPotentials->data(), partCount * sizeof(float)) &&
+              readColumn(this->temperatures->data(), partCount * sizeof(float)) &&
+              readColumn(this->entropy->data(), partCount * sizeof(float)) &&
+              readColumn(this->particleIDs->data(), partCount * sizeof(int64_t));
+    std::vector<uint64_t> words((partCount + 63) / 64);
+    for (auto flags : {this->isBaryonFlags, this->isStarFlags, this->isWindFlags, this->isStarFormingGasFlags,
+             this->isAGNFlags}) {
+        ok = ok && readColumn(words.data(), words.size() * sizeof(uint64_t));
+        if (ok) unpackFlags(words, *flags);
+    }
+    if (!ok) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Column cache \"%s\" is truncated, reading the snapshot instead", cachePath.c_str());
+    }
+    return ok;
+}
 
-        // calculate the temperature ourselves
-        // formula out of the mail of J.D Emberson 20.6.2019
-        if (this->isBaryonFlags->at(i)) {
-            this->temperatures->operator[](i) =
-                4.8e5f * this->internalEnergies->at(i) / std::pow(1.0f + redshift, 3.0f);
+/*
+ * Contest2019DataLoader::Frame::writeColumnCache
+ */
+void Contest2019DataLoader::Frame::writeColumnCache(
+    const std::string& cachePath, const ColumnCacheHeader& header) const {
+    // write to a temporary file first, so that concurrent loaders never see a partial cache
+    std::string const tmpPath =
+        cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return;
+
+        uint64_t const partCount = this->positions->size();
+        uint64_t offset = 0;
+        auto writeColumn = [&file, &offset](const void* data, uint64_t bytes) {
+            static const char padding[ColumnAlignment] = {};
+            uint64_t const start = (offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+            file.write(padding, start - offset);
+            file.write(static_cast<const char*>(data), bytes);
+            offset = start + bytes;
+        };
+        writeColumn(&header, sizeof(ColumnCacheHeader));
+        writeColumn(this->positions->data(), partCount * sizeof(glm::vec3));
+        writeColumn(this->velocities->data(), partCount * sizeof(glm::vec3));
+        writeColumn(this->masses->data(), partCount * sizeof(float));
+        writeColumn(this->internalEnergies->data(), partCount * sizeof(float));
+        writeColumn(this->smoothingLengths->data(), partCount * sizeof(float));
+        writeColumn(this->molecularWeights->data(), partCount * sizeof(float));
+        writeColumn(this->densities->data(), partCount * sizeof(float));
+        writeColumn(this->gravitationalPotentials->data(), partCount * sizeof(float));
+        writeColumn(this->temperatures->data(), partCount * sizeof(float));
+        writeColumn(this->entropy->data(), partCount * sizeof(float));
+        writeColumn(this->particleIDs->data(), partCount * sizeof(int64_t));
+        std::vector<uint64_t> words;
+        for (auto flags : {this->isBaryonFlags, this->isStarFlags, this->isWindFlags, this->isStarFormingGasFlags,
+                 this->isAGNFlags}) {
+            packFlags(*flags, words);
+            writeColumn(words.data(), words.size() * sizeof(uint64_t));
         }
-
-        // calculate the entropy ourselves
-        // formula directly from the contest description
-        if (this->isBaryonFlags->at(i) && this->temperatures->at(i) > 0.0f && this->densities->at(i) > 0.0f) {
-            auto t = (*this->temperatures)[i];
-            auto p = (*this->densities)[i];
-            this->entropy->operator[](i) = std::log(t / std::pow(p, 2.0f / 3.0f));
-
-            // This is Juhans formula:
-            // auto mu = (*this->masses)[i];
-            // auto eps = (*this->internalEnergies)[i];
-            //(*this->entropy)[i] = std::log((mu * eps) / std::pow(p, 2.0f / 3.0f));
+        if (header.particleCount != partCount || !file.good()) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return;
         }
+    }
 
-        // the derivatives will be calculated later, when the frame before and after are known
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Could not write column cache \"%s\"", cachePath.c_str());
     }
-    return true;
 }
 
 /*
@@ -503,7 +677,10 @@ Contest2019DataLoader::Contest2019DataLoader(void)
           "already existing frames are not re-evaluated.")
     , calculateAGNDistances("calculateAGNDistances",
           "Enables the calculation of the distance to the AGNs. This option increases the frame loading time "
-          "significantly. The effect of this slot might be delayed as already existing frames are not re-evaluated.") {
+          "significantly. The effect of this slot might be delayed as already existing frames are not re-evaluated.")
+    , useColumnCache("useColumnCache",
+          "Stores every loaded snapshot as binary columns in a '.mmcol' file next to it and reads these files instead "
+          "of the snapshots as long as the snapshots are unchanged.") {
 
     this->getDataSlot.SetCallback(AstroDataCall::ClassName(),
         AstroDataCall::FunctionName(AstroDataCall::CallForGetData), &Contest2019DataLoader::getDataCallback);
@@ -525,6 +702,9 @@ Contest2019DataLoader::Contest2019DataLoader(void)
     this->calculateAGNDistances.SetParameter(new param::BoolParam(true));
     this->MakeSlotAvailable(&this->calculateAGNDistances);
 
+    this->useColumnCache.SetParameter(new param::BoolParam(false));
+    this->MakeSlotAvailable(&this->useColumnCache);
+
     // static bounding box size, because we know (TM)
     this->boundingBox = vislib::math::Cuboid<float>(0.0f, 0.0f, 0.0f, 64.0f, 64.0f, 64.0f);
     this->clipBox = this->boundingBox;
@@ -585,19 +765,20 @@ void Contest2019DataLoader::loadFrame(view::AnimDataModule::Frame* frame, unsign
         filenameAfter = this->filenames.at(frameIDAfter);
         redshiftAfter = this->redshiftsForFilename.at(frameIDAfter);
     }
+    bool useCache = this->useColumnCache.Param<param::BoolParam>()->Value();
     if (!filename.empty()) {
-        if (!f->LoadFrame(filename, frameID, redshift)) {
+        if (!f->LoadFrame(filename, frameID, redshift, useCache)) {
             Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame %d from file\n", idx);
         }
     }
     bool calcDerivatives = this->calculateDerivatives.Param<param::BoolParam>()->Value();
     if (!filenameBefore.empty() && calcDerivatives) {
-        if (!fbefore->LoadFrame(filenameBefore, frameIDBefore, redshiftBefore)) {
+        if (!fbefore->LoadFrame(filenameBefore, frameIDBefore, redshiftBefore, useCache)) {
             Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame before frame %d from file\n", idx);
         }
     }
     if (!filenameAfter.empty() && calcDerivatives) {
-        if (!fafter->LoadFrame(filenameAfter, frameIDAfter, redshiftAfter)) {
+        if (!fafter->LoadFrame(filenameAfter, frameIDAfter, redshiftAfter, useCache)) {
             Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame after frame %d from file\n", idx);
         }
     }
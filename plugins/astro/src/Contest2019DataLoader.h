@@ -137,10 +137,12 @@ protected:
          * necessary.
          * @param frameIdx The zero-based index of the loaded frame.
          * @param redshift The redshift value for the frame
+         * @param useColumnCache If true, the columns are read from the cache file next to 'filepath' if it is up to
+         * date and the cache file is (re-)written otherwise.
          *
          * @return True on success, false otherwise.
          */
-        bool LoadFrame(std::string filepath, unsigned int frameIdx, float redshift = 0.0f);
+        bool LoadFrame(std::string filepath, unsigned int frameIdx, float redshift = 0.0f, bool useColumnCache = false);
 
         /**
          * Sets the data pointers of a given call to the internally stored values
@@ -190,8 +192,43 @@ protected:
             int64_t particleID;
             uint16_t bitmask;
         };
+
+        /**
+         * Header of the column cache file.
+         *
+         * The header is followed by the columns positions, velocities (both xyz), masses, internal energies,
+         * smoothing lengths, molecular weights, densities, gravitational potentials, temperatures, entropy, particle
+         * IDs and the baryon, star, wind, star forming gas and AGN flags. The flags are stored as bitsets of 64 bit
+         * words, every column starts at a multiple of ColumnAlignment bytes.
+         */
+        struct ColumnCacheHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerSize;
+            uint64_t particleCount;
+            uint64_t sourceSize;
+            int64_t sourceTime;
+            float redshift;
+            uint32_t reserved;
+        };
 #pragma pack(pop)
 
+        /** Alignment of the columns in the cache file */
+        static constexpr uint64_t ColumnAlignment = 64;
+
+        /** Resizes all arrays to 'partCount' elements, allocating them if necessary */
+        void allocateArrays(uint64_t partCount);
+
+        /**
+         * Reads the frame from a column cache file.
+         *
+         * @return false if the file does not exist or does not match 'expected'.
+         */
+        bool readColumnCache(const std::string& cachePath, const ColumnCacheHeader& expected);
+
+        /** Writes the frame to a column cache file, failing silently */
+        void writeColumnCache(const std::string& cachePath, const ColumnCacheHeader& header) const;
+
         void buildParticleIDMap(const Frame* frame, std::map<int64_t, int64_t>& outIndexMap);
 
         /** Pointer to the position array */
@@ -338,6 +375,9 @@ protected:
     /** Slot determining whether the distances to the AGNs should be calculated */
     core::param::ParamSlot calculateAGNDistances;
 
+    /** Slot determining whether the snapshots are cached as binary columns */
+    core::param::ParamSlot useColumnCache;
+
     /** Slot to send the data over */
     core::CalleeSlot getDataSlot;
 
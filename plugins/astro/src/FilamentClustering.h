@@ -0,0 +1,181 @@
+/*
+ * FilamentClustering.h
+ *
+ * Copyright (C) 2019 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+#pragma once
+
+#include <nanoflann.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "omp.h"
+
+namespace megamol {
+namespace astro {
+
+namespace detail {
+/** Parent of the particles that were not reached from any seed */
+constexpr uint64_t unvisited = std::numeric_limits<uint64_t>::max();
+
+/** Answers the root of the cluster containing 'idx', halving the path on the way */
+inline uint64_t findRoot(std::vector<std::atomic<uint64_t>>& parent, uint64_t idx) {
+    for (;;) {
+        uint64_t p = parent[idx].load();
+        if (p == idx) return idx;
+        uint64_t const gp = parent[p].load();
+        if (gp != p) parent[idx].compare_exchange_weak(p, gp);
+        idx = gp;
+    }
+}
+
+/** Merges the clusters containing 'a' and 'b', the smaller root index survives */
+inline void unite(std::vector<std::atomic<uint64_t>>& parent, uint64_t a, uint64_t b) {
+    for (;;) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        uint64_t expected = a;
+        if (parent[a].compare_exchange_strong(expected, b)) return;
+    }
+}
+} // namespace detail
+
+/**
+ * Friends-of-friends clustering of the particles reachable from 'seeds':
+ * two particles are friends if they are closer than 'radius'. Answers the
+ * particles of all clusters with at least 'minClusterSize' particles in
+ * ascending order, the same as growing one cluster after another from the
+ * seeds.
+ *
+ * Every seed starts its own cluster. All seeds grow in parallel, one
+ * neighbourhood ring per step. A particle belongs to the cluster of whoever
+ * reached it first, the clusters of everybody else reaching it are merged.
+ *
+ * @param index          The radius search over 'positions', a nanoflann index.
+ * @param positions      The particle positions, with contiguous members x, y and z.
+ * @param seeds          The indices of the seed particles.
+ * @param radius         The friends-of-friends radius.
+ * @param minClusterSize The minimal number of particles of a cluster.
+ *
+ * @return The indices of the clustered particles.
+ */
+template <class I, class P>
+std::vector<uint64_t> FindFilamentClusters(const I& index, const std::vector<P>& positions,
+    const std::vector<uint64_t>& seeds, float radius, uint64_t minClusterSize) {
+    using detail::unvisited;
+    const auto particleCount = static_cast<int64_t>(positions.size());
+    nanoflann::SearchParams searchParams;
+    searchParams.sorted = false;
+
+    std::vector<std::atomic<uint64_t>> parent(particleCount);
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < particleCount; ++i) {
+        parent[i].store(unvisited, std::memory_order_relaxed);
+    }
+    std::vector<uint64_t> frontier;
+    frontier.reserve(seeds.size());
+    for (const auto seed : seeds) {
+        // a seed given twice must not be counted twice
+        if (parent[seed].load(std::memory_order_relaxed) != unvisited) continue;
+        parent[seed].store(seed);
+        frontier.push_back(seed);
+    }
+    std::vector<uint64_t> reached(frontier);
+    std::vector<std::vector<uint64_t>> nextFrontiers;
+
+    while (!frontier.empty()) {
+        const auto frontierSize = static_cast<int64_t>(frontier.size());
+#pragma omp parallel
+        {
+            // the team can be smaller than omp_get_max_threads(), so size by the actual team; this drops the
+            // frontiers of threads that are not part of it and keeps the capacity of the others
+#pragma omp single
+            nextFrontiers.resize(omp_get_num_threads());
+            auto& next = nextFrontiers[omp_get_thread_num()];
+            next.clear();
+            std::vector<std::pair<size_t, float>> searchResults;
+#pragma omp for schedule(dynamic, 64)
+            for (int64_t i = 0; i < frontierSize; ++i) {
+                const uint64_t cur = frontier[i];
+                const auto& pos = positions[cur];
+                index.radiusSearch(&pos.x, radius * radius, searchResults, searchParams);
+                for (const auto& v : searchResults) {
+                    const uint64_t idx = v.first;
+                    if (idx == cur) continue;
+                    uint64_t expected = unvisited;
+                    if (parent[idx].compare_exchange_strong(expected, cur)) {
+                        next.push_back(idx);
+                    } else {
+                        detail::unite(parent, cur, idx);
+                    }
+                }
+            }
+        }
+        frontier.clear();
+        for (const auto& next : nextFrontiers) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+        }
+        reached.insert(reached.end(), frontier.begin(), frontier.end());
+    }
+
+    // count the cluster sizes at the roots, the forest is not needed anymore afterwards
+    const auto reachedCount = static_cast<int64_t>(reached.size());
+    std::vector<uint64_t> roots(reached.size());
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < reachedCount; ++i) {
+        roots[i] = detail::findRoot(parent, reached[i]);
+    }
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < reachedCount; ++i) {
+        parent[reached[i]].store(0);
+    }
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < reachedCount; ++i) {
+        parent[roots[i]].fetch_add(1);
+    }
+    // erase too small clusters
+    std::vector<unsigned char> keep(particleCount, 0);
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < reachedCount; ++i) {
+        keep[reached[i]] = parent[roots[i]].load() >= minClusterSize;
+    }
+
+    // compact the kept particles in ascending order, every thread writes its own range of indices
+    std::vector<uint64_t> indices;
+    std::vector<uint64_t> offsets;
+#pragma omp parallel
+    {
+        const int thread = omp_get_thread_num();
+        const int threadCount = omp_get_num_threads();
+        const int64_t first = particleCount * thread / threadCount;
+        const int64_t last = particleCount * (thread + 1) / threadCount;
+#pragma omp single
+        offsets.assign(threadCount + 1, 0);
+        uint64_t kept = 0;
+        for (int64_t i = first; i < last; ++i) {
+            kept += keep[i];
+        }
+        offsets[thread + 1] = kept;
+#pragma omp barrier
+#pragma omp single
+        {
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            indices.resize(offsets.back());
+        }
+        uint64_t out = offsets[thread];
+        for (int64_t i = first; i < last; ++i) {
+            if (keep[i]) indices[out++] = static_cast<uint64_t>(i);
+        }
+    }
+    return indices;
+}
+
+} // namespace astro
+} // namespace megamol
@@ -6,14 +6,14 @@
  */
 #include "stdafx.h"
 #include "FilamentFilter.h"
+#include "FilamentClustering.h"
 
 #include <algorithm>
 #include <climits>
-#include <queue>
-#include <set>
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
+#include "omp.h"
 
 using namespace megamol;
 using namespace megamol::astro;
@@ -238,7 +238,7 @@ std::pair<float, float> FilamentFilter::getMinMaxDensity(const AstroDataCall& ca
 }
 
 /*
- * FilamentFilter::getMinMaxDensity
+ * FilamentFilter::retrieveDensityCandidateList
  */
 void FilamentFilter::retrieveDensityCandidateList(
     const AstroDataCall& call, std::vector<std::pair<float, uint64_t>>& result) {
@@ -246,22 +246,27 @@ void FilamentFilter::retrieveDensityCandidateList(
     const auto& dens = call.GetDensity();
     if (dens == nullptr) return;
     auto minmax = this->getMinMaxDensity(call);
-    result.resize(dens->size());
-    for (uint64_t i = 0; i < dens->size(); i++) {
-        result[i] = std::make_pair(dens->at(i), i);
-    }
-    // sort all the densities in descending order and only keep a certain percentage
-    std::sort(result.rbegin(), result.rend());
     float percentage = this->densitySeedPercentageSlot.Param<param::FloatParam>()->Value();
     percentage = 100.0f - percentage;
     percentage /= 100.0f;
     float minDensity = percentage * minmax.second;
-    auto foundval =
-        std::find_if(result.begin(), result.end(), [&minDensity](const auto& x) { return minDensity > x.first; });
-    result.erase(foundval, result.end());
+    const auto count = static_cast<int64_t>(dens->size());
+#pragma omp parallel
+    {
+        std::vector<std::pair<float, uint64_t>> local;
+#pragma omp for schedule(static) nowait
+        for (int64_t i = 0; i < count; i++) {
+            if (!(minDensity > (*dens)[i])) local.emplace_back((*dens)[i], static_cast<uint64_t>(i));
+        }
+#pragma omp critical
+        result.insert(result.end(), local.begin(), local.end());
+    }
+    // only keep the densest candidates. Their order does not influence the clusters, so a partial sort suffices
     const auto maxPartCount = static_cast<uint64_t>(
         call.GetParticleCount() * (this->maxParticlePercentageCuttoff.Param<param::FloatParam>()->Value() / 100.0f));
     if (result.size() > maxPartCount) {
+        std::nth_element(result.begin(), result.begin() + maxPartCount, result.end(),
+            std::greater<std::pair<float, uint64_t>>());
         result.resize(maxPartCount);
     }
 }
@@ -284,46 +289,53 @@ void FilamentFilter::initSearchStructure(const AstroDataCall& call) {
 /*
  * FilamentFilter::copyInCallToContent
  */
-bool FilamentFilter::copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet) {
-    this->positions->resize(indexSet.size());
-    this->velocities->resize(indexSet.size());
-    this->temperatures->resize(indexSet.size());
-    this->masses->resize(indexSet.size());
-    this->internalEnergies->resize(indexSet.size());
-    this->smoothingLengths->resize(indexSet.size());
-    this->molecularWeights->resize(indexSet.size());
-    this->densities->resize(indexSet.size());
-    this->gravitationalPotentials->resize(indexSet.size());
-    this->entropies->resize(indexSet.size());
-    this->isBaryonFlags->resize(indexSet.size());
-    this->isStarFlags->resize(indexSet.size());
-    this->isWindFlags->resize(indexSet.size());
-    this->isStarFormingGasFlags->resize(indexSet.size());
-    this->isAGNFlags->resize(indexSet.size());
-    this->particleIDs->resize(indexSet.size());
-
-    std::vector<uint64_t> setVec(indexSet.begin(), indexSet.end());
-    std::sort(setVec.begin(), setVec.end());
-
-    uint64_t i = 0;
-    for (const auto id : setVec) {
-        this->positions->at(i) = inCall.GetPositions()->at(id);
-        this->velocities->at(i) = inCall.GetVelocities()->at(id);
-        this->temperatures->at(i) = inCall.GetTemperature()->at(id);
-        this->masses->at(i) = inCall.GetMass()->at(id);
-        this->internalEnergies->at(i) = inCall.GetInternalEnergy()->at(id);
-        this->smoothingLengths->at(i) = inCall.GetSmoothingLength()->at(id);
-        this->molecularWeights->at(i) = inCall.GetMolecularWeights()->at(id);
-        this->densities->at(i) = inCall.GetDensity()->at(id);
-        this->gravitationalPotentials->at(i) = inCall.GetGravitationalPotential()->at(id);
-        this->entropies->at(i) = inCall.GetEntropy()->at(i);
-        this->isBaryonFlags->at(i) = inCall.GetIsBaryonFlags()->at(id);
-        this->isStarFlags->at(i) = inCall.GetIsStarFlags()->at(id);
-        this->isWindFlags->at(i) = inCall.GetIsWindFlags()->at(id);
-        this->isStarFormingGasFlags->at(i) = inCall.GetIsStarFormingGasFlags()->at(id);
-        this->isAGNFlags->at(i) = inCall.GetIsAGNFlags()->at(id);
-        this->particleIDs->at(i) = inCall.GetParticleIDs()->at(id);
-        ++i;
+bool FilamentFilter::copyInCallToContent(const AstroDataCall& inCall, const std::vector<uint64_t>& indices) {
+    this->positions->resize(indices.size());
+    this->velocities->resize(indices.size());
+    this->temperatures->resize(indices.size());
+    this->masses->resize(indices.size());
+    this->internalEnergies->resize(indices.size());
+    this->smoothingLengths->resize(indices.size());
+    this->molecularWeights->resize(indices.size());
+    this->densities->resize(indices.size());
+    this->gravitationalPotentials->resize(indices.size());
+    this->entropies->resize(indices.size());
+    this->isBaryonFlags->resize(indices.size());
+    this->isStarFlags->resize(indices.size());
+    this->isWindFlags->resize(indices.size());
+    this->isStarFormingGasFlags->resize(indices.size());
+    this->isAGNFlags->resize(indices.size());
+    this->particleIDs->resize(indices.size());
+
+    const auto count = static_cast<int64_t>(indices.size());
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < count; ++i) {
+        const auto id = indices[i];
+        (*this->positions)[i] = (*inCall.GetPositions())[id];
+        (*this->velocities)[i] = (*inCall.GetVelocities())[id];
+        (*this->temperatures)[i] = (*inCall.GetTemperature())[id];
+        (*this->masses)[i] = (*inCall.GetMass())[id];
+        (*this->internalEnergies)[i] = (*inCall.GetInternalEnergy())[id];
+        (*this->smoothingLengths)[i] = (*inCall.GetSmoothingLength())[id];
+        (*this->molecularWeights)[i] = (*inCall.GetMolecularWeights())[id];
+        (*this->densities)[i] = (*inCall.GetDensity())[id];
+        (*this->gravitationalPotentials)[i] = (*inCall.GetGravitationalPotential())[id];
+        (*this->entropies)[i] = (*inCall.GetEntropy())[id];
+        (*this->particleIDs)[i] = (*inCall.GetParticleIDs())[id];
+    }
+    // std::vector<bool> packs the flags into words, so every thread writes whole blocks of 64 flags
+    const int64_t flagBlocks = (count + 63) / 64;
+#pragma omp parallel for schedule(static)
+    for (int64_t b = 0; b < flagBlocks; ++b) {
+        const int64_t last = std::min(count, (b + 1) * 64);
+        for (int64_t i = b * 64; i < last; ++i) {
+            const auto id = indices[i];
+            (*this->isBaryonFlags)[i] = (*inCall.GetIsBaryonFlags())[id];
+            (*this->isStarFlags)[i] = (*inCall.GetIsStarFlags())[id];
+            (*this->isWindFlags)[i] = (*inCall.GetIsWindFlags())[id];
+            (*this->isStarFormingGasFlags)[i] = (*inCall.GetIsStarFormingGasFlags())[id];
+            (*this->isAGNFlags)[i] = (*inCall.GetIsAGNFlags())[id];
+        }
     }
     return true;
 }
@@ -335,73 +347,16 @@ bool FilamentFilter::filterFilaments(const AstroDataCall& call) {
     if (call.GetPositions() == nullptr) return false;
     std::vector<std::pair<float, uint64_t>> densityPeaks;
     this->retrieveDensityCandidateList(call, densityPeaks);
-    std::set<uint64_t> candidateSet;
-    for (const auto& a : densityPeaks) {
-        candidateSet.insert(a.second);
-    }
     this->initSearchStructure(call);
     if (this->searchIndexPtr == nullptr) return false;
 
-    // the following approach is not really performant, but it should work
-    std::vector<std::set<uint64_t>> setVec;
-    std::vector<bool> calculatedFlags(call.GetPositions()->size(), false);
-
-    nanoflann::SearchParams searchParams;
-    float searchRadius = this->radiusSlot.Param<param::FloatParam>()->Value();
-    std::vector<std::pair<size_t, float>> searchResults;
-    std::set<uint64_t> toProcessSet;
-
-    while (!candidateSet.empty()) {
-        auto current = *candidateSet.begin();
-        auto position = call.GetPositions()->at(current);
-        setVec.push_back(std::set<uint64_t>());
-        setVec.back().insert(current);
-        toProcessSet.clear();
-        calculatedFlags[current] = true;
-        const auto nMatches =
-            this->searchIndexPtr->radiusSearch(&position.x, searchRadius * searchRadius, searchResults, searchParams);
-        // insert everything in the vicinity of the current candidate to the queue
-        for (const auto& v : searchResults) {
-            uint64_t index = v.first;
-            if (index == current) continue;
-            if (!calculatedFlags[index]) {
-                toProcessSet.insert(index);
-                setVec.back().insert(index);
-                calculatedFlags[index] = true;
-            }
-        }
-        while (!toProcessSet.empty()) {
-            auto cur = *toProcessSet.begin();
-            auto pos = call.GetPositions()->at(cur);
-            searchResults.clear();
-            const auto matches =
-                this->searchIndexPtr->radiusSearch(&pos.x, searchRadius * searchRadius, searchResults, searchParams);
-            for (const auto& v : searchResults) {
-                uint64_t index = v.first;
-                if (index == cur) continue;
-                if (!calculatedFlags[index]) {
-                    toProcessSet.insert(index);
-                    setVec.back().insert(index);
-                    calculatedFlags[index] = true;
-                }
-            }
-            toProcessSet.erase(cur);
-            candidateSet.erase(cur);
-        }
-        candidateSet.erase(current);
-    }
-    // erase too small clusters
-    auto minClusterSize = this->minClusterSizeSlot.Param<param::IntParam>()->Value();
-    for (auto it = setVec.begin(); it != setVec.end(); /* intentionally empty*/) {
-        if ((*it).size() < minClusterSize) {
-            it = setVec.erase(it);
-        } else {
-            ++it;
-        }
-    }
-    std::set<uint64_t> endset;
-    for (const auto& s : setVec) {
-        endset.insert(s.begin(), s.end());
+    std::vector<uint64_t> seeds(densityPeaks.size());
+    for (size_t i = 0; i < densityPeaks.size(); ++i) {
+        seeds[i] = densityPeaks[i].second;
     }
-    return this->copyInCallToContent(call, endset);
+    const float searchRadius = this->radiusSlot.Param<param::FloatParam>()->Value();
+    const auto minClusterSize = static_cast<uint64_t>(this->minClusterSizeSlot.Param<param::IntParam>()->Value());
+    const auto indices =
+        FindFilamentClusters(*this->searchIndexPtr, *call.GetPositions(), seeds, searchRadius, minClusterSize);
+    return this->copyInCallToContent(call, indices);
 }
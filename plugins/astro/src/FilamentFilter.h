@@ -7,7 +7,7 @@
 #pragma once
 
 #include <nanoflann.hpp>
-#include <set>
+#include <vector>
 #include "astro/AstroDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
@@ -75,7 +75,7 @@ private:
     void retrieveDensityCandidateList(const AstroDataCall& call, std::vector<std::pair<float, uint64_t>>& result);
     bool filterFilaments(const AstroDataCall& call);
     bool copyContentToOutCall(AstroDataCall& outCall);
-    bool copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet);
+    bool copyInCallToContent(const AstroDataCall& inCall, const std::vector<uint64_t>& indices);
     void initSearchStructure(const AstroDataCall& call);
 
     core::CalleeSlot filamentOutSlot;
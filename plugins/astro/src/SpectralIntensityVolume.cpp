@@ -282,7 +282,7 @@ bool megamol::astro::SpectralIntensityVolume::getDataCallback(core::Call& c) {
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -415,7 +415,7 @@ bool megamol::astro::SpectralIntensityVolume::getLSUDataCallback(core::Call& c)
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -548,7 +548,7 @@ bool megamol::astro::SpectralIntensityVolume::getAbsorptionDataCallback(core::Ca
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -606,12 +606,7 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
 
     auto const numCells = sx * sy * sz;
 
-    vol_.resize(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol_[init].resize(numCells);
-        std::fill(vol_[init].begin(), vol_[init].end(), 0.0f);
-    }
+    vol_.assign(numCells, 0.0f);
 
     auto const cycl_x = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
     auto const cycl_y = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
@@ -856,8 +851,7 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
         }
     }*/
 
-    std::uniform_real_distribution<> distr(0.0, 1.0);
-    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<> const distr_proto(0.0, 1.0);
 
     // Implements the Bump Function from
     // https://en.wikipedia.org/wiki/Radial_basis_function
@@ -871,8 +865,28 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
     auto const cone_factor = std::tan(coneAngleDeg * M_PI / 180.0f);
     auto const cone_angle = coneAngleDeg * M_PI / 180.0;
 
-#    pragma omp parallel for
-    for (int64_t idx = 0; idx < positions.size(); ++idx) {
+    stdplugin::datatools::TiledSplatter::Grid splat_grid;
+    splat_grid.resolution = {sx, sy, sz};
+    splat_grid.origin = {minOSx, minOSy, minOSz};
+    splat_grid.spacing = {sliceDistX, sliceDistY, sliceDistZ};
+    splat_grid.cyclic = {cycl_x, cycl_y, cycl_z};
+    splatter_.SetGrid(splat_grid);
+
+    // bound the buffered samples of one batch of particles by a fixed memory budget, but keep enough particles
+    // per batch to amortize the parallel regions and the tile sort of Deposit
+    auto const max_steps = static_cast<size_t>(
+        std::sqrt(rangeOSx * rangeOSx + rangeOSy * rangeOSy + rangeOSz * rangeOSz) / min_vol_dis + 2.0f);
+    auto const samples_per_particle =
+        static_cast<size_t>(numSamples) * static_cast<size_t>(numConeSamples) * max_steps;
+    auto const batch_size = stdplugin::datatools::TiledSplatter::DepositBatchSize(
+        samples_per_particle, deposit_budget_, 16 * static_cast<size_t>(omp_get_max_threads()));
+
+    splatter_.Deposit(positions.size(), batch_size, [&](size_t const idx, auto const& emit) {
+        // One generator per particle keeps the result independent of the thread scheduling. The former single
+        // generator seeded with 42 was shared by all threads without synchronization, so its results were not
+        // reproducible either.
+        std::mt19937_64 rng(42 + idx);
+        auto distr = distr_proto;
         auto const pos = positions[idx];
         /*auto x_base = pos.x;
         auto x = voxel_idx[idx].x;
@@ -940,7 +954,7 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
                     e -= e * aps;
                     // att += aps * (1.0 - att);
 
-                    vol_[omp_get_thread_num()][(vz * sy + vy) * sx + vx] += e;
+                    emit(vx, vy, vz, static_cast<float>(e));
 
                     /*auto const cone = cone_factor * t;
                     auto const voxel_diff_x = static_cast<int>(cone / sliceDistX);
@@ -957,7 +971,7 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
                                 auto const hvx = (vvx + 2 * sx) % sx;
                                 auto const hvy = (vvy + 2 * sy) % sy;
                                 auto const hvz = (vvz + 2 * sz) % sz;
-                                vol_[omp_get_thread_num()][(hvz * sy + hvy) * sx + hvx] += e * rbf(distance, cone);
+                                emit(hvx, hvy, hvz, e * rbf(distance, cone));
                             }
                         }
                     }*/
@@ -971,22 +985,18 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
         if (omp_get_thread_num() == 0) {
             cpb.Set(counter.load());
         }
-    }
+    }, vol_.data());
     cpb.Stop();
 #endif
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol_[i].begin(), vol_[i].end(), vol_[0].begin(), vol_[0].begin(), std::plus<>());
-    }
-
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -995,14 +1005,11 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
 //#define SIV_DEBUG_OUTPUT
 #ifdef SIV_DEBUG_OUTPUT
     std::ofstream raw_file{"int.raw", std::ios::binary};
-    raw_file.write(reinterpret_cast<char const*>(vol_[0].data()), vol_[0].size() * sizeof(float));
+    raw_file.write(reinterpret_cast<char const*>(vol_.data()), vol_.size() * sizeof(float));
     raw_file.close();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("SpectralIntensityVolume: Debug file written\n");
 #endif
 
-    // Cleanup
-    vol_.resize(1);
-
     return true;
 }
 
@@ -1064,19 +1071,18 @@ bool megamol::astro::SpectralIntensityVolume::createBremsstrahlungVolume(core::m
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(density, density + numCells, temperature, vol_[0].begin(),
+    vol_.resize(numCells);
+    std::transform(density, density + numCells, temperature, vol_.begin(),
         [cell_vol](float d, float t) { return d * d * std::sqrt(t) * cell_vol; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -1155,26 +1161,25 @@ bool megamol::astro::SpectralIntensityVolume::createAbsorptionVolume(core::misc:
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(mw, mw + numCells, temperature, vol_[0].begin(), [](float mw, float t) {
+    vol_.resize(numCells);
+    std::transform(mw, mw + numCells, temperature, vol_.begin(), [](float mw, float t) {
         return 0.018 * std::pow(static_cast<double>(t), -1.5) * 0.0134 * 0.0134 * static_cast<double>(mw) * 1.2;
     });
-    std::transform(mass, mass + numCells, vol_[0].cbegin(), vol_[0].begin(), [](float m, double o) { return o / m; });
-    auto const minmax_optical = std::minmax_element(vol_[0].cbegin(), vol_[0].cend());
+    std::transform(mass, mass + numCells, vol_.cbegin(), vol_.begin(), [](float m, double o) { return o / m; });
+    auto const minmax_optical = std::minmax_element(vol_.cbegin(), vol_.cend());
     auto const min_optical = *minmax_optical.first;
     auto const minmax_optical_rcp = 1.0 / (*minmax_optical.second - min_optical);
-    std::transform(vol_[0].cbegin(), vol_[0].cend(), vol_[0].begin(),
+    std::transform(vol_.cbegin(), vol_.cend(), vol_.begin(),
         [min_optical, minmax_optical_rcp](float o) { return (o - min_optical) * minmax_optical_rcp; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -12,6 +12,7 @@
 
 #include "astro/AstroDataCall.h"
 #include "mmcore/misc/VolumetricDataCall.h"
+#include "mmstd_datatools/TiledSplatter.h"
 
 namespace megamol {
 namespace astro {
@@ -111,7 +112,12 @@ private:
 
     // core::param::ParamSlot wavelength_slot_;
 
-    std::vector<std::vector<float>> vol_;
+    std::vector<float> vol_;
+
+    stdplugin::datatools::TiledSplatter splatter_;
+
+    /** Bytes the splatter may buffer for one batch of particles */
+    static constexpr size_t deposit_budget_ = size_t(64) << 20;
 
     float max_dens_ = 0.0f;
     float min_dens_ = std::numeric_limits<float>::max();
@@ -0,0 +1,19 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testhelper.h"
+#include "testfilamentclustering.h"
+
+
+/* all available tests:
+ * Add your tests here
+ */
+TestEntry tests[] = {
+    { "FilamentClustering", ::TestFilamentClustering, "Compares the parallel filament clustering with the serial one" },
+    // end guard. Do not remove. Must be last entry.
+    {NULL, NULL, NULL}
+};
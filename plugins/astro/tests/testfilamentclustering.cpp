@@ -0,0 +1,147 @@
+/*
+ * testfilamentclustering.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testfilamentclustering.h"
+#include "testhelper.h"
+
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <omp.h>
+
+#include "FilamentClustering.h"
+#include "FilamentFilter.h"
+
+using namespace megamol::astro;
+
+namespace {
+
+typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, PointCloud<float>>, PointCloud<float>,
+    3>
+    kd_tree_t;
+
+/**
+ * The serial clustering FilamentFilter used before the union-find: grows
+ * one cluster after another from the seeds, drops the small clusters and
+ * answers the union of the rest.
+ */
+std::vector<uint64_t> serialClusters(const kd_tree_t& index, const std::vector<PointCloud<float>::Point>& positions,
+    const std::vector<uint64_t>& seeds, float radius, uint64_t minClusterSize) {
+    std::set<uint64_t> candidateSet(seeds.begin(), seeds.end());
+    std::vector<std::set<uint64_t>> setVec;
+    std::vector<bool> calculatedFlags(positions.size(), false);
+    nanoflann::SearchParams searchParams;
+    std::vector<std::pair<size_t, float>> searchResults;
+    std::set<uint64_t> toProcessSet;
+
+    while (!candidateSet.empty()) {
+        auto current = *candidateSet.begin();
+        setVec.push_back(std::set<uint64_t>());
+        setVec.back().insert(current);
+        toProcessSet.clear();
+        calculatedFlags[current] = true;
+        index.radiusSearch(&positions[current].x, radius * radius, searchResults, searchParams);
+        for (const auto& v : searchResults) {
+            if (v.first != current && !calculatedFlags[v.first]) {
+                toProcessSet.insert(v.first);
+                setVec.back().insert(v.first);
+                calculatedFlags[v.first] = true;
+            }
+        }
+        while (!toProcessSet.empty()) {
+            auto cur = *toProcessSet.begin();
+            index.radiusSearch(&positions[cur].x, radius * radius, searchResults, searchParams);
+            for (const auto& v : searchResults) {
+                if (v.first != cur && !calculatedFlags[v.first]) {
+                    toProcessSet.insert(v.first);
+                    setVec.back().insert(v.first);
+                    calculatedFlags[v.first] = true;
+                }
+            }
+            toProcessSet.erase(cur);
+            candidateSet.erase(cur);
+        }
+        candidateSet.erase(current);
+    }
+
+    std::set<uint64_t> endset;
+    for (const auto& s : setVec) {
+        if (s.size() >= minClusterSize) endset.insert(s.begin(), s.end());
+    }
+    return std::vector<uint64_t>(endset.begin(), endset.end());
+}
+
+/** Random particles, half of them along random walks, so that the clusters are elongated like filaments */
+PointCloud<float> filaments(size_t count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> box(0.0f, 20.0f);
+    std::normal_distribution<float> step(0.0f, 0.3f);
+    PointCloud<float> cloud;
+    cloud.pts.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& p = cloud.pts[i];
+        if (i % 2 == 0 || i % 1000 < 100) {
+            p.x = box(rng);
+            p.y = box(rng);
+            p.z = box(rng);
+        } else {
+            // continue the walk of the previous odd particle
+            const auto& prev = cloud.pts[i - 2];
+            p.x = prev.x + step(rng);
+            p.y = prev.y + step(rng);
+            p.z = prev.z + step(rng);
+        }
+    }
+    return cloud;
+}
+
+/** Compares the clustering with 'threads' threads against the serial one */
+bool sameClusters(const PointCloud<float>& cloud, const std::vector<uint64_t>& seeds, float radius,
+    uint64_t minClusterSize, int threads) {
+    kd_tree_t index(3, cloud, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+    index.buildIndex();
+
+    const auto expected = serialClusters(index, cloud.pts, seeds, radius, minClusterSize);
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(threads);
+    const auto clustered = FindFilamentClusters(index, cloud.pts, seeds, radius, minClusterSize);
+    omp_set_num_threads(maxThreads);
+    return clustered == expected;
+}
+
+} // namespace
+
+
+void TestFilamentClustering(void) {
+    const auto cloud = filaments(20000, 1);
+
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<uint64_t> particle(0, cloud.pts.size() - 1);
+    std::vector<uint64_t> seeds(500);
+    for (auto& s : seeds) {
+        s = particle(rng);
+    }
+    // seeds given twice, and seeds in the same cluster
+    std::vector<uint64_t> duplicates(seeds);
+    duplicates.insert(duplicates.end(), seeds.begin(), seeds.begin() + 100);
+    for (size_t i = 1; i < 200; i += 2) {
+        duplicates.push_back(i);
+    }
+
+    AssertTrue("No seeds", sameClusters(cloud, std::vector<uint64_t>(), 0.5f, 1, 4));
+    AssertTrue("Radius 0", sameClusters(cloud, seeds, 0.0f, 1, 4));
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        AssertTrue("Single particles are clusters", sameClusters(cloud, seeds, 0.3f, 1, threads));
+        AssertTrue("Small radius", sameClusters(cloud, seeds, 0.3f, 3, threads));
+        AssertTrue("Filament radius", sameClusters(cloud, seeds, 0.5f, 10, threads));
+        AssertTrue("Large radius, big clusters only", sameClusters(cloud, seeds, 0.8f, 200, threads));
+        AssertTrue("Duplicate seeds", sameClusters(cloud, duplicates, 0.5f, 10, threads));
+        AssertTrue("Duplicate seeds, exact cluster size", sameClusters(cloud, duplicates, 0.5f, 2, threads));
+    }
+}
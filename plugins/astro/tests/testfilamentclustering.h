@@ -0,0 +1,16 @@
+/*
+ * testfilamentclustering.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef ASTROTEST_TESTFILAMENTCLUSTERING_H_INCLUDED
+#define ASTROTEST_TESTFILAMENTCLUSTERING_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+void TestFilamentClustering(void);
+
+#endif /* ASTROTEST_TESTFILAMENTCLUSTERING_H_INCLUDED */
@@ -98,6 +98,7 @@ void megamol::gui::GUIManager::init_state() {
     this->gui_state.stat_averaged_fps = 0.0f;
     this->gui_state.stat_averaged_ms = 0.0f;
     this->gui_state.stat_frame_count = 0;
+    this->gui_state.call_profiling = nullptr;
     this->gui_state.load_docking_preset = true;
 }
 
@@ -322,6 +323,7 @@ bool GUIManager::PreDraw(glm::vec2 framebuffer_size, glm::vec2 window_size, doub
     if (auto win_perfmon_ptr = this->win_collection.GetWindow<PerformanceMonitor>()) {
         win_perfmon_ptr->SetData(
             this->gui_state.stat_averaged_fps, this->gui_state.stat_averaged_ms, this->gui_state.stat_frame_count);
+        win_perfmon_ptr->SetCallProfiling(this->gui_state.call_profiling);
     }
 
     // Update windows
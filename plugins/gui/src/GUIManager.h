@@ -12,6 +12,7 @@
 
 #include "mmcore/CoreInstance.h"
 #include "mmcore/MegaMolGraph.h"
+#include "CallProfiling.h"
 #include "mmcore/utility/Picking_gl.h"
 #include "widgets/FileBrowserWidget.h"
 #include "widgets/HoverToolTip.h"
@@ -202,6 +203,13 @@ namespace gui {
             this->gui_state.stat_frame_count = frame_count;
         }
 
+        /**
+         * Set source of per-call timings, nullptr disables the call table.
+         */
+        void SetCallProfiling(const megamol::frontend_resources::CallProfiling* call_profiling) {
+            this->gui_state.call_profiling = call_profiling;
+        }
+
         /**
          * Set resource directories.
          */
@@ -284,6 +292,7 @@ namespace gui {
             float stat_averaged_fps;              // current average fps value
             float stat_averaged_ms;               // current average fps value
             size_t stat_frame_count;              // current fame count
+            const megamol::frontend_resources::CallProfiling* call_profiling; // per-call timings
             bool load_docking_preset;             // Flag indicating docking preset loading
         };
 
@@ -75,6 +75,13 @@ bool PerformanceMonitor::Update() {
             update_values(((this->averaged_ms == 0.0f) ? (io.DeltaTime * 1000.0f) : (this->averaged_ms)),
                 this->win_ms_max, this->win_ms_values, this->win_buffer_size);
 
+            if (this->win_show_calls && (this->call_profiling != nullptr) && this->call_profiling->is_enabled()) {
+                this->call_stats = this->call_profiling->statistics();
+                // most expensive calls of the last frames first
+                std::stable_sort(this->call_stats.begin(), this->call_stats.end(),
+                    [](auto const& a, auto const& b) { return a.last_cpu_ms > b.last_cpu_ms; });
+            }
+
             this->win_current_delay = 0.0f;
         }
     }
@@ -148,12 +155,74 @@ bool PerformanceMonitor::Draw() {
         ImGui::TextUnformatted("Copy to Clipborad");
         std::string help("Values are listed in chronological order (newest first).");
         this->tooltip.Marker(help);
+
+        if (this->call_profiling != nullptr) {
+            bool profiling = this->call_profiling->is_enabled();
+            if (ImGui::Checkbox("Profile Calls", &profiling)) {
+                this->call_profiling->set_enabled(profiling);
+            }
+            ImGui::SameLine();
+            ImGui::Checkbox("Show Calls", &this->win_show_calls);
+            if (ImGui::InputInt("Listed Calls", &this->win_call_count, 1, 10, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                this->win_call_count = std::max(1, this->win_call_count);
+            }
+            if (ImGui::Button("Reset Calls")) {
+                this->call_profiling->reset();
+                this->call_stats.clear();
+            }
+        }
+    }
+
+    if (this->win_show_calls) {
+        this->draw_call_table();
     }
 
     return true;
 }
 
 
+void PerformanceMonitor::draw_call_table() {
+
+    if (this->call_stats.empty()) {
+        ImGui::TextDisabled("No call timings recorded.");
+        return;
+    }
+
+    auto table_flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("###calltimings", 6, table_flags)) {
+        ImGui::TableSetupColumn("Callee");
+        ImGui::TableSetupColumn("Function");
+        ImGui::TableSetupColumn("Last [ms]");
+        ImGui::TableSetupColumn("GPU [ms]");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Data [MB]");
+        ImGui::TableHeadersRow();
+
+        const size_t count = std::min(this->call_stats.size(), static_cast<size_t>(this->win_call_count));
+        for (size_t i = 0; i < count; ++i) {
+            auto const& s = this->call_stats[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(s.callee.c_str());
+            if (ImGui::IsItemHovered()) {
+                this->tooltip.ToolTip(s.caller + " -> " + s.callee + " (" + s.call_class + ")");
+            }
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(s.function.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.last_cpu_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.last_gpu_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(s.call_count));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", static_cast<double>(s.last_bytes_produced) / (1024.0 * 1024.0));
+        }
+        ImGui::EndTable();
+    }
+}
+
+
 void PerformanceMonitor::PopUps() {
 
     // UNUSED
@@ -174,6 +243,10 @@ void PerformanceMonitor::SpecificStateFromJSON(const nlohmann::json& in_json) {
                         config_values, {"fpsms_max_value_count"}, &this->win_buffer_size);
                     megamol::core::utility::get_json_value<float>(
                         config_values, {"fpsms_refresh_rate"}, &this->win_refresh_rate);
+                    megamol::core::utility::get_json_value<bool>(
+                        config_values, {"fpsms_show_calls"}, &this->win_show_calls);
+                    megamol::core::utility::get_json_value<int>(
+                        config_values, {"fpsms_call_count"}, &this->win_call_count);
                     int mode = 0;
                     megamol::core::utility::get_json_value<int>(config_values, {"fpsms_mode"}, &mode);
                     this->win_mode = static_cast<TimingMode>(mode);
@@ -190,4 +263,6 @@ void PerformanceMonitor::SpecificStateToJSON(nlohmann::json& inout_json) {
     inout_json[GUI_JSON_TAG_WINDOW_CONFIGS][this->Name()]["fpsms_max_value_count"] = this->win_buffer_size;
     inout_json[GUI_JSON_TAG_WINDOW_CONFIGS][this->Name()]["fpsms_refresh_rate"] = this->win_refresh_rate;
     inout_json[GUI_JSON_TAG_WINDOW_CONFIGS][this->Name()]["fpsms_mode"] = static_cast<int>(this->win_mode);
+    inout_json[GUI_JSON_TAG_WINDOW_CONFIGS][this->Name()]["fpsms_show_calls"] = this->win_show_calls;
+    inout_json[GUI_JSON_TAG_WINDOW_CONFIGS][this->Name()]["fpsms_call_count"] = this->win_call_count;
 }
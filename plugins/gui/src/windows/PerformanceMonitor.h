@@ -11,6 +11,7 @@
 
 
 #include "AbstractWindow.h"
+#include "CallProfiling.h"
 #include "widgets/HoverToolTip.h"
 
 
@@ -34,6 +35,11 @@ namespace gui {
             this->frame_id = current_frame_id;
         }
 
+        // Source of per-call timings, may be nullptr
+        inline void SetCallProfiling(const megamol::frontend_resources::CallProfiling* call_profiling) {
+            this->call_profiling = call_profiling;
+        }
+
         bool Update() override;
         bool Draw() override;
         void PopUps() override;
@@ -54,6 +60,14 @@ namespace gui {
         float win_ms_max = 1.0f;              // current ms plot scaling factor
         float win_fps_max = 1.0f;             // current fps plot scaling factor
 
+        bool win_show_calls = false;          // [SAVED] show/hide table of call timings
+        int win_call_count = 20;              // [SAVED] maximum count of calls listed
+
+        const megamol::frontend_resources::CallProfiling* call_profiling = nullptr;
+        std::vector<megamol::frontend_resources::CallStatistics> call_stats; // refreshed with refresh rate
+
+        void draw_call_table();
+
         size_t frame_id;
         float averaged_fps;
         float averaged_ms;
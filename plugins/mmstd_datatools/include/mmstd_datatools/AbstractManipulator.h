@@ -32,6 +32,16 @@ public:
     /** Dtor */
     virtual ~AbstractManipulator(void);
 
+    /**
+     * Manipulators compute from the data of their input call only, so the
+     * callbacks may be re-issued from a prefetch thread of the graph.
+     *
+     * @return 'true'
+     */
+    bool IsThreadSafe(void) const override {
+        return true;
+    }
+
 protected:
     /** Lazy initialization of the module */
     bool create(void) override;
@@ -0,0 +1,528 @@
+/*
+ * TiledSplatter.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+#ifndef MEGAMOL_DATATOOLS_TILEDSPLATTER_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TILEDSPLATTER_H_INCLUDED
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "omp.h"
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+/**
+ * Accumulates particle contributions into a regular grid without per-thread
+ * copies of the output volume.
+ *
+ * The grid is subdivided into cubic tiles. Work items are first binned by
+ * the tiles they touch (counting sort), afterwards the tiles are processed in
+ * parallel with exactly one thread writing to each tile. Additional memory is
+ * thus proportional to the number of items and tiles, not to the number of
+ * threads times the volume size.
+ *
+ * In deterministic mode the binning is stable, i.e. every voxel receives its
+ * contributions in item order, which yields bit-identical results for any
+ * number of threads.
+ */
+class TiledSplatter {
+public:
+    /** Radial kernels, 'scale' times the particle radius gives their width h */
+    enum class Kernel {
+        Bump,     //< exp(-1 / (1 - (d/h)^2)) for d < h
+        Box,      //< 1 for d <= h
+        Gaussian, //< exp(-d^2 / (2 h^2)), cut off at 3h
+        SPH       //< cubic spline with support h
+    };
+
+    struct Grid {
+        /** Number of voxels per axis */
+        std::array<int, 3> resolution = {0, 0, 0};
+        /** Position of voxel (0, 0, 0) */
+        std::array<float, 3> origin = {0.0f, 0.0f, 0.0f};
+        /** Distance between neighbouring voxels */
+        std::array<float, 3> spacing = {1.0f, 1.0f, 1.0f};
+        /** Periodic boundary per axis */
+        std::array<bool, 3> cyclic = {false, false, false};
+        /** Interleaved values per voxel */
+        unsigned int components = 1;
+    };
+
+    TiledSplatter(void) = default;
+
+    void SetGrid(Grid const& grid) {
+        this->grid = grid;
+        this->updateTiles();
+    }
+
+    inline Grid const& GetGrid(void) const {
+        return this->grid;
+    }
+
+    /** Sets the edge length of the tiles in voxels */
+    void SetTileSize(int edge) {
+        this->tileSize = std::max(edge, 1);
+        this->updateTiles();
+    }
+
+    inline void SetDeterministic(bool deterministic) {
+        this->deterministic = deterministic;
+    }
+
+    inline size_t VoxelCount(void) const {
+        return static_cast<size_t>(this->grid.resolution[0]) * static_cast<size_t>(this->grid.resolution[1]) *
+               static_cast<size_t>(this->grid.resolution[2]);
+    }
+
+    inline size_t TileCount(void) const {
+        return static_cast<size_t>(this->tiles[0]) * static_cast<size_t>(this->tiles[1]) *
+               static_cast<size_t>(this->tiles[2]);
+    }
+
+    /** Answer the distance beyond which the kernel vanishes */
+    static inline float SupportRadius(Kernel kernel, float scale, float radius) {
+        float const h = scale * radius;
+        return kernel == Kernel::Gaussian ? 3.0f * h : h;
+    }
+
+    /** Evaluates the kernel of width h at distance dist */
+    static inline float Weight(Kernel kernel, float dist, float h) {
+        switch (kernel) {
+        case Kernel::Box:
+            return dist <= h ? 1.0f : 0.0f;
+        case Kernel::Gaussian:
+            return dist <= 3.0f * h ? std::exp(-0.5f * dist * dist / (h * h)) : 0.0f;
+        case Kernel::SPH: {
+            if (dist >= h) return 0.0f;
+            float const q = dist / h;
+            if (q < 0.5f) return 1.0f - 6.0f * q * q + 6.0f * q * q * q;
+            float const r = 1.0f - q;
+            return 2.0f * r * r * r;
+        }
+        case Kernel::Bump:
+        default: {
+            // https://en.wikipedia.org/wiki/Radial_basis_function
+            if (dist >= h) return 0.0f;
+            float const q = dist / h;
+            return std::exp(-1.0f / (1.0f - q * q));
+        }
+        }
+    }
+
+    /**
+     * Splats 'count' particles into 'volume'.
+     *
+     * Every particle touches the voxels within SupportRadius() of its cell,
+     * i.e. the footprint grows with 'scale'. Cutting it off at the particle
+     * radius instead would clip the kernel whenever scale > 1; for scale = 1
+     * and the bump kernel both are the same.
+     *
+     * @param count    The number of particles.
+     * @param kernel   The kernel.
+     * @param scale    Kernel width in multiples of the particle radius.
+     * @param particle float particle(size_t idx, float pos[3]), writes the position and returns the radius.
+     *                 Particles with radius <= 0 are skipped.
+     * @param value    void value(size_t idx, float* vals), writes 'components' values which are weighted and
+     *                 accumulated.
+     * @param volume   VoxelCount() * components values, contributions are added.
+     * @param weights  Optional VoxelCount() values receiving the sum of the kernel weights.
+     */
+    template <typename ParticleFn, typename ValueFn>
+    void Splat(size_t count, Kernel kernel, float scale, ParticleFn const& particle, ValueFn const& value,
+        float* volume, float* weights = nullptr) {
+        if (count == 0 || this->TileCount() == 0) return;
+
+        auto const footprint = [this, kernel, scale, &particle](
+                                   size_t idx, float pos[3], float& h, std::array<int, 3>& lo, std::array<int, 3>& hi) {
+            float const rad = particle(idx, pos);
+            if (!(rad > 0.0f)) return false;
+            h = scale * rad;
+            float const support = SupportRadius(kernel, scale, rad);
+            for (int a = 0; a < 3; ++a) {
+                // truncation like the former per-thread loops, only particles outside the grid differ from floor
+                int const c = static_cast<int>((pos[a] - this->grid.origin[a]) / this->grid.spacing[a]);
+                int const f = static_cast<int>(std::ceil(support / this->grid.spacing[a]));
+                lo[a] = c - f;
+                hi[a] = c + f;
+                if (!this->grid.cyclic[a]) {
+                    lo[a] = std::max(lo[a], 0);
+                    hi[a] = std::min(hi[a], this->grid.resolution[a] - 1);
+                    if (lo[a] > hi[a]) return false;
+                }
+            }
+            return true;
+        };
+
+        this->bin(count, [this, &footprint](size_t idx, auto const& emit) {
+            float pos[3];
+            float h = 0.0f;
+            std::array<int, 3> lo, hi;
+            if (!footprint(idx, pos, h, lo, hi)) return;
+            this->forEachTile(lo, hi, emit);
+        });
+
+        auto const comps = this->grid.components;
+        auto const sx = static_cast<size_t>(this->grid.resolution[0]);
+        auto const sy = static_cast<size_t>(this->grid.resolution[1]);
+        auto const numTiles = static_cast<int64_t>(this->TileCount());
+
+#pragma omp parallel
+        {
+            std::array<std::vector<std::pair<int, int>>, 3> axis;
+            std::vector<float> vals(comps);
+#pragma omp for schedule(dynamic)
+            for (int64_t tile = 0; tile < numTiles; ++tile) {
+                std::array<int, 3> t0, t1;
+                this->tileRange(static_cast<size_t>(tile), t0, t1);
+                for (auto r = this->binStart[tile]; r < this->binStart[tile + 1]; ++r) {
+                    auto const idx = this->binned[r];
+                    float pos[3];
+                    float h = 0.0f;
+                    std::array<int, 3> lo, hi;
+                    footprint(idx, pos, h, lo, hi);
+                    for (int a = 0; a < 3; ++a) {
+                        this->clipToTile(a, lo[a], hi[a], t0[a], t1[a], axis[a]);
+                    }
+                    value(idx, vals.data());
+                    auto const& sp = this->grid.spacing;
+                    auto const& org = this->grid.origin;
+                    for (auto const& z : axis[2]) {
+                        float const dz = static_cast<float>(z.first) * sp[2] + org[2] - pos[2];
+                        for (auto const& y : axis[1]) {
+                            float const dy = static_cast<float>(y.first) * sp[1] + org[1] - pos[1];
+                            for (auto const& x : axis[0]) {
+                                float const dx = static_cast<float>(x.first) * sp[0] + org[0] - pos[0];
+                                float const w = Weight(kernel, std::sqrt(dx * dx + dy * dy + dz * dz), h);
+                                if (w == 0.0f) continue;
+                                auto const voxel =
+                                    static_cast<size_t>(x.second) +
+                                    (static_cast<size_t>(y.second) + static_cast<size_t>(z.second) * sy) * sx;
+                                for (unsigned int c = 0; c < comps; ++c) {
+                                    volume[voxel * comps + c] += w * vals[c];
+                                }
+                                if (weights != nullptr) weights[voxel] += w;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        this->releaseBins();
+    }
+
+    /**
+     * Answer the batch size for Deposit such that the buffered contributions
+     * of one batch stay within 'budget' bytes, but never fewer than
+     * 'minItems' items, so the parallel regions of a batch still have work
+     * for every thread.
+     *
+     * @param itemSamples Upper bound of the contributions emitted per item.
+     * @param budget      Bytes available for the buffered contributions.
+     * @param minItems    The smallest batch size returned.
+     */
+    static inline size_t DepositBatchSize(size_t itemSamples, size_t budget, size_t minItems) {
+        // every contribution lives in a thread buffer and in the tile-sorted copy
+        auto const perItem = std::max<size_t>(itemSamples, 1) * 2 * sizeof(Contribution);
+        return std::max<size_t>(budget / perItem, std::max<size_t>(minItems, 1));
+    }
+
+    /**
+     * Adds arbitrary per-voxel contributions generated by 'count' work items,
+     * e.g. samples along rays. Items are processed in batches of 'batchSize',
+     * all contributions of a batch are buffered, binned by tile and applied
+     * before the next batch starts.
+     *
+     * @param count     The number of work items.
+     * @param batchSize The number of items per batch, bounds the buffered contributions.
+     * @param generate  void generate(size_t idx, Emit const& emit) with emit(int x, int y, int z, float value)
+     *                  taking voxel coordinates within the grid.
+     * @param volume    VoxelCount() * components values, values are added to the first component.
+     */
+    template <typename GeneratorFn>
+    void Deposit(size_t count, size_t batchSize, GeneratorFn const& generate, float* volume) {
+        if (count == 0 || this->TileCount() == 0) return;
+        batchSize = std::max<size_t>(batchSize, 1);
+
+        auto const comps = this->grid.components;
+        auto const sx = static_cast<size_t>(this->grid.resolution[0]);
+        auto const sy = static_cast<size_t>(this->grid.resolution[1]);
+        auto const numTiles = this->TileCount();
+        auto const maxThreads = omp_get_max_threads();
+
+        // deterministic mode fills one buffer per contiguous chunk of items, otherwise one per thread
+        std::vector<std::vector<Contribution>> buffers(maxThreads);
+        std::vector<Contribution> sorted;
+        std::vector<size_t> offsets;
+
+        for (size_t batch = 0; batch < count; batch += batchSize) {
+            auto const batchEnd = std::min(count, batch + batchSize);
+            for (auto& buf : buffers) buf.clear();
+
+            auto const run = [this, &generate, sx, sy](size_t idx, std::vector<Contribution>& buf) {
+                generate(idx, [this, &buf, sx, sy](int x, int y, int z, float value) {
+                    auto const voxel =
+                        static_cast<size_t>(x) + (static_cast<size_t>(y) + static_cast<size_t>(z) * sy) * sx;
+                    buf.push_back(Contribution{voxel, this->tileOf(x, y, z), value});
+                });
+            };
+            if (this->deterministic) {
+#pragma omp parallel for schedule(static, 1)
+                for (int chunk = 0; chunk < maxThreads; ++chunk) {
+                    size_t begin, end;
+                    chunkRange(batch, batchEnd, chunk, maxThreads, begin, end);
+                    for (size_t idx = begin; idx < end; ++idx) run(idx, buffers[chunk]);
+                }
+            } else {
+#pragma omp parallel for schedule(dynamic, 16)
+                for (int64_t idx = static_cast<int64_t>(batch); idx < static_cast<int64_t>(batchEnd); ++idx) {
+                    run(static_cast<size_t>(idx), buffers[omp_get_thread_num()]);
+                }
+            }
+
+            // stable counting sort by tile
+            offsets.assign(numTiles + 1, 0);
+            size_t total = 0;
+            for (auto const& buf : buffers) {
+                for (auto const& c : buf) ++offsets[c.tile + 1];
+                total += buf.size();
+            }
+            for (size_t t = 0; t < numTiles; ++t) offsets[t + 1] += offsets[t];
+            sorted.resize(total);
+            {
+                std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (auto const& buf : buffers) {
+                    for (auto const& c : buf) sorted[cursor[c.tile]++] = c;
+                }
+            }
+
+#pragma omp parallel for schedule(dynamic)
+            for (int64_t tile = 0; tile < static_cast<int64_t>(numTiles); ++tile) {
+                for (auto r = offsets[tile]; r < offsets[tile + 1]; ++r) {
+                    volume[sorted[r].voxel * comps] += sorted[r].value;
+                }
+            }
+        }
+    }
+
+private:
+    struct Contribution {
+        size_t voxel;
+        size_t tile;
+        float value;
+    };
+
+    void updateTiles(void) {
+        for (int a = 0; a < 3; ++a) {
+            this->tiles[a] = (std::max(this->grid.resolution[a], 0) + this->tileSize - 1) / this->tileSize;
+        }
+    }
+
+    inline size_t tileOf(int x, int y, int z) const {
+        return static_cast<size_t>(x / this->tileSize) +
+               (static_cast<size_t>(y / this->tileSize) +
+                   static_cast<size_t>(z / this->tileSize) * static_cast<size_t>(this->tiles[1])) *
+                   static_cast<size_t>(this->tiles[0]);
+    }
+
+    /** Voxel range [t0, t1) covered by the tile */
+    inline void tileRange(size_t tile, std::array<int, 3>& t0, std::array<int, 3>& t1) const {
+        std::array<size_t, 3> const t = {tile % this->tiles[0], (tile / this->tiles[0]) % this->tiles[1],
+            tile / (static_cast<size_t>(this->tiles[0]) * this->tiles[1])};
+        for (int a = 0; a < 3; ++a) {
+            t0[a] = static_cast<int>(t[a]) * this->tileSize;
+            t1[a] = std::min(t0[a] + this->tileSize, this->grid.resolution[a]);
+        }
+    }
+
+    inline int wrap(int a, int v) const {
+        int const r = this->grid.resolution[a];
+        v %= r;
+        return v < 0 ? v + r : v;
+    }
+
+    /**
+     * Collects the voxels of the footprint [lo, hi] lying in the tile range
+     * [t0, t1) on axis a as pairs of unwrapped and wrapped index.
+     */
+    inline void clipToTile(int a, int lo, int hi, int t0, int t1, std::vector<std::pair<int, int>>& out) const {
+        out.clear();
+        if (!this->grid.cyclic[a]) {
+            for (int v = std::max(lo, t0); v <= std::min(hi, t1 - 1); ++v) out.emplace_back(v, v);
+            return;
+        }
+        for (int v = lo; v <= hi; ++v) {
+            int const w = this->wrap(a, v);
+            if (w >= t0 && w < t1) out.emplace_back(v, w);
+        }
+    }
+
+    /** Calls emit(tile) once for every tile touched by the footprint [lo, hi] */
+    template <typename EmitFn>
+    inline void forEachTile(std::array<int, 3> const& lo, std::array<int, 3> const& hi, EmitFn const& emit) const {
+        // per axis at most two ranges of tiles, as a cyclic footprint can wrap around once
+        std::array<std::array<int, 4>, 3> ranges;
+        std::array<int, 3> num;
+        for (int a = 0; a < 3; ++a) {
+            auto& r = ranges[a];
+            if (hi[a] - lo[a] + 1 >= this->grid.resolution[a]) {
+                r[0] = 0;
+                r[1] = this->tiles[a] - 1;
+                num[a] = 1;
+                continue;
+            }
+            int const wl = this->grid.cyclic[a] ? this->wrap(a, lo[a]) : lo[a];
+            int const wh = this->grid.cyclic[a] ? this->wrap(a, hi[a]) : hi[a];
+            if (wl <= wh) {
+                r[0] = wl / this->tileSize;
+                r[1] = wh / this->tileSize;
+                num[a] = 1;
+            } else if (wh / this->tileSize >= wl / this->tileSize) {
+                r[0] = 0;
+                r[1] = this->tiles[a] - 1;
+                num[a] = 1;
+            } else {
+                r[0] = 0;
+                r[1] = wh / this->tileSize;
+                r[2] = wl / this->tileSize;
+                r[3] = this->tiles[a] - 1;
+                num[a] = 2;
+            }
+        }
+        for (int rz = 0; rz < num[2]; ++rz) {
+            for (int tz = ranges[2][2 * rz]; tz <= ranges[2][2 * rz + 1]; ++tz) {
+                for (int ry = 0; ry < num[1]; ++ry) {
+                    for (int ty = ranges[1][2 * ry]; ty <= ranges[1][2 * ry + 1]; ++ty) {
+                        for (int rx = 0; rx < num[0]; ++rx) {
+                            for (int tx = ranges[0][2 * rx]; tx <= ranges[0][2 * rx + 1]; ++tx) {
+                                emit(static_cast<size_t>(tx) +
+                                     (static_cast<size_t>(ty) + static_cast<size_t>(tz) * this->tiles[1]) *
+                                         this->tiles[0]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /** Answer the range of chunk 'chunk' when splitting [begin, end) into 'chunks' contiguous ranges */
+    static inline void chunkRange(size_t begin, size_t end, int chunk, int chunks, size_t& cbegin, size_t& cend) {
+        auto const size = (end - begin + chunks - 1) / static_cast<size_t>(chunks);
+        cbegin = std::min(end, begin + static_cast<size_t>(chunk) * size);
+        cend = std::min(end, cbegin + size);
+    }
+
+    /**
+     * Counting sort of the items by the tiles they touch. 'touch(idx, emit)'
+     * calls emit(tile) for every tile of item idx. Fills binStart and binned.
+     */
+    template <typename TouchFn>
+    void bin(size_t count, TouchFn const& touch) {
+        auto const numTiles = this->TileCount();
+        this->binStart.assign(numTiles + 1, 0);
+
+        if (this->deterministic) {
+            // histograms per contiguous chunk of items make the scatter stable
+            auto const chunks = omp_get_max_threads();
+            std::vector<size_t> counts(static_cast<size_t>(chunks) * numTiles, 0);
+#pragma omp parallel for schedule(static, 1)
+            for (int chunk = 0; chunk < chunks; ++chunk) {
+                size_t begin, end;
+                chunkRange(0, count, chunk, chunks, begin, end);
+                auto* local = counts.data() + chunk * numTiles;
+                for (size_t idx = begin; idx < end; ++idx) {
+                    touch(idx, [local](size_t tile) { ++local[tile]; });
+                }
+            }
+            size_t sum = 0;
+            for (size_t tile = 0; tile < numTiles; ++tile) {
+                this->binStart[tile] = sum;
+                for (int chunk = 0; chunk < chunks; ++chunk) {
+                    auto& c = counts[chunk * numTiles + tile];
+                    auto const num = c;
+                    c = sum;
+                    sum += num;
+                }
+            }
+            this->binStart[numTiles] = sum;
+            this->binned.resize(sum);
+#pragma omp parallel for schedule(static, 1)
+            for (int chunk = 0; chunk < chunks; ++chunk) {
+                size_t begin, end;
+                chunkRange(0, count, chunk, chunks, begin, end);
+                auto* cursor = counts.data() + chunk * numTiles;
+                for (size_t idx = begin; idx < end; ++idx) {
+                    touch(idx, [this, cursor, idx](size_t tile) { this->binned[cursor[tile]++] = idx; });
+                }
+            }
+        } else {
+            // per-thread histograms, both passes share the static schedule of one parallel region
+            auto const maxThreads = omp_get_max_threads();
+            std::vector<size_t> counts(static_cast<size_t>(maxThreads) * numTiles, 0);
+#pragma omp parallel
+            {
+                auto* local = counts.data() + omp_get_thread_num() * numTiles;
+#pragma omp for schedule(static)
+                for (int64_t idx = 0; idx < static_cast<int64_t>(count); ++idx) {
+                    touch(static_cast<size_t>(idx), [local](size_t tile) { ++local[tile]; });
+                }
+#pragma omp single
+                {
+                    auto const threads = omp_get_num_threads();
+                    size_t sum = 0;
+                    for (size_t tile = 0; tile < numTiles; ++tile) {
+                        this->binStart[tile] = sum;
+                        for (int t = 0; t < threads; ++t) {
+                            auto& c = counts[t * numTiles + tile];
+                            auto const num = c;
+                            c = sum;
+                            sum += num;
+                        }
+                    }
+                    this->binStart[numTiles] = sum;
+                    this->binned.resize(sum);
+                }
+#pragma omp for schedule(static)
+                for (int64_t idx = 0; idx < static_cast<int64_t>(count); ++idx) {
+                    touch(static_cast<size_t>(idx),
+                        [this, local, idx](size_t tile) { this->binned[local[tile]++] = static_cast<size_t>(idx); });
+                }
+            }
+        }
+    }
+
+    void releaseBins(void) {
+        std::vector<size_t>().swap(this->binned);
+        std::vector<size_t>().swap(this->binStart);
+    }
+
+    Grid grid;
+
+    int tileSize = 32;
+
+    std::array<int, 3> tiles = {0, 0, 0};
+
+    bool deterministic = true;
+
+    /** First entry of every tile in 'binned', one additional entry marks the end */
+    std::vector<size_t> binStart;
+
+    /** Item indices sorted by tile */
+    std::vector<size_t> binned;
+};
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_TILEDSPLATTER_H_INCLUDED */
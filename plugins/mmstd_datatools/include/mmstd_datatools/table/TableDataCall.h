@@ -87,6 +87,10 @@ namespace table {
         TableDataCall(void);
         virtual ~TableDataCall(void);
 
+        size_t ProfilingDataSize(void) const override {
+            return columns_count * rows_count * sizeof(float);
+        }
+
         inline size_t GetColumnsCount(void) const {
             return columns_count;
         }
@@ -6,22 +6,297 @@
  */
 #include "stdafx.h"
 #include "MPIParticleCollector.h"
+#include "ParticleRadixSort.h"
 #include "mmcore/cluster/mpi/MpiCall.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/utility/sys/SystemInformation.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstring>
 
 using namespace megamol;
 using namespace megamol::stdplugin;
 
+namespace {
+
+using megamol::core::moldyn::SimpleSphericalParticles;
+
+/**
+ * Values the ranks agree on per list before the gather. Minimums are stored
+ * negated, so one MPI_MAX reduction answers all of them.
+ */
+enum ListInfo {
+    INFO_VERT_MAX = 0,
+    INFO_VERT_MIN,
+    INFO_COL_MAX,
+    INFO_COL_MIN,
+    INFO_MAX_X,
+    INFO_MAX_Y,
+    INFO_MAX_Z,
+    INFO_MIN_X,
+    INFO_MIN_Y,
+    INFO_MIN_Z,
+    INFO_MAX_I,
+    INFO_MIN_I,
+    INFO_SIZE
+};
+
+/** Layout of the particle records sent over MPI */
+struct RecordLayout {
+    SimpleSphericalParticles::VertexDataType vertType = SimpleSphericalParticles::VERTDATA_NONE;
+    SimpleSphericalParticles::ColourDataType colType = SimpleSphericalParticles::COLDATA_NONE;
+    SimpleSphericalParticles::VertexDataType outVertType = SimpleSphericalParticles::VERTDATA_NONE;
+    SimpleSphericalParticles::ColourDataType outColType = SimpleSphericalParticles::COLDATA_NONE;
+    bool quantVert = false; //< positions as 16 bit fixed point in the common bounding box
+    bool quantCol = false;  //< RGB(A) as 8 bit, intensities as 16 bit fixed point in the common range
+    unsigned int vertSize = 0;
+    unsigned int colSize = 0;
+
+    inline unsigned int Size(void) const {
+        return this->vertSize + this->colSize;
+    }
+
+    inline unsigned int OutVertSize(void) const {
+        return SimpleSphericalParticles::VertexDataSize[this->outVertType];
+    }
+
+    inline unsigned int OutSize(void) const {
+        return this->OutVertSize() + SimpleSphericalParticles::ColorDataSize[this->outColType];
+    }
+};
+
+RecordLayout makeLayout(
+    SimpleSphericalParticles::VertexDataType vdt, SimpleSphericalParticles::ColourDataType cdt, bool quantize) {
+    RecordLayout l;
+    l.vertType = l.outVertType = vdt;
+    l.colType = l.outColType = cdt;
+    l.vertSize = SimpleSphericalParticles::VertexDataSize[vdt];
+    l.colSize = SimpleSphericalParticles::ColorDataSize[cdt];
+    if (!quantize) return l;
+
+    switch (vdt) {
+    case SimpleSphericalParticles::VERTDATA_FLOAT_XYZ:
+    case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ:
+        l.quantVert = true;
+        l.vertSize = 3 * sizeof(uint16_t);
+        l.outVertType = SimpleSphericalParticles::VERTDATA_FLOAT_XYZ;
+        break;
+    case SimpleSphericalParticles::VERTDATA_FLOAT_XYZR:
+        // the radius stays a float, it often only takes a few distinct values
+        l.quantVert = true;
+        l.vertSize = 3 * sizeof(uint16_t) + sizeof(float);
+        break;
+    default:
+        break;
+    }
+    switch (cdt) {
+    case SimpleSphericalParticles::COLDATA_FLOAT_RGB:
+        l.quantCol = true;
+        l.colSize = 3;
+        l.outColType = SimpleSphericalParticles::COLDATA_UINT8_RGB;
+        break;
+    case SimpleSphericalParticles::COLDATA_FLOAT_RGBA:
+        l.quantCol = true;
+        l.colSize = 4;
+        l.outColType = SimpleSphericalParticles::COLDATA_UINT8_RGBA;
+        break;
+    case SimpleSphericalParticles::COLDATA_FLOAT_I:
+    case SimpleSphericalParticles::COLDATA_DOUBLE_I:
+        l.quantCol = true;
+        l.colSize = sizeof(uint16_t);
+        l.outColType = SimpleSphericalParticles::COLDATA_FLOAT_I;
+        break;
+    default:
+        break;
+    }
+    return l;
+}
+
+/** Fixed point mapping of [lo, hi] to [0, 65535] */
+struct Quantizer {
+    Quantizer(double lo, double hi) : lo(static_cast<float>(lo)), scale(0.0f), invScale(0.0f) {
+        if (hi > lo) {
+            this->scale = static_cast<float>(65535.0 / (hi - lo));
+            this->invScale = static_cast<float>((hi - lo) / 65535.0);
+        }
+    }
+
+    inline uint16_t Encode(float v) const {
+        float const q = (v - this->lo) * this->scale + 0.5f;
+        return (q <= 0.0f) ? 0 : ((q >= 65535.0f) ? 65535 : static_cast<uint16_t>(q));
+    }
+
+    inline float Decode(uint16_t q) const {
+        return this->lo + static_cast<float>(q) * this->invScale;
+    }
+
+    float lo, scale, invScale;
+};
+
+inline uint8_t encodeChannel(float v) {
+    return static_cast<uint8_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+/** Packs the particles of 'p' into records of 'l' */
+void packRecords(SimpleSphericalParticles& p, RecordLayout const& l, double const* info, std::vector<uint8_t>& out) {
+    size_t const cnt = static_cast<size_t>(p.GetCount());
+    size_t const rs = l.Size();
+    out.resize(cnt * rs);
+    if (cnt * rs == 0) return;
+
+    std::vector<datatools::GatherStream> raw;
+    if (!l.quantVert && (l.vertSize > 0)) {
+        unsigned int const s = p.GetVertexDataStride();
+        raw.push_back({p.GetVertexData(), (s == 0) ? l.vertSize : s, l.vertSize, 0});
+    }
+    if (!l.quantCol && (l.colSize > 0)) {
+        unsigned int const s = p.GetColourDataStride();
+        raw.push_back({p.GetColourData(), (s == 0) ? l.colSize : s, l.colSize, l.vertSize});
+    }
+    if (!raw.empty()) {
+        datatools::GatherStreams<size_t>(out.data(), rs, raw, nullptr, cnt);
+    }
+    if (!l.quantVert && !l.quantCol) return;
+
+    auto const& store = p.GetParticleStore();
+    Quantizer const qx(-info[INFO_MIN_X], info[INFO_MAX_X]);
+    Quantizer const qy(-info[INFO_MIN_Y], info[INFO_MAX_Y]);
+    Quantizer const qz(-info[INFO_MIN_Z], info[INFO_MAX_Z]);
+    Quantizer const qi(-info[INFO_MIN_I], info[INFO_MAX_I]);
+    bool const withRadius = (l.vertType == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR);
+    bool const intensity = (l.outColType == SimpleSphericalParticles::COLDATA_FLOAT_I);
+
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+        uint8_t* rec = out.data() + static_cast<size_t>(i) * rs;
+        if (l.quantVert) {
+            uint16_t const q[3] = {qx.Encode(store.GetXAcc()->Get_f(i)), qy.Encode(store.GetYAcc()->Get_f(i)),
+                qz.Encode(store.GetZAcc()->Get_f(i))};
+            ::memcpy(rec, q, sizeof(q));
+            if (withRadius) {
+                float const r = store.GetRAcc()->Get_f(i);
+                ::memcpy(rec + sizeof(q), &r, sizeof(float));
+            }
+        }
+        if (l.quantCol) {
+            uint8_t* col = rec + l.vertSize;
+            if (intensity) {
+                uint16_t const q = qi.Encode(store.GetCRAcc()->Get_f(i));
+                ::memcpy(col, &q, sizeof(q));
+            } else {
+                col[0] = encodeChannel(store.GetCRAcc()->Get_f(i));
+                col[1] = encodeChannel(store.GetCGAcc()->Get_f(i));
+                col[2] = encodeChannel(store.GetCBAcc()->Get_f(i));
+                if (l.colSize > 3) col[3] = encodeChannel(store.GetCAAcc()->Get_f(i));
+            }
+        }
+    }
+}
+
+/** Expands 'cnt' quantized records of 'l' to the output types */
+void decodeRecords(
+    const uint8_t* in, size_t cnt, RecordLayout const& l, double const* info, std::vector<uint8_t>& out) {
+    size_t const rs = l.Size();
+    size_t const ors = l.OutSize();
+    size_t const ovs = l.OutVertSize();
+    out.resize(cnt * ors);
+
+    Quantizer const qx(-info[INFO_MIN_X], info[INFO_MAX_X]);
+    Quantizer const qy(-info[INFO_MIN_Y], info[INFO_MAX_Y]);
+    Quantizer const qz(-info[INFO_MIN_Z], info[INFO_MAX_Z]);
+    Quantizer const qi(-info[INFO_MIN_I], info[INFO_MAX_I]);
+    bool const withRadius = (l.vertType == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR);
+    bool const intensity = (l.outColType == SimpleSphericalParticles::COLDATA_FLOAT_I);
+
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+        const uint8_t* rec = in + static_cast<size_t>(i) * rs;
+        uint8_t* dst = out.data() + static_cast<size_t>(i) * ors;
+        if (l.quantVert) {
+            uint16_t q[3];
+            ::memcpy(q, rec, sizeof(q));
+            float const pos[3] = {qx.Decode(q[0]), qy.Decode(q[1]), qz.Decode(q[2])};
+            ::memcpy(dst, pos, sizeof(pos));
+            if (withRadius) ::memcpy(dst + sizeof(pos), rec + sizeof(q), sizeof(float));
+        } else {
+            ::memcpy(dst, rec, l.vertSize);
+        }
+        if (l.quantCol && intensity) {
+            uint16_t q;
+            ::memcpy(&q, rec + l.vertSize, sizeof(q));
+            float const v = qi.Decode(q);
+            ::memcpy(dst + ovs, &v, sizeof(float));
+        } else {
+            // 8 bit colours are sent as they are output
+            ::memcpy(dst + ovs, rec + l.vertSize, l.colSize);
+        }
+    }
+}
+
+#ifdef WITH_MPI
+
+/** A gather of particle records to rank 0 of a communicator, in flight until it is waited for */
+struct RecordGather {
+    std::vector<int> counts;
+    std::vector<int> displs;
+    uint64_t total = 0;
+    MPI_Request request = MPI_REQUEST_NULL;
+};
+
+/** Collects the number of records of every rank of 'comm' at its rank 0 */
+void gatherCounts(MPI_Comm comm, int rank, int size, uint64_t cnt, RecordGather& g) {
+    std::vector<uint64_t> counts((rank == 0) ? size : 1);
+    MPI_Gather(&cnt, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, 0, comm);
+    g.total = cnt;
+    if (rank == 0) {
+        // the records are counted in whole particles, so a list can hold up to INT_MAX particles
+        g.counts.resize(size);
+        g.displs.resize(size);
+        g.total = 0;
+        for (int r = 0; r < size; ++r) {
+            g.counts[r] = static_cast<int>(counts[r]);
+            g.displs[r] = static_cast<int>(g.total);
+            g.total += counts[r];
+        }
+    }
+}
+
+/** Starts gathering the records counted by gatherCounts at rank 0 of 'comm' */
+void startGather(MPI_Comm comm, int rank, const std::vector<uint8_t>& data, size_t recSize,
+    std::vector<uint8_t>& out, RecordGather& g) {
+    if (rank == 0) out.resize(static_cast<size_t>(g.total) * recSize);
+    if (recSize == 0) return;
+    MPI_Datatype rec;
+    MPI_Type_contiguous(static_cast<int>(recSize), MPI_BYTE, &rec);
+    MPI_Type_commit(&rec);
+    MPI_Igatherv(data.data(), static_cast<int>(data.size() / recSize), rec, out.data(), g.counts.data(),
+        g.displs.data(), rec, 0, comm, &g.request);
+    MPI_Type_free(&rec); // freed once the gather is done
+}
+
+#endif /* WITH_MPI */
+
+} // namespace
+
 
 /*
  * datatools::MPIParticleCollector::MPIParticleCollector
  */
 datatools::MPIParticleCollector::MPIParticleCollector(void)
     : AbstractParticleManipulator("outData", "indata")
-    , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.") {
+    , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
+    , nodeLocalSlot("nodeLocal", "Collects the particles on every host first, then sends one message per host")
+    , quantizeSlot("quantize", "Sends positions as 16 bit fixed point and colours as 8 bit or 16 bit intensities") {
 
     this->callRequestMpi.SetCompatibleCall<core::cluster::mpi::MpiCallDescription>();
     this->MakeSlotAvailable(&this->callRequestMpi);
+
+    this->nodeLocalSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->nodeLocalSlot);
+
+    this->quantizeSlot.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->quantizeSlot);
 }
 
 
@@ -31,6 +306,23 @@ datatools::MPIParticleCollector::MPIParticleCollector(void)
 datatools::MPIParticleCollector::~MPIParticleCollector(void) { this->Release(); }
 
 
+/*
+ * datatools::MPIParticleCollector::release
+ */
+void datatools::MPIParticleCollector::release(void) {
+#ifdef WITH_MPI
+    int finalized = 0;
+    ::MPI_Finalized(&finalized);
+    if (!finalized) {
+        if (this->nodeComm != MPI_COMM_NULL) ::MPI_Comm_free(&this->nodeComm);
+        if (this->leaderComm != MPI_COMM_NULL) ::MPI_Comm_free(&this->leaderComm);
+    }
+    this->nodeComm = MPI_COMM_NULL;
+    this->leaderComm = MPI_COMM_NULL;
+#endif /* WITH_MPI */
+}
+
+
 /*
  * datatools::MPIParticleCollector::manipulateData
  */
@@ -43,86 +335,193 @@ bool datatools::MPIParticleCollector::manipulateData(
     inData.SetUnlocker(nullptr, false); // keep original data locked
                                         // original data will be unlocked through outData
 #ifdef WITH_MPI
-    bool useMpi = initMPI();
-
-    unsigned int plc = outData.GetParticleListCount();
-    for (unsigned int i = 0; i < plc; i++) {
-        MultiParticleDataCall::Particles& p = outData.AccessParticles(i);
-
-        uint64_t cnt = p.GetCount();
-
-        const uint8_t* cd = reinterpret_cast<const uint8_t*>(p.GetColourData());
-        unsigned int cds = p.GetColourDataStride();
-        MultiParticleDataCall::Particles::ColourDataType cdt = p.GetColourDataType();
-        unsigned int csize = MultiParticleDataCall::Particles::ColorDataSize[cdt];
-
-        const uint8_t* vd = reinterpret_cast<const uint8_t*>(p.GetVertexData());
-        unsigned int vds = p.GetVertexDataStride();
-        MultiParticleDataCall::Particles::VertexDataType vdt = p.GetVertexDataType();
-        unsigned int vsize = MultiParticleDataCall::Particles::VertexDataSize[vdt];
-
-        //megamol::core::utility::log::Log::DefaultLog.WriteInfo("Count = %lu", cnt);
-        //megamol::core::utility::log::Log::DefaultLog.WriteInfo("csize = %u, vsize = %u", csize, vsize);
-
-        std::vector<uint64_t> counts;
-        std::vector<int32_t> vertSizes, colSizes, vertOffsets, colOffsets;
-        counts.resize(this->mpiSize);
-        vertSizes.resize(this->mpiSize);
-        colSizes.resize(this->mpiSize);
-        vertOffsets.resize(this->mpiSize);
-        vertOffsets[0] = 0;
-        colOffsets.resize(this->mpiSize);
-        colOffsets[0] = 0;
-        uint64_t allCount = 0;
-        // MPI_Reduce(&cnt, &allCount, 1, MPI_INT64_T, MPI_SUM, 0, this->comm);
-        MPI_Gather(&cnt, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, 0, this->comm);
+    if (!initMPI()) return true;
+
+    unsigned int const plc = outData.GetParticleListCount();
 
+    // every rank takes part in every collective, so the ranks first agree on what to do
+    int const changed = !this->hasCollected || (inData.DataHash() == 0) || (inData.DataHash() != this->lastHash) ||
+                        (inData.FrameID() != this->lastFrame) || this->nodeLocalSlot.IsDirty() ||
+                        this->quantizeSlot.IsDirty();
+    int flags[5] = {changed, this->nodeLocalSlot.Param<core::param::BoolParam>()->Value() ? 1 : 0,
+        this->quantizeSlot.Param<core::param::BoolParam>()->Value() ? 1 : 0, static_cast<int>(plc),
+        -static_cast<int>(plc)};
+    MPI_Allreduce(MPI_IN_PLACE, flags, 5, MPI_INT, MPI_MAX, this->comm);
+    this->lastHash = inData.DataHash();
+    this->lastFrame = inData.FrameID();
+    this->nodeLocalSlot.ResetDirty();
+    this->quantizeSlot.ResetDirty();
+    if (flags[3] != -flags[4]) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "MPIParticleCollector: the ranks hold between %d and %d particle lists", -flags[4], flags[3]);
+        this->hasCollected = false;
+        return false;
+    }
+    bool const nodeLocal = (flags[1] != 0) && (this->nodeComm != MPI_COMM_NULL);
+    bool const quantize = (flags[2] != 0);
+
+    if (flags[0] == 0) {
+        // nothing changed on any rank, the last collection is still valid
         if (this->mpiRank == 0) {
-            for (auto x = 0; x < this->mpiSize; ++x) {
-                allCount += counts[x];
-                vertSizes[x] = counts[x] * vsize;
-                colSizes[x] = counts[x] * csize;
-                if (x > 0) {
-                    vertOffsets[x] = vertOffsets[x - 1] + counts[x - 1] * vsize;
-                    colOffsets[x] = colOffsets[x - 1] + counts[x - 1] * csize;
-                }
+            for (unsigned int i = 0; i < plc; ++i) {
+                auto& p = outData.AccessParticles(i);
+                auto const& c = this->collected[i];
+                p.SetCount(c.count);
+                p.SetVertexData(c.vertType, c.data, c.stride);
+                p.SetColourData(c.colType, c.data + c.colOffset, c.stride);
+                p.SetDirData(MultiParticleDataCall::Particles::DIRDATA_NONE, nullptr);
+                p.SetIDData(MultiParticleDataCall::Particles::IDDATA_NONE, nullptr);
+                if (c.hasColRange) p.SetColourMapIndexValues(c.minCol, c.maxCol);
             }
-            //megamol::core::utility::log::Log::DefaultLog.WriteInfo("allCount = %lu", allCount);
-            if (allCount * csize > std::numeric_limits<int>::max() ||
-                allCount * vsize > std::numeric_limits<int>::max()) {
-                // this is so bad there is no way to fix it
-                megamol::core::utility::log::Log::DefaultLog.WriteError("allCount is more powerful than MPI, kill me now. Try subsampling more aggressively", allCount);
-                abort();
+        }
+        return true;
+    }
+    this->hasCollected = false;
+
+    // types and value ranges of all lists
+    std::vector<double> info(static_cast<size_t>(plc) * INFO_SIZE, -DBL_MAX);
+    std::vector<uint64_t> totals(plc, 0);
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto& p = outData.AccessParticles(i);
+        double* li = info.data() + static_cast<size_t>(i) * INFO_SIZE;
+        totals[i] = p.GetCount();
+        if (p.GetCount() == 0) continue; // empty ranks often do not even set the types
+        li[INFO_VERT_MAX] = p.GetVertexDataType();
+        li[INFO_VERT_MIN] = -static_cast<double>(p.GetVertexDataType());
+        li[INFO_COL_MAX] = p.GetColourDataType();
+        li[INFO_COL_MIN] = -static_cast<double>(p.GetColourDataType());
+        if (quantize) {
+            auto const& store = p.GetParticleStore();
+            int64_t const cnt = static_cast<int64_t>(p.GetCount());
+#pragma omp parallel
+            {
+                double bounds[8] = {-DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX};
+#pragma omp for
+                for (int64_t j = 0; j < cnt; ++j) {
+                    float const v[4] = {store.GetXAcc()->Get_f(j), store.GetYAcc()->Get_f(j),
+                        store.GetZAcc()->Get_f(j), store.GetCRAcc()->Get_f(j)};
+                    for (int c = 0; c < 4; ++c) {
+                        bounds[2 * c] = std::max<double>(bounds[2 * c], v[c]);
+                        bounds[2 * c + 1] = std::max<double>(bounds[2 * c + 1], -v[c]);
+                    }
+                }
+#pragma omp critical
+                {
+                    for (int c = 0; c < 3; ++c) {
+                        li[INFO_MAX_X + c] = std::max(li[INFO_MAX_X + c], bounds[2 * c]);
+                        li[INFO_MIN_X + c] = std::max(li[INFO_MIN_X + c], bounds[2 * c + 1]);
+                    }
+                    li[INFO_MAX_I] = std::max(li[INFO_MAX_I], bounds[6]);
+                    li[INFO_MIN_I] = std::max(li[INFO_MIN_I], bounds[7]);
+                }
             }
-            p.SetCount(allCount);
-            allVertexData.resize(allCount * vsize);
-            allColorData.resize(allCount * csize);
-        } else {
-            p.SetCount(cnt);
         }
-        vertexData.resize(cnt * vsize);
-        colorData.resize(cnt * csize);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, info.data(), static_cast<int>(info.size()), MPI_DOUBLE, MPI_MAX, this->comm);
+    MPI_Allreduce(MPI_IN_PLACE, totals.data(), static_cast<int>(plc), MPI_UINT64_T, MPI_SUM, this->comm);
 
-        megamol::core::utility::log::Log::DefaultLog.FlushLog();
+    std::vector<RecordLayout> layouts(plc);
+    for (unsigned int i = 0; i < plc; ++i) {
+        double const* li = info.data() + static_cast<size_t>(i) * INFO_SIZE;
+        if (totals[i] == 0) continue;
+        if ((li[INFO_VERT_MAX] != -li[INFO_VERT_MIN]) || (li[INFO_COL_MAX] != -li[INFO_COL_MIN])) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "MPIParticleCollector: the ranks use different data types in list %u", i);
+            return false;
+        }
+        if (totals[i] > static_cast<uint64_t>(INT_MAX)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError("MPIParticleCollector: list %u holds %llu "
+                "particles, MPI cannot gather more than %d. Try subsampling more aggressively", i,
+                static_cast<unsigned long long>(totals[i]), INT_MAX);
+            return false;
+        }
+        layouts[i] = makeLayout(static_cast<SimpleSphericalParticles::VertexDataType>(li[INFO_VERT_MAX]),
+            static_cast<SimpleSphericalParticles::ColourDataType>(li[INFO_COL_MAX]), quantize);
+    }
 
-#    pragma omp parallel for
-        for (long long idx = 0; idx < cnt; ++idx) {
-            memcpy(colorData.data() + csize * idx, cd + cds * idx, csize);
-            memcpy(vertexData.data() + vsize * idx, vd + vds * idx, vsize);
+    // first stage: on every host, or across all ranks at once
+    MPI_Comm const firstComm = nodeLocal ? this->nodeComm : this->comm;
+    int const firstRank = nodeLocal ? this->nodeRank : this->mpiRank;
+    int const firstSize = nodeLocal ? this->nodeSize : this->mpiSize;
+    // second stage: the first rank of every host sends to rank 0
+    bool const secondStage = nodeLocal && (this->leaderSize > 1);
+    bool const leader = secondStage && (this->leaderComm != MPI_COMM_NULL);
+
+    this->packedData.resize(plc);
+    this->nodeData.resize(plc);
+    this->allData.resize(plc);
+    this->decodedData.resize(plc);
+    std::vector<RecordGather> firstGathers(plc), secondGathers(plc);
+
+    // packing a list overlaps with the transfer of the previous ones
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto& p = outData.AccessParticles(i);
+        if (totals[i] == 0) continue;
+        packRecords(p, layouts[i], info.data() + static_cast<size_t>(i) * INFO_SIZE, this->packedData[i]);
+        gatherCounts(firstComm, firstRank, firstSize, p.GetCount(), firstGathers[i]);
+        startGather(firstComm, firstRank, this->packedData[i], layouts[i].Size(), this->nodeData[i], firstGathers[i]);
+        if (leader) {
+            gatherCounts(this->leaderComm, this->leaderRank, this->leaderSize, firstGathers[i].total,
+                secondGathers[i]);
         }
+    }
+    if (leader) {
+        for (unsigned int i = 0; i < plc; ++i) {
+            if (totals[i] == 0) continue;
+            MPI_Wait(&firstGathers[i].request, MPI_STATUS_IGNORE);
+            startGather(this->leaderComm, this->leaderRank, this->nodeData[i], layouts[i].Size(),
+                this->allData[i], secondGathers[i]);
+        }
+    }
+
+    if (this->mpiRank != 0) {
+        for (unsigned int i = 0; i < plc; ++i) {
+            MPI_Wait(&firstGathers[i].request, MPI_STATUS_IGNORE);
+            MPI_Wait(&secondGathers[i].request, MPI_STATUS_IGNORE);
+        }
+        // the other ranks keep their own particles
+        this->hasCollected = true;
+        return true;
+    }
 
-        MPI_Gatherv(colorData.data(), cnt * csize, MPI_BYTE, allColorData.data(), colSizes.data(), colOffsets.data(), MPI_BYTE, 0, this->comm);
-        MPI_Gatherv(vertexData.data(), cnt * vsize, MPI_BYTE, allVertexData.data(), vertSizes.data(), vertOffsets.data(),
-            MPI_BYTE, 0, this->comm);
+    // unpacking a list overlaps with the transfer of the following ones
+    this->collected.assign(plc, CollectedList());
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto& p = outData.AccessParticles(i);
+        auto& c = this->collected[i];
+        RecordLayout const& l = layouts[i];
+        MPI_Wait(&firstGathers[i].request, MPI_STATUS_IGNORE);
+        MPI_Wait(&secondGathers[i].request, MPI_STATUS_IGNORE);
+        std::vector<uint8_t> const& all = secondStage ? this->allData[i] : this->nodeData[i];
 
-        if (this->mpiRank == 0) {
-            p.SetColourData(cdt, allColorData.data(), csize);
-            p.SetVertexData(vdt, allVertexData.data(), vsize);
+        c.count = totals[i];
+        c.vertType = l.outVertType;
+        c.colType = l.outColType;
+        if (l.quantVert || l.quantCol) {
+            double const* li = info.data() + static_cast<size_t>(i) * INFO_SIZE;
+            decodeRecords(all.data(), static_cast<size_t>(totals[i]), l, li, this->decodedData[i]);
+            c.data = this->decodedData[i].data();
+            c.stride = l.OutSize();
+            c.colOffset = l.OutVertSize();
+            if (l.outColType == SimpleSphericalParticles::COLDATA_FLOAT_I) {
+                c.hasColRange = true;
+                c.minCol = static_cast<float>(-li[INFO_MIN_I]);
+                c.maxCol = static_cast<float>(li[INFO_MAX_I]);
+            }
         } else {
-            p.SetColourData(cdt, colorData.data(), csize);
-            p.SetVertexData(vdt, vertexData.data(), vsize);
+            c.data = all.data();
+            c.stride = l.Size();
+            c.colOffset = l.vertSize;
         }
+
+        p.SetCount(c.count);
+        p.SetVertexData(c.vertType, c.data, c.stride);
+        p.SetColourData(c.colType, c.data + c.colOffset, c.stride);
+        p.SetDirData(MultiParticleDataCall::Particles::DIRDATA_NONE, nullptr);
+        p.SetIDData(MultiParticleDataCall::Particles::IDDATA_NONE, nullptr);
+        if (c.hasColRange) p.SetColourMapIndexValues(c.minCol, c.maxCol);
     }
+    this->hasCollected = true;
 #endif /* WITH_MPI */
 
     return true;
@@ -153,6 +552,20 @@ bool datatools::MPIParticleCollector::initMPI() {
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("This MPIParticleCollector on %hs is %d ")
                                                    _T("of %d."),
                 vislib::sys::SystemInformation::ComputerNameA().PeekBuffer(), this->mpiRank, this->mpiSize);
+
+            // ordered by rank, so rank 0 is the first rank of its host and of the leaders
+            ::MPI_Comm_split_type(this->comm, MPI_COMM_TYPE_SHARED, this->mpiRank, MPI_INFO_NULL, &this->nodeComm);
+            if (this->nodeComm != MPI_COMM_NULL) {
+                ::MPI_Comm_rank(this->nodeComm, &this->nodeRank);
+                ::MPI_Comm_size(this->nodeComm, &this->nodeSize);
+            }
+            ::MPI_Comm_split(
+                this->comm, (this->nodeRank == 0) ? 0 : MPI_UNDEFINED, this->mpiRank, &this->leaderComm);
+            if (this->leaderComm != MPI_COMM_NULL) {
+                ::MPI_Comm_rank(this->leaderComm, &this->leaderRank);
+                ::MPI_Comm_size(this->leaderComm, &this->leaderSize);
+            }
+            ::MPI_Bcast(&this->leaderSize, 1, MPI_INT, 0, this->comm);
         } /* end if (this->comm != MPI_COMM_NULL) */
     }     /* end if (this->comm == MPI_COMM_NULL) */
 
@@ -160,4 +573,4 @@ bool datatools::MPIParticleCollector::initMPI() {
     retval = (this->comm != MPI_COMM_NULL);
 #endif /* WITH_MPI */
     return retval;
-}
\ No newline at end of file
+}
@@ -13,6 +13,8 @@
 
 #include "mmstd_datatools/AbstractParticleManipulator.h"
 #include "mmcore/param/ParamSlot.h"
+#include <cstdint>
+#include <vector>
 
 #ifdef WITH_MPI
 #include "mpi.h"
@@ -27,6 +29,12 @@ namespace datatools {
      * This should be used for gathering large in situ SUBSAMPLED (ParticleThinner) data sets:
      * Everything is collected at once and MPI cannot push that much data
      * at once.
+     *
+     * The particles are first collected on the first rank of every host and
+     * then sent from there to rank 0, so only one message per host crosses
+     * the network. Positions and colours can be quantized before the
+     * transfer. Each list is gathered with non-blocking collectives, so
+     * packing and unpacking overlap with the transfers of the other lists.
      */
     class MPIParticleCollector : public AbstractParticleManipulator {
     public:
@@ -56,6 +64,17 @@ namespace datatools {
         /** Dtor */
         virtual ~MPIParticleCollector(void);
 
+        /**
+         * MPI is only used from the render thread, so the collective calls
+         * of all ranks stay in the same order. Opts out of the prefetch the
+         * other manipulators allow.
+         *
+         * @return 'false'
+         */
+        bool IsThreadSafe(void) const override {
+            return false;
+        }
+
     protected:
 
         /**
@@ -73,21 +92,65 @@ namespace datatools {
             megamol::core::moldyn::MultiParticleDataCall& inData);
         bool initMPI();
 
+        /** Resource release */
+        void release(void) override;
+
     private:
 
+        /** How the particles collected for a list are output on rank 0 */
+        struct CollectedList {
+            uint64_t count = 0;
+            megamol::core::moldyn::SimpleSphericalParticles::VertexDataType vertType =
+                megamol::core::moldyn::SimpleSphericalParticles::VERTDATA_NONE;
+            megamol::core::moldyn::SimpleSphericalParticles::ColourDataType colType =
+                megamol::core::moldyn::SimpleSphericalParticles::COLDATA_NONE;
+            const uint8_t* data = nullptr;
+            unsigned int stride = 0;
+            unsigned int colOffset = 0;
+            bool hasColRange = false;
+            float minCol = 0.0f;
+            float maxCol = 1.0f;
+        };
+
 #ifdef WITH_MPI
         /** The communicator that the view uses. */
         MPI_Comm comm = MPI_COMM_NULL;
+
+        /** The ranks on the same host as this one */
+        MPI_Comm nodeComm = MPI_COMM_NULL;
+
+        /** The first rank of every host, MPI_COMM_NULL on the other ranks */
+        MPI_Comm leaderComm = MPI_COMM_NULL;
 #endif /* WITH_MPI */
 
         /** slot for MPIprovider */
         core::CallerSlot callRequestMpi;
 
+        /** Collect on every host first */
+        core::param::ParamSlot nodeLocalSlot;
+
+        /** Quantize positions and colours before the transfer */
+        core::param::ParamSlot quantizeSlot;
+
         int mpiRank = 0;
         int mpiSize = 0;
+        int nodeRank = 0;
+        int nodeSize = 1;
+        int leaderRank = 0;
+        int leaderSize = 1;
+
+        /** Per list, the packed local particles, the particles collected on the host and on rank 0 */
+        std::vector<std::vector<uint8_t>> packedData, nodeData, allData;
+
+        /** Per list, the collected particles with dequantized positions and colours (rank 0 only) */
+        std::vector<std::vector<uint8_t>> decodedData;
+
+        /** Per list, the output of the last collection (rank 0 only) */
+        std::vector<CollectedList> collected;
 
-        std::vector<uint8_t> vertexData, colorData;
-        std::vector<uint8_t> allVertexData, allColorData;
+        unsigned int lastFrame = 0;
+        size_t lastHash = 0;
+        bool hasCollected = false;
     };
 
 } /* end namespace datatools */
@@ -8,13 +8,108 @@
 #include "MPIVolumeAggregator.h"
 #include "mmcore/cluster/mpi/MpiCall.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/utility/sys/SystemInformation.h"
+#include <algorithm>
 #include <chrono>
 
 using namespace megamol;
 using namespace megamol::stdplugin;
 
+namespace {
+
+/** Staging memory of one reduction or gather round */
+constexpr size_t roundBytes = size_t(64) << 20;
+
+/**
+ * Partition of a volume into cubic bricks. The brick index runs x fastest,
+ * so the bricks of a range of z layers are consecutive.
+ */
+struct BrickGrid {
+    BrickGrid(size_t const resolution[3], size_t components, size_t edgeLength)
+        : comp(components), edge(edgeLength) {
+        for (int d = 0; d < 3; ++d) {
+            this->res[d] = resolution[d];
+            this->count[d] = (resolution[d] + edgeLength - 1) / edgeLength;
+        }
+    }
+
+    size_t Bricks(void) const { return this->count[0] * this->count[1] * this->count[2]; }
+
+    size_t LayerBricks(void) const { return this->count[0] * this->count[1]; }
+
+    size_t BrickFloats(void) const { return this->edge * this->edge * this->edge * this->comp; }
+
+    size_t SliceFloats(void) const { return this->res[0] * this->res[1] * this->comp; }
+
+    /** Answers the first brick layer of the slab owned by 'rank' */
+    size_t FirstLayer(int rank, int ranks) const {
+        return this->count[2] * static_cast<size_t>(rank) / static_cast<size_t>(ranks);
+    }
+
+    /** Answers the first z slice of the slab owned by 'rank' */
+    size_t FirstSlice(int rank, int ranks) const {
+        return std::min(this->FirstLayer(rank, ranks) * this->edge, this->res[2]);
+    }
+
+    /** Answers the voxels [lo, hi) of 'brick' */
+    void Range(size_t brick, size_t lo[3], size_t hi[3]) const {
+        size_t const idx[3] = {brick % this->count[0], (brick / this->count[0]) % this->count[1],
+            brick / this->LayerBricks()};
+        for (int d = 0; d < 3; ++d) {
+            lo[d] = idx[d] * this->edge;
+            hi[d] = std::min(lo[d] + this->edge, this->res[d]);
+        }
+    }
+
+    /**
+     * Calls 'f(volumeOffset, brickOffset, floats)' for every row of 'brick'
+     * in a volume holding the z slices from 'zFirst' on.
+     */
+    template <class F> void ForEachRow(size_t brick, size_t zFirst, F f) const {
+        size_t lo[3], hi[3];
+        this->Range(brick, lo, hi);
+        size_t const rowFloats = (hi[0] - lo[0]) * this->comp;
+        for (size_t z = lo[2]; z < hi[2]; ++z) {
+            for (size_t y = lo[1]; y < hi[1]; ++y) {
+                f((((z - zFirst) * this->res[1] + y) * this->res[0] + lo[0]) * this->comp,
+                    ((z - lo[2]) * this->edge + (y - lo[1])) * this->edge * this->comp, rowFloats);
+            }
+        }
+    }
+
+    /** Copies 'brick' from 'vol' to 'dst', voxels outside the volume are zero */
+    void Pack(float const* vol, size_t zFirst, size_t brick, float* dst) const {
+        std::fill(dst, dst + this->BrickFloats(), 0.0f);
+        this->ForEachRow(brick, zFirst,
+            [vol, dst](size_t v, size_t b, size_t n) { std::copy(vol + v, vol + v + n, dst + b); });
+    }
+
+    /** Copies the packed 'brick' from 'src' to 'vol' */
+    void Unpack(float const* src, size_t brick, float* vol, size_t zFirst) const {
+        this->ForEachRow(brick, zFirst,
+            [src, vol](size_t v, size_t b, size_t n) { std::copy(src + b, src + b + n, vol + v); });
+    }
+
+    /** Answers whether any voxel of 'brick' in 'vol' is not zero */
+    bool IsSet(float const* vol, size_t zFirst, size_t brick) const {
+        bool set = false;
+        this->ForEachRow(brick, zFirst, [vol, &set](size_t v, size_t, size_t n) {
+            set = set || std::any_of(vol + v, vol + v + n, [](float f) { return f != 0.0f; });
+        });
+        return set;
+    }
+
+    size_t res[3];
+    size_t count[3];
+    size_t comp;
+    size_t edge;
+};
+
+} /* end anonymous namespace */
+
 
 /*
  * datatools::MPIVolumeAggregator::MPIVolumeAggregator
@@ -22,7 +117,10 @@ using namespace megamol::stdplugin;
 datatools::MPIVolumeAggregator::MPIVolumeAggregator(void)
     : AbstractVolumeManipulator("outData", "indata")
     , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
-    , operatorSlot("operator", "the operator to apply to the volume when aggregating") {
+    , operatorSlot("operator", "the operator to apply to the volume when aggregating")
+    , modeSlot("mode", "whether every rank gets the whole volume or only its slab")
+    , brickSizeSlot("brickSize", "edge length of the bricks the volume is reduce-scattered in")
+    , skipEmptySlot("skipEmptyBricks", "do not reduce bricks that are zero on all ranks") {
 
     this->callRequestMpi.SetCompatibleCall<core::cluster::mpi::MpiCallDescription>();
     this->MakeSlotAvailable(&this->callRequestMpi);
@@ -34,6 +132,20 @@ datatools::MPIVolumeAggregator::MPIVolumeAggregator(void)
     ep->SetTypePair(3, "Product");
     this->operatorSlot << ep;
     this->MakeSlotAvailable(&this->operatorSlot);
+
+    auto* mp = new core::param::EnumParam(ALLREDUCE);
+    mp->SetTypePair(ALLREDUCE, "Allreduce");
+    mp->SetTypePair(REDUCE_SCATTER, "Reduce-scatter");
+    mp->SetTypePair(GATHER, "Reduce-scatter + gather");
+    this->modeSlot << mp;
+    this->MakeSlotAvailable(&this->modeSlot);
+
+    // 256^3 floats are the staging memory of one round
+    this->brickSizeSlot << new core::param::IntParam(32, 1, 256);
+    this->MakeSlotAvailable(&this->brickSizeSlot);
+
+    this->skipEmptySlot << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->skipEmptySlot);
 }
 
 
@@ -74,6 +186,7 @@ bool datatools::MPIVolumeAggregator::manipulateData(
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: starting volume aggregation");
     const auto startAllTime = std::chrono::high_resolution_clock::now();
 
+    this->freeMetadata();
     metadata = inData.GetMetadata()->Clone();
     const auto comp = metadata.Components;
 
@@ -89,12 +202,8 @@ bool datatools::MPIVolumeAggregator::manipulateData(
     }
 
     const size_t numFloats = comp * metadata.Resolution[0] * metadata.Resolution[1] * metadata.Resolution[2];
-    // we need a copy of the data since we must not alter it.
-    std::vector<float> tmpVolume;
-    tmpVolume.resize(numFloats);
-    memcpy(tmpVolume.data(), inData.GetData(), numFloats * sizeof(float));
-    // and a copy to receive the result
-    this->theVolume.resize(numFloats);
+    // the input is only read by the reduction, so no copy of it is needed
+    auto const* inVolume = reinterpret_cast<float const*>(inData.GetData());
 
     MPI_Op op = MPI_SUM;
     const auto opVal = this->operatorSlot.Param<core::param::EnumParam>()->Value();
@@ -122,27 +231,89 @@ bool datatools::MPIVolumeAggregator::manipulateData(
         return false;
     }
 
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: starting Allreduce");
-    const auto startTime = std::chrono::high_resolution_clock::now();
-
-    MPI_Allreduce(tmpVolume.data(), this->theVolume.data(), numFloats, MPI_FLOAT, op, this->comm);
-
-    const auto endTime = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<float, std::milli> diffMillis = endTime - startTime;
-
-    const int chunkSize = (numFloats) / this->mpiSize + 1;
+    const auto mode = this->modeSlot.Param<core::param::EnumParam>()->Value();
     float min = std::numeric_limits<float>::max();
     float max = 0.0f;
     float globalmin = min;
     float globalmax = max;
-    const int end = std::min<int>((this->mpiRank + 1) * chunkSize, numFloats);
-    for (int x = this->mpiRank * chunkSize; x < end; x += comp) {
-        auto& d = this->theVolume.data()[x];
-        if (d < min) {
-            min = d;
+
+    if (mode == ALLREDUCE) {
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: starting Allreduce");
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        this->theSlab.clear();
+        this->theSlab.shrink_to_fit();
+        this->theVolume.resize(numFloats);
+
+        // reduce in slabs to keep MPI's internal buffers small and the counts within int range
+        constexpr size_t slabFloats = size_t(1) << 24;
+        for (size_t offset = 0; offset < numFloats; offset += slabFloats) {
+            auto const count = static_cast<int>(std::min(slabFloats, numFloats - offset));
+            MPI_Allreduce(inVolume + offset, this->theVolume.data() + offset, count, MPI_FLOAT, op, this->comm);
+        }
+
+        const auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<float, std::milli> diffMillis = endTime - startTime;
+
+        const int chunkSize = (numFloats) / this->mpiSize + 1;
+        const int end = std::min<int>((this->mpiRank + 1) * chunkSize, numFloats);
+        for (int x = this->mpiRank * chunkSize; x < end; x += comp) {
+            auto& d = this->theVolume.data()[x];
+            if (d < min) {
+                min = d;
+            }
+            if (d > max) {
+                max = d;
+            }
+        }
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: Allreduce of %u x %u x %u volume took %f ms.",
+            metadata.Resolution[0], metadata.Resolution[1], metadata.Resolution[2], diffMillis.count());
+    } else {
+        // a round moves at most max(roundBytes, one brick per rank), its MPI counts and displacements are int
+        BrickGrid const grid(metadata.Resolution, comp,
+            static_cast<size_t>(this->brickSizeSlot.Param<core::param::IntParam>()->Value()));
+        if (grid.BrickFloats() * static_cast<size_t>(this->mpiSize) >
+            static_cast<size_t>(std::numeric_limits<int>::max())) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "MPIVolumeAggregator: bricks of %zu floats on %d ranks exceed the MPI count range, use a smaller "
+                "brick size", grid.BrickFloats(), this->mpiSize);
+            return false;
+        }
+
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: starting Reduce_scatter");
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        const auto active = this->reduceScatter(inVolume, op);
+
+        const auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<float, std::milli> diffMillis = endTime - startTime;
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+            "MPIVolumeAggregator: Reduce_scatter of %u x %u x %u volume took %f ms, slices [%zu, %zu) on rank %d.",
+            metadata.Resolution[0], metadata.Resolution[1], metadata.Resolution[2], diffMillis.count(),
+            this->slabBegin, this->slabEnd, this->mpiRank);
+        if (this->slabEnd <= this->slabBegin) {
+            megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                "MPIVolumeAggregator: rank %d owns no slices, use a smaller brick size", this->mpiRank);
+        }
+
+        // the ghost slice belongs to the next slab
+        const size_t sliceFloats = comp * metadata.Resolution[0] * metadata.Resolution[1];
+        const size_t ownedFloats = (this->slabEnd - this->slabBegin) * sliceFloats;
+        for (size_t x = 0; x < ownedFloats; x += comp) {
+            auto const d = this->theSlab[x];
+            if (d < min) {
+                min = d;
+            }
+            if (d > max) {
+                max = d;
+            }
         }
-        if (d > max) {
-            max = d;
+
+        if (mode == GATHER) {
+            this->gatherSlabs(active);
+        } else {
+            this->theVolume.clear();
+            this->theVolume.shrink_to_fit();
         }
     }
 
@@ -152,12 +323,15 @@ bool datatools::MPIVolumeAggregator::manipulateData(
 
     const auto endAllTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<float, std::milli> diffAllMillis = endAllTime - startAllTime;
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: Allreduce of %u x %u x %u volume took %f ms.",
-        metadata.Resolution[0], metadata.Resolution[1], metadata.Resolution[2], diffMillis.count());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("MPIVolumeAggregator: volume aggregation of %u x %u x %u volume took %f ms.",
         metadata.Resolution[0], metadata.Resolution[1], metadata.Resolution[2], diffAllMillis.count());
 
-    outData.SetData(this->theVolume.data());
+    if ((mode == ALLREDUCE) || ((mode == GATHER) && (this->mpiRank == 0))) {
+        outData.SetData(this->theVolume.data());
+    } else {
+        this->restrictMetadataToSlab();
+        outData.SetData(this->theSlab.data());
+    }
     metadata.MinValues[0] = globalmin;
     metadata.MaxValues[0] = globalmax;
     outData.SetMetadata(&metadata);
@@ -166,6 +340,203 @@ bool datatools::MPIVolumeAggregator::manipulateData(
     return true;
 }
 
+#ifdef WITH_MPI
+/*
+ * datatools::MPIVolumeAggregator::reduceScatter
+ */
+std::vector<std::vector<size_t>> datatools::MPIVolumeAggregator::reduceScatter(float const* inVolume, MPI_Op op) {
+    BrickGrid const grid(this->metadata.Resolution, this->metadata.Components,
+        static_cast<size_t>(this->brickSizeSlot.Param<core::param::IntParam>()->Value()));
+    size_t const brickFloats = grid.BrickFloats();
+    size_t const sliceFloats = grid.SliceFloats();
+    auto const bricks = static_cast<int64_t>(grid.Bricks());
+
+    // a brick that is zero on every rank stays zero under every operator
+    std::vector<unsigned char> set(grid.Bricks(), 1);
+    if (this->skipEmptySlot.Param<core::param::BoolParam>()->Value()) {
+#pragma omp parallel for
+        for (int64_t b = 0; b < bricks; ++b) {
+            set[b] = grid.IsSet(inVolume, 0, static_cast<size_t>(b)) ? 1 : 0;
+        }
+        MPI_Allreduce(MPI_IN_PLACE, set.data(), static_cast<int>(set.size()), MPI_UNSIGNED_CHAR, MPI_MAX, this->comm);
+    }
+
+    std::vector<std::vector<size_t>> active(this->mpiSize);
+    size_t maxActive = 0;
+    for (int r = 0; r < this->mpiSize; ++r) {
+        size_t const end = grid.FirstLayer(r + 1, this->mpiSize) * grid.LayerBricks();
+        for (size_t b = grid.FirstLayer(r, this->mpiSize) * grid.LayerBricks(); b < end; ++b) {
+            if (set[b] != 0) active[r].push_back(b);
+        }
+        maxActive = std::max(maxActive, active[r].size());
+    }
+
+    // the following slab provides one ghost slice, so the slab can be sampled up to its border
+    this->slabBegin = grid.FirstSlice(this->mpiRank, this->mpiSize);
+    this->slabEnd = grid.FirstSlice(this->mpiRank + 1, this->mpiSize);
+    int next = -1, prev = -1;
+    if (this->slabEnd > this->slabBegin) {
+        for (int r = this->mpiRank + 1; (r < this->mpiSize) && (next < 0); ++r) {
+            if (grid.FirstSlice(r + 1, this->mpiSize) > grid.FirstSlice(r, this->mpiSize)) next = r;
+        }
+        for (int r = this->mpiRank - 1; (r >= 0) && (prev < 0); --r) {
+            if (grid.FirstSlice(r + 1, this->mpiSize) > grid.FirstSlice(r, this->mpiSize)) prev = r;
+        }
+    }
+    this->slabSlices = this->slabEnd - this->slabBegin + ((next >= 0) ? 1 : 0);
+    this->theSlab.assign(this->slabSlices * sliceFloats, 0.0f);
+
+    // reduce the bricks in rounds, every rank receiving up to 'perRound' bricks per round
+    size_t const perRound =
+        std::max<size_t>(1, roundBytes / (sizeof(float) * brickFloats * static_cast<size_t>(this->mpiSize)));
+    std::vector<float> send;
+    std::vector<float> recv(perRound * brickFloats);
+    std::vector<int> counts(this->mpiSize);
+    std::vector<std::pair<size_t, size_t>> jobs; // brick, offset in 'send'
+    for (size_t first = 0; first < maxActive; first += perRound) {
+        jobs.clear();
+        for (int r = 0; r < this->mpiSize; ++r) {
+            size_t const n = (active[r].size() > first) ? std::min(perRound, active[r].size() - first) : 0;
+            counts[r] = static_cast<int>(n * brickFloats);
+            for (size_t j = 0; j < n; ++j) {
+                jobs.emplace_back(active[r][first + j], jobs.size() * brickFloats);
+            }
+        }
+        send.resize(jobs.size() * brickFloats);
+#pragma omp parallel for
+        for (int64_t j = 0; j < static_cast<int64_t>(jobs.size()); ++j) {
+            grid.Pack(inVolume, 0, jobs[j].first, send.data() + jobs[j].second);
+        }
+
+        MPI_Reduce_scatter(send.data(), recv.data(), counts.data(), MPI_FLOAT, op, this->comm);
+
+        auto const& mine = active[this->mpiRank];
+        auto const received = static_cast<int64_t>(counts[this->mpiRank] / brickFloats);
+#pragma omp parallel for
+        for (int64_t j = 0; j < received; ++j) {
+            grid.Unpack(recv.data() + j * brickFloats, mine[first + j], this->theSlab.data(), this->slabBegin);
+        }
+    }
+
+    MPI_Request requests[2];
+    int numRequests = 0;
+    if (next >= 0) {
+        MPI_Irecv(this->theSlab.data() + (this->slabEnd - this->slabBegin) * sliceFloats,
+            static_cast<int>(sliceFloats), MPI_FLOAT, next, 0, this->comm, &requests[numRequests++]);
+    }
+    if (prev >= 0) {
+        MPI_Isend(this->theSlab.data(), static_cast<int>(sliceFloats), MPI_FLOAT, prev, 0, this->comm,
+            &requests[numRequests++]);
+    }
+    MPI_Waitall(numRequests, requests, MPI_STATUSES_IGNORE);
+
+    return active;
+}
+
+
+/*
+ * datatools::MPIVolumeAggregator::gatherSlabs
+ */
+void datatools::MPIVolumeAggregator::gatherSlabs(std::vector<std::vector<size_t>> const& active) {
+    BrickGrid const grid(this->metadata.Resolution, this->metadata.Components,
+        static_cast<size_t>(this->brickSizeSlot.Param<core::param::IntParam>()->Value()));
+    size_t const brickFloats = grid.BrickFloats();
+    bool const isRoot = (this->mpiRank == 0);
+
+    if (isRoot) {
+        this->theVolume.assign(grid.SliceFloats() * grid.res[2], 0.0f);
+    } else {
+        this->theVolume.clear();
+        this->theVolume.shrink_to_fit();
+    }
+
+    size_t maxActive = 0;
+    for (auto const& a : active) {
+        maxActive = std::max(maxActive, a.size());
+    }
+
+    size_t const perRound =
+        std::max<size_t>(1, roundBytes / (sizeof(float) * brickFloats * static_cast<size_t>(this->mpiSize)));
+    auto const& mine = active[this->mpiRank];
+    std::vector<float> send(perRound * brickFloats);
+    std::vector<float> recv(isRoot ? perRound * brickFloats * this->mpiSize : 0);
+    std::vector<int> counts(this->mpiSize), displs(this->mpiSize);
+    std::vector<std::pair<size_t, size_t>> jobs; // brick, offset in 'recv'
+    for (size_t first = 0; first < maxActive; first += perRound) {
+        jobs.clear();
+        for (int r = 0; r < this->mpiSize; ++r) {
+            size_t const n = (active[r].size() > first) ? std::min(perRound, active[r].size() - first) : 0;
+            counts[r] = static_cast<int>(n * brickFloats);
+            displs[r] = static_cast<int>(jobs.size() * brickFloats);
+            for (size_t j = 0; j < n; ++j) {
+                jobs.emplace_back(active[r][first + j], jobs.size() * brickFloats);
+            }
+        }
+
+        auto const sent = static_cast<int64_t>(counts[this->mpiRank] / brickFloats);
+#pragma omp parallel for
+        for (int64_t j = 0; j < sent; ++j) {
+            grid.Pack(this->theSlab.data(), this->slabBegin, mine[first + j], send.data() + j * brickFloats);
+        }
+
+        MPI_Gatherv(send.data(), counts[this->mpiRank], MPI_FLOAT, recv.data(), counts.data(), displs.data(),
+            MPI_FLOAT, 0, this->comm);
+
+        if (isRoot) {
+#pragma omp parallel for
+            for (int64_t j = 0; j < static_cast<int64_t>(jobs.size()); ++j) {
+                grid.Unpack(recv.data() + jobs[j].second, jobs[j].first, this->theVolume.data(), 0);
+            }
+        }
+    }
+}
+#endif /* WITH_MPI */
+
+
+/*
+ * datatools::MPIVolumeAggregator::restrictMetadataToSlab
+ */
+void datatools::MPIVolumeAggregator::restrictMetadataToSlab(void) {
+    auto& md = this->metadata;
+    if ((md.GridType == core::misc::RECTILINEAR) && !md.IsUniform[2]) {
+        float offset = 0.0f;
+        for (size_t z = 0; z < this->slabBegin; ++z) {
+            offset += md.SliceDists[2][z];
+        }
+        auto* dists = new float[std::max<size_t>(this->slabSlices, 1) - 1];
+        float extent = 0.0f;
+        for (size_t z = 0; z + 1 < this->slabSlices; ++z) {
+            dists[z] = md.SliceDists[2][this->slabBegin + z];
+            extent += dists[z];
+        }
+        delete[] md.SliceDists[2];
+        md.SliceDists[2] = dists;
+        md.Origin[2] += offset;
+        md.Extents[2] = extent;
+    } else {
+        auto const dist = md.SliceDists[2][0];
+        md.Origin[2] += static_cast<float>(this->slabBegin) * dist;
+        md.Extents[2] = static_cast<float>(std::max<size_t>(this->slabSlices, 1) - 1) * dist;
+    }
+    md.Resolution[2] = this->slabSlices;
+}
+
+
+/*
+ * datatools::MPIVolumeAggregator::freeMetadata
+ */
+void datatools::MPIVolumeAggregator::freeMetadata(void) {
+    delete[] this->metadata.MinValues;
+    delete[] this->metadata.MaxValues;
+    this->metadata.MinValues = nullptr;
+    this->metadata.MaxValues = nullptr;
+    for (int d = 0; d < 3; ++d) {
+        delete[] this->metadata.SliceDists[d];
+        this->metadata.SliceDists[d] = nullptr;
+    }
+}
+
+
 bool datatools::MPIVolumeAggregator::initMPI() {
     bool retval = false;
 #ifdef WITH_MPI
@@ -201,9 +572,5 @@ bool datatools::MPIVolumeAggregator::initMPI() {
 }
 
 void datatools::MPIVolumeAggregator::release() {
-    delete[] this->metadata.MinValues;
-    delete[] this->metadata.MaxValues;
-    delete[] this->metadata.SliceDists[0];
-    delete[] this->metadata.SliceDists[1];
-    delete[] this->metadata.SliceDists[2];
+    this->freeMetadata();
 }
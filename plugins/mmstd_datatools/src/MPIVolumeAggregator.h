@@ -13,6 +13,7 @@
 
 #include "mmstd_datatools/AbstractVolumeManipulator.h"
 #include "mmcore/param/ParamSlot.h"
+#include <vector>
 
 #ifdef WITH_MPI
 #include "mpi.h"
@@ -27,6 +28,13 @@ namespace datatools {
      * This should be used for gathering large in situ SUBSAMPLED (ParticleThinner) data sets:
      * Everything is collected at once and MPI cannot push that much data
      * at once.
+     *
+     * Besides reducing the whole volume on every rank, the volume can be
+     * reduce-scattered: it is split into cubic bricks, every rank owns a
+     * slab of brick layers along z and only receives the reduced bricks of
+     * its slab. Each rank then provides its slab (plus one ghost slice) for
+     * sort-last rendering, or the slabs are gathered brick by brick on rank
+     * 0. Bricks that are zero on all ranks can be skipped entirely.
      */
     class MPIVolumeAggregator : public AbstractVolumeManipulator {
     public:
@@ -76,6 +84,29 @@ namespace datatools {
 
     private:
 
+        enum modeEnum {
+            ALLREDUCE = 0,      //< every rank gets the whole volume
+            REDUCE_SCATTER = 1, //< every rank gets its slab
+            GATHER = 2          //< every rank gets its slab, rank 0 the whole volume
+        };
+
+#ifdef WITH_MPI
+        /**
+         * Reduces the bricks of the slab this rank owns into 'theSlab', see
+         * modeEnum::REDUCE_SCATTER. Answers the bricks reduced for every rank.
+         */
+        std::vector<std::vector<size_t>> reduceScatter(float const* inVolume, MPI_Op op);
+
+        /** Collects the reduced bricks of all slabs in 'theVolume' on rank 0 */
+        void gatherSlabs(std::vector<std::vector<size_t>> const& active);
+#endif /* WITH_MPI */
+
+        /** Restricts 'metadata' to the slab owned by this rank */
+        void restrictMetadataToSlab(void);
+
+        /** Frees the arrays of 'metadata' */
+        void freeMetadata(void);
+
 #ifdef WITH_MPI
         /** The communicator that the view uses. */
         MPI_Comm comm = MPI_COMM_NULL;
@@ -86,12 +117,24 @@ namespace datatools {
 
         core::param::ParamSlot operatorSlot;
 
+        core::param::ParamSlot modeSlot;
+
+        core::param::ParamSlot brickSizeSlot;
+
+        core::param::ParamSlot skipEmptySlot;
+
         core::misc::VolumetricDataCall::Metadata metadata;
 
         int mpiRank = 0;
         int mpiSize = 0;
 
         std::vector<float> theVolume;
+
+        /** The slab of this rank in reduce-scatter modes, z slices [slabBegin, slabEnd) plus a ghost slice */
+        std::vector<float> theSlab;
+        size_t slabBegin = 0;
+        size_t slabEnd = 0;
+        size_t slabSlices = 0;
     };
 
 } /* end namespace datatools */
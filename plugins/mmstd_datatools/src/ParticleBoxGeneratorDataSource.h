@@ -63,6 +63,16 @@ namespace datatools {
         /** Dtor. */
 		virtual ~ParticleBoxGeneratorDataSource(void);
 
+		/**
+		 * The particles are generated on the CPU, so the callbacks may be
+		 * re-issued from a prefetch thread of the graph.
+		 *
+		 * @return 'true'
+		 */
+		bool IsThreadSafe(void) const override {
+			return true;
+		}
+
     protected:
 
         /**
@@ -1,10 +1,11 @@
 #include "stdafx.h"
 #include "ParticleIdentitySort.h"
+#include "ParticleRadixSort.h"
 #include <numeric>
 
 
 megamol::stdplugin::datatools::ParticleIdentitySort::ParticleIdentitySort(void)
-    : AbstractParticleManipulator("outData", "indata") {}
+    : AbstractParticleManipulator("outData", "indata"), frameID_(0), dataHash_(0) {}
 
 
 megamol::stdplugin::datatools::ParticleIdentitySort::~ParticleIdentitySort(void) { this->Release(); };
@@ -13,6 +14,7 @@ megamol::stdplugin::datatools::ParticleIdentitySort::~ParticleIdentitySort(void)
 bool megamol::stdplugin::datatools::ParticleIdentitySort::manipulateData(
     megamol::core::moldyn::MultiParticleDataCall& outData, megamol::core::moldyn::MultiParticleDataCall& inData) {
     using megamol::core::moldyn::MultiParticleDataCall;
+    using megamol::core::moldyn::SimpleSphericalParticles;
 
     outData = inData; // also transfers the unlocker to 'outData'
 
@@ -20,83 +22,77 @@ bool megamol::stdplugin::datatools::ParticleIdentitySort::manipulateData(
                                         // original data will be unlocked through outData
 
     auto const plc = outData.GetParticleListCount();
-    this->data_.clear();
+
+    // renderers ask for the same frame over and over, only sort when the input changed
+    bool const resort = (inData.DataHash() == 0) || (inData.DataHash() != this->dataHash_) ||
+                        (inData.FrameID() != this->frameID_) || (this->data_.size() != plc);
+    this->frameID_ = inData.FrameID();
+    this->dataHash_ = inData.DataHash();
+    if (resort) {
+        this->data_.assign(plc, nullptr);
+        this->perms_.resize(plc);
+    }
+
     for (unsigned int i = 0; i < plc; ++i) {
         auto& p = outData.AccessParticles(i);
 
-        if (p.GetIDDataType() == core::moldyn::SimpleSphericalParticles::IDDATA_NONE) {
-            megamol::core::utility::log::Log::DefaultLog.WriteWarn("ParticleIdentitySort: Particlelist %d has no indentity array\n", i);
+        if (p.GetIDDataType() == SimpleSphericalParticles::IDDATA_NONE) {
+            if (resort) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleIdentitySort: Particlelist %d has no indentity array\n", i);
+                this->perms_[i].clear();
+            }
             continue;
         }
 
-        this->data_.emplace_back();
-        auto& dlist = this->data_.back();
-
-        auto vs = p.GetVertexDataStride();
-        auto cs = p.GetColourDataStride();
-        auto is = p.GetIDDataStride();
-
-        auto avs = vs;
-        auto acs = cs;
-        auto ais = is;
-
-        auto const vp = reinterpret_cast<char const* const>(p.GetVertexData());
-        auto const cp = reinterpret_cast<char const* const>(p.GetColourData());
-        auto const ip = reinterpret_cast<char const* const>(p.GetIDData());
-
-        auto ts = vs;
-
-        bool const sep = (vs == 0) || (cs == 0) || (is == 0);
-
-        if (sep) {
-            vs = core::moldyn::SimpleSphericalParticles::VertexDataSize[p.GetVertexDataType()];
-            cs = core::moldyn::SimpleSphericalParticles::ColorDataSize[p.GetColourDataType()];
-            is = core::moldyn::SimpleSphericalParticles::IDDataSize[p.GetIDDataType()];
-
-            ts = vs + cs + is;
-
-            // sep = true;
-        }
-
-        auto const cnt = p.GetCount();
-
-        std::vector<size_t> keys(cnt);
-        std::iota(keys.begin(), keys.end(), 0);
-
-        auto const& iAcc = p.GetParticleStore().GetIDAcc();
-
-        std::sort(keys.begin(), keys.end(),
-            [&iAcc](auto const& a, auto const& b) -> bool { return iAcc->Get_u64(a) < iAcc->Get_u64(b); });
-
-        dlist.resize(cnt * ts);
-
-        auto const basePtr = dlist.data();
-
-        if (sep) {
-            for (size_t pidx = 0; pidx < cnt; ++pidx) {
-                auto const sidx = keys[pidx];
-                memcpy(basePtr + ts * pidx, vp + sidx * avs, vs);
-                memcpy(basePtr + ts * pidx + vs, cp + sidx * acs, cs);
-                memcpy(basePtr + ts * pidx + vs + cs, ip + sidx * ais, is);
-
-                /*auto const didx = iAcc->Get_u64(pidx);
-                memcpy(basePtr + ts * didx, vp, vs);
-                memcpy(basePtr + ts * didx + vs, cp, cs);
-                memcpy(basePtr + ts * didx + vs + cs, ip, is);*/
+        // the sorted list is stored packed, one record per particle
+        size_t const vs = SimpleSphericalParticles::VertexDataSize[p.GetVertexDataType()];
+        size_t const cs = SimpleSphericalParticles::ColorDataSize[p.GetColourDataType()];
+        size_t const ds = SimpleSphericalParticles::DirDataSize[p.GetDirDataType()];
+        size_t const is = SimpleSphericalParticles::IDDataSize[p.GetIDDataType()];
+        size_t const ts = vs + cs + ds + is;
+
+        if (resort || (this->data_[i] == nullptr)) {
+            auto const cnt = static_cast<size_t>(p.GetCount());
+            auto const& iAcc = p.GetParticleStore().GetIDAcc();
+            auto& perm = this->perms_[i];
+
+            // with mostly stable ordering the last permutation (nearly) sorts this frame as well
+            std::vector<uint64_t> keys(cnt);
+            if (perm.size() != cnt) {
+                perm.resize(cnt);
+                std::iota(perm.begin(), perm.end(), 0);
             }
-        } else {
-            for (size_t pidx = 0; pidx < cnt; ++pidx) {
-                auto const sidx = keys[pidx];
-                memcpy(basePtr + ts * pidx, vp + sidx * ts, ts);
-
-                /*auto const didx = iAcc->Get_u64(pidx);
-                memcpy(basePtr + ts * didx, vp, ts);*/
+#pragma omp parallel for
+            for (int64_t pidx = 0; pidx < static_cast<int64_t>(cnt); ++pidx) {
+                keys[pidx] = iAcc->Get_u64(perm[pidx]);
             }
+            if (!IsSorted(keys)) {
+                RadixSort(keys, perm);
+            }
+
+            // a fresh buffer per frame, downstream modules may still share the previous one
+            this->data_[i] = std::make_shared<std::vector<char>>(cnt * ts);
+
+            std::vector<GatherStream> streams;
+            auto const addStream = [&streams](void const* ptr, unsigned int stride, size_t size, size_t offset) {
+                if (size > 0) streams.push_back({ptr, (stride == 0) ? size : stride, size, offset});
+            };
+            addStream(p.GetVertexData(), p.GetVertexDataStride(), vs, 0);
+            addStream(p.GetColourData(), p.GetColourDataStride(), cs, vs);
+            addStream(p.GetDirData(), p.GetDirDataStride(), ds, vs + cs);
+            addStream(p.GetIDData(), p.GetIDDataStride(), is, vs + cs + ds);
+            GatherStreams(this->data_[i]->data(), ts, streams, perm.data(), cnt);
         }
 
-        p.SetVertexData(p.GetVertexDataType(), basePtr, ts);
-        p.SetColourData(p.GetColourDataType(), basePtr + vs, ts);
-        p.SetIDData(p.GetIDDataType(), basePtr + vs + cs, ts);
+        if (this->data_[i]->empty()) continue;
+        auto const basePtr = this->data_[i]->data();
+        p.SetVertexData(p.GetVertexDataType(), basePtr, static_cast<unsigned int>(ts), this->data_[i]);
+        p.SetColourData(p.GetColourDataType(), basePtr + vs, static_cast<unsigned int>(ts), this->data_[i]);
+        if (ds > 0) {
+            p.SetDirData(p.GetDirDataType(), basePtr + vs + cs, static_cast<unsigned int>(ts), this->data_[i]);
+        }
+        p.SetIDData(p.GetIDDataType(), basePtr + vs + cs + ds, static_cast<unsigned int>(ts), this->data_[i]);
     }
     return true;
 }
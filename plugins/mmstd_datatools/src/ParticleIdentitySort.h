@@ -48,7 +48,15 @@ namespace datatools {
 
     private:
 
-        std::vector<std::vector<char>> data_;
+        /** Per list, the sorted particles, nullptr for lists without identity */
+        std::vector<std::shared_ptr<std::vector<char>>> data_;
+
+        /** Per list, the sort permutation of the last frame, tried first for the next one */
+        std::vector<std::vector<uint64_t>> perms_;
+
+        /** Frame and hash of the input 'data_' was sorted from */
+        unsigned int frameID_;
+        size_t dataHash_;
     };
 
 } /* end namespace datatools */
@@ -0,0 +1,131 @@
+/*
+ * ParticleRadixSort.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "ParticleRadixSort.h"
+
+#include <algorithm>
+#include <cassert>
+#include <omp.h>
+
+using namespace megamol::stdplugin;
+
+namespace {
+
+/** Number of bits sorted per pass */
+constexpr unsigned int digitBits = 8;
+
+/** Number of different digits */
+constexpr size_t digitCount = size_t(1) << digitBits;
+
+/** Minimal number of keys handled by one block */
+constexpr size_t minBlockSize = 1 << 16;
+
+/** Answers the number of blocks 'cnt' keys are split into, one per thread at most */
+int blockCountFor(size_t cnt) {
+    return static_cast<int>(
+        std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(omp_get_max_threads()), cnt / minBlockSize)));
+}
+
+} // namespace
+
+/*
+ * datatools::RadixSort
+ */
+void datatools::RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& values) {
+    assert(keys.size() == values.size());
+    size_t const cnt = keys.size();
+    if (cnt < 2) return;
+
+    // the blocks keep their position for all passes, so the scatter stays stable
+    int const blocks = blockCountFor(cnt);
+    auto const blockBegin = [cnt, blocks](int b) { return cnt * static_cast<size_t>(b) / blocks; };
+
+    std::vector<uint64_t> blockMax(blocks, 0);
+#pragma omp parallel for
+    for (int b = 0; b < blocks; ++b) {
+        uint64_t m = 0;
+        for (size_t i = blockBegin(b), e = blockBegin(b + 1); i < e; ++i) {
+            m = std::max(m, keys[i]);
+        }
+        blockMax[b] = m;
+    }
+    uint64_t const maxKey = *std::max_element(blockMax.begin(), blockMax.end());
+
+    std::vector<uint64_t> keysTmp;
+    std::vector<uint64_t> valuesTmp;
+    std::vector<size_t> hist(static_cast<size_t>(blocks) * digitCount);
+
+    for (unsigned int shift = 0; (shift < 64) && ((maxKey >> shift) != 0); shift += digitBits) {
+        std::fill(hist.begin(), hist.end(), 0);
+#pragma omp parallel for
+        for (int b = 0; b < blocks; ++b) {
+            size_t* h = hist.data() + static_cast<size_t>(b) * digitCount;
+            for (size_t i = blockBegin(b), e = blockBegin(b + 1); i < e; ++i) {
+                ++h[(keys[i] >> shift) & (digitCount - 1)];
+            }
+        }
+
+        // a digit shared by all keys does not change the order
+        bool shared = false;
+        for (size_t d = 0; (d < digitCount) && !shared; ++d) {
+            size_t total = 0;
+            for (int b = 0; b < blocks; ++b) total += hist[static_cast<size_t>(b) * digitCount + d];
+            shared = (total == cnt);
+        }
+        if (shared) continue;
+
+        // digit-major prefix sums, every block writes behind the lower blocks with the same digit
+        size_t sum = 0;
+        for (size_t d = 0; d < digitCount; ++d) {
+            for (int b = 0; b < blocks; ++b) {
+                size_t& h = hist[static_cast<size_t>(b) * digitCount + d];
+                size_t const c = h;
+                h = sum;
+                sum += c;
+            }
+        }
+
+        keysTmp.resize(cnt);
+        valuesTmp.resize(cnt);
+#pragma omp parallel for
+        for (int b = 0; b < blocks; ++b) {
+            size_t* h = hist.data() + static_cast<size_t>(b) * digitCount;
+            for (size_t i = blockBegin(b), e = blockBegin(b + 1); i < e; ++i) {
+                size_t const dst = h[(keys[i] >> shift) & (digitCount - 1)]++;
+                keysTmp[dst] = keys[i];
+                valuesTmp[dst] = values[i];
+            }
+        }
+        keys.swap(keysTmp);
+        values.swap(valuesTmp);
+    }
+}
+
+/*
+ * datatools::IsSorted
+ */
+bool datatools::IsSorted(std::vector<uint64_t> const& keys) {
+    size_t const cnt = keys.size();
+    if (cnt < 2) return true;
+
+    int const blocks = blockCountFor(cnt);
+    std::vector<char> sorted(blocks, 1);
+#pragma omp parallel for
+    for (int b = 0; b < blocks; ++b) {
+        // every block also compares its first key with the last key of the previous block
+        size_t const first = std::max<size_t>(cnt * static_cast<size_t>(b) / blocks, 1);
+        size_t const last = cnt * static_cast<size_t>(b + 1) / blocks;
+        for (size_t i = first; i < last; ++i) {
+            if (keys[i - 1] > keys[i]) {
+                sorted[b] = 0;
+                break;
+            }
+        }
+    }
+    return std::find(sorted.begin(), sorted.end(), 0) == sorted.end();
+}
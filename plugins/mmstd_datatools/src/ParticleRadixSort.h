@@ -0,0 +1,78 @@
+/*
+ * ParticleRadixSort.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_PARTICLERADIXSORT_H_INCLUDED
+#define MMSTD_DATATOOLS_PARTICLERADIXSORT_H_INCLUDED
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+/**
+ * Sorts 'keys' ascending with a parallel LSD radix sort on 8-bit digits and
+ * applies the same permutation to 'values'. The sort is stable. Digits above
+ * the largest key and digits all keys share are skipped, so 32-bit particle
+ * IDs never take more than four passes.
+ *
+ * @param keys   The keys, sorted on return.
+ * @param values The payload, usually particle indices. Must have the same
+ *               size as 'keys'.
+ */
+void RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& values);
+
+/**
+ * Answers whether 'keys' is sorted ascending, checked in parallel.
+ *
+ * @param keys The keys to test.
+ *
+ * @return true if no key is larger than its successor.
+ */
+bool IsSorted(std::vector<uint64_t> const& keys);
+
+/** One attribute stream gathered by GatherStreams */
+struct GatherStream {
+    const void* src;    //< the first element of the source stream
+    size_t srcStride;   //< distance of the source elements in bytes
+    size_t size;        //< size of one element in bytes
+    size_t dstOffset;   //< offset of the element in the destination record
+};
+
+/**
+ * Gathers the elements 'perm[0..cnt)' of all 'streams' into 'dst' in
+ * parallel. Each destination record holds one element of every stream and
+ * records are 'dstStride' bytes apart.
+ *
+ * @param dst       The destination buffer, at least cnt * dstStride bytes.
+ * @param dstStride Distance of the destination records in bytes.
+ * @param streams   The streams to gather.
+ * @param perm      The source index of every destination record, nullptr
+ *                  to copy the first 'cnt' elements in order.
+ * @param cnt       The number of records.
+ */
+template <class I>
+void GatherStreams(void* dst, size_t dstStride, std::vector<GatherStream> const& streams, I const* perm, size_t cnt) {
+    auto const base = static_cast<char*>(dst);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+        char* rec = base + static_cast<size_t>(i) * dstStride;
+        size_t const sidx = (perm != nullptr) ? static_cast<size_t>(perm[i]) : static_cast<size_t>(i);
+        for (auto const& s : streams) {
+            ::memcpy(rec + s.dstOffset, static_cast<const char*>(s.src) + sidx * s.srcStride, s.size);
+        }
+    }
+}
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MMSTD_DATATOOLS_PARTICLERADIXSORT_H_INCLUDED */
@@ -6,6 +6,7 @@
  */
 #include "stdafx.h"
 #include "ParticleSortFixHack.h"
+#include "ParticleRadixSort.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/BoolParam.h"
 #include <cstdint>
@@ -537,21 +538,15 @@ void datatools::ParticleSortFixHack::updateData(
     data.resize(inData.GetParticleListCount());
 
     for (unsigned int i = 0; i < static_cast<unsigned int>(data.size()); i++) {
-        copyData(data[i], inData.AccessParticles(i));
-        vislib::RawStorage td(data[i].dat.GetSize());
-        ::memcpy(td, data[i].dat, data[i].dat.GetSize());
-        unsigned int ps = data[i].parts.GetVertexDataStride();
-        int pc = static_cast<int>(data[i].parts.GetCount());
-#pragma omp parallel for
-        for (int pi = 0; pi < pc; ++pi) {
-            ::memcpy(data[i].dat.At(pi * ps), td.At(ids[inData.FrameID()][i][pi] * ps), ps);
-        }
+        // gather the particles of this frame in the order of the first one
+        copyData(data[i], inData.AccessParticles(i), ids[inData.FrameID()][i].data());
     }
 
     outDataTime = inData.FrameID();
 }
 
-void datatools::ParticleSortFixHack::copyData(particle_data& tar, core::moldyn::SimpleSphericalParticles& src) {
+void datatools::ParticleSortFixHack::copyData(
+        particle_data& tar, core::moldyn::SimpleSphericalParticles& src, const unsigned int* perm) {
     tar.parts = src;
 
     const unsigned char* colPtr = static_cast<const unsigned char*>(src.GetColourData());
@@ -588,13 +583,10 @@ void datatools::ParticleSortFixHack::copyData(particle_data& tar, core::moldyn::
     tar.parts.SetVertexData(src.GetVertexDataType(), tar.dat.At(0), colSize + vertSize);
     tar.parts.SetColourData(src.GetColourDataType(), tar.dat.At(vertSize), colSize + vertSize);
 
-    for (UINT64 pi = 0; pi < tar.parts.GetCount(); ++pi) {
-        ::memcpy(tar.dat.At(static_cast<size_t>(pi * (colSize + vertSize) + 0)), vertPtr, vertSize);
-        vertPtr += vertStride;
-        ::memcpy(tar.dat.At(static_cast<size_t>(pi * (colSize + vertSize) + vertSize)), colPtr, colSize);
-        colPtr += colStride;
-    }
-
+    std::vector<GatherStream> streams;
+    if (vertSize > 0) streams.push_back({vertPtr, vertStride, vertSize, 0});
+    if (colSize > 0) streams.push_back({colPtr, colStride, colSize, vertSize});
+    GatherStreams(tar.dat.As<char>(), colSize + vertSize, streams, perm, static_cast<size_t>(tar.parts.GetCount()));
 }
 
 double datatools::ParticleSortFixHack::part_sqdist(const float *p1, const float *p2, const vislib::math::Dimension<float, 3>& bboxsize) {
@@ -82,7 +82,8 @@ namespace datatools {
 
         bool updateIDdata(megamol::core::moldyn::MultiParticleDataCall& inData);
         void updateData(megamol::core::moldyn::MultiParticleDataCall& inData);
-        void copyData(particle_data& tar, core::moldyn::SimpleSphericalParticles& src);
+        void copyData(particle_data& tar, core::moldyn::SimpleSphericalParticles& src,
+            const unsigned int* perm = nullptr);
 
         double part_sqdist(const float *p1, const float *p2, const vislib::math::Dimension<float, 3>& bboxsize);
 
@@ -8,11 +8,13 @@
 #include "ParticleThermodyn.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cfloat>
 #include <cfenv>
 #include <cstdint>
 #include <limits>
+#include <numeric>
 #include <omp.h>
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
@@ -53,7 +55,6 @@ datatools::ParticleThermodyn::ParticleThermodyn(void)
     , lastTime(-1)
     , newColors()
     , allParts()
-    , maxDist(0.0f)
     , particleTree(nullptr)
     , myPts(nullptr)
     , outDataSlot("outData", "Provides intensities based on a local particle metric")
@@ -191,7 +192,6 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
     const unsigned int time = out->FrameID();
     unsigned int plc = in->GetParticleListCount();
     float theRadius = this->radiusSlot.Param<core::param::FloatParam>()->Value();
-    float theSquaredRadius = theRadius * theRadius;
     const float theMass = this->massSlot.Param<core::param::FloatParam>()->Value();
     const float theFreedom = this->freedomSlot.Param<core::param::FloatParam>()->Value();
     const int theNumber = this->numNeighborSlot.Param<core::param::IntParam>()->Value();
@@ -208,12 +208,23 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
             return false;
         }
 
+        this->datahash = in->DataHash();
+        this->lastTime = time;
+        this->particleTree.reset();
+    }
+
+    // the metric decides which lists can be used, only a different selection requires a new search structure
+    plc = in->GetParticleListCount();
+    std::vector<bool> usedLists(plc);
+    for (unsigned int i = 0; i < plc; i++) {
+        usedLists[i] = isListOK(in, i) && isDirOK(static_cast<metricsEnum>(theMetrics), in, i);
+    }
+
+    if (this->particleTree == nullptr || usedLists != this->lists) {
         size_t totalParts = 0;
-        plc = in->GetParticleListCount();
 
         for (unsigned int i = 0; i < plc; i++) {
-            if (isListOK(in, i) && isDirOK(static_cast<metricsEnum>(theMetrics), in, i))
-                totalParts += in->AccessParticles(i).GetCount();
+            if (usedLists[i]) totalParts += in->AccessParticles(i).GetCount();
         }
 
         if (theSearchType == searchTypeEnum::RADIUS) {
@@ -229,20 +240,13 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         allpartcnt = 0;
         for (unsigned int pli = 0; pli < plc; pli++) {
             auto& pl = in->AccessParticles(pli);
-            if (!isListOK(in, pli) || !isDirOK(static_cast<metricsEnum>(theMetrics), in, pli)) {
+            if (!usedLists[pli]) {
                 megamol::core::utility::log::Log::DefaultLog.WriteWarn(
                     "ParticleThermodyn: ignoring list %d because it either has no proper positions or no velocity",
                     pli);
                 continue;
             }
 
-            // unsigned int vert_stride = 0;
-            // if (pl.GetVertexDataType() == DirectionalParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZ)
-            // vert_stride = 12; else if (pl.GetVertexDataType() ==
-            // DirectionalParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZR) vert_stride = 16; else
-            // continue; vert_stride = std::max<unsigned int>(vert_stride, pl.GetVertexDataStride()); const unsigned char
-            // *vert = static_cast<const unsigned char*>(pl.GetVertexData());
-
             UINT64 part_cnt = pl.GetCount();
 
             for (int part_i = 0; part_i < part_cnt; ++part_i) {
@@ -261,26 +265,36 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         particleTree->buildIndex();
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
 
-        this->datahash = in->DataHash();
-        this->lastTime = time;
-        this->radiusSlot.ForceSetDirty();
+        this->lists = usedLists;
+        this->neighborsValid = false;
     }
 
-    if (this->radiusSlot.IsDirty() || this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() ||
-        this->cyclZSlot.IsDirty() || this->numNeighborSlot.IsDirty() || this->searchTypeSlot.IsDirty() ||
-        this->metricsSlot.IsDirty() || this->removeSelfSlot.IsDirty() || this->findExtremesSlot.IsDirty() ||
+    auto bbox = in->AccessBoundingBoxes().ObjectSpaceBBox();
+    // bbox.EnforcePositiveSize(); // paranoia
+
+    // the neighborhoods only depend on the search parameters, the metrics are computed from the cached lists
+    const bool searchDirty = !this->neighborsValid || this->radiusSlot.IsDirty() || this->cyclXSlot.IsDirty() ||
+                             this->cyclYSlot.IsDirty() || this->cyclZSlot.IsDirty() ||
+                             this->numNeighborSlot.IsDirty() || this->searchTypeSlot.IsDirty() ||
+                             this->removeSelfSlot.IsDirty();
+    if (searchDirty) {
+        if (!this->searchNeighbors(bbox)) return false;
+        this->neighborsValid = true;
+
+        this->radiusSlot.ResetDirty();
+        this->cyclXSlot.ResetDirty();
+        this->cyclYSlot.ResetDirty();
+        this->cyclZSlot.ResetDirty();
+        this->numNeighborSlot.ResetDirty();
+        this->searchTypeSlot.ResetDirty();
+        this->removeSelfSlot.ResetDirty();
+    }
+
+    if (searchDirty || this->metricsSlot.IsDirty() || this->findExtremesSlot.IsDirty() ||
         this->extremeValueSlot.IsDirty() || this->fluidDensitySlot.IsDirty()) {
         allpartcnt = 0;
         ++myHash;
 
-        // final computation
-        bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
-        bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
-        bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
-        auto bbox = in->AccessBoundingBoxes().ObjectSpaceBBox();
-        // bbox.EnforcePositiveSize(); // paranoia
-        auto bbox_cntr = bbox.CalcCenter();
-
         vislib::sys::ConsoleProgressBar cpb;
         const int progressDivider = 100;
         cpb.Start("measuring thermodynamics",
@@ -301,7 +315,7 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         allpartcnt = 0;
         for (unsigned int pli = 0; pli < plc; pli++) {
             auto& pl = in->AccessParticles(pli);
-            if (!isListOK(in, pli) || !isDirOK(static_cast<metricsEnum>(theMetrics), in, pli)) {
+            if (!this->lists[pli]) {
                 continue;
             }
 
@@ -311,23 +325,11 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
             std::vector<float> metricMin(num_thr, FLT_MAX);
             std::vector<float> metricMax(num_thr, 0.0f);
 
-            float eps = sqrt(std::numeric_limits<float>::epsilon());
             bool findExtremes = this->findExtremesSlot.Param<megamol::core::param::BoolParam>()->Value();
             float extremeVal = this->extremeValueSlot.Param<megamol::core::param::FloatParam>()->Value();
 
 #pragma omp parallel num_threads(num_thr)
-            //#pragma omp parallel num_threads(1)
             {
-                float theVertex[3];
-                std::vector<std::pair<size_t, float>> ret_matches;
-                std::vector<std::pair<size_t, float>> ret_localMatches;
-                std::vector<size_t> ret_index(theNumber);
-                std::vector<float> out_dist_sqr(theNumber);
-                nanoflann::KNNResultSet<float> resultSet(theNumber);
-                nanoflann::SearchParams params;
-                params.sorted = false;
-                ret_matches.reserve(100);
-                ret_localMatches.reserve(100);
                 int threadIdx = omp_get_thread_num();
 
                 INT64 part_cnt = pl.GetCount();
@@ -335,87 +337,31 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                 for (INT64 part_i = 0; part_i < part_cnt; ++part_i) {
 
                     INT64 myIndex = part_i + allpartcnt;
-                    ret_matches.clear();
                     const float* vertexBase = this->myPts->get_position(myIndex);
-                    // const float *velocityBase = this->myPts->get_velocity(myIndex);
-
-                    for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                        for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                            for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                                theVertex[0] = vertexBase[0];
-                                theVertex[1] = vertexBase[1];
-                                theVertex[2] = vertexBase[2];
-                                if (x_s > 0)
-                                    theVertex[0] =
-                                        theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                                if (y_s > 0)
-                                    theVertex[1] = theVertex[1] +
-                                                   ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                                if (z_s > 0)
-                                    theVertex[2] =
-                                        theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                                if (theSearchType == searchTypeEnum::RADIUS) {
-                                    // the documentation says the parameter radius for L2 is squared
-                                    // caution: the criterion is < radius, not <= !!!!
-                                    particleTree->radiusSearch(
-                                        theVertex, theSquaredRadius + eps, ret_localMatches, params);
-                                    if (remove_self) {
-                                        ret_localMatches.erase(
-                                            std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
-                                                [&](decltype(ret_localMatches)::value_type& elem) {
-                                                    return elem.first == myIndex;
-                                                }),
-                                            ret_localMatches.end());
-                                    }
-                                    ret_matches.insert(
-                                        ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                                } else {
-                                    resultSet.init(ret_index.data(), out_dist_sqr.data());
-                                    particleTree->findNeighbors(resultSet, theVertex, params);
-                                    for (size_t i = 0; i < resultSet.size(); ++i) {
-                                        if (!remove_self || ret_index[i] != myIndex) {
-                                            ret_matches.push_back(
-                                                std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    // no neighbor should count twice!
-                    ret_matches.erase(unique(ret_matches.begin(), ret_matches.end()), ret_matches.end());
-
-                    size_t num_matches = 0;
-                    if (theSearchType == searchTypeEnum::RADIUS) {
-                        maxDist = theRadius;
-                        num_matches = ret_matches.size();
-                    } else {
-                        // find overall closest! we did search around periodic boundary conditions, so there will be
-                        // huge distances!
-                        sort(ret_matches.begin(), ret_matches.end(),
-                            [](const decltype(ret_matches)::value_type& left,
-                                const decltype(ret_matches)::value_type& right) { return left.second < right.second; });
-                        // the furthest is theNumber closest or the last one if fewer.
-                        num_matches = ret_matches.size() >= theNumber ? theNumber : ret_matches.size();
+                    auto const* matches = this->neighborIndices.data() + this->neighborOffsets[myIndex];
+                    auto const* distances = this->neighborDistances.data() + this->neighborOffsets[myIndex];
+                    size_t const found = this->neighborOffsets[myIndex + 1] - this->neighborOffsets[myIndex];
+
+                    size_t num_matches = found;
+                    float maxDist = theRadius;
+                    if (theSearchType == searchTypeEnum::NUM_NEIGHBORS) {
+                        // the lists are sorted, the furthest is theNumber closest or the last one if fewer.
+                        num_matches = found >= theNumber ? theNumber : found;
                         // the documentation says the returned distances are squares as well
-                        maxDist = sqrt(ret_matches[num_matches - 1].second);
+                        if (num_matches > 0) maxDist = sqrt(distances[num_matches - 1]);
                     }
 
                     float magnitude = 0.0f;
 
                     switch (theMetrics) {
                     case metricsEnum::TEMPERATURE:
-                        magnitude = computeTemperature(ret_matches, num_matches, theMass, theFreedom);
+                        magnitude = computeTemperature(matches, num_matches, theMass, theFreedom);
                         break;
                     case metricsEnum::DENSITY:
-                        //megamol::core::utility::log::Log::DefaultLog.WriteWarn("ParticleThermodyn: cannot compute density yet!");
-                        magnitude = computeDensity(ret_matches, num_matches, vertexBase, pl.GetGlobalRadius(), bbox);
+                        magnitude = computeDensity(matches, num_matches, vertexBase, pl.GetGlobalRadius(), bbox);
                         break;
                     case metricsEnum::FRACTIONAL_ANISOTROPY:
-                        magnitude = computeFractionalAnisotropy(ret_matches, num_matches);
+                        magnitude = computeFractionalAnisotropy(matches, num_matches);
                         break;
                     case metricsEnum::PRESSURE:
                         megamol::core::utility::log::Log::DefaultLog.WriteWarn("ParticleThermodyn: cannot compute pressure yet!");
@@ -428,13 +374,13 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                             magnitude = std::numeric_limits<float>::max();
                             if (remove_self) {
                                 // nearest is a neighbor
-                                if (!ret_matches.empty()) {
-                                    magnitude = ret_matches[0].second;
+                                if (found > 0) {
+                                    magnitude = distances[0];
                                 }
                             } else {
                                 // nearest should be ourselves, with distance 0, so take the next best
-                                if (ret_matches.size() > 1) {
-                                    magnitude = ret_matches[1].second;
+                                if (found > 1) {
+                                    magnitude = distances[1];
                                 }
                             }
                         } break;
@@ -452,7 +398,7 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                     } break;
                     case metricsEnum::PHASE02: {
                         auto const inv_search_volume = 1.0f / (4.0f / 3.0f * 3.14f * maxDist * maxDist * maxDist);
-                        auto const temperature = computeTemperature(ret_matches, num_matches, theMass, theFreedom);
+                        auto const temperature = computeTemperature(matches, num_matches, theMass, theFreedom);
                         auto const rho_fluid = rho_c + 0.5649f * std::pow(T_c - temperature, 0.3333333f) +
                                                0.1314 * (T_c - temperature) +
                                                0.0412 * std::pow(T_c - temperature, 1.5f);
@@ -476,7 +422,7 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                         // debug weird magnitudes
                         if (magnitude > extremeVal) {
                             for (size_t x = 0; x < num_matches; ++x) {
-                                auto idx = ret_matches[x].first;
+                                auto idx = matches[x];
                                 if (newColors[idx] < extremeVal) {
                                     newColors[idx] = magnitude / 2;
                                 }
@@ -508,14 +454,7 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "ParticleThermodyn: min metric: %f max metric: %f", theMinTemp, theMaxTemp);
 
-        this->radiusSlot.ResetDirty();
-        this->cyclXSlot.ResetDirty();
-        this->cyclYSlot.ResetDirty();
-        this->cyclZSlot.ResetDirty();
-        this->numNeighborSlot.ResetDirty();
-        this->searchTypeSlot.ResetDirty();
         this->metricsSlot.ResetDirty();
-        this->removeSelfSlot.ResetDirty();
         this->findExtremesSlot.ResetDirty();
         this->extremeValueSlot.ResetDirty();
         this->fluidDensitySlot.ResetDirty();
@@ -533,7 +472,7 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         outMPDC->SetParticleListCount(in->GetParticleListCount());
         for (unsigned int i = 0; i < in->GetParticleListCount(); ++i) {
             auto& pl = in->AccessParticles(i);
-            if (!isListOK(in, i) || !isDirOK(static_cast<metricsEnum>(theMetrics), in, i)) {
+            if (!this->lists[i]) {
                 outMPDC->AccessParticles(i).SetCount(0);
                 continue;
             }
@@ -557,13 +496,158 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
     return true;
 }
 
+bool datatools::ParticleThermodyn::searchNeighbors(vislib::math::Cuboid<float> const& bbox) {
+    const float theRadius = this->radiusSlot.Param<core::param::FloatParam>()->Value();
+    const float theSquaredRadius = theRadius * theRadius;
+    const int theNumber = this->numNeighborSlot.Param<core::param::IntParam>()->Value();
+    const auto theSearchType = this->searchTypeSlot.Param<core::param::EnumParam>()->Value();
+    const bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
+    const bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
+    const bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
+    const bool remove_self = this->removeSelfSlot.Param<megamol::core::param::BoolParam>()->Value();
+    const auto bbox_cntr = bbox.CalcCenter();
+    const float eps = sqrt(std::numeric_limits<float>::epsilon());
+    // the nearest distance without 'remove self' is the second entry of a list
+    const size_t keep = static_cast<size_t>(std::max(theNumber, 2));
+
+    const INT64 total = static_cast<INT64>(this->allParts.size());
+    if (static_cast<uint64_t>(total) > std::numeric_limits<uint32_t>::max()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleThermodyn: cannot store neighbors of more than %u particles", std::numeric_limits<uint32_t>::max());
+        return false;
+    }
+    this->neighborOffsets.assign(total + 1, 0);
+
+    // The search runs twice: the first pass only counts, the second writes the lists straight to their final
+    // place. This doubles the search time, but the peak memory is the final arrays only.
+    vislib::sys::ConsoleProgressBar cpb;
+    cpb.Start("searching neighbors", static_cast<vislib::sys::ConsoleProgressBar::Size>(2 * total));
+    std::atomic<INT64> counter(0);
+
+#pragma omp parallel
+    {
+        float theVertex[3];
+        std::vector<std::pair<size_t, float>> ret_matches;
+        std::vector<std::pair<size_t, float>> ret_localMatches;
+        std::vector<size_t> ret_index(theNumber);
+        std::vector<float> out_dist_sqr(theNumber);
+        nanoflann::KNNResultSet<float> resultSet(theNumber);
+        nanoflann::SearchParams params;
+        params.sorted = false;
+        ret_matches.reserve(100);
+        ret_localMatches.reserve(100);
+
+        auto search = [&](INT64 const myIndex) {
+            ret_matches.clear();
+            const float* vertexBase = this->myPts->get_position(myIndex);
+
+            for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
+                for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
+                    for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
+
+                        theVertex[0] = vertexBase[0];
+                        theVertex[1] = vertexBase[1];
+                        theVertex[2] = vertexBase[2];
+                        if (x_s > 0)
+                            theVertex[0] =
+                                theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
+                        if (y_s > 0)
+                            theVertex[1] =
+                                theVertex[1] + ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
+                        if (z_s > 0)
+                            theVertex[2] =
+                                theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
+
+                        if (theSearchType == searchTypeEnum::RADIUS) {
+                            // the documentation says the parameter radius for L2 is squared
+                            // caution: the criterion is < radius, not <= !!!!
+                            particleTree->radiusSearch(theVertex, theSquaredRadius + eps, ret_localMatches, params);
+                            if (remove_self) {
+                                ret_localMatches.erase(std::remove_if(ret_localMatches.begin(),
+                                                           ret_localMatches.end(),
+                                                           [&](decltype(ret_localMatches)::value_type& elem) {
+                                                               return elem.first == myIndex;
+                                                           }),
+                                    ret_localMatches.end());
+                            }
+                            ret_matches.insert(ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
+                        } else {
+                            resultSet.init(ret_index.data(), out_dist_sqr.data());
+                            particleTree->findNeighbors(resultSet, theVertex, params);
+                            for (size_t i = 0; i < resultSet.size(); ++i) {
+                                if (!remove_self || ret_index[i] != myIndex) {
+                                    ret_matches.push_back(std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // no neighbor should count twice!
+            ret_matches.erase(unique(ret_matches.begin(), ret_matches.end()), ret_matches.end());
+
+            if (theSearchType == searchTypeEnum::NUM_NEIGHBORS) {
+                // find overall closest! we did search around periodic boundary conditions, so there will be
+                // huge distances!
+                sort(ret_matches.begin(), ret_matches.end(),
+                    [](const decltype(ret_matches)::value_type& left,
+                        const decltype(ret_matches)::value_type& right) { return left.second < right.second; });
+                if (ret_matches.size() > keep) ret_matches.resize(keep);
+            }
+        };
+
+        auto progress = [&]() {
+            const INT64 done = ++counter;
+            // the progress bar is not thread-safe
+            if (omp_get_thread_num() == 0) {
+                cpb.Set(static_cast<vislib::sys::ConsoleProgressBar::Size>(done));
+            }
+        };
+
+#pragma omp for schedule(dynamic, 256)
+        for (INT64 myIndex = 0; myIndex < total; ++myIndex) {
+            search(myIndex);
+            this->neighborOffsets[myIndex + 1] = ret_matches.size();
+            progress();
+        }
+
+#pragma omp single
+        {
+            std::partial_sum(
+                this->neighborOffsets.begin(), this->neighborOffsets.end(), this->neighborOffsets.begin());
+            this->neighborIndices.resize(this->neighborOffsets.back());
+            this->neighborIndices.shrink_to_fit();
+            this->neighborDistances.resize(this->neighborOffsets.back());
+            this->neighborDistances.shrink_to_fit();
+        }
+
+#pragma omp for schedule(dynamic, 256)
+        for (INT64 myIndex = 0; myIndex < total; ++myIndex) {
+            search(myIndex);
+            auto const offset = this->neighborOffsets[myIndex];
+            for (size_t n = 0; n < ret_matches.size(); ++n) {
+                this->neighborIndices[offset + n] = static_cast<uint32_t>(ret_matches[n].first);
+                this->neighborDistances[offset + n] = ret_matches[n].second;
+            }
+            progress();
+        }
+    } // end #pragma omp parallel
+    cpb.Stop();
+
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+        "ParticleThermodyn: found %zu neighbors for %lld particles", this->neighborIndices.size(), total);
+    return true;
+}
+
+
 float megamol::stdplugin::datatools::ParticleThermodyn::computeTemperature(
-    std::vector<std::pair<size_t, float>>& matches, const size_t num_matches, const float mass, const float freedom) {
+    uint32_t const* matches, const size_t num_matches, const float mass, const float freedom) const {
     std::array<float, 3> sum = {0, 0, 0};
     std::array<float, 3> sq_sum = {0, 0, 0};
     std::array<float, 3> the_temperature = {0, 0, 0};
     for (size_t i = 0; i < num_matches; ++i) {
-        const float* velo = myPts->get_velocity(matches[i].first);
+        const float* velo = myPts->get_velocity(matches[i]);
         for (int c = 0; c < 3; ++c) {
             float v = velo[c];
             sum[c] += v;
@@ -585,18 +669,19 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeTemperature(
 }
 
 float megamol::stdplugin::datatools::ParticleThermodyn::computeFractionalAnisotropy(
-    std::vector<std::pair<size_t, float>>& matches, const size_t num_matches) {
+    uint32_t const* matches, const size_t num_matches) const {
 
     Eigen::Matrix3f mat;
     mat.fill(0.0f);
 
     for (size_t i = 0; i < num_matches; ++i) {
-        const float* velo = myPts->get_velocity(matches[i].first);
+        const float* velo = myPts->get_velocity(matches[i]);
         for (int x = 0; x < 3; ++x)
             for (int y = 0; y < 3; ++y) mat(x, y) += velo[x] * velo[y];
     }
     mat /= static_cast<float>(num_matches);
 
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> eigensolver;
     eigensolver.computeDirect(mat, Eigen::EigenvaluesOnly);
     auto& ev = eigensolver.eigenvalues();
     float evMean = ev[0] + ev[1] + ev[2];
@@ -609,8 +694,8 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeFractionalAnisotr
     return FA * scale;
 }
 
-float megamol::stdplugin::datatools::ParticleThermodyn::computeDensity(std::vector<std::pair<size_t, float>>& matches,
-    size_t num_matches, float const curPoint[3], float radius, vislib::math::Cuboid<float> const& bbox) {
+float megamol::stdplugin::datatools::ParticleThermodyn::computeDensity(uint32_t const* matches,
+    size_t num_matches, float const curPoint[3], float radius, vislib::math::Cuboid<float> const& bbox) const {
     bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
     bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
     bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
@@ -621,7 +706,7 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeDensity(std::vect
     std::vector<float> part;
     part.reserve(num_matches * 4);
     for (size_t i = 0; i < num_matches; ++i) {
-        auto coord = myPts->get_position(matches[i].first);
+        auto coord = myPts->get_position(matches[i]);
         part.push_back(
             cycl_x ? coord[0] - bbox.Width() * std::nearbyintf((coord[0] - curPoint[0]) / bbox.Width()) : coord[0]);
         part.push_back(
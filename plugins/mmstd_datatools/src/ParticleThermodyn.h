@@ -15,6 +15,7 @@
 #include "mmcore/Module.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
 #include "PointcloudHelpers.h"
+#include <cstdint>
 #include <vector>
 #include <nanoflann.hpp>
 #include <Eigen/Eigenvalues>
@@ -71,6 +72,16 @@ namespace datatools {
         /** Dtor */
         virtual ~ParticleThermodyn(void);
 
+        /**
+         * The quantities are computed from the input particles only, so the
+         * callbacks may be re-issued from a prefetch thread of the graph.
+         *
+         * @return 'true'
+         */
+        bool IsThreadSafe(void) const override {
+            return true;
+        }
+
         /**
         * Called when the data is requested by this module
         *
@@ -102,9 +113,18 @@ namespace datatools {
         bool assertData(core::moldyn::MultiParticleDataCall *in,
             core::moldyn::MultiParticleDataCall *outMPDC);
 
-        float computeTemperature(std::vector<std::pair<size_t, float> > &matches, size_t num_matches, float mass, float freedom);
-        float computeFractionalAnisotropy(std::vector<std::pair<size_t, float> > &matches, size_t num_matches);
-        float computeDensity(std::vector<std::pair<size_t, float> > &matches, size_t num_matches, float const curPoint[3], float radius, vislib::math::Cuboid<float> const& bbox);
+        /**
+         * Fills 'neighborIndices' and 'neighborDistances' with the
+         * neighborhood of every particle in 'myPts', stored consecutively
+         * with 'neighborOffsets' (CSR).
+         *
+         * @return false if there are too many particles for 32 bit indices.
+         */
+        bool searchNeighbors(vislib::math::Cuboid<float> const& bbox);
+
+        float computeTemperature(uint32_t const* matches, size_t num_matches, float mass, float freedom) const;
+        float computeFractionalAnisotropy(uint32_t const* matches, size_t num_matches) const;
+        float computeDensity(uint32_t const* matches, size_t num_matches, float const curPoint[3], float radius, vislib::math::Cuboid<float> const& bbox) const;
 
         core::param::ParamSlot cyclXSlot;
         core::param::ParamSlot cyclYSlot;
@@ -129,9 +149,21 @@ namespace datatools {
         int lastTime;
         std::vector<float> newColors;
         std::vector<size_t> allParts;
-        float maxDist;
 
-        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> eigensolver;
+        /** The lists that make up 'myPts' */
+        std::vector<bool> lists;
+
+        /**
+         * The neighbors of particle i are the entries
+         * [neighborOffsets[i] .. neighborOffsets[i + 1]) of 'neighborIndices'
+         * and their squared distances the same entries of
+         * 'neighborDistances', for the current frame and search parameters.
+         * Lists of a neighbor count search are sorted by distance.
+         */
+        std::vector<uint32_t> neighborIndices;
+        std::vector<float> neighborDistances;
+        std::vector<size_t> neighborOffsets;
+        bool neighborsValid = false;
 
         typedef nanoflann::KDTreeSingleIndexAdaptor<
             nanoflann::L2_Simple_Adaptor<float, simplePointcloud>,
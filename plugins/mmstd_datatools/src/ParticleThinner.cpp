@@ -49,23 +49,35 @@ bool datatools::ParticleThinner::manipulateData(
     for (unsigned int i = 0; i < plc; i++) {
         MultiParticleDataCall::Particles& p = outData.AccessParticles(i);
 
-        UINT64 cnt = p.GetCount();
-
-        const void *cd = p.GetColourData();
-        unsigned int cds = p.GetColourDataStride();
-        MultiParticleDataCall::Particles::ColourDataType cdt = p.GetColourDataType();
-
-        const void *vd = p.GetVertexData();
-        unsigned int vds = p.GetVertexDataStride();
-        MultiParticleDataCall::Particles::VertexDataType vdt = p.GetVertexDataType();
-
-        cds *= tf;  // lol
-        vds *= tf;
-        cnt /= tf;
-
-        p.SetCount(cnt);
-        p.SetColourData(cdt, cd, cds);
-        p.SetVertexData(vdt, vd, vds);
+        // Every tf-th particle is selected by scaling the strides, so the streams stay shared with the input.
+        // The strides are answered as 0 for packed data, so the actual element sizes are used.
+        const unsigned int vds = (p.GetVertexDataStride() != 0)
+                                     ? p.GetVertexDataStride()
+                                     : MultiParticleDataCall::Particles::VertexDataSize[p.GetVertexDataType()];
+        const unsigned int cds = (p.GetColourDataStride() != 0)
+                                     ? p.GetColourDataStride()
+                                     : MultiParticleDataCall::Particles::ColorDataSize[p.GetColourDataType()];
+        const unsigned int dds = (p.GetDirDataStride() != 0)
+                                     ? p.GetDirDataStride()
+                                     : MultiParticleDataCall::Particles::DirDataSize[p.GetDirDataType()];
+        const unsigned int ids = (p.GetIDDataStride() != 0)
+                                     ? p.GetIDDataStride()
+                                     : MultiParticleDataCall::Particles::IDDataSize[p.GetIDDataType()];
+        const MultiParticleDataCall::Particles src = p;
+
+        p.SetCount(src.GetCount() / tf);
+        if (src.GetVertexDataType() != MultiParticleDataCall::Particles::VERTDATA_NONE) {
+            p.SetVertexData(src.GetVertexDataType(), src.GetVertexData(), vds * tf, src.GetVertexDataStorage());
+        }
+        if (src.GetColourDataType() != MultiParticleDataCall::Particles::COLDATA_NONE) {
+            p.SetColourData(src.GetColourDataType(), src.GetColourData(), cds * tf, src.GetColourDataStorage());
+        }
+        if (src.GetDirDataType() != MultiParticleDataCall::Particles::DIRDATA_NONE) {
+            p.SetDirData(src.GetDirDataType(), src.GetDirData(), dds * tf, src.GetDirDataStorage());
+        }
+        if (src.GetIDDataType() != MultiParticleDataCall::Particles::IDDATA_NONE) {
+            p.SetIDData(src.GetIDDataType(), src.GetIDData(), ids * tf, src.GetIDDataStorage());
+        }
     }
 
     return true;
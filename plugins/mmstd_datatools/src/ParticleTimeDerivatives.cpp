@@ -0,0 +1,468 @@
+/*
+ * ParticleTimeDerivatives.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "ParticleTimeDerivatives.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+using namespace megamol;
+using namespace megamol::stdplugin;
+
+/** Shortest difference of two coordinates, across the boundary if it is cyclic */
+inline float minimumImage(float d, float size, bool cyclic) {
+    if (cyclic && (size > 0.0f) && (std::fabs(d) > 0.5f * size)) {
+        d -= size * std::floor(d / size + 0.5f);
+    }
+    return d;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::ParticleTimeDerivatives
+ */
+datatools::ParticleTimeDerivatives::ParticleTimeDerivatives(void)
+        : derivativeSlot("derivative", "The time derivative of the positions to compute")
+        , stencilSlot("stencil", "The central difference stencil, higher orders use more frames")
+        , dtSlot("dt", "time difference between two sequential time steps")
+        , cyclXSlot("cyclX", "Considers cyclic boundary conditions in X direction")
+        , cyclYSlot("cyclY", "Considers cyclic boundary conditions in Y direction")
+        , cyclZSlot("cyclZ", "Considers cyclic boundary conditions in Z direction")
+        , windowSlot("window", "Number of frames kept in memory, at least the stencil width")
+        , magnitudeColorSlot("magnitudeAsColor", "Replaces the colours by the magnitudes of the derivatives")
+        , frames()
+        , nextSlot(0)
+        , computedFrame(0)
+        , computedHash(0)
+        , computedValid(false)
+        , derivatives()
+        , magnitudes()
+        , magnitudeRanges()
+        , myHash(0)
+        , outDataSlot("outData", "Provides the particles of the inner frames with their derivatives as directions")
+        , inDataSlot("inData", "Takes the particle data, sorted, with constant particle numbers over all frames") {
+
+    core::param::EnumParam* dp = new core::param::EnumParam(derivativeEnum::VELOCITY);
+    dp->SetTypePair(derivativeEnum::VELOCITY, "Velocity");
+    dp->SetTypePair(derivativeEnum::ACCELERATION, "Acceleration");
+    this->derivativeSlot << dp;
+    this->MakeSlotAvailable(&this->derivativeSlot);
+
+    core::param::EnumParam* sp = new core::param::EnumParam(stencilEnum::CENTRAL_3);
+    sp->SetTypePair(stencilEnum::CENTRAL_3, "2nd order (3 frames)");
+    sp->SetTypePair(stencilEnum::CENTRAL_5, "4th order (5 frames)");
+    sp->SetTypePair(stencilEnum::CENTRAL_7, "6th order (7 frames)");
+    this->stencilSlot << sp;
+    this->MakeSlotAvailable(&this->stencilSlot);
+
+    this->dtSlot.SetParameter(new core::param::FloatParam(0.1f, 0.0000001f, 100.0f));
+    this->MakeSlotAvailable(&this->dtSlot);
+
+    this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->cyclXSlot);
+
+    this->cyclYSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->cyclYSlot);
+
+    this->cyclZSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->cyclZSlot);
+
+    this->windowSlot.SetParameter(new core::param::IntParam(7, 1, 64));
+    this->MakeSlotAvailable(&this->windowSlot);
+
+    this->magnitudeColorSlot.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->magnitudeColorSlot);
+
+    this->outDataSlot.SetCallback(megamol::core::moldyn::MultiParticleDataCall::ClassName(), "GetData",
+        &ParticleTimeDerivatives::getDataCallback);
+    this->outDataSlot.SetCallback(megamol::core::moldyn::MultiParticleDataCall::ClassName(), "GetExtent",
+        &ParticleTimeDerivatives::getExtentCallback);
+    this->MakeSlotAvailable(&this->outDataSlot);
+
+    this->inDataSlot.SetCompatibleCall<megamol::core::moldyn::MultiParticleDataCallDescription>();
+    this->MakeSlotAvailable(&this->inDataSlot);
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::~ParticleTimeDerivatives
+ */
+datatools::ParticleTimeDerivatives::~ParticleTimeDerivatives(void) {
+    this->Release();
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::create
+ */
+bool datatools::ParticleTimeDerivatives::create(void) {
+    return true;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::release
+ */
+void datatools::ParticleTimeDerivatives::release(void) {
+    this->frames.clear();
+    this->derivatives.clear();
+    this->magnitudes.clear();
+    this->computedValid = false;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::stencilWeights
+ */
+std::vector<double> datatools::ParticleTimeDerivatives::stencilWeights(void) const {
+    bool const velocity =
+        this->derivativeSlot.Param<core::param::EnumParam>()->Value() == derivativeEnum::VELOCITY;
+    switch (this->stencilSlot.Param<core::param::EnumParam>()->Value()) {
+    case stencilEnum::CENTRAL_5:
+        if (velocity) return {1.0 / 12.0, -2.0 / 3.0, 0.0, 2.0 / 3.0, -1.0 / 12.0};
+        return {-1.0 / 12.0, 4.0 / 3.0, -5.0 / 2.0, 4.0 / 3.0, -1.0 / 12.0};
+    case stencilEnum::CENTRAL_7:
+        if (velocity) return {-1.0 / 60.0, 3.0 / 20.0, -3.0 / 4.0, 0.0, 3.0 / 4.0, -3.0 / 20.0, 1.0 / 60.0};
+        return {1.0 / 90.0, -3.0 / 20.0, 3.0 / 2.0, -49.0 / 18.0, 3.0 / 2.0, -3.0 / 20.0, 1.0 / 90.0};
+    case stencilEnum::CENTRAL_3:
+    default:
+        if (velocity) return {-0.5, 0.0, 0.5};
+        return {1.0, -2.0, 1.0};
+    }
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::requestFrame
+ */
+bool datatools::ParticleTimeDerivatives::requestFrame(
+        core::moldyn::MultiParticleDataCall *in, unsigned int frameID) {
+    in->SetFrameID(frameID, true);
+    do {
+        if (!(*in)(1)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleTimeDerivatives: could not get frame extents (%u)", frameID);
+            return false;
+        }
+        if (!(*in)(0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleTimeDerivatives: could not get frame (%u)", frameID);
+            return false;
+        }
+    } while (in->FrameID() != frameID); // did we get correct frame?
+    return true;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::findFrame
+ */
+datatools::ParticleTimeDerivatives::FrameSlot *datatools::ParticleTimeDerivatives::findFrame(
+        unsigned int frameID, size_t dataHash) {
+    for (auto& s : this->frames) {
+        if (s.valid && (s.frameID == frameID) && (s.dataHash == dataHash)) return &s;
+    }
+    return nullptr;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::storeFrame
+ */
+datatools::ParticleTimeDerivatives::FrameSlot *datatools::ParticleTimeDerivatives::storeFrame(
+        core::moldyn::MultiParticleDataCall *in, size_t dataHash, unsigned int keepFirst, unsigned int keepLast) {
+    using megamol::core::moldyn::MultiParticleDataCall;
+
+    // next slot in ring order not holding a frame of the current stencil
+    FrameSlot *slot = nullptr;
+    for (size_t n = 0; (n < this->frames.size()) && (slot == nullptr); ++n) {
+        size_t const idx = (this->nextSlot + n) % this->frames.size();
+        FrameSlot& s = this->frames[idx];
+        if (s.valid && (s.dataHash == dataHash) && (s.frameID >= keepFirst) && (s.frameID <= keepLast)) continue;
+        slot = &s;
+        this->nextSlot = (idx + 1) % this->frames.size();
+    }
+    if (slot == nullptr) return nullptr;
+
+    unsigned int const plc = in->GetParticleListCount();
+    slot->valid = false;
+    slot->x.resize(plc);
+    slot->y.resize(plc);
+    slot->z.resize(plc);
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto& parts = in->AccessParticles(i);
+        size_t const cnt = (parts.GetVertexDataType() == MultiParticleDataCall::Particles::VERTDATA_NONE)
+                               ? 0
+                               : static_cast<size_t>(parts.GetCount());
+        auto& x = slot->x[i];
+        auto& y = slot->y[i];
+        auto& z = slot->z[i];
+        x.resize(cnt);
+        y.resize(cnt);
+        z.resize(cnt);
+        auto const& xAcc = parts.GetParticleStore().GetXAcc();
+        auto const& yAcc = parts.GetParticleStore().GetYAcc();
+        auto const& zAcc = parts.GetParticleStore().GetZAcc();
+#pragma omp parallel for
+        for (int64_t p = 0; p < static_cast<int64_t>(cnt); ++p) {
+            x[p] = xAcc->Get_f(p);
+            y[p] = yAcc->Get_f(p);
+            z[p] = zAcc->Get_f(p);
+        }
+    }
+    slot->frameID = in->FrameID();
+    slot->dataHash = dataHash;
+    slot->valid = true;
+    return slot;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::computeDerivatives
+ */
+bool datatools::ParticleTimeDerivatives::computeDerivatives(
+        std::vector<FrameSlot*> const& stencil, FrameSlot const& center, vislib::math::Cuboid<float> const& bbox) {
+    auto const weights = this->stencilWeights();
+    bool const cycleX = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
+    bool const cycleY = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
+    bool const cycleZ = this->cyclZSlot.Param<core::param::BoolParam>()->Value();
+    double const dt = this->dtSlot.Param<core::param::FloatParam>()->Value();
+    bool const velocity =
+        this->derivativeSlot.Param<core::param::EnumParam>()->Value() == derivativeEnum::VELOCITY;
+    double const scale = velocity ? 1.0 / dt : 1.0 / (dt * dt);
+    float const width = bbox.Width();
+    float const height = bbox.Height();
+    float const depth = bbox.Depth();
+
+    size_t const plc = center.x.size();
+    for (auto s : stencil) {
+        if (s->x.size() != plc) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleTimeDerivatives: inconsistent number "
+                "of lists between frames %u (%u) and %u (%u)", s->frameID, static_cast<unsigned int>(s->x.size()),
+                center.frameID, static_cast<unsigned int>(plc));
+            return false;
+        }
+    }
+
+    this->derivatives.assign(plc, nullptr);
+    this->magnitudes.assign(plc, nullptr);
+    this->magnitudeRanges.assign(plc, std::make_pair(0.0f, 0.0f));
+
+    for (size_t i = 0; i < plc; ++i) {
+        size_t const cnt = center.x[i].size();
+        if (cnt == 0) continue;
+
+        // the centre frame has no weight for velocities, every difference is taken relative to it
+        std::vector<const float*> sx, sy, sz;
+        std::vector<double> sw;
+        for (size_t k = 0; k < stencil.size(); ++k) {
+            if (stencil[k]->x[i].size() != cnt) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleTimeDerivatives: inconsistent list "
+                    "length between frames %u and %u in list %u", stencil[k]->frameID, center.frameID,
+                    static_cast<unsigned int>(i));
+                return false;
+            }
+            if (weights[k] == 0.0) continue;
+            sx.push_back(stencil[k]->x[i].data());
+            sy.push_back(stencil[k]->y[i].data());
+            sz.push_back(stencil[k]->z[i].data());
+            sw.push_back(weights[k] * scale);
+        }
+
+        // fresh buffers, downstream modules may still share the previous ones
+        auto deriv = std::make_shared<std::vector<float>>(cnt * 3);
+        auto mag = std::make_shared<std::vector<float>>(cnt);
+        float *d = deriv->data();
+        float *m = mag->data();
+        const float *cx = center.x[i].data();
+        const float *cy = center.y[i].data();
+        const float *cz = center.z[i].data();
+        int const terms = static_cast<int>(sw.size());
+
+#pragma omp parallel for
+        for (int64_t p = 0; p < static_cast<int64_t>(cnt); ++p) {
+            double vx = 0.0, vy = 0.0, vz = 0.0;
+            for (int k = 0; k < terms; ++k) {
+                vx += sw[k] * minimumImage(sx[k][p] - cx[p], width, cycleX);
+                vy += sw[k] * minimumImage(sy[k][p] - cy[p], height, cycleY);
+                vz += sw[k] * minimumImage(sz[k][p] - cz[p], depth, cycleZ);
+            }
+            d[p * 3 + 0] = static_cast<float>(vx);
+            d[p * 3 + 1] = static_cast<float>(vy);
+            d[p * 3 + 2] = static_cast<float>(vz);
+            m[p] = static_cast<float>(std::sqrt(vx * vx + vy * vy + vz * vz));
+        }
+
+        auto const range = std::minmax_element(mag->begin(), mag->end());
+        this->magnitudeRanges[i] = std::make_pair(*range.first, *range.second);
+        this->derivatives[i] = deriv;
+        this->magnitudes[i] = mag;
+    }
+    return true;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::getExtentCallback
+ */
+bool datatools::ParticleTimeDerivatives::getExtentCallback(megamol::core::Call& c) {
+    using megamol::core::moldyn::MultiParticleDataCall;
+
+    MultiParticleDataCall *outMpdc = dynamic_cast<MultiParticleDataCall*>(&c);
+    if (outMpdc == nullptr) return false;
+
+    MultiParticleDataCall *inMpdc = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inMpdc == nullptr) return false;
+
+    unsigned int const width = static_cast<unsigned int>(this->stencilWeights().size());
+    unsigned int const half = width / 2;
+
+    inMpdc->SetFrameID(outMpdc->FrameID() + half, true);
+    if (!(*inMpdc)(1)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleTimeDerivatives: could not get frame extents (%u)", outMpdc->FrameID() + half);
+        return false;
+    }
+    if (inMpdc->FrameCount() < width) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleTimeDerivatives: the selected stencil needs at least %u time steps", width);
+        return false;
+    }
+    outMpdc->AccessBoundingBoxes().SetObjectSpaceBBox(inMpdc->GetBoundingBoxes().ObjectSpaceBBox());
+    outMpdc->AccessBoundingBoxes().SetObjectSpaceClipBox(inMpdc->GetBoundingBoxes().ObjectSpaceClipBox());
+    outMpdc->SetFrameCount(inMpdc->FrameCount() - 2 * half);
+    outMpdc->SetDataHash(this->myHash);
+    inMpdc->SetUnlocker(nullptr, false);
+    inMpdc->Unlock();
+
+    return true;
+}
+
+
+/*
+ * datatools::ParticleTimeDerivatives::getDataCallback
+ */
+bool datatools::ParticleTimeDerivatives::getDataCallback(megamol::core::Call& c) {
+    using megamol::core::moldyn::MultiParticleDataCall;
+
+    MultiParticleDataCall *outMpdc = dynamic_cast<MultiParticleDataCall*>(&c);
+    if (outMpdc == nullptr) return false;
+
+    MultiParticleDataCall *inMpdc = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inMpdc == nullptr) return false;
+
+    unsigned int const width = static_cast<unsigned int>(this->stencilWeights().size());
+    unsigned int const half = width / 2;
+
+    // the extents of the centre frame tell the number of frames and the data hash
+    unsigned int center = outMpdc->FrameID() + half;
+    inMpdc->SetFrameID(center, true);
+    if (!(*inMpdc)(1)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleTimeDerivatives: could not get frame extents (%u)", center);
+        return false;
+    }
+    if (inMpdc->FrameCount() < width) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleTimeDerivatives: the selected stencil needs at least %u time steps", width);
+        return false;
+    }
+    center = std::min(center, inMpdc->FrameCount() - 1 - half);
+    size_t const hash = inMpdc->DataHash();
+
+    size_t const capacity =
+        std::max<size_t>(static_cast<size_t>(this->windowSlot.Param<core::param::IntParam>()->Value()), width);
+    if (this->frames.size() != capacity) {
+        this->frames.clear();
+        this->frames.resize(capacity);
+        this->nextSlot = 0;
+    }
+
+    bool const paramsDirty = this->derivativeSlot.IsDirty() || this->stencilSlot.IsDirty() ||
+                             this->dtSlot.IsDirty() || this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() ||
+                             this->cyclZSlot.IsDirty();
+    bool const recompute = !this->computedValid || (this->computedFrame != center) ||
+                           (this->computedHash != hash) || paramsDirty;
+
+    unsigned int const first = center - half;
+    unsigned int const last = center + half;
+    if (recompute) {
+        // the neighbouring frames first, the centre frame is requested last and stays locked for the output
+        for (unsigned int f = first; f <= last; ++f) {
+            if ((f == center) || (this->findFrame(f, hash) != nullptr)) continue;
+            if (!this->requestFrame(inMpdc, f)) return false;
+            FrameSlot *slot = this->storeFrame(inMpdc, hash, first, last);
+            inMpdc->Unlock();
+            if (slot == nullptr) return false;
+        }
+    }
+    if (!this->requestFrame(inMpdc, center)) return false;
+
+    if (recompute) {
+        FrameSlot *centerSlot = this->findFrame(center, hash);
+        if (centerSlot == nullptr) centerSlot = this->storeFrame(inMpdc, hash, first, last);
+        std::vector<FrameSlot*> stencil;
+        for (unsigned int f = first; f <= last; ++f) {
+            stencil.push_back(this->findFrame(f, hash));
+        }
+        if ((centerSlot == nullptr) || (std::find(stencil.begin(), stencil.end(), nullptr) != stencil.end()) ||
+            !this->computeDerivatives(stencil, *centerSlot, inMpdc->AccessBoundingBoxes().ObjectSpaceBBox())) {
+            this->computedValid = false;
+            inMpdc->Unlock();
+            return false;
+        }
+        this->computedFrame = center;
+        this->computedHash = hash;
+        this->computedValid = true;
+        ++this->myHash;
+        this->derivativeSlot.ResetDirty();
+        this->stencilSlot.ResetDirty();
+        this->dtSlot.ResetDirty();
+        this->cyclXSlot.ResetDirty();
+        this->cyclYSlot.ResetDirty();
+        this->cyclZSlot.ResetDirty();
+    }
+    if (this->magnitudeColorSlot.IsDirty()) {
+        ++this->myHash;
+        this->magnitudeColorSlot.ResetDirty();
+    }
+
+    if (inMpdc->GetParticleListCount() != this->derivatives.size()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleTimeDerivatives: frame %u changed while computing its derivatives", center);
+        this->computedValid = false;
+        inMpdc->Unlock();
+        return false;
+    }
+
+    *outMpdc = *inMpdc; // also transfers the unlocker, the centre frame stays locked until the output is released
+    inMpdc->SetUnlocker(nullptr, false);
+    outMpdc->SetFrameID(center - half);
+    outMpdc->SetFrameCount(inMpdc->FrameCount() - 2 * half);
+    outMpdc->SetDataHash(this->myHash);
+
+    bool const magColor = this->magnitudeColorSlot.Param<core::param::BoolParam>()->Value();
+    for (unsigned int i = 0; i < outMpdc->GetParticleListCount(); ++i) {
+        auto& parts = outMpdc->AccessParticles(i);
+        if (this->derivatives[i] == nullptr) continue;
+        parts.SetDirData(MultiParticleDataCall::Particles::DIRDATA_FLOAT_XYZ, this->derivatives[i]->data(), 0,
+            this->derivatives[i]);
+        if (magColor) {
+            parts.SetColourData(MultiParticleDataCall::Particles::COLDATA_FLOAT_I, this->magnitudes[i]->data(), 0,
+                this->magnitudes[i]);
+            parts.SetColourMapIndexValues(this->magnitudeRanges[i].first, this->magnitudeRanges[i].second);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,182 @@
+/*
+ * ParticleTimeDerivatives.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_PARTICLETIMEDERIVATIVES_H_INCLUDED
+#define MMSTD_DATATOOLS_PARTICLETIMEDERIVATIVES_H_INCLUDED
+#pragma once
+
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/moldyn/MultiParticleDataCall.h"
+#include "mmcore/param/ParamSlot.h"
+#include "vislib/math/Cuboid.h"
+#include <memory>
+#include <vector>
+
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+    /**
+     * Module computing velocities or accelerations of particles with
+     * central differences over several frames. Particle numbers must not
+     * change between frames and the particle order must always be the same
+     * to allow for identification of particles (see ParticleIdentitySort).
+     *
+     * The positions of the frames a stencil needs are kept in a ring buffer
+     * of SoA copies, so playing forward loads one frame per step, while
+     * frames can still be requested in any order. The output lacks the
+     * first and last frames of the input the stencil cannot be centred on.
+     */
+    class ParticleTimeDerivatives : public megamol::core::Module {
+    public:
+
+        /** Return module class name */
+        static const char *ClassName(void) {
+            return "ParticleTimeDerivatives";
+        }
+
+        /** Return module class description */
+        static const char *Description(void) {
+            return "Computes velocities or accelerations of (sorted, synchronized) particles with central differences "
+                   "over several frames. Reduces the number of available time steps by the stencil width - 1.";
+        }
+
+        /** Module is always available */
+        static bool IsAvailable(void) {
+            return true;
+        }
+
+        /** Ctor */
+        ParticleTimeDerivatives(void);
+
+        /** Dtor */
+        virtual ~ParticleTimeDerivatives(void);
+
+    protected:
+
+        /** Lazy initialization of the module */
+        virtual bool create(void);
+
+        /** Resource release */
+        virtual void release(void);
+
+    private:
+
+        enum derivativeEnum {
+            VELOCITY = 0,
+            ACCELERATION = 1
+        };
+
+        enum stencilEnum {
+            CENTRAL_3 = 0, //< second order, 3 frames
+            CENTRAL_5 = 1, //< fourth order, 5 frames
+            CENTRAL_7 = 2  //< sixth order, 7 frames
+        };
+
+        /** The positions of one input frame, one SoA copy per list */
+        struct FrameSlot {
+            bool valid = false;
+            unsigned int frameID = 0;
+            size_t dataHash = 0;
+            std::vector<std::vector<float>> x, y, z;
+        };
+
+        /**
+         * Called when the data is requested by this module
+         *
+         * @param c The incoming call
+         *
+         * @return True on success
+         */
+        bool getDataCallback(megamol::core::Call& c);
+
+        /**
+         * Called when the extend information is requested by this module
+         *
+         * @param c The incoming call
+         *
+         * @return True on success
+         */
+        bool getExtentCallback(megamol::core::Call& c);
+
+        /**
+         * Answers the weights of the selected stencil for the frames
+         * center - half width to center + half width. The weights still
+         * need to be divided by dt^order.
+         */
+        std::vector<double> stencilWeights(void) const;
+
+        /**
+         * Requests 'frameID' from 'in' and waits until the data source
+         * actually delivers it. The data stays locked.
+         */
+        bool requestFrame(megamol::core::moldyn::MultiParticleDataCall *in, unsigned int frameID);
+
+        /**
+         * Answers the ring buffer slot holding 'frameID' of 'dataHash', or
+         * nullptr if the frame is not cached.
+         */
+        FrameSlot *findFrame(unsigned int frameID, size_t dataHash);
+
+        /**
+         * Copies the positions of the frame currently held by 'in' into the
+         * next slot of the ring buffer. Slots holding frames in [keepFirst,
+         * keepLast] of 'dataHash' are not overwritten.
+         */
+        FrameSlot *storeFrame(megamol::core::moldyn::MultiParticleDataCall *in, size_t dataHash,
+            unsigned int keepFirst, unsigned int keepLast);
+
+        /**
+         * Computes the derivatives of the particles of the frame in
+         * 'center' from the frames in 'stencil'.
+         */
+        bool computeDerivatives(std::vector<FrameSlot*> const& stencil, FrameSlot const& center,
+            vislib::math::Cuboid<float> const& bbox);
+
+        core::param::ParamSlot derivativeSlot;
+        core::param::ParamSlot stencilSlot;
+        core::param::ParamSlot dtSlot;
+        core::param::ParamSlot cyclXSlot;
+        core::param::ParamSlot cyclYSlot;
+        core::param::ParamSlot cyclZSlot;
+        core::param::ParamSlot windowSlot;
+        core::param::ParamSlot magnitudeColorSlot;
+
+        /** The ring buffer of input frames */
+        std::vector<FrameSlot> frames;
+
+        /** The slot overwritten next */
+        size_t nextSlot;
+
+        /** Input frame and hash the derivatives were computed for */
+        unsigned int computedFrame;
+        size_t computedHash;
+        bool computedValid;
+
+        /** Per list, the derivatives (XYZ) and their magnitudes */
+        std::vector<std::shared_ptr<std::vector<float>>> derivatives;
+        std::vector<std::shared_ptr<std::vector<float>>> magnitudes;
+        std::vector<std::pair<float, float>> magnitudeRanges;
+
+        size_t myHash;
+
+        /** The slot providing access to the manipulated data */
+        megamol::core::CalleeSlot outDataSlot;
+
+        /** The slot accessing the original data */
+        megamol::core::CallerSlot inDataSlot;
+
+    };
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MMSTD_DATATOOLS_PARTICLETIMEDERIVATIVES_H_INCLUDED */
@@ -105,111 +105,81 @@ bool datatools::ParticleTranslateRotateScale::manipulateData(
     trafo = glm::translate(trafo, glm::vec3(bboxCenterX, bboxCenterY, bboxCenterZ));
     trafo = glm::translate(trafo, glm::vec3(transX, transY, transZ));
 
-    if (InterfaceIsDirty() || (hash != inData.DataHash()) || (inData.DataHash() == 0) || (frameID != inData.FrameID())) {
+    outData = inData; // also transfers the unlocker to 'outData'
+    inData.SetUnlocker(nullptr, false); // keep original data locked
+                                        // original data will be unlocked through outData
+
+    unsigned int plc = inData.GetParticleListCount();
+    if (InterfaceIsDirty() || (hash != inData.DataHash()) || (inData.DataHash() == 0) || (frameID != inData.FrameID()) ||
+        (finalData.size() != plc)) {
         // Update data
         hash = inData.DataHash();
         frameID = inData.FrameID();
         InterfaceResetDirty();
 
-        unsigned int plc = inData.GetParticleListCount();
-        outData.SetParticleListCount(plc);
-
-        outData = inData; // also transfers the unlocker to 'outData'
-        inData.SetUnlocker(nullptr, false); // keep original data locked
-                                            // original data will be unlocked through outData
-
+        // Only the positions are transformed, all other attributes stay shared with the input lists.
         finalData.resize(plc);
         for (unsigned int i = 0; i < plc; i++) {
             MultiParticleDataCall::Particles& p = inData.AccessParticles(i);
 
             uint64_t cnt = p.GetCount();
 
-            const void* cd = p.GetColourData();
-            unsigned int cds = p.GetColourDataStride();
-            MultiParticleDataCall::Particles::ColourDataType cdt = p.GetColourDataType();
-
-            const void* vd = p.GetVertexData();
-            unsigned int vds = p.GetVertexDataStride();
-            MultiParticleDataCall::Particles::VertexDataType vdt = p.GetVertexDataType();
-
-
-            // Color transfer call and calculation
-            //std::vector<float> rgba;
-            //rgba.reserve(cnt * 4);
-            //unsigned int texSize = 0;
-            //megamol::core::view::CallGetTransferFunction* cgtf =
-            //    this->getTFSlot.CallAs<core::view::CallGetTransferFunction>();
-            //if (cgtf != NULL && ((*cgtf)())) {
-            //    float const* tfTex = cgtf->GetTextureData();
-            //    texSize = cgtf->TextureSize();
-            //    this->colorTransferGray(p, tfTex, texSize, rgba);
-            //} else {
-            //    this->colorTransferGray(p, NULL, 0, rgba);
-            //}
-
             auto const& parStore = p.GetParticleStore();
             auto const& xAcc = parStore.GetXAcc();
             auto const& yAcc = parStore.GetYAcc();
             auto const& zAcc = parStore.GetZAcc();
-            auto const& rAcc = parStore.GetCRAcc();
-            auto const& gAcc = parStore.GetCGAcc();
-            auto const& bAcc = parStore.GetCBAcc();
-            auto const& aAcc = parStore.GetCAAcc();
 
-            finalData[i].resize(cnt * 7, 0.0f);
-//#pragma omp parallel for
+            auto positions = std::make_shared<std::vector<float>>(cnt * 3, 0.0f);
+            auto& pos = *positions;
             for (int64_t loop = 0; loop < cnt; loop++) {
-
                 glm::vec4 glmpos = trafo * glm::vec4(xAcc->Get_f(loop), yAcc->Get_f(loop), zAcc->Get_f(loop), 1.0);
 
-                finalData[i][7 * loop + 0] = glmpos.x; // pos.GetX();
-                finalData[i][7 * loop + 1] = glmpos.y; // pos.GetY();
-                finalData[i][7 * loop + 2] = glmpos.z; //pos.GetZ();
-                finalData[i][7 * loop + 3] = rAcc->Get_f(loop);                              // rgba[4 * loop + 0];
-                finalData[i][7 * loop + 4] = gAcc->Get_f(loop); // rgba[4 * loop + 1];
-                finalData[i][7 * loop + 5] = bAcc->Get_f(loop); // rgba[4 * loop + 2];
-                finalData[i][7 * loop + 6] = aAcc->Get_f(loop); // rgba[4 * loop + 3];
-
-            }
-
-            auto lbb_local = glm::vec3(finalData[i][0], finalData[i][1], finalData[i][2]);
-            auto rtf_local = lbb_local;
-            for (int64_t loop = 1; loop < cnt; loop++) {
-                lbb_local = glm::min(lbb_local,
-                    glm::vec3(finalData[i][7 * loop + 0], finalData[i][7 * loop + 1], finalData[i][7 * loop + 2]));
-                rtf_local = glm::max(rtf_local,
-                    glm::vec3(finalData[i][7 * loop + 0], finalData[i][7 * loop + 1], finalData[i][7 * loop + 2]));
+                pos[3 * loop + 0] = glmpos.x;
+                pos[3 * loop + 1] = glmpos.y;
+                pos[3 * loop + 2] = glmpos.z;
             }
 
             vislib::math::Cuboid<float> newBoxLocal;
-            newBoxLocal.Set(
-                lbb_local.x, lbb_local.y, lbb_local.z, rtf_local.x, rtf_local.y, rtf_local.z);
-            _global_box = newBoxLocal;
-            MultiParticleDataCall::Particles& outp = outData.AccessParticles(i);
-            outp.SetBBox(newBoxLocal);
-            outp.SetCount(cnt);
-            outp.SetVertexData(
-                MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ, finalData[i].data(), 7 * sizeof(float));
-            outp.SetColourData(
-                MultiParticleDataCall::Particles::COLDATA_FLOAT_RGBA, finalData[i].data() + 3, 7 * sizeof(float));
-            outp.SetGlobalRadius(p.GetGlobalRadius() * scaleX);
+            if (cnt > 0) {
+                auto lbb_local = glm::vec3(pos[0], pos[1], pos[2]);
+                auto rtf_local = lbb_local;
+                for (int64_t loop = 1; loop < cnt; loop++) {
+                    lbb_local = glm::min(lbb_local, glm::vec3(pos[3 * loop + 0], pos[3 * loop + 1], pos[3 * loop + 2]));
+                    rtf_local = glm::max(rtf_local, glm::vec3(pos[3 * loop + 0], pos[3 * loop + 1], pos[3 * loop + 2]));
+                }
+                newBoxLocal.Set(lbb_local.x, lbb_local.y, lbb_local.z, rtf_local.x, rtf_local.y, rtf_local.z);
+            }
+            finalData[i].positions = std::move(positions);
+            finalData[i].bbox = newBoxLocal;
+            finalData[i].radius = p.GetGlobalRadius() * scaleX;
         }
 
         if (plc > 0) {
-            auto bbox = outData.AccessParticles(0).GetBBox();
+            auto bbox = finalData[0].bbox;
             auto lbb = glm::vec3(bbox.Left(), bbox.Bottom(), bbox.Back());
             auto rtf = glm::vec3(bbox.Right(), bbox.Top(), bbox.Front());
             for (unsigned int i = 1; i < plc; i++) {
-                bbox = outData.AccessParticles(i).GetBBox();
+                bbox = finalData[i].bbox;
                 lbb = glm::min(lbb, glm::vec3(bbox.Left(), bbox.Bottom(), bbox.Back()));
                 rtf = glm::max(rtf, glm::vec3(bbox.Right(), bbox.Top(), bbox.Front()));
             }
-            
+
             _global_box.Set(lbb.x, lbb.y, lbb.z, rtf.x, rtf.y, rtf.z);
-            outData.AccessBoundingBoxes().SetObjectSpaceBBox(_global_box);
-            outData.AccessBoundingBoxes().SetObjectSpaceClipBox(_global_box);
         }
     }
+
+    // Replace the position stream of every list with the transformed copy.
+    for (unsigned int i = 0; i < plc; i++) {
+        MultiParticleDataCall::Particles& outp = outData.AccessParticles(i);
+        outp.SetBBox(finalData[i].bbox);
+        outp.SetGlobalRadius(finalData[i].radius);
+        outp.SetVertexData(MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ, finalData[i].positions->data(), 0,
+            finalData[i].positions);
+    }
+    if (plc > 0) {
+        outData.AccessBoundingBoxes().SetObjectSpaceBBox(_global_box);
+        outData.AccessBoundingBoxes().SetObjectSpaceClipBox(_global_box);
+    }
     outData.SetDataHash(this->hash);
     outData.SetFrameID(this->frameID);
 
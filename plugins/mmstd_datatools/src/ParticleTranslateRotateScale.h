@@ -76,7 +76,14 @@ namespace datatools {
         size_t hash = -1;
         unsigned int frameID = -1;
 
-        std::vector<std::vector<float>> finalData;
+        /** The transformed positions of a particle list */
+        struct TransformedList {
+            std::shared_ptr<std::vector<float>> positions;
+            vislib::math::Cuboid<float> bbox;
+            float radius;
+        };
+
+        std::vector<TransformedList> finalData;
         vislib::math::Cuboid<float> _global_box;
     };
 
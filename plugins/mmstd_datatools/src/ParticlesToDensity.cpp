@@ -69,6 +69,8 @@ datatools::ParticlesToDensity::ParticlesToDensity(void)
     , cyclZSlot("cyclZ", "Considers cyclic boundary conditions in Z direction")
     , normalizeSlot("normalize", "Normalize the output volume")
     , sigmaSlot("sigma", "Sigma for Gauss in multiple of rad")
+    , kernelSlot("kernel", "Kernel splatted for every particle, its width is sigma times the particle radius")
+    , deterministicSlot("deterministic", "Accumulate in particle order for bit-identical results")
     , surfaceSlot("forSurfaceReconstruction", "Set true if this volume is used for surface reconstruction")
     , datahash(0)
     , time(std::numeric_limits<unsigned int>::max())
@@ -147,6 +149,17 @@ datatools::ParticlesToDensity::ParticlesToDensity(void)
         1.0f, std::numeric_limits<float>::min(), std::numeric_limits<float>::max());
     this->MakeSlotAvailable(&this->sigmaSlot);
 
+    auto* kp = new core::param::EnumParam(static_cast<int>(TiledSplatter::Kernel::Bump));
+    kp->SetTypePair(static_cast<int>(TiledSplatter::Kernel::Bump), "Bump");
+    kp->SetTypePair(static_cast<int>(TiledSplatter::Kernel::Box), "Box");
+    kp->SetTypePair(static_cast<int>(TiledSplatter::Kernel::Gaussian), "Gaussian");
+    kp->SetTypePair(static_cast<int>(TiledSplatter::Kernel::SPH), "SPH");
+    this->kernelSlot << kp;
+    this->MakeSlotAvailable(&this->kernelSlot);
+
+    this->deterministicSlot << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->deterministicSlot);
+
     this->surfaceSlot << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->surfaceSlot);
 
@@ -245,7 +258,7 @@ bool datatools::ParticlesToDensity::getDataCallback(megamol::core::Call& c) {
     // TODO set data
     if (outVol != nullptr) {
         outVol->SetFrameID(this->time);
-        outVol->SetData(this->vol[0].data());
+        outVol->SetData(this->vol.data());
         metadata.Components = is_vector ? 3 : 1;
         metadata.GridType = core::misc::GridType_t::CARTESIAN;
         metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -292,7 +305,7 @@ bool datatools::ParticlesToDensity::getDataCallback(megamol::core::Call& c) {
         this->zResSlot.Param<core::param::IntParam>()->Value()); outVol->SetComponents(1);
         outVol->SetMinimumDensity(0.0f);
         outVol->SetMaximumDensity(this->maxDens);
-        outVol->SetVoxelMapPointer(this->vol[0].data());*/
+        outVol->SetVoxelMapPointer(this->vol.data());*/
         // inMpdc->Unlock();
     }
 
@@ -392,21 +405,12 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
 
     bool const is_vector = this->aggregatorSlot.Param<core::param::EnumParam>()->Value() == 2;
 
-    vol.resize(omp_get_max_threads());
-    std::vector<std::vector<float>> weights(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol[init].resize(sx * sy * sz * (is_vector ? 3 : 1));
-        std::fill(vol[init].begin(), vol[init].end(), 0.0f);
-
-        weights[init].resize(sx * sy * sz);
-        std::fill(weights[init].begin(), weights[init].end(), 0.0f);
-    }
+    // one volume shared by all threads, the splatter assigns every tile to exactly one writer
+    vol.assign(static_cast<size_t>(sx) * sy * sz * (is_vector ? 3 : 1), 0.0f);
+    std::vector<float> weights(is_vector ? static_cast<size_t>(sx) * sy * sz : 0, 0.0f);
 
     // TODO: the whole code is wrong since we might not have the bounding box for the actual cyclic boundary conditions.
 
-    // TODO: what about near-zero or zero radii? This currently blows the whole thing up.
-
     bool const cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
     bool const cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
     bool const cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
@@ -417,9 +421,6 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
     auto const rangeOSx = c2->AccessBoundingBoxes().ObjectSpaceBBox().Width();
     auto const rangeOSy = c2->AccessBoundingBoxes().ObjectSpaceBBox().Height();
     auto const rangeOSz = c2->AccessBoundingBoxes().ObjectSpaceBBox().Depth();
-    auto const halfRangeOSx = c2->AccessBoundingBoxes().ObjectSpaceBBox().Width() * 0.5;
-    auto const halfRangeOSy = c2->AccessBoundingBoxes().ObjectSpaceBBox().Height() * 0.5;
-    auto const halfRangeOSz = c2->AccessBoundingBoxes().ObjectSpaceBBox().Depth() * 0.5;
 
     float const sliceDistX = rangeOSx / static_cast<float>(sx - 1);
     float const sliceDistY = rangeOSy / static_cast<float>(sy - 1);
@@ -449,6 +450,19 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
         }
     }
 
+    TiledSplatter::Grid splatGrid;
+    splatGrid.resolution = {sx, sy, sz};
+    splatGrid.origin = {minOSx, minOSy, minOSz};
+    splatGrid.spacing = {sliceDistX, sliceDistY, sliceDistZ};
+    splatGrid.cyclic = {cycl_x, cycl_y, cycl_z};
+    splatGrid.components = is_vector ? 3 : 1;
+    this->splatter.SetGrid(splatGrid);
+    this->splatter.SetDeterministic(this->deterministicSlot.Param<core::param::BoolParam>()->Value());
+
+    auto const kernel =
+        static_cast<TiledSplatter::Kernel>(this->kernelSlot.Param<core::param::EnumParam>()->Value());
+    auto const sigma = this->sigmaSlot.Param<core::param::FloatParam>()->Value();
+
     for (unsigned int i = 0; i < c2->GetParticleListCount(); ++i) {
         megamol::core::moldyn::MultiParticleDataCall::Particles& parts = c2->AccessParticles(i);
         const float globRad = parts.GetGlobalRadius();
@@ -462,13 +476,6 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
 
         totalParticles += parts.GetCount();
 
-        // Implements the Bump Function from
-        // https://en.wikipedia.org/wiki/Radial_basis_function
-        auto rbf = [](float const dist, float const epsilon) -> float {
-            if (dist >= epsilon) return 0.0f;
-            return std::exp(-1.0f / (1.0f - std::pow((1.0f / epsilon) * dist, 2.0f)));
-        };
-
         auto const& parStore = parts.GetParticleStore();
         auto const& xAcc = parStore.GetXAcc();
         auto const& yAcc = parStore.GetYAcc();
@@ -479,160 +486,53 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
         auto const& dyAcc = parStore.GetDYAcc();
         auto const& dzAcc = parStore.GetDZAcc();
 
-        auto const sigma = this->sigmaSlot.Param<core::param::FloatParam>()->Value();
+        auto const particle = [&](size_t const pidx, float pos[3]) -> float {
+            pos[0] = xAcc->Get_f(pidx);
+            pos[1] = yAcc->Get_f(pidx);
+            pos[2] = zAcc->Get_f(pidx);
+            return useGlobRad ? globRad : rAcc->Get_f(pidx);
+        };
 
-        std::function<void(int, int, int, int, float, float)> volOp;
         switch (this->aggregatorSlot.Param<core::param::EnumParam>()->Value()) {
         case 2: {
-            volOp = [this, &rbf, &weights, dxAcc, dyAcc, dzAcc, sx, sy, sigma](int const pidx, int const x,
-                        int const y, int const z, float const dis, float const rad) -> void {
-                if (rad == 0.0f) return;
-
-                auto const val_x = dxAcc->Get_f(pidx);
-                auto const val_y = dyAcc->Get_f(pidx);
-                auto const val_z = dzAcc->Get_f(pidx);
-
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 0] += rbf(dis, sigma * rad) * val_x;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 1] += rbf(dis, sigma * rad) * val_y;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 2] += rbf(dis, sigma * rad) * val_z;
-
-                weights[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
+            this->splatter.Splat(parts.GetCount(), kernel, sigma, particle,
+                [&](size_t const pidx, float* val) {
+                    val[0] = dxAcc->Get_f(pidx);
+                    val[1] = dyAcc->Get_f(pidx);
+                    val[2] = dzAcc->Get_f(pidx);
+                },
+                this->vol.data(), weights.data());
         } break;
         case 1: {
-            volOp = [this, &rbf, iAcc, sx, sy, sigma](int const pidx, int const x, int const y, int const z,
-                        float const dis, float const rad) -> void {
-                if (rad == 0.0f) return;
-
-                auto const val = iAcc->Get_f(pidx);
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad) * val;
-            };
+            this->splatter.Splat(parts.GetCount(), kernel, sigma, particle,
+                [&](size_t const pidx, float* val) { val[0] = iAcc->Get_f(pidx); }, this->vol.data());
         } break;
         default:
         case 0: {
-            volOp = [this, &rbf, sx, sy, sigma](int const pidx, int const x, int const y, int const z,
-                        float const dis, float const rad) -> void {
-                if (rad == 0.0f) return;
-
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
-        }
-        }
-
-#if 0
-#    pragma omp parallel for collapse(4)
-        for (int z = 0; z < sz; ++z) {
-            for (int y = 0; y < sy; ++y) {
-                for (int x = 0; x < sx; ++x) {
-                    for (int64_t j = 0; j < parts.GetCount(); ++j) {
-                        auto const x_base = xAcc->Get_f(j);
-                        auto const y_base = yAcc->Get_f(j);
-                        auto const z_base = zAcc->Get_f(j);
-                        auto rad = globRad;
-                        if (!useGlobRad) rad = rAcc->Get_f(j);
-
-                        float x_diff = static_cast<float>(x) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        if (cycl_x && x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(y) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        if (cycl_y && y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(z) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        if (cycl_z && z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, x, y, z, dis, rad);
-                    }
-                }
-            }
+            this->splatter.Splat(parts.GetCount(), kernel, sigma, particle,
+                [](size_t const, float* val) { val[0] = 1.0f; }, this->vol.data());
         }
-#endif
-
-#pragma omp parallel for
-        for (int64_t j = 0; j < parts.GetCount(); ++j) {
-            auto const x_base = xAcc->Get_f(j);
-            auto x = static_cast<int>((x_base - minOSx) / sliceDistX);
-            auto const y_base = yAcc->Get_f(j);
-            auto y = static_cast<int>((y_base - minOSy) / sliceDistY);
-            auto const z_base = zAcc->Get_f(j);
-            auto z = static_cast<int>((z_base - minOSz) / sliceDistZ);
-            auto rad = globRad;
-            if (!useGlobRad) rad = rAcc->Get_f(j);
-
-            int const filterSizeX = static_cast<int>(std::ceil(rad / sliceDistX));
-            int const filterSizeY = static_cast<int>(std::ceil(rad / sliceDistY));
-            int const filterSizeZ = static_cast<int>(std::ceil(rad / sliceDistZ));
-
-            for (int hz = z - filterSizeZ; hz <= z + filterSizeZ; ++hz) {
-                for (int hy = y - filterSizeY; hy <= y + filterSizeY; ++hy) {
-                    for (int hx = x - filterSizeX; hx <= x + filterSizeX; ++hx) {
-                        auto tmp_hx = hx;
-                        auto tmp_hy = hy;
-                        auto tmp_hz = hz;
-                        if (cycl_x) {
-                            tmp_hx = (hx + 2 * sx) % sx;
-                        } else {
-                            if (hx < 0 || hx > sx - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_y) {
-                            tmp_hy = (hy + 2 * sy) % sy;
-                        } else {
-                            if (hy < 0 || hy > sy - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_z) {
-                            tmp_hz = (hz + 2 * sz) % sz;
-                        } else {
-                            if (hz < 0 || hz > sz - 1) {
-                                continue;
-                            }
-                        }
-
-                        float x_diff = static_cast<float>(hx) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        // if (x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(hy) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        // if (y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(hz) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        // if (z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, tmp_hx, tmp_hy, tmp_hz, dis, rad);
-                    }
-                }
-            }
         }
     }
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol[i].begin(), vol[i].end(), vol[0].begin(), vol[0].begin(), std::plus<>());
-        std::transform(weights[i].begin(), weights[i].end(), weights[0].begin(), weights[0].begin(), std::plus<>());
-    }
-
     if (is_vector) {
-        this->directions.resize(vol[0].size());
-        this->colors.resize(vol[0].size() / 3);
-        this->densities.resize(vol[0].size() / 3);
+        this->directions.resize(vol.size());
+        this->colors.resize(vol.size() / 3);
+        this->densities.resize(vol.size() / 3);
         maxDens = 0.0f;
         minDens = std::numeric_limits<float>::max();
-        for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
-            vol[0][i * 3 + 0] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 1] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 2] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
+        for (std::size_t i = 0; i < vol.size() / 3; ++i) {
+            vol[i * 3 + 0] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[i * 3 + 1] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[i * 3 + 2] /= weights[i] == 0.0f ? 1.0f : weights[i];
 
             const float density =
-                std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
-                          vol[0][i * 3 + 2] * vol[0][i * 3 + 2]);
+                std::sqrt(vol[i * 3 + 0] * vol[i * 3 + 0] + vol[i * 3 + 1] * vol[i * 3 + 1] +
+                          vol[i * 3 + 2] * vol[i * 3 + 2]);
 
-            this->directions[i * 3 + 0] = density == 0.0f ? 0.0f : vol[0][i * 3 + 0] / density;
-            this->directions[i * 3 + 1] = density == 0.0f ? 0.0f : vol[0][i * 3 + 1] / density;
-            this->directions[i * 3 + 2] = density == 0.0f ? 0.0f : vol[0][i * 3 + 2] / density;
+            this->directions[i * 3 + 0] = density == 0.0f ? 0.0f : vol[i * 3 + 0] / density;
+            this->directions[i * 3 + 1] = density == 0.0f ? 0.0f : vol[i * 3 + 1] / density;
+            this->directions[i * 3 + 2] = density == 0.0f ? 0.0f : vol[i * 3 + 2] / density;
 
             this->infoData[i * this->info.size() + 3] = this->directions[i * 3 + 0];
             this->infoData[i * this->info.size() + 4] = this->directions[i * 3 + 1];
@@ -641,10 +541,10 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
             maxDens = std::max(maxDens, density);
             minDens = std::min(minDens, density);
         }
-        for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
+        for (std::size_t i = 0; i < vol.size() / 3; ++i) {
             const float density =
-                std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
-                          vol[0][i * 3 + 2] * vol[0][i * 3 + 2]);
+                std::sqrt(vol[i * 3 + 0] * vol[i * 3 + 0] + vol[i * 3 + 1] * vol[i * 3 + 1] +
+                          vol[i * 3 + 2] * vol[i * 3 + 2]);
 
             this->colors[i] = (density - minDens) / (maxDens - minDens);
             this->densities[i] = density;
@@ -656,15 +556,15 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
             }
         }
     } else {
-        maxDens = *std::max_element(vol[0].begin(), vol[0].end());
-        minDens = *std::min_element(vol[0].begin(), vol[0].end());
+        maxDens = *std::max_element(vol.begin(), vol.end());
+        minDens = *std::min_element(vol.begin(), vol.end());
     }
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticlesToDensity: Captured density %f -> %f", minDens, maxDens);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (maxDens - minDens);
-        std::transform(vol[0].begin(), vol[0].end(), vol[0].begin(),
+        std::transform(vol.begin(), vol.end(), vol.begin(),
             [this, rcpValRange](float const& a) { return (a - minDens) * rcpValRange; });
         minDens = 0.0f;
         maxDens = 1.0f;
@@ -718,7 +618,7 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
 //#define PTD_DEBUG_OUTPUT
 #ifdef PTD_DEBUG_OUTPUT
     std::ofstream raw_file{"bolla.raw", std::ios::binary};
-    raw_file.write(reinterpret_cast<char const*>(vol[0].data()), vol[0].size() * sizeof(float));
+    raw_file.write(reinterpret_cast<char const*>(vol.data()), vol.size() * sizeof(float));
     raw_file.close();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticlesToDensity: Debug file written\n");
 #endif
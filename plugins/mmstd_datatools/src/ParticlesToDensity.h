@@ -16,6 +16,7 @@
 #include "mmcore/moldyn/MultiParticleDataCall.h"
 #include "mmcore/param/ParamSlot.h"
 
+#include "mmstd_datatools/TiledSplatter.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 #include "vislib/math/Vector.h"
@@ -85,7 +86,8 @@ private:
     inline bool anythingDirty() const {
         return this->aggregatorSlot.IsDirty() || this->xResSlot.IsDirty() || this->yResSlot.IsDirty() ||
                this->zResSlot.IsDirty() || this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() ||
-               this->cyclZSlot.IsDirty() || this->normalizeSlot.IsDirty() || this->sigmaSlot.IsDirty();
+               this->cyclZSlot.IsDirty() || this->normalizeSlot.IsDirty() || this->sigmaSlot.IsDirty() ||
+               this->kernelSlot.IsDirty() || this->deterministicSlot.IsDirty();
     }
 
     inline void resetDirty() {
@@ -98,6 +100,8 @@ private:
         this->cyclZSlot.ResetDirty();
         this->normalizeSlot.ResetDirty();
         this->sigmaSlot.ResetDirty();
+        this->kernelSlot.ResetDirty();
+        this->deterministicSlot.ResetDirty();
     }
 
     core::param::ParamSlot aggregatorSlot;
@@ -114,9 +118,15 @@ private:
 
     core::param::ParamSlot sigmaSlot;
 
+    core::param::ParamSlot kernelSlot;
+
+    core::param::ParamSlot deterministicSlot;
+
     core::param::ParamSlot surfaceSlot;
 
-    std::vector<std::vector<float>> vol;
+    std::vector<float> vol;
+
+    TiledSplatter splatter;
     std::vector<float> directions, colors, densities;
     std::vector<float> grid;
 
@@ -198,6 +198,11 @@ public:
         return &(_point_data[idx * static_cast<std::size_t>(DIM)]);
     }
 
+    // Returns the weights of the dimensions in kdtree_distance
+    std::array<T, DIM> const& get_weights() const {
+        return _weights;
+    }
+
     void normalize_data() {
         std::array<T, DIM> mins;
         std::array<T, DIM> divs;
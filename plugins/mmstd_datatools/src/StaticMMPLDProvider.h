@@ -42,6 +42,16 @@ public:
     /** Dtor. */
     virtual ~StaticMMPLDProvider(void);
 
+    /**
+     * The files are read into memory by the callbacks only, so they may be
+     * re-issued from a prefetch thread of the graph.
+     *
+     * @return 'true'
+     */
+    bool IsThreadSafe(void) const override {
+        return true;
+    }
+
 protected:
     bool create() override;
 
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <vector>
 
+#include "ParticleRadixSort.h"
 #include "PointcloudHelpers.h"
 
 #include <nanoflann.hpp>
@@ -82,4 +89,291 @@ inline cluster_result_t DBSCAN(std::shared_ptr<kd_tree_t<T, DIM>> const& D, T ep
     return clusters;
 }
 
+namespace detail {
+
+constexpr int pow3(int e) {
+    return (e <= 0) ? 1 : 3 * pow3(e - 1);
+}
+
+// uniform grid over the points, with cells at least as wide as the search radius in every dimension with non-zero
+// weight; eps is squared, like in the radius search. The points are stored sorted by cell, the cell index runs
+// along dimension 0 fastest, so the neighbors of a cell are found in 3^(DIM-1) runs of consecutive cells.
+template<typename T, int DIM>
+class dbscan_grid {
+public:
+    using range_t = std::pair<index_t, index_t>;
+
+    static constexpr int num_runs = pow3(DIM - 1);
+
+    dbscan_grid(genericPointcloud<T, DIM> const& data, T eps) : _eps(eps) {
+        auto const num_points = static_cast<int64_t>(data.kdtree_get_point_count());
+        auto const& weights = data.get_weights();
+
+        std::array<T, DIM> maxs;
+        for (int d = 0; d < DIM; ++d) {
+            _mins[d] = std::numeric_limits<T>::max();
+            maxs[d] = std::numeric_limits<T>::lowest();
+        }
+        for (int64_t pidx = 0; pidx < num_points; ++pidx) {
+            auto const pos = data.get_position(pidx);
+            for (int d = 0; d < DIM; ++d) {
+                _mins[d] = std::min(_mins[d], pos[d]);
+                maxs[d] = std::max(maxs[d], pos[d]);
+            }
+        }
+
+        // |p_d - q_d| < sqrt(eps / w_d) for all neighbors, the cells are slightly wider to be safe from rounding;
+        // at most 2^15 cells per dimension keep the linear cell index within 64 bits
+        constexpr T max_cells = static_cast<T>(1 << 15);
+        for (int d = 0; d < DIM; ++d) {
+            auto const range = (num_points > 0) ? maxs[d] - _mins[d] : static_cast<T>(0);
+            _inv_size[d] = static_cast<T>(0);
+            _counts[d] = 1;
+            if (weights[d] > static_cast<T>(0) && range > static_cast<T>(0)) {
+                auto const size =
+                    std::max(static_cast<T>(1.0001) * std::sqrt(eps / weights[d]), range / (max_cells - 1));
+                _inv_size[d] = static_cast<T>(1) / size;
+                _counts[d] = static_cast<uint64_t>(range * _inv_size[d]) + 1;
+            }
+        }
+
+        std::vector<uint64_t> keys(num_points);
+        _original.resize(num_points);
+#pragma omp parallel for
+        for (int64_t pidx = 0; pidx < num_points; ++pidx) {
+            keys[pidx] = cell_key(data.get_position(pidx));
+            _original[pidx] = static_cast<uint64_t>(pidx);
+        }
+        RadixSort(keys, _original);
+
+        // a sorted copy with the same distance function keeps the region queries local
+        std::vector<T> sorted(num_points * DIM);
+#pragma omp parallel for
+        for (int64_t i = 0; i < num_points; ++i) {
+            auto const pos = data.get_position(_original[i]);
+            std::copy(pos, pos + DIM, sorted.begin() + i * DIM);
+        }
+        std::array<T, 2 * DIM> bbox;
+        for (int d = 0; d < DIM; ++d) {
+            bbox[d * 2] = _mins[d];
+            bbox[d * 2 + 1] = maxs[d];
+        }
+        _points = std::make_unique<genericPointcloud<T, DIM>>(sorted, bbox, weights);
+
+        for (int64_t i = 0; i < num_points; ++i) {
+            if (i == 0 || keys[i] != keys[i - 1]) {
+                _cell_keys.push_back(keys[i]);
+                _cell_starts.push_back(static_cast<index_t>(i));
+            }
+        }
+        _cell_starts.push_back(static_cast<index_t>(num_points));
+    }
+
+    index_t num_cells() const {
+        return _cell_keys.size();
+    }
+
+    // index of the i-th sorted point in the input
+    index_t original(index_t i) const {
+        return static_cast<index_t>(_original[i]);
+    }
+
+    // same criterion as the radius search of nanoflann, on sorted points
+    bool within(index_t i, index_t j) const {
+        return _points->kdtree_distance(_points->get_position(i), j, DIM) < _eps;
+    }
+
+    // calls f(points, runs) for the cells [first, last), with the sorted points of the cell and up to num_runs
+    // ranges of sorted points that contain all of their neighbors
+    template<typename F>
+    void for_each_cell(index_t first, index_t last, F f) const {
+        auto const num_cells = _cell_keys.size();
+        // as the cells are visited in key order, each run starts at or after the one of the previous cell
+        std::array<index_t, num_runs> cursors;
+        cursors.fill(std::numeric_limits<index_t>::max());
+        std::vector<range_t> runs;
+        runs.reserve(num_runs);
+
+        for (auto c = first; c < last; ++c) {
+            std::array<int64_t, DIM> coord;
+            auto key = _cell_keys[c];
+            for (int d = 0; d < DIM; ++d) {
+                coord[d] = static_cast<int64_t>(key % _counts[d]);
+                key /= _counts[d];
+            }
+
+            runs.clear();
+            for (int r = 0; r < num_runs; ++r) {
+                bool valid = true;
+                uint64_t base = 0;
+                for (int d = DIM - 1, o = r; d > 0; --d, o /= 3) {
+                    auto const cd = coord[d] + (o % 3) - 1;
+                    valid = valid && cd >= 0 && cd < static_cast<int64_t>(_counts[d]);
+                    base = base * _counts[d] + static_cast<uint64_t>(cd);
+                }
+                if (!valid) continue;
+                base *= _counts[0];
+                auto const lo = base + static_cast<uint64_t>(std::max<int64_t>(coord[0] - 1, 0));
+                auto const hi = base + static_cast<uint64_t>(
+                                           std::min<int64_t>(coord[0] + 1, static_cast<int64_t>(_counts[0]) - 1));
+
+                auto& cur = cursors[r];
+                if (cur == std::numeric_limits<index_t>::max()) {
+                    cur = std::distance(
+                        _cell_keys.cbegin(), std::lower_bound(_cell_keys.cbegin(), _cell_keys.cend(), lo));
+                }
+                while (cur < num_cells && _cell_keys[cur] < lo) ++cur;
+                auto end = cur;
+                while (end < num_cells && _cell_keys[end] <= hi) ++end;
+                if (end > cur) runs.emplace_back(_cell_starts[cur], _cell_starts[end]);
+            }
+
+            f(range_t(_cell_starts[c], _cell_starts[c + 1]), runs);
+        }
+    }
+
+private:
+    uint64_t cell_key(T const* pos) const {
+        uint64_t key = 0;
+        for (int d = DIM - 1; d >= 0; --d) {
+            auto const c = static_cast<uint64_t>(std::max(static_cast<T>(0), (pos[d] - _mins[d]) * _inv_size[d]));
+            key = key * _counts[d] + std::min(c, _counts[d] - 1);
+        }
+        return key;
+    }
+
+    T _eps;
+
+    std::array<T, DIM> _mins;
+
+    std::array<T, DIM> _inv_size;
+
+    std::array<uint64_t, DIM> _counts;
+
+    std::vector<uint64_t> _original;
+
+    std::unique_ptr<genericPointcloud<T, DIM>> _points;
+
+    std::vector<uint64_t> _cell_keys;
+
+    std::vector<index_t> _cell_starts;
+};
+
+// parents only ever point to smaller indices, so the root of a set is its smallest element
+inline index_t uf_find(std::vector<std::atomic<index_t>>& parents, index_t x) {
+    while (true) {
+        auto p = parents[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        auto const gp = parents[p].load(std::memory_order_relaxed);
+        if (gp != p) parents[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+inline void uf_unite(std::vector<std::atomic<index_t>>& parents, index_t x, index_t y) {
+    while (true) {
+        x = uf_find(parents, x);
+        y = uf_find(parents, y);
+        if (x == y) return;
+        if (x < y) std::swap(x, y);
+        auto expected = x;
+        if (parents[x].compare_exchange_strong(expected, y, std::memory_order_relaxed)) return;
+    }
+}
+
+// calls f(points, runs) of the grid for all cells, in parallel
+template<typename T, int DIM, typename F>
+inline void for_all_cells(dbscan_grid<T, DIM> const& grid, F f) {
+    constexpr index_t cells_per_chunk = 256;
+    auto const num_chunks = static_cast<int64_t>((grid.num_cells() + cells_per_chunk - 1) / cells_per_chunk);
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        auto const first = static_cast<index_t>(chunk) * cells_per_chunk;
+        grid.for_each_cell(first, std::min(first + cells_per_chunk, grid.num_cells()), f);
+    }
+}
+
+} // namespace detail
+
+// parallel DBSCAN: region queries on a grid with cells of size eps, core points are marked in parallel and merged
+// with a concurrent union-find. Clusters are numbered by their smallest core point and border points join the
+// adjacent cluster with the smallest number, which is exactly the result of DBSCAN above. Eps is squared, as there.
+template<typename T, int DIM>
+inline cluster_result_t DBSCAN_parallel(genericPointcloud<T, DIM> const& data, T eps, index_t minPts) {
+    using range_t = typename detail::dbscan_grid<T, DIM>::range_t;
+
+    auto const num_points = static_cast<int64_t>(data.kdtree_get_point_count());
+    cluster_result_t clusters(num_points, static_cast<cluster_type_ut>(cluster_type::NOISE));
+    if (num_points == 0 || eps <= static_cast<T>(0)) return clusters;
+
+    detail::dbscan_grid<T, DIM> const grid(data, eps);
+
+    // core points, by sorted index
+    std::vector<char> core(num_points, 0);
+    detail::for_all_cells(grid, [&grid, &core, minPts](range_t const& points, std::vector<range_t> const& runs) {
+        for (auto i = points.first; i < points.second; ++i) {
+            index_t count = 0;
+            for (auto const& run : runs) {
+                for (auto j = run.first; j < run.second && count < minPts; ++j) {
+                    if (grid.within(i, j)) ++count;
+                }
+            }
+            core[i] = (count >= minPts) ? 1 : 0;
+        }
+    });
+
+    // clusters, by input index
+    std::vector<std::atomic<index_t>> parents(num_points);
+#pragma omp parallel for
+    for (int64_t pidx = 0; pidx < num_points; ++pidx) {
+        parents[pidx].store(static_cast<index_t>(pidx), std::memory_order_relaxed);
+    }
+    detail::for_all_cells(grid, [&grid, &core, &parents](range_t const& points, std::vector<range_t> const& runs) {
+        for (auto i = points.first; i < points.second; ++i) {
+            if (core[i] == 0) continue;
+            for (auto const& run : runs) {
+                for (auto j = run.first; j < run.second; ++j) {
+                    if (j < i && core[j] != 0 && grid.within(i, j)) {
+                        detail::uf_unite(parents, grid.original(i), grid.original(j));
+                    }
+                }
+            }
+        }
+    });
+
+    // the roots become the clusters, in the order of the sequential scan
+    std::vector<index_t> labels(num_points, 0);
+#pragma omp parallel for
+    for (int64_t i = 0; i < num_points; ++i) {
+        if (core[i] != 0) labels[grid.original(i)] = 1;
+    }
+    index_t cluster_idx = static_cast<cluster_type_ut>(cluster_type::NOISE);
+    for (int64_t pidx = 0; pidx < num_points; ++pidx) {
+        if (labels[pidx] != 0 && detail::uf_find(parents, pidx) == static_cast<index_t>(pidx)) {
+            labels[pidx] = ++cluster_idx;
+        }
+    }
+
+    detail::for_all_cells(
+        grid, [&grid, &core, &parents, &labels, &clusters](range_t const& points, std::vector<range_t> const& runs) {
+            for (auto i = points.first; i < points.second; ++i) {
+                auto root = std::numeric_limits<index_t>::max();
+                if (core[i] != 0) {
+                    root = detail::uf_find(parents, grid.original(i));
+                } else {
+                    for (auto const& run : runs) {
+                        for (auto j = run.first; j < run.second; ++j) {
+                            if (core[j] != 0 && grid.within(i, j)) {
+                                root = std::min(root, detail::uf_find(parents, grid.original(j)));
+                            }
+                        }
+                    }
+                }
+                if (root != std::numeric_limits<index_t>::max()) clusters[grid.original(i)] = labels[root];
+            }
+        });
+
+    return clusters;
+}
+
 } // namespace megamol::stdplugin::datatools::clustering
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "ParticleIColClustering.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 
@@ -9,7 +10,8 @@ megamol::stdplugin::datatools::clustering::ParticleIColClustering::ParticleIColC
         : AbstractParticleManipulator("outData", "inData")
         , _eps_slot("eps", "")
         , _minpts_slot("minpts", "")
-        , _icol_weight("icol weight", "") {
+        , _icol_weight("icol weight", "")
+        , _parallel_slot("parallel", "Use the grid-based parallel DBSCAN, which yields the same clusters") {
     _eps_slot << new core::param::FloatParam(0.1f, 0.0f, 1.0f);
     MakeSlotAvailable(&_eps_slot);
 
@@ -18,6 +20,9 @@ megamol::stdplugin::datatools::clustering::ParticleIColClustering::ParticleIColC
 
     _icol_weight << new core::param::FloatParam(0.5f, 0.0f, 1.0f);
     MakeSlotAvailable(&_icol_weight);
+
+    _parallel_slot << new core::param::BoolParam(true);
+    MakeSlotAvailable(&_parallel_slot);
 }
 
 
@@ -38,6 +43,7 @@ bool megamol::stdplugin::datatools::clustering::ParticleIColClustering::manipula
         auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
         auto const minpts = static_cast<index_t>(_minpts_slot.Param<core::param::IntParam>()->Value());
         auto const icol_weight = _icol_weight.Param<core::param::FloatParam>()->Value();
+        auto const parallel = _parallel_slot.Param<core::param::BoolParam>()->Value();
 
         std::array<float, 4> weights = {(1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
 
@@ -80,12 +86,21 @@ bool megamol::stdplugin::datatools::clustering::ParticleIColClustering::manipula
                 _points[pl_idx] = std::make_shared<genericPointcloud<float, 4>>(cur_points, bbox, weights);
                 _points[pl_idx]->normalize_data();
 
-                _kd_trees[pl_idx] = std::make_shared<kd_tree_t<float, 4>>(
-                    4, *_points[pl_idx], nanoflann::KDTreeSingleIndexAdaptorParams());
-                _kd_trees[pl_idx]->buildIndex();
+                _kd_trees[pl_idx] = nullptr;
             }
 
-            auto const cluster_res = DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
+            cluster_result_t cluster_res;
+            if (parallel) {
+                cluster_res = DBSCAN_parallel(*_points[pl_idx], eps * eps, minpts);
+            } else {
+                // the parallel variant brings its own search structure
+                if (_kd_trees[pl_idx] == nullptr) {
+                    _kd_trees[pl_idx] = std::make_shared<kd_tree_t<float, 4>>(
+                        4, *_points[pl_idx], nanoflann::KDTreeSingleIndexAdaptorParams());
+                    _kd_trees[pl_idx]->buildIndex();
+                }
+                cluster_res = DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
+            }
 
             _ret_cols[pl_idx].resize(p_count);
             std::transform(cluster_res.cbegin(), cluster_res.cend(), _ret_cols[pl_idx].begin(),
@@ -0,0 +1,79 @@
+/*
+ * MappedFile.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "io/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else /* _WIN32 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+using namespace megamol::stdplugin::datatools;
+
+/*
+ * io::MappedFile::~MappedFile
+ */
+io::MappedFile::~MappedFile(void) {
+    this->Close();
+}
+
+/*
+ * io::MappedFile::Open
+ */
+bool io::MappedFile::Open(const std::string& path) {
+    this->Close();
+#ifdef _WIN32
+    HANDLE file = ::CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    this->file = file;
+    LARGE_INTEGER fileSize;
+    if (!::GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0)) return false;
+    this->mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (this->mapping == NULL) return false;
+    this->data = static_cast<const char*>(::MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+    if (this->data == nullptr) return false;
+    this->size = static_cast<std::size_t>(fileSize.QuadPart);
+#else /* _WIN32 */
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if ((::fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        ::close(fd);
+        return false;
+    }
+    void* ptr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return false;
+    ::madvise(ptr, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    this->data = static_cast<const char*>(ptr);
+    this->size = static_cast<std::size_t>(st.st_size);
+#endif /* _WIN32 */
+    return true;
+}
+
+/*
+ * io::MappedFile::Close
+ */
+void io::MappedFile::Close(void) {
+#ifdef _WIN32
+    if (this->data != nullptr) ::UnmapViewOfFile(this->data);
+    if (this->mapping != nullptr) ::CloseHandle(this->mapping);
+    if (this->file != nullptr) ::CloseHandle(this->file);
+    this->mapping = nullptr;
+    this->file = nullptr;
+#else /* _WIN32 */
+    if (this->data != nullptr) ::munmap(const_cast<char*>(this->data), this->size);
+#endif /* _WIN32 */
+    this->data = nullptr;
+    this->size = 0;
+}
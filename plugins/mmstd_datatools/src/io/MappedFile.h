@@ -0,0 +1,72 @@
+/*
+ * MappedFile.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_IO_MAPPEDFILE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_IO_MAPPEDFILE_H_INCLUDED
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+namespace io {
+
+/**
+ * Read-only memory mapping of a whole file, used by the readers that parse
+ * large files in parallel.
+ */
+class MappedFile {
+public:
+    MappedFile(void) = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile(void);
+
+    /**
+     * Maps the file 'path', replacing the current mapping.
+     *
+     * @param path The path of the file.
+     *
+     * @return false if the file cannot be mapped or is empty.
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * Unmaps the file.
+     */
+    void Close(void);
+
+    inline const char* Begin(void) const {
+        return this->data;
+    }
+
+    inline const char* End(void) const {
+        return this->data + this->size;
+    }
+
+    inline std::size_t Size(void) const {
+        return this->size;
+    }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif /* _WIN32 */
+};
+
+} /* end namespace io */
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_IO_MAPPEDFILE_H_INCLUDED */
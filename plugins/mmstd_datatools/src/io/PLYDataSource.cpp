@@ -7,11 +7,19 @@
 
 #include "stdafx.h"
 #include "io/PLYDataSource.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <omp.h>
 #include "geometry_calls/CallTriMeshData.h"
+#include "io/MappedFile.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/FlexEnumParam.h"
@@ -124,6 +132,120 @@ template <class T> void changeEndianness(T& obj) {
     std::reverse(mem, mem + sizeof(T));
 }
 
+/** Location of a property inside of the elements of the binary data */
+struct PropertyLayout {
+    bool present = false;
+    uint64_t stride = 0;
+    uint64_t size = 0;
+};
+
+/**
+ * Copies up to three properties of 'count' binary elements to the interleaved
+ * array 'out' in parallel. Missing properties are left untouched. If the
+ * elements are the interleaved triples already, they are copied in blocks.
+ *
+ * @param elements The first element in the file data.
+ * @param elemSize The size of an element in bytes.
+ * @param props The layout of the three properties.
+ * @param swapBytes Whether the endianness has to be changed.
+ * @param out The output array with 3 * 'count' values.
+ * @param count The number of elements.
+ */
+template <class T>
+void gatherTriples(const char* elements, uint64_t elemSize, const std::array<PropertyLayout, 3>& props, bool swapBytes,
+    T* out, uint64_t count) {
+    const int64_t cnt = static_cast<int64_t>(count);
+    bool packed = !swapBytes && (elemSize == 3 * sizeof(T));
+    for (uint64_t i = 0; i < 3; i++) {
+        packed = packed && props[i].present && (props[i].size == sizeof(T)) && (props[i].stride == i * sizeof(T));
+    }
+    if (packed) {
+        const int64_t blockSize = 1 << 16;
+#pragma omp parallel for
+        for (int64_t first = 0; first < cnt; first += blockSize) {
+            std::memcpy(out + 3 * first, elements + first * elemSize, std::min(blockSize, cnt - first) * elemSize);
+        }
+        return;
+    }
+#pragma omp parallel for
+    for (int64_t e = 0; e < cnt; e++) {
+        const char* element = elements + e * elemSize;
+        for (int i = 0; i < 3; i++) {
+            if (!props[i].present) continue;
+            std::memcpy(&out[3 * e + i], element + props[i].stride, props[i].size);
+            if (swapBytes) changeEndianness(out[3 * e + i]);
+        }
+    }
+}
+
+/**
+ * Copies the vertex indices of 'count' binary triangular faces in parallel.
+ *
+ * @param faces The first face in the file data.
+ * @param faceSize The size of a face in bytes.
+ * @param offset The offset of the first index inside of a face.
+ * @param size The size of an index in bytes.
+ * @param swapBytes Whether the endianness has to be changed.
+ * @param out The output array with 3 * 'count' indices.
+ * @param count The number of faces.
+ */
+template <class T>
+void gatherFaces(
+    const char* faces, uint64_t faceSize, uint64_t offset, uint64_t size, bool swapBytes, T* out, uint64_t count) {
+    const int64_t cnt = static_cast<int64_t>(count);
+#pragma omp parallel for
+    for (int64_t f = 0; f < cnt; f++) {
+        std::memcpy(&out[3 * f], faces + f * faceSize + offset, 3 * size);
+        if (swapBytes) {
+            changeEndianness(out[3 * f + 0]);
+            changeEndianness(out[3 * f + 1]);
+            changeEndianness(out[3 * f + 2]);
+        }
+    }
+}
+
+/**
+ * Splits the ASCII data [begin, end) into ranges of whole lines for the
+ * parallel parser.
+ *
+ * @param begin The start of the data.
+ * @param end The end of the data.
+ * @param count The requested number of ranges.
+ * @return The bounds of the ranges, i.e. one more than their number.
+ */
+std::vector<const char*> splitLineRanges(const char* begin, const char* end, size_t count) {
+    std::vector<const char*> bounds(1, begin);
+    const size_t size = static_cast<size_t>(end - begin);
+    for (size_t i = 1; i < count; i++) {
+        const char* p = std::max(begin + size / count * i, bounds.back());
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        if (nl == nullptr) break;
+        p = static_cast<const char*>(nl) + 1;
+        if (p == end) break;
+        bounds.push_back(p);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+/**
+ * Parses a number of an ASCII line.
+ *
+ * @param first The start of the token.
+ * @param last The end of the token.
+ * @return The parsed value.
+ */
+template <class T> T parseToken(const char* first, const char* last) {
+    char buffer[64];
+    const size_t len = std::min(static_cast<size_t>(last - first), sizeof(buffer) - 1);
+    std::memcpy(buffer, first, len);
+    buffer[len] = '\0';
+    if (std::is_floating_point<T>::value) {
+        return static_cast<T>(std::strtod(buffer, nullptr));
+    }
+    return static_cast<T>(std::strtoul(buffer, nullptr, 10));
+}
+
 /*
  * io::PLYDataSource::theUndef
  */
@@ -236,18 +358,15 @@ bool io::PLYDataSource::assertData() {
     // if one of these pointers is not null, we already have read the data
     if (posPointers.pos_double != nullptr || posPointers.pos_float != nullptr) return true;
 
-    instream.close();
-    instream.open(filename.Param<core::param::FilePathParam>()->Value(), std::ios::binary);
-    if (instream.fail()) {
+    // the data is parsed in parallel from a mapping of the whole file
+    io::MappedFile file;
+    if (!file.Open(vislib::StringA(filename.Param<core::param::FilePathParam>()->Value()).PeekBuffer()) ||
+        (file.Size() < this->data_offset)) {
         megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_ERROR, "Unable to open PLY File \"%s\".",
             vislib::StringA(filename.Param<core::param::FilePathParam>()->Value()).PeekBuffer());
         return true;
     }
-    // if one of these pointers is not null, we already have read the data
-    //if (posPointers.pos_double != nullptr || posPointers.pos_float != nullptr) return true;
 
-    // jump to the data in the file
-    instream.seekg(this->data_offset, instream.beg);
     size_t vertexCount = 0;
     size_t faceCount = 0;
 
@@ -336,16 +455,11 @@ bool io::PLYDataSource::assertData() {
         }
     }
 
-    auto const flt_max = std::numeric_limits<float>::max();
-    auto const flt_min = std::numeric_limits<float>::lowest();
-    this->boundingBox.Set(flt_max, flt_max, flt_max, flt_min, flt_min, flt_min);
-    float* bbPointer = const_cast<float*>(boundingBox.PeekBounds()); // hackedihack
-
     if (this->hasBinaryFormat) {
-        // vector storing the read data seperately
-        std::vector<std::vector<char>> readData(this->elementCount.size());
-        for (size_t i = 0; i < readData.size(); i++) {
-            // maybe TODO: skip unnecessary elements
+        // locate the elements in the file, unused elements are never touched
+        std::vector<const char*> elementData(this->elementCount.size());
+        uint64_t offset = this->data_offset;
+        for (size_t i = 0; i < elementData.size(); i++) {
             uint64_t readsize = elementSizes[i];
             if (elementIndexMap.count(selectedIndices) > 0) {
                 auto idx = elementIndexMap[selectedIndices];
@@ -354,10 +468,9 @@ bool io::PLYDataSource::assertData() {
                     readsize = listSizes[idx.first][idx.second] + 3 * propertySizes[idx.first][idx.second];
                 }
             }
-            readData[i].resize(elementCount[i] * readsize);
-            auto ms = readData[i].max_size();
-            instream.read(reinterpret_cast<char*>(readData[i].data()), elementCount[i] * readsize);
-            if (instream.fail()) {
+            elementData[i] = file.Begin() + offset;
+            offset += elementCount[i] * readsize;
+            if (offset > file.Size()) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "Reading of the field with index %i failed", static_cast<int>(i));
                 this->clearAllFields();
@@ -365,283 +478,272 @@ bool io::PLYDataSource::assertData() {
             }
         }
 
-        // copy the data into the vectors (this is necessary because the data may be interleaved, which is not always
-        // the case)
-        // this could be done partially in parallel
-        for (size_t i = 0; i < selectedPos.size(); i++) {
-            if (elementIndexMap.count(selectedPos[i]) > 0) {
-                auto idx = elementIndexMap[selectedPos[i]];
-                auto elemSize = elementSizes[idx.first];
-                auto size = propertySizes[idx.first][idx.second];
-                auto stride = propertyStrides[idx.first][idx.second];
-                if (posPointers.pos_float != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &posPointers.pos_float[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                        if (posPointers.pos_float[3 * v + i] < bbPointer[i]) {
-                            bbPointer[i] = posPointers.pos_float[3 * v + i];
-                        }
-                        if (posPointers.pos_float[3 * v + i] > bbPointer[i + 3]) {
-                            bbPointer[i + 3] = posPointers.pos_float[3 * v + i];
-                        }
-                    }
-                }
-                if (posPointers.pos_double != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &posPointers.pos_double[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                        if (posPointers.pos_double[3 * v + i] < bbPointer[i]) {
-                            bbPointer[i] = static_cast<float>(posPointers.pos_double[3 * v + i]);
-                        }
-                        if (posPointers.pos_double[3 * v + i] > bbPointer[i + 3]) {
-                            bbPointer[i + 3] = static_cast<float>(posPointers.pos_double[3 * v + i]);
-                        }
-                    }
+        // copy the data into the arrays, this is necessary because the data may be interleaved
+        auto layoutOf = [this](const std::vector<std::string>& names, uint64_t& element) {
+            std::array<PropertyLayout, 3> props;
+            for (size_t i = 0; i < 3 && i < names.size(); i++) {
+                if (elementIndexMap.count(names[i]) > 0) {
+                    auto idx = elementIndexMap[names[i]];
+                    element = idx.first;
+                    props[i].present = true;
+                    props[i].stride = propertyStrides[idx.first][idx.second];
+                    props[i].size = propertySizes[idx.first][idx.second];
                 }
             }
+            return props;
+        };
+        const bool swapBytes = !isLittleEndian;
+
+        uint64_t elm = 0;
+        auto props = layoutOf(selectedPos, elm);
+        if (posPointers.pos_float != nullptr) {
+            gatherTriples(elementData[elm], elementSizes[elm], props, swapBytes, posPointers.pos_float, vertex_count);
+        }
+        if (posPointers.pos_double != nullptr) {
+            gatherTriples(elementData[elm], elementSizes[elm], props, swapBytes, posPointers.pos_double, vertex_count);
         }
 
-        for (size_t i = 0; i < selectedNormal.size(); i++) {
-            if (elementIndexMap.count(selectedNormal[i]) > 0) {
-                auto idx = elementIndexMap[selectedNormal[i]];
-                auto elemSize = elementSizes[idx.first];
-                auto size = propertySizes[idx.first][idx.second];
-                auto stride = propertyStrides[idx.first][idx.second];
-                if (normalPointers.norm_float != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &normalPointers.norm_float[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                    }
-                }
-                if (normalPointers.norm_double != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &normalPointers.norm_double[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                    }
-                }
-            }
+        props = layoutOf(selectedNormal, elm);
+        if (normalPointers.norm_float != nullptr) {
+            gatherTriples(
+                elementData[elm], elementSizes[elm], props, swapBytes, normalPointers.norm_float, vertex_count);
+        }
+        if (normalPointers.norm_double != nullptr) {
+            gatherTriples(
+                elementData[elm], elementSizes[elm], props, swapBytes, normalPointers.norm_double, vertex_count);
         }
 
-        for (size_t i = 0; i < selectedColor.size(); i++) {
-            if (i > 2) break;
-            if (elementIndexMap.count(selectedColor[i]) > 0) {
-                auto idx = elementIndexMap[selectedColor[i]];
-                auto elemSize = elementSizes[idx.first];
-                auto size = propertySizes[idx.first][idx.second];
-                auto stride = propertyStrides[idx.first][idx.second];
-                if (colorPointers.col_uchar != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &colorPointers.col_uchar[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                    }
-                }
-                if (colorPointers.col_float != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &colorPointers.col_float[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                    }
-                }
-                if (colorPointers.col_double != nullptr) {
-                    for (size_t v = 0; v < vertex_count; v++) {
-                        std::memcpy(
-                            &colorPointers.col_double[3 * v + i], &readData[idx.first][v * elemSize + stride], size);
-                    }
-                }
-            }
+        props = layoutOf(selectedColor, elm);
+        if (colorPointers.col_uchar != nullptr) {
+            gatherTriples(elementData[elm], elementSizes[elm], props, swapBytes, colorPointers.col_uchar, vertex_count);
+        }
+        if (colorPointers.col_float != nullptr) {
+            gatherTriples(elementData[elm], elementSizes[elm], props, swapBytes, colorPointers.col_float, vertex_count);
+        }
+        if (colorPointers.col_double != nullptr) {
+            gatherTriples(
+                elementData[elm], elementSizes[elm], props, swapBytes, colorPointers.col_double, vertex_count);
         }
 
         if (elementIndexMap.count(selectedIndices) > 0) {
             auto idx = elementIndexMap[selectedIndices];
-            auto elemSize = elementSizes[idx.first];
             auto size = propertySizes[idx.first][idx.second];
             auto stride = propertyStrides[idx.first][idx.second];
             auto listStartSize = listSizes[idx.first][idx.second];
             auto totSize = listStartSize + 3 * size;
+            const char* faces = elementData[idx.first];
             if (facePointers.face_uchar != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    std::memcpy(&facePointers.face_uchar[f * 3],
-                        &readData[idx.first][f * totSize + stride + listStartSize], 3 * size);
-                }
+                gatherFaces(faces, totSize, stride + listStartSize, size, swapBytes, facePointers.face_uchar, face_count);
             }
             if (facePointers.face_u16 != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    std::memcpy(&facePointers.face_u16[f * 3],
-                        &readData[idx.first][f * totSize + stride + listStartSize], 3 * size);
-                }
+                gatherFaces(faces, totSize, stride + listStartSize, size, swapBytes, facePointers.face_u16, face_count);
             }
             if (facePointers.face_u32 != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    std::memcpy(&facePointers.face_u32[f * 3],
-                        &readData[idx.first][f * totSize + stride + listStartSize], 3 * size);
-                }
-            }
-        }
-        // change endianness if necessary
-        if (!isLittleEndian) {
-            // this could be done in parallel
-            if (posPointers.pos_float != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(posPointers.pos_float[3 * v + 0]);
-                    changeEndianness(posPointers.pos_float[3 * v + 1]);
-                    changeEndianness(posPointers.pos_float[3 * v + 2]);
-                }
-            }
-            if (posPointers.pos_double != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(posPointers.pos_double[3 * v + 0]);
-                    changeEndianness(posPointers.pos_double[3 * v + 1]);
-                    changeEndianness(posPointers.pos_double[3 * v + 2]);
-                }
-            }
-            if (normalPointers.norm_float != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(normalPointers.norm_float[3 * v + 0]);
-                    changeEndianness(normalPointers.norm_float[3 * v + 1]);
-                    changeEndianness(normalPointers.norm_float[3 * v + 2]);
-                }
-            }
-            if (normalPointers.norm_double != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(normalPointers.norm_double[3 * v + 0]);
-                    changeEndianness(normalPointers.norm_double[3 * v + 1]);
-                    changeEndianness(normalPointers.norm_double[3 * v + 2]);
-                }
-            }
-            if (colorPointers.col_uchar != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(colorPointers.col_uchar[3 * v + 0]);
-                    changeEndianness(colorPointers.col_uchar[3 * v + 1]);
-                    changeEndianness(colorPointers.col_uchar[3 * v + 2]);
-                }
-            }
-            if (colorPointers.col_float != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(colorPointers.col_float[3 * v + 0]);
-                    changeEndianness(colorPointers.col_float[3 * v + 1]);
-                    changeEndianness(colorPointers.col_float[3 * v + 2]);
-                }
-            }
-            if (colorPointers.col_double != nullptr) {
-                for (size_t v = 0; v < vertex_count; v++) {
-                    changeEndianness(colorPointers.col_double[3 * v + 0]);
-                    changeEndianness(colorPointers.col_double[3 * v + 1]);
-                    changeEndianness(colorPointers.col_double[3 * v + 2]);
-                }
-            }
-            if (facePointers.face_uchar != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    changeEndianness(facePointers.face_uchar[3 * f + 0]);
-                    changeEndianness(facePointers.face_uchar[3 * f + 1]);
-                    changeEndianness(facePointers.face_uchar[3 * f + 2]);
-                }
-            }
-            if (facePointers.face_u16 != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    changeEndianness(facePointers.face_u16[3 * f + 0]);
-                    changeEndianness(facePointers.face_u16[3 * f + 1]);
-                    changeEndianness(facePointers.face_u16[3 * f + 2]);
-                }
-            }
-            if (facePointers.face_u32 != nullptr) {
-                for (size_t f = 0; f < face_count; f++) {
-                    changeEndianness(facePointers.face_u32[3 * f + 0]);
-                    changeEndianness(facePointers.face_u32[3 * f + 1]);
-                    changeEndianness(facePointers.face_u32[3 * f + 2]);
-                }
+                gatherFaces(faces, totSize, stride + listStartSize, size, swapBytes, facePointers.face_u32, face_count);
             }
         }
     } else { // ascii format
-        std::string line;
+        // index of the first line of each element
+        std::vector<uint64_t> firstLine(this->elementCount.size() + 1, 0);
+        std::partial_sum(this->elementCount.begin(), this->elementCount.end(), firstLine.begin() + 1);
+        int64_t vertElm = -1;
+        int64_t faceElm = -1;
         for (size_t elm = 0; elm < this->elementCount.size(); elm++) {
-            // parse vertices
-            if (icompare(elementNames[elm], selectedVertices)) {
-                for (size_t i = 0; i < vertexCount; i++) {
-                    if (std::getline(instream, line)) {
-                        auto split = isplit(line);
-                        for (size_t j = 0; j < selectedPos.size(); j++) {
-                            if (elementIndexMap.count(selectedPos[j]) > 0) {
-                                auto idx = elementIndexMap[selectedPos[j]];
+            if (icompare(elementNames[elm], selectedVertices)) vertElm = static_cast<int64_t>(elm);
+            if (icompare(elementNames[elm], selectedFaces)) faceElm = static_cast<int64_t>(elm);
+        }
+        if (vertElm < 0) vertexCount = 0;
+        if ((faceElm < 0) || (elementIndexMap.count(selectedIndices) == 0)) faceCount = 0;
+
+        // split the data into ranges of whole lines and count their lines
+        const char* begin = file.Begin() + this->data_offset;
+        const char* end = file.End();
+        const auto bounds = splitLineRanges(begin, end, 4 * static_cast<size_t>(omp_get_max_threads()));
+        const int64_t rangeCount = static_cast<int64_t>(bounds.size() - 1);
+        std::vector<uint64_t> rangeFirstLine(bounds.size(), 0);
+#pragma omp parallel for
+        for (int64_t r = 0; r < rangeCount; r++) {
+            uint64_t lines = static_cast<uint64_t>(std::count(bounds[r], bounds[r + 1], '\n'));
+            if ((bounds[r + 1] != bounds[r]) && (bounds[r + 1][-1] != '\n')) lines++;
+            rangeFirstLine[r + 1] = lines;
+        }
+        std::partial_sum(rangeFirstLine.begin(), rangeFirstLine.end(), rangeFirstLine.begin());
+        const uint64_t lineCount = rangeFirstLine.back();
+
+        if ((vertexCount > 0) && (lineCount < firstLine[vertElm] + vertexCount)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError("Unexpected file ending during vertex parsing");
+            this->clearAllFields();
+            return false;
+        }
+        if ((faceCount > 0) && (lineCount < firstLine[faceElm] + faceCount)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError("Unexpected file ending during face parsing");
+            this->clearAllFields();
+            return false;
+        }
+
+        // token index of each selected property, or -1
+        auto tokensOf = [this](const std::vector<std::string>& names) {
+            std::array<int64_t, 3> tokens = {-1, -1, -1};
+            for (size_t i = 0; i < 3 && i < names.size(); i++) {
+                if (elementIndexMap.count(names[i]) > 0) tokens[i] = elementIndexMap[names[i]].second;
+            }
+            return tokens;
+        };
+        const auto posTokens = tokensOf(selectedPos);
+        const auto normalTokens = tokensOf(selectedNormal);
+        const auto colorTokens = tokensOf(selectedColor);
+
+        std::atomic<bool> malformed(false);
+        std::atomic<bool> nonTriangular(false);
+#pragma omp parallel
+        {
+            std::vector<std::pair<const char*, const char*>> tokens;
+#pragma omp for schedule(dynamic, 1)
+            for (int64_t r = 0; r < rangeCount; r++) {
+                uint64_t line = rangeFirstLine[r];
+                for (const char* p = bounds[r]; p != bounds[r + 1]; line++) {
+                    const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', bounds[r + 1] - p));
+                    if (lineEnd == nullptr) lineEnd = bounds[r + 1];
+                    const char* next = (lineEnd == bounds[r + 1]) ? lineEnd : lineEnd + 1;
+
+                    const bool isVertex = (vertexCount > 0) && (line >= firstLine[vertElm]) &&
+                                          (line < firstLine[vertElm] + vertexCount);
+                    const bool isFace =
+                        (faceCount > 0) && (line >= firstLine[faceElm]) && (line < firstLine[faceElm] + faceCount);
+                    if (!isVertex && !isFace) {
+                        p = next;
+                        continue;
+                    }
+
+                    tokens.clear();
+                    while (p != lineEnd) {
+                        while ((p != lineEnd) && ((*p == ' ') || (*p == '\t') || (*p == '\r'))) ++p;
+                        const char* first = p;
+                        while ((p != lineEnd) && (*p != ' ') && (*p != '\t') && (*p != '\r')) ++p;
+                        if (first != p) tokens.emplace_back(first, p);
+                    }
+                    p = next;
+
+                    if (isVertex) {
+                        const uint64_t i = line - firstLine[vertElm];
+                        for (size_t j = 0; j < 3; j++) {
+                            if (posTokens[j] >= 0) {
+                                if (static_cast<size_t>(posTokens[j]) >= tokens.size()) {
+                                    malformed = true;
+                                    continue;
+                                }
+                                const auto& t = tokens[posTokens[j]];
                                 if (posPointers.pos_float != nullptr) {
-                                    posPointers.pos_float[3 * i + j] = std::stof(split[idx.second]);
+                                    posPointers.pos_float[3 * i + j] = parseToken<float>(t.first, t.second);
                                 }
                                 if (posPointers.pos_double != nullptr) {
-                                    posPointers.pos_double[3 * i + j] = std::stod(split[idx.second]);
-                                }
-                                if (std::stof(split[idx.second]) < bbPointer[j]) {
-                                    bbPointer[j] = std::stof(split[idx.second]);
-                                }
-                                if (std::stof(split[idx.second]) > bbPointer[j + 3]) {
-                                    bbPointer[j + 3] = std::stof(split[idx.second]);
+                                    posPointers.pos_double[3 * i + j] = parseToken<double>(t.first, t.second);
                                 }
                             }
-                        }
-                        for (size_t j = 0; j < selectedNormal.size(); j++) {
-                            if (elementIndexMap.count(selectedNormal[j]) > 0) {
-                                auto idx = elementIndexMap[selectedNormal[j]];
+                            if (normalTokens[j] >= 0) {
+                                if (static_cast<size_t>(normalTokens[j]) >= tokens.size()) {
+                                    malformed = true;
+                                    continue;
+                                }
+                                const auto& t = tokens[normalTokens[j]];
                                 if (normalPointers.norm_float != nullptr) {
-                                    normalPointers.norm_float[3 * i + j] = std::stof(split[idx.second]);
+                                    normalPointers.norm_float[3 * i + j] = parseToken<float>(t.first, t.second);
                                 }
                                 if (normalPointers.norm_double != nullptr) {
-                                    normalPointers.norm_double[3 * i + j] = std::stod(split[idx.second]);
+                                    normalPointers.norm_double[3 * i + j] = parseToken<double>(t.first, t.second);
                                 }
                             }
-                        }
-                        for (size_t j = 0; j < selectedColor.size(); j++) {
-                            if (elementIndexMap.count(selectedColor[j]) > 0) {
-                                auto idx = elementIndexMap[selectedColor[j]];
+                            if (colorTokens[j] >= 0) {
+                                if (static_cast<size_t>(colorTokens[j]) >= tokens.size()) {
+                                    malformed = true;
+                                    continue;
+                                }
+                                const auto& t = tokens[colorTokens[j]];
                                 if (colorPointers.col_uchar != nullptr) {
-                                    colorPointers.col_uchar[3 * i + j] =
-                                        static_cast<unsigned char>(std::stoul(split[idx.second]));
+                                    colorPointers.col_uchar[3 * i + j] = parseToken<unsigned char>(t.first, t.second);
                                 }
                                 if (colorPointers.col_float != nullptr) {
-                                    colorPointers.col_float[3 * i + j] = std::stof(split[idx.second]);
+                                    colorPointers.col_float[3 * i + j] = parseToken<float>(t.first, t.second);
                                 }
                                 if (colorPointers.col_double != nullptr) {
-                                    colorPointers.col_double[3 * i + j] = std::stod(split[idx.second]);
+                                    colorPointers.col_double[3 * i + j] = parseToken<double>(t.first, t.second);
                                 }
                             }
                         }
-                    } else {
-                        megamol::core::utility::log::Log::DefaultLog.WriteError("Unexpected file ending during vertex parsing");
-                        return false;
                     }
-                }
-            }
-            // parse faces
-            if (icompare(elementNames[elm], selectedFaces)) {
-                for (size_t i = 0; i < faceCount; i++) {
-                    if (std::getline(instream, line)) {
-                        auto split = isplit(line);
-                        if (elementIndexMap.count(selectedIndices)) {
-                            uint64_t faceSize = static_cast<uint64_t>(std::stoul(split[0]));
-                            if (faceSize != 3) {
-                                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                                    "The PlyDataSource is currently only able to handle triangular faces");
-                                return false;
+
+                    if (isFace) {
+                        const uint64_t i = line - firstLine[faceElm];
+                        if (tokens.empty() || (parseToken<uint64_t>(tokens[0].first, tokens[0].second) != 3)) {
+                            nonTriangular = true;
+                            continue;
+                        }
+                        if (tokens.size() < 4) {
+                            malformed = true;
+                            continue;
+                        }
+                        for (size_t j = 1; j < 4; j++) {
+                            const auto index = parseToken<uint32_t>(tokens[j].first, tokens[j].second);
+                            if (facePointers.face_uchar != nullptr) {
+                                facePointers.face_uchar[3 * i + j - 1] = static_cast<unsigned char>(index);
                             }
-                            for (size_t j = 1; j < faceSize + 1; j++) {
-                                unsigned long bla = std::stoul(split[j]);
-                                if (facePointers.face_uchar != nullptr) {
-                                    facePointers.face_uchar[3 * i + j - 1] = static_cast<unsigned char>(bla);
-                                }
-                                if (facePointers.face_u16 != nullptr) {
-                                    facePointers.face_u16[3 * i + j - 1] = static_cast<uint16_t>(bla);
-                                }
-                                if (facePointers.face_u32 != nullptr) {
-                                    facePointers.face_u32[3 * i + j - 1] = static_cast<uint32_t>(bla);
-                                }
+                            if (facePointers.face_u16 != nullptr) {
+                                facePointers.face_u16[3 * i + j - 1] = static_cast<uint16_t>(index);
+                            }
+                            if (facePointers.face_u32 != nullptr) {
+                                facePointers.face_u32[3 * i + j - 1] = index;
                             }
                         }
-                    } else {
-                        megamol::core::utility::log::Log::DefaultLog.WriteError("Unexpected file ending during face parsing");
-                        return false;
                     }
                 }
             }
         }
+
+        if (nonTriangular) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "The PlyDataSource is currently only able to handle triangular faces");
+            this->clearAllFields();
+            return false;
+        }
+        if (malformed) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError("Missing values in the ASCII data of the PLY file");
+            this->clearAllFields();
+            return false;
+        }
     }
 
-    instream.close();
+    // compute the bounding box from the positions, one box per thread that are merged afterwards
+    const float lo = std::numeric_limits<float>::lowest(), hi = std::numeric_limits<float>::max();
+    std::vector<std::array<float, 6>> threadBoxes(
+        omp_get_max_threads(), std::array<float, 6>{hi, hi, hi, lo, lo, lo});
+    const int64_t vertCnt = static_cast<int64_t>(posPointers.pos_float != nullptr || posPointers.pos_double != nullptr
+                                                     ? this->vertex_count
+                                                     : 0);
+#pragma omp parallel
+    {
+        auto& box = threadBoxes[omp_get_thread_num()];
+#pragma omp for
+        for (int64_t v = 0; v < vertCnt; v++) {
+            float p[3];
+            for (int d = 0; d < 3; ++d) {
+                p[d] = (posPointers.pos_float != nullptr) ? posPointers.pos_float[3 * v + d]
+                                                          : static_cast<float>(posPointers.pos_double[3 * v + d]);
+                box[d] = std::min(box[d], p[d]);
+                box[d + 3] = std::max(box[d + 3], p[d]);
+            }
+        }
+    }
+    auto bounds = threadBoxes[0];
+    for (size_t t = 1; t < threadBoxes.size(); ++t) {
+        for (int d = 0; d < 3; ++d) {
+            bounds[d] = std::min(bounds[d], threadBoxes[t][d]);
+            bounds[d + 3] = std::max(bounds[d + 3], threadBoxes[t][d + 3]);
+        }
+    }
+    const float minX = bounds[0], minY = bounds[1], minZ = bounds[2];
+    const float maxX = bounds[3], maxY = bounds[4], maxZ = bounds[5];
+    this->boundingBox.Set(minX, minY, minZ, maxX, maxY, maxZ);
+
     return true;
 }
 
@@ -7,10 +7,12 @@
 
 #include "../stdafx.h"
 #include "STLDataSource.h"
+#include "MappedFile.h"
 
 #include "mmcore/Call.h"
 #include "mmcore/AbstractGetData3DCall.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/utility/DataHash.h"
 
@@ -24,6 +26,8 @@
 
 #include <array>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <fstream>
 #include <limits>
@@ -34,6 +38,8 @@
 #include <string>
 #include <vector>
 
+#include <omp.h>
+
 namespace megamol
 {
 	namespace stdplugin
@@ -43,6 +49,7 @@ namespace megamol
 			namespace io
 			{
 				STLDataSource::STLDataSource() : filename_slot("STL file", "The name of to the STL file to load")
+					, weld_slot("weld vertices", "Merge vertices with identical positions, averaging the facet normals")
 					, mesh_output_slot("mesh_data", "Slot to request mesh data")
 #ifdef MEGAMOL_NG_MESH
 					, ngmesh_output_slot("ngmesh_data", "Slot to request mesh data for the NGMeshRenderer")
@@ -53,6 +60,9 @@ namespace megamol
 					this->filename_slot << new core::param::FilePathParam("");
 					Module::MakeSlotAvailable(&this->filename_slot);
 
+					this->weld_slot << new core::param::BoolParam(false);
+					Module::MakeSlotAvailable(&this->weld_slot);
+
 					// Create output slot for triangle mesh data
 					this->mesh_output_slot.SetCallback(geocalls::CallTriMeshData::ClassName(), "GetExtent", &STLDataSource::get_extent_callback);
 					this->mesh_output_slot.SetCallback(geocalls::CallTriMeshData::ClassName(), "GetData", &STLDataSource::get_mesh_data_callback);
@@ -86,9 +96,10 @@ namespace megamol
 					// Get mesh call
 					auto& call = dynamic_cast<core::AbstractGetData3DCall&>(caller);
 
-					if (this->filename_slot.IsDirty())
+					if (this->filename_slot.IsDirty() || this->weld_slot.IsDirty())
 					{
 						this->filename_slot.ResetDirty();
+						this->weld_slot.ResetDirty();
 
 						// Read data
 						const auto& vislib_filename = this->filename_slot.Param<core::param::FilePathParam>()->Value();
@@ -97,6 +108,11 @@ namespace megamol
 						try
 						{
 							read(filename);
+
+							if (this->weld_slot.Param<core::param::BoolParam>()->Value())
+							{
+								weld_vertices();
+							}
 						}
 						catch (const std::runtime_error& ex)
 						{
@@ -105,27 +121,52 @@ namespace megamol
 							return false;
 						}
 
-						// Extract extent information
-						this->min_x = this->min_y = this->min_z = std::numeric_limits<float>::max();
-						this->max_x = this->max_y = this->max_z = std::numeric_limits<float>::lowest();
+						// Extract extent information, one box per thread that are merged afterwards
+						const float lo = std::numeric_limits<float>::lowest();
+						const float hi = std::numeric_limits<float>::max();
+						std::vector<std::array<float, 6>> thread_boxes(omp_get_max_threads(), std::array<float, 6>{ hi, hi, hi, lo, lo, lo });
 
 						const float* vertices = reinterpret_cast<float*>(&this->vertex_normal_buffer[2 * sizeof(uint32_t)]);
+						const int64_t num_vertices = static_cast<int64_t>(this->num_vertices);
 
-						for (std::size_t value_index = 0; value_index < static_cast<std::size_t>(this->num_triangles * 9); )
+#pragma omp parallel
 						{
-							const float x = vertices[value_index++];
-							const float y = vertices[value_index++];
-							const float z = vertices[value_index++];
+							auto& box = thread_boxes[omp_get_thread_num()];
+
+#pragma omp for
+							for (int64_t vertex_index = 0; vertex_index < num_vertices; ++vertex_index)
+							{
+								for (int d = 0; d < 3; ++d)
+								{
+									const float value = vertices[3 * vertex_index + d];
+
+									box[d] = std::min(box[d], value);
+									box[d + 3] = std::max(box[d + 3], value);
+								}
+							}
+						}
 
-							this->min_x = std::min(this->min_x, x);
-							this->min_y = std::min(this->min_y, y);
-							this->min_z = std::min(this->min_z, z);
+						std::array<float, 6> bounds = thread_boxes[0];
 
-							this->max_x = std::max(this->max_x, x);
-							this->max_y = std::max(this->max_y, y);
-							this->max_z = std::max(this->max_z, z);
+						for (std::size_t thread = 1; thread < thread_boxes.size(); ++thread)
+						{
+							for (int d = 0; d < 3; ++d)
+							{
+								bounds[d] = std::min(bounds[d], thread_boxes[thread][d]);
+								bounds[d + 3] = std::max(bounds[d + 3], thread_boxes[thread][d + 3]);
+							}
 						}
 
+						const float min_x = bounds[0], min_y = bounds[1], min_z = bounds[2];
+						const float max_x = bounds[3], max_y = bounds[4], max_z = bounds[5];
+
+						this->min_x = min_x;
+						this->min_y = min_y;
+						this->min_z = min_z;
+						this->max_x = max_x;
+						this->max_y = max_y;
+						this->max_z = max_z;
+
 						megamol::core::utility::log::Log::DefaultLog.WriteInfo("Extent: [%.2f, %.2f, %.2f] x [%.2f, %.2f, %.2f]",
 							this->min_x, this->min_y, this->min_z, this->max_x, this->max_y, this->max_z);
 					}
@@ -143,7 +184,7 @@ namespace megamol
 					if (call.DataHash() != static_cast<SIZE_T>(hash()))
 					{
 						// Read data if necessary
-						if (this->filename_slot.IsDirty())
+						if (this->filename_slot.IsDirty() || this->weld_slot.IsDirty())
 						{
 							if (!get_extent_callback(caller))
 							{
@@ -154,9 +195,9 @@ namespace megamol
 						call.SetDataHash(static_cast<SIZE_T>(hash()));
 
 						// Fill call
-						this->mesh.SetVertexData(static_cast<unsigned int>(this->num_triangles * 3),
+						this->mesh.SetVertexData(static_cast<unsigned int>(this->num_vertices),
 							reinterpret_cast<float*>(&this->vertex_normal_buffer.data()[2 * sizeof(uint32_t)]),
-							reinterpret_cast<float*>(&this->vertex_normal_buffer.data()[2 * sizeof(uint32_t) + 9 * this->num_triangles * sizeof(float)]),
+							reinterpret_cast<float*>(&this->vertex_normal_buffer.data()[2 * sizeof(uint32_t) + 3 * static_cast<std::size_t>(this->num_vertices) * sizeof(float)]),
 							nullptr, nullptr, false);
 
 						this->mesh.SetTriangleData(static_cast<unsigned int>(this->num_triangles), this->index_buffer.data(), false);
@@ -306,30 +347,39 @@ namespace megamol
 
 				void STLDataSource::read_binary(const std::string& filename)
 				{
-					std::ifstream ifs(filename, std::ofstream::in | std::ofstream::binary);
+					MappedFile file;
 
-					if (ifs.good())
+					if (file.Open(filename))
 					{
+						const std::size_t header_size = 80 * sizeof(uint8_t) + sizeof(uint32_t);
+						const std::size_t triangle_size = 12 * sizeof(float) + sizeof(uint16_t);
+
+						if (file.Size() < header_size)
+						{
+							throw std::runtime_error("File is too small to be a binary STL file.");
+						}
+
 						// Get number of triangles from header
-						ifs.ignore(80 * sizeof(uint8_t));
-						ifs.read(reinterpret_cast<char*>(&this->num_triangles), sizeof(uint32_t));
+						std::memcpy(&this->num_triangles, file.Begin() + 80 * sizeof(uint8_t), sizeof(uint32_t));
 
 						// Sanity check for file size
-						ifs.ignore(std::numeric_limits<std::streamsize>::max());
-						std::streamsize file_size = ifs.gcount();
-
-						if (file_size != this->num_triangles * 50)
+						if (file.Size() - header_size != static_cast<std::size_t>(this->num_triangles) * triangle_size)
 						{
 							throw std::runtime_error("File size does not match the number of triangles.");
 						}
 
-						megamol::core::utility::log::Log::DefaultLog.WriteInfo("Number of triangles from binary STL file: %d", this->num_triangles);
+						if (static_cast<std::size_t>(this->num_triangles) * 3 > std::numeric_limits<uint32_t>::max())
+						{
+							throw std::runtime_error("Too many triangles for 32 bit vertex indices.");
+						}
 
-						// Read data
-						ifs.seekg(80 * sizeof(uint8_t) + sizeof(uint32_t));
+						megamol::core::utility::log::Log::DefaultLog.WriteInfo("Number of triangles from binary STL file: %u", this->num_triangles);
+
+						this->num_vertices = 3 * this->num_triangles;
 
+						// Convert the interleaved triangles to the vertex and normal blocks in parallel
 						const std::size_t header_block_size = sizeof(uint32_t);
-						const std::size_t data_block_size = 9 * this->num_triangles * sizeof(float);
+						const std::size_t data_block_size = 9 * static_cast<std::size_t>(this->num_triangles) * sizeof(float);
 
 						const std::size_t data_offset_1 = 2 * header_block_size;
 						const std::size_t data_offset_2 = 2 * header_block_size + data_block_size;
@@ -339,24 +389,24 @@ namespace megamol
 						reinterpret_cast<uint32_t&>(this->vertex_normal_buffer[0 * header_block_size]) = static_cast<uint32_t>(data_offset_1);
 						reinterpret_cast<uint32_t&>(this->vertex_normal_buffer[1 * header_block_size]) = static_cast<uint32_t>(data_offset_2);
 
-						std::size_t vertex_position = data_offset_1;
-						std::size_t normal_position = data_offset_2;
+						float* vertices = reinterpret_cast<float*>(&this->vertex_normal_buffer[data_offset_1]);
+						float* normals = reinterpret_cast<float*>(&this->vertex_normal_buffer[data_offset_2]);
+						const char* triangles = file.Begin() + header_size;
+						const int64_t num_triangles = static_cast<int64_t>(this->num_triangles);
 
-						for (std::size_t triangle_index = 0; triangle_index < static_cast<std::size_t>(this->num_triangles); ++triangle_index)
+#pragma omp parallel for
+						for (int64_t triangle_index = 0; triangle_index < num_triangles; ++triangle_index)
 						{
-							ifs.read(reinterpret_cast<char*>(&this->vertex_normal_buffer[normal_position]), 3 * sizeof(float));
-							ifs.read(reinterpret_cast<char*>(&this->vertex_normal_buffer[vertex_position]), 9 * sizeof(float));
-							ifs.ignore(sizeof(uint16_t));
+							const char* triangle = triangles + triangle_index * triangle_size;
 
-							std::memcpy(&this->vertex_normal_buffer[normal_position + 3 * sizeof(float)], &this->vertex_normal_buffer[normal_position], 3 * sizeof(float));
-							std::memcpy(&this->vertex_normal_buffer[normal_position + 6 * sizeof(float)], &this->vertex_normal_buffer[normal_position], 3 * sizeof(float));
-
-							vertex_position += 9 * sizeof(float);
-							normal_position += 9 * sizeof(float);
+							std::memcpy(&normals[9 * triangle_index + 0], triangle, 3 * sizeof(float));
+							std::memcpy(&normals[9 * triangle_index + 3], triangle, 3 * sizeof(float));
+							std::memcpy(&normals[9 * triangle_index + 6], triangle, 3 * sizeof(float));
+							std::memcpy(&vertices[9 * triangle_index], triangle + 3 * sizeof(float), 9 * sizeof(float));
 						}
 
 						// Fill index buffer
-						this->index_buffer.resize(this->num_triangles * 3);
+						this->index_buffer.resize(this->num_vertices);
 
 						std::iota(this->index_buffer.begin(), this->index_buffer.end(), 0);
 					}
@@ -623,6 +673,7 @@ namespace megamol
 						}
 
 						this->num_triangles = static_cast<uint32_t>(vertices.size() / 9);
+						this->num_vertices = 3 * this->num_triangles;
 						megamol::core::utility::log::Log::DefaultLog.WriteInfo("Number of triangles from ASCII STL file: %d", this->num_triangles);
 
 						// Fill buffer
@@ -634,21 +685,16 @@ namespace megamol
 						std::memcpy(&this->vertex_normal_buffer[2 * sizeof(uint32_t)], vertices.data(), 9 * this->num_triangles * sizeof(float));
 
 						const std::size_t offset = 2 * sizeof(uint32_t) + 9 * this->num_triangles * sizeof(float);
-						std::size_t position = 0;
+						float* vertex_normals = reinterpret_cast<float*>(&this->vertex_normal_buffer[offset]);
+						const int64_t num_triangles = static_cast<int64_t>(this->num_triangles);
 
-						for (std::size_t triangle_index = 0; triangle_index < this->num_triangles; ++triangle_index)
+#pragma omp parallel for
+						for (int64_t triangle_index = 0; triangle_index < num_triangles; ++triangle_index)
 						{
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 0];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 1];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 2];
-
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 0];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 1];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 2];
-
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 0];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 1];
-							reinterpret_cast<float*>(&this->vertex_normal_buffer[offset])[position++] = normals[triangle_index * 3 + 2];
+							for (int64_t corner = 0; corner < 3; ++corner)
+							{
+								std::memcpy(&vertex_normals[9 * triangle_index + 3 * corner], &normals[3 * triangle_index], 3 * sizeof(float));
+							}
 						}
 
 						// Fill index buffer
@@ -658,6 +704,195 @@ namespace megamol
 					}
 				}
 
+				namespace
+				{
+					/// <summary>
+					/// Hash of a vertex position, equal for -0 and +0
+					/// </summary>
+					inline uint64_t hash_position(const float* position)
+					{
+						uint64_t hash = 14695981039346656037ull;
+
+						for (int i = 0; i < 3; ++i)
+						{
+							const float value = position[i] + 0.0f;
+							uint32_t bits;
+							std::memcpy(&bits, &value, sizeof(uint32_t));
+
+							hash = (hash ^ bits) * 1099511628211ull;
+						}
+
+						return hash ^ (hash >> 29);
+					}
+				}
+
+				void STLDataSource::weld_vertices()
+				{
+					const uint32_t empty = std::numeric_limits<uint32_t>::max();
+					const int64_t num_vertices = static_cast<int64_t>(this->num_vertices);
+
+					const float* vertices = reinterpret_cast<const float*>(&this->vertex_normal_buffer[2 * sizeof(uint32_t)]);
+					const float* normals = vertices + 3 * static_cast<std::size_t>(num_vertices);
+
+					const auto same_position = [vertices](uint32_t lhs, uint32_t rhs)
+					{
+						return vertices[3 * static_cast<std::size_t>(lhs) + 0] == vertices[3 * static_cast<std::size_t>(rhs) + 0]
+							&& vertices[3 * static_cast<std::size_t>(lhs) + 1] == vertices[3 * static_cast<std::size_t>(rhs) + 1]
+							&& vertices[3 * static_cast<std::size_t>(lhs) + 2] == vertices[3 * static_cast<std::size_t>(rhs) + 2];
+					};
+
+					// Insert all vertices into a concurrent open addressing table, where each slot keeps the smallest
+					// index with its position, so that the result does not depend on the scheduling
+					std::size_t table_size = 1;
+
+					while (table_size < 2 * static_cast<std::size_t>(num_vertices))
+					{
+						table_size <<= 1;
+					}
+
+					const std::size_t mask = table_size - 1;
+					std::vector<std::atomic<uint32_t>> table(table_size);
+
+#pragma omp parallel for
+					for (int64_t slot = 0; slot < static_cast<int64_t>(table_size); ++slot)
+					{
+						table[slot].store(empty, std::memory_order_relaxed);
+					}
+
+#pragma omp parallel for
+					for (int64_t vertex_index = 0; vertex_index < num_vertices; ++vertex_index)
+					{
+						const uint32_t index = static_cast<uint32_t>(vertex_index);
+						std::size_t slot = hash_position(&vertices[3 * vertex_index]) & mask;
+
+						while (true)
+						{
+							uint32_t current = table[slot].load();
+
+							if (current == empty)
+							{
+								if (table[slot].compare_exchange_strong(current, index))
+								{
+									break;
+								}
+							}
+
+							if (current != empty && same_position(current, index))
+							{
+								while (index < current && !table[slot].compare_exchange_weak(current, index)) {}
+
+								break;
+							}
+
+							if (current != empty)
+							{
+								slot = (slot + 1) & mask;
+							}
+						}
+					}
+
+					// Find the representative of each vertex and number the representatives in order
+					std::vector<uint32_t> representatives(num_vertices);
+
+#pragma omp parallel for
+					for (int64_t vertex_index = 0; vertex_index < num_vertices; ++vertex_index)
+					{
+						const uint32_t index = static_cast<uint32_t>(vertex_index);
+						std::size_t slot = hash_position(&vertices[3 * vertex_index]) & mask;
+						uint32_t current = table[slot].load(std::memory_order_relaxed);
+
+						while (current != index && !same_position(current, index))
+						{
+							slot = (slot + 1) & mask;
+							current = table[slot].load(std::memory_order_relaxed);
+						}
+
+						representatives[vertex_index] = current;
+					}
+
+					table.clear();
+					table.shrink_to_fit();
+
+					std::vector<uint32_t> welded_index(num_vertices);
+					std::vector<uint32_t> block_counts(omp_get_max_threads() + 1, 0);
+
+#pragma omp parallel
+					{
+						const int64_t num_blocks = omp_get_num_threads();
+						const int64_t block = omp_get_thread_num();
+						const int64_t first = num_vertices * block / num_blocks;
+						const int64_t last = num_vertices * (block + 1) / num_blocks;
+
+						uint32_t count = 0;
+
+						for (int64_t vertex_index = first; vertex_index < last; ++vertex_index)
+						{
+							if (representatives[vertex_index] == vertex_index) ++count;
+						}
+
+						block_counts[block + 1] = count;
+
+#pragma omp barrier
+#pragma omp single
+						std::partial_sum(block_counts.begin(), block_counts.begin() + num_blocks + 1, block_counts.begin());
+
+						uint32_t next = block_counts[block];
+
+						for (int64_t vertex_index = first; vertex_index < last; ++vertex_index)
+						{
+							if (representatives[vertex_index] == vertex_index) welded_index[vertex_index] = next++;
+						}
+					}
+
+					const uint32_t num_welded = *std::max_element(block_counts.begin(), block_counts.end());
+
+					// Copy the representatives, and average the normals of all facets sharing a vertex
+					std::vector<uint8_t> welded_buffer(2 * sizeof(uint32_t) + 6 * static_cast<std::size_t>(num_welded) * sizeof(float), 0);
+
+					reinterpret_cast<uint32_t*>(welded_buffer.data())[0] = 2 * sizeof(uint32_t);
+					reinterpret_cast<uint32_t*>(welded_buffer.data())[1] = static_cast<uint32_t>(2 * sizeof(uint32_t) + 3 * static_cast<std::size_t>(num_welded) * sizeof(float));
+
+					float* welded_vertices = reinterpret_cast<float*>(&welded_buffer[2 * sizeof(uint32_t)]);
+					float* welded_normals = welded_vertices + 3 * static_cast<std::size_t>(num_welded);
+
+#pragma omp parallel for
+					for (int64_t vertex_index = 0; vertex_index < num_vertices; ++vertex_index)
+					{
+						const std::size_t target = welded_index[representatives[vertex_index]];
+						this->index_buffer[vertex_index] = static_cast<unsigned int>(target);
+
+						if (representatives[vertex_index] == vertex_index)
+						{
+							std::memcpy(&welded_vertices[3 * target], &vertices[3 * vertex_index], 3 * sizeof(float));
+						}
+
+						for (int i = 0; i < 3; ++i)
+						{
+#pragma omp atomic
+							welded_normals[3 * target + i] += normals[3 * vertex_index + i];
+						}
+					}
+
+#pragma omp parallel for
+					for (int64_t vertex_index = 0; vertex_index < static_cast<int64_t>(num_welded); ++vertex_index)
+					{
+						float* normal = &welded_normals[3 * vertex_index];
+						const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+						if (length > 0.0f)
+						{
+							normal[0] /= length;
+							normal[1] /= length;
+							normal[2] /= length;
+						}
+					}
+
+					megamol::core::utility::log::Log::DefaultLog.WriteInfo("Welded %u vertices into %u vertices", this->num_vertices, num_welded);
+
+					this->vertex_normal_buffer.swap(welded_buffer);
+					this->num_vertices = num_welded;
+				}
+
 				uint32_t STLDataSource::hash() const
 				{
 					if (this->vertex_normal_buffer.empty())
@@ -665,8 +900,9 @@ namespace megamol
 						return 0;
 					}
 
-					const uint32_t first_dataset = reinterpret_cast<const uint32_t&>(this->vertex_normal_buffer[0 * sizeof(uint32_t)]);
-					const uint32_t second_dataset = reinterpret_cast<const uint32_t&>(this->vertex_normal_buffer[1 * sizeof(uint32_t)]);
+					// Computed from the vertex count, as the offsets in the header overflow for large meshes
+					const std::size_t first_dataset = 2 * sizeof(uint32_t);
+					const std::size_t second_dataset = first_dataset + 3 * static_cast<std::size_t>(this->num_vertices) * sizeof(float);
 
 					return core::utility::DataHash(
 						// Header
@@ -143,6 +143,11 @@ namespace megamol
 					/// <param name="filename">File name of the STL file</param>
 					void read_ascii(const std::string& filename);
 
+					/// <summary>
+					/// Merge vertices with identical positions and average their normals
+					/// </summary>
+					void weld_vertices();
+
 					/// <summary>
 					/// Calculate the data hash
 					/// </summary>
@@ -152,6 +157,9 @@ namespace megamol
 					/// File name
 					core::param::ParamSlot filename_slot;
 
+					/// Vertex welding
+					core::param::ParamSlot weld_slot;
+
 					/// Output
 					core::CalleeSlot mesh_output_slot;
 
@@ -171,6 +179,7 @@ namespace megamol
 
 					/// Buffers to store vertices and normals, and indices
 					uint32_t num_triangles;
+					uint32_t num_vertices;
 
 					float min_x, min_y, min_z, max_x, max_y, max_z;
 					
@@ -58,6 +58,7 @@
 #include "ParticleSortFixHack.h"
 #include "ParticleThermodyn.h"
 #include "ParticleThinner.h"
+#include "ParticleTimeDerivatives.h"
 #include "ParticleTranslateRotateScale.h"
 #include "ParticleVelocities.h"
 #include "ParticleVisibilityFromVolume.h"
@@ -177,6 +178,7 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableSort>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableWhere>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleVelocities>();
+        this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleTimeDerivatives>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleNeighborhood>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleThermodyn>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::io::PlyWriter>();
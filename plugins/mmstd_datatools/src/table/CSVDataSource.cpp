@@ -15,12 +15,21 @@
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/CoreInstance.h"
+#include "io/MappedFile.h"
 
-#include "mmcore/utility/sys/ASCIIFileBuffer.h"
 #include "vislib/StringTokeniser.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <list>
+#include <numeric>
 #include <random>
 #include <map>
 #include <limits>
@@ -30,6 +39,7 @@ using namespace megamol::stdplugin::datatools;
 using namespace megamol::stdplugin::datatools::table;
 using namespace megamol;
 
+
 enum class DecimalSeparator : int {
     Unknown = 0,
     US = 1,
@@ -84,6 +94,246 @@ double parseValue(const char* tokenStart, const char* tokenEnd) {
     return NAN;
 }
 
+namespace {
+
+/** Magic number of the table cache files */
+const char cacheMagic[8] = {'M', 'M', 'C', 'S', 'V', 'T', 'B', 'L'};
+
+/** Version of the table cache file format */
+const uint32_t cacheVersion = 1;
+
+/** Number of data rows used to infer the column types */
+const size_t typeSampleRows = 1024;
+
+/** Minimal size of the byte ranges parsed by one thread */
+const size_t minChunkSize = 1 << 20;
+
+/** How a column is parsed, inferred from the first rows unless given by the header */
+enum class ParseType {
+    Integer,
+    Real,
+    Category
+};
+
+inline bool isLineBreak(char c) {
+    return (c == '\n') || (c == '\r');
+}
+
+/** Answers the end of the line starting at 'p', excluding the line break */
+inline const char* findLineEnd(const char* p, const char* end) {
+    while ((p != end) && !isLineBreak(*p)) ++p;
+    return p;
+}
+
+/** Skips the line break at 'p'. Like ASCIIFileBuffer, "\r\n" and "\n\r" count as one line break. */
+inline const char* skipLineBreak(const char* p, const char* end) {
+    if (p == end) return p;
+    const char c = *p++;
+    if ((p != end) && isLineBreak(*p) && (*p != c)) ++p;
+    return p;
+}
+
+/** Answers the end of the field starting at 'p', i.e. the next column separator or the end of the line */
+inline const char* findFieldEnd(const char* p, const char* lineEnd, const std::string& colSep) {
+    if (colSep.size() == 1) {
+        const void* sep = std::memchr(p, colSep[0], static_cast<size_t>(lineEnd - p));
+        return (sep != nullptr) ? static_cast<const char*>(sep) : lineEnd;
+    }
+    return std::search(p, lineEnd, colSep.begin(), colSep.end());
+}
+
+/** Answers the start of the field following the one ending at 'fieldEnd' */
+inline const char* nextField(const char* fieldEnd, const char* lineEnd, const std::string& colSep) {
+    return (fieldEnd == lineEnd) ? lineEnd : fieldEnd + colSep.size();
+}
+
+/** Answers the number of fields in a line, counting at most 'maxCount' fields */
+size_t countFields(const char* p, const char* lineEnd, const std::string& colSep, size_t maxCount) {
+    size_t cnt = 0;
+    while ((p != lineEnd) && (cnt < maxCount)) {
+        p = nextField(findFieldEnd(p, lineEnd, colSep), lineEnd, colSep);
+        ++cnt;
+    }
+    return cnt;
+}
+
+inline void trimSpaces(const char*& first, const char*& last) {
+    while ((first != last) && ((*first == ' ') || (*first == '\t'))) ++first;
+    while ((first != last) && ((last[-1] == ' ') || (last[-1] == '\t'))) --last;
+}
+
+/** Parses a plain integer, answers false if [first, last) is anything else */
+bool parseInteger(const char* first, const char* last, double& value) {
+    trimSpaces(first, last);
+    bool negative = false;
+    if ((first != last) && ((*first == '-') || (*first == '+'))) negative = (*first++ == '-');
+    if ((first == last) || (last - first > 18)) return false;
+    int64_t v = 0;
+    for (; first != last; ++first) {
+        if ((*first < '0') || (*first > '9')) return false;
+        v = v * 10 + (*first - '0');
+    }
+    value = static_cast<double>(negative ? -v : v);
+    return true;
+}
+
+/**
+ * Parses a decimal number with optional exponent without going through a
+ * locale-aware stream. Answers false if [first, last) is anything else, e.g.
+ * a timestamp, which is left to parseValue.
+ */
+bool parseReal(const char* first, const char* last, char decimalPoint, double& value) {
+    static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+        1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    trimSpaces(first, last);
+    bool negative = false;
+    if ((first != last) && ((*first == '-') || (*first == '+'))) negative = (*first++ == '-');
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    int significant = 0;
+    for (; (first != last) && (*first >= '0') && (*first <= '9'); ++first, ++digits) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (*first - '0');
+            if (mantissa != 0) ++significant;
+        } else {
+            ++exponent;
+        }
+    }
+    if ((first != last) && (*first == decimalPoint)) {
+        for (++first; (first != last) && (*first >= '0') && (*first <= '9'); ++first, ++digits) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*first - '0');
+                if (mantissa != 0) ++significant;
+                --exponent;
+            }
+        }
+    }
+    if (digits == 0) return false;
+    if ((first != last) && ((*first == 'e') || (*first == 'E'))) {
+        ++first;
+        bool negativeExp = false;
+        if ((first != last) && ((*first == '-') || (*first == '+'))) negativeExp = (*first++ == '-');
+        if (first == last) return false;
+        int e = 0;
+        for (; (first != last) && (*first >= '0') && (*first <= '9'); ++first) {
+            if (e < 10000) e = e * 10 + (*first - '0');
+        }
+        exponent += negativeExp ? -e : e;
+    }
+    if (first != last) return false;
+
+    double v = static_cast<double>(mantissa);
+    if ((mantissa < (uint64_t(1) << 53)) && (exponent >= -22) && (exponent <= 22)) {
+        // exact operands, so the result is correctly rounded
+        v = (exponent < 0) ? v / powersOf10[-exponent] : v * powersOf10[exponent];
+    } else if (mantissa != 0) {
+        v *= std::pow(10.0, exponent);
+    }
+    value = negative ? -v : v;
+    return true;
+}
+
+/** Parses a numeric field, trying the fast parsers first */
+double parseField(const char* first, const char* last, ParseType type, DecimalSeparator decType) {
+    const char decimalPoint = (decType == DecimalSeparator::DE) ? ',' : '.';
+    double value;
+    if ((type == ParseType::Integer) && parseInteger(first, last, value)) return value;
+    if (parseReal(first, last, decimalPoint, value)) return value;
+    if (decType != DecimalSeparator::DE) return parseValue(first, last);
+    std::string token(first, last);
+    std::replace(token.begin(), token.end(), ',', '.');
+    return parseValue(token.data(), token.data() + token.size());
+}
+
+/**
+ * Infers how the columns are parsed from the first rows of the data. Columns
+ * without any number become categorical unless their type is 'fixed' by the
+ * header, numeric columns are parsed as integers if the sample allows it.
+ */
+void inferParseTypes(const char* begin, const char* end, const std::string& colSep, DecimalSeparator decType,
+        std::vector<ParseType>& types, const std::vector<bool>& fixed) {
+    const size_t colCnt = types.size();
+    std::vector<size_t> numbers(colCnt, 0), integers(colCnt, 0), words(colCnt, 0);
+    const char* p = begin;
+    for (size_t row = 0; (row < typeSampleRows) && (p != end); ++row) {
+        const char* lineEnd = findLineEnd(p, end);
+        size_t col = 0;
+        while ((p != lineEnd) && (col < colCnt)) {
+            const char* fieldEnd = findFieldEnd(p, lineEnd, colSep);
+            const char* first = p;
+            const char* last = fieldEnd;
+            trimSpaces(first, last);
+            double value;
+            if (first == last) {
+                // empty fields do not tell anything
+            } else if (parseInteger(first, last, value)) {
+                ++numbers[col];
+                ++integers[col];
+            } else if (!std::isnan(parseField(first, last, ParseType::Real, decType))) {
+                ++numbers[col];
+            } else {
+                ++words[col];
+            }
+            p = nextField(fieldEnd, lineEnd, colSep);
+            ++col;
+        }
+        p = skipLineBreak(lineEnd, end);
+    }
+    for (size_t c = 0; c < colCnt; ++c) {
+        if (!fixed[c] && (numbers[c] == 0) && (words[c] > 0)) {
+            types[c] = ParseType::Category;
+        } else if (types[c] != ParseType::Category) {
+            types[c] = (integers[c] == numbers[c]) ? ParseType::Integer : ParseType::Real;
+        }
+    }
+}
+
+/**
+ * Splits [begin, end) into byte ranges of about 'chunkSize' bytes, each
+ * starting at the beginning of a line. Only '\n' is used to find the line
+ * starts, so files using "\r" alone are parsed as one range.
+ */
+std::vector<const char*> splitIntoChunks(const char* begin, const char* end, size_t chunkSize) {
+    std::vector<const char*> bounds(1, begin);
+    while (static_cast<size_t>(end - bounds.back()) > chunkSize) {
+        const char* p = bounds.back() + chunkSize;
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        if (nl == nullptr) break;
+        // line breaks pair up from the start of a run of them. The next range starts behind the first line break
+        // of the run, like the sequential parse would, so the empty lines of the run still yield their rows.
+        p = static_cast<const char*>(nl);
+        while ((p != bounds.back()) && isLineBreak(*(p - 1))) --p;
+        p = skipLineBreak(p, end);
+        if (p == end) break;
+        bounds.push_back(p);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+/** Answers the number of lines in [begin, end), the last line does not need a line break */
+size_t countLines(const char* p, const char* end) {
+    size_t cnt = 0;
+    while (p != end) {
+        p = skipLineBreak(findLineEnd(p, end), end);
+        ++cnt;
+    }
+    return cnt;
+}
+
+uint64_t hashString(const std::string& str) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : str) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+
 CSVDataSource::CSVDataSource(void) : core::Module(),
 filenameSlot("filename", "Filename to read from"),
 skipPrefaceSlot("skipPreface", "Number of lines to skip before parsing"),
@@ -94,6 +344,8 @@ clearSlot("clear", "Clears the data"),
 colSepSlot("colSep", "The column separator (detected if empty)"),
 decSepSlot("decSep", "The decimal point parser format type"),
 shuffleSlot("shuffle", "Shuffle data points"),
+useCacheSlot("useCache", "Stores the parsed table in a binary '.mmcsv' file next to the CSV file and reads it instead "
+    "as long as the CSV file and the parser settings do not change"),
 getDataSlot("getData", "Slot providing the data"),
 dataHash(0), columns(), values() {
     this->filenameSlot << new core::param::FilePathParam("");
@@ -128,6 +380,9 @@ dataHash(0), columns(), values() {
     this->shuffleSlot.SetParameter(new core::param::BoolParam(false));
     this->MakeSlotAvailable(&this->shuffleSlot);
 
+    this->useCacheSlot.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->useCacheSlot);
+
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetData", &CSVDataSource::getDataCallback);
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetHash", &CSVDataSource::getHashCallback);
     this->MakeSlotAvailable(&this->getDataSlot);
@@ -147,6 +402,7 @@ void CSVDataSource::release(void) {
     this->values.clear();
 }
 
+
 void CSVDataSource::assertData(void) {
     if (!this->filenameSlot.IsDirty()
         && !this->skipPrefaceSlot.IsDirty()
@@ -154,7 +410,8 @@ void CSVDataSource::assertData(void) {
         && !this->headerTypesSlot.IsDirty()
         && !this->commentPrefixSlot.IsDirty()
         && !this->colSepSlot.IsDirty()
-        && !this->decSepSlot.IsDirty()) {
+        && !this->decSepSlot.IsDirty()
+        && !this->useCacheSlot.IsDirty()) {
         if (this->shuffleSlot.IsDirty()) {
             shuffleData();
             this->shuffleSlot.ResetDirty();
@@ -171,6 +428,7 @@ void CSVDataSource::assertData(void) {
     this->colSepSlot.ResetDirty();
     this->decSepSlot.ResetDirty();
     this->shuffleSlot.ResetDirty();
+    this->useCacheSlot.ResetDirty();
 
     this->columns.clear();
     this->values.clear();
@@ -178,41 +436,79 @@ void CSVDataSource::assertData(void) {
 	auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
 
     try {
-        vislib::sys::ASCIIFileBuffer file;
+        const std::string path(vislib::StringA(filename).PeekBuffer());
+
+        // 0. Use the cache if the CSV file and the parser settings did not change
+        //////////////////////////////////////////////////////////////////////
+        const bool useCache = this->useCacheSlot.Param<core::param::BoolParam>()->Value();
+        const std::string cachePath = path + ".mmcsv";
+        CacheHeader cacheHeader;
+        std::memset(&cacheHeader, 0, sizeof(CacheHeader));
+        if (useCache) {
+            std::error_code ec;
+            const auto sourceSize = std::filesystem::file_size(path, ec);
+            const auto sourceTime = std::filesystem::last_write_time(path, ec);
+            if (!ec) {
+                std::stringstream settings;
+                settings << this->skipPrefaceSlot.Param<core::param::IntParam>()->Value() << '|'
+                         << this->headerNamesSlot.Param<core::param::BoolParam>()->Value() << '|'
+                         << this->headerTypesSlot.Param<core::param::BoolParam>()->Value() << '|'
+                         << vislib::StringA(this->commentPrefixSlot.Param<core::param::StringParam>()->Value()).PeekBuffer() << '|'
+                         << vislib::StringA(this->colSepSlot.Param<core::param::StringParam>()->Value()).PeekBuffer() << '|'
+                         << this->decSepSlot.Param<core::param::EnumParam>()->Value();
+                std::memcpy(cacheHeader.magic, cacheMagic, sizeof(cacheHeader.magic));
+                cacheHeader.version = cacheVersion;
+                cacheHeader.headerSize = sizeof(CacheHeader);
+                cacheHeader.sourceSize = sourceSize;
+                cacheHeader.sourceTime = static_cast<int64_t>(sourceTime.time_since_epoch().count());
+                cacheHeader.settingsHash = hashString(settings.str());
+                if (this->readCache(cachePath, cacheHeader)) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                        "Tabular data loaded from cache \"%s\": %u dimensions; %u samples\n", cachePath.c_str(),
+                        static_cast<unsigned int>(this->columns.size()),
+                        static_cast<unsigned int>(this->values.size() / this->columns.size()));
+                    shuffleData();
+                    this->dataHash++;
+                    return;
+                }
+            }
+        }
 
-        // 1. Load the whole file into memory (FAST!)
+        // 1. Map the file, the data is parsed straight from the mapping
         //////////////////////////////////////////////////////////////////////
-        if (!file.LoadFile(filename, vislib::sys::ASCIIFileBuffer::PARSING_LINES)) throw vislib::Exception(__FILE__, __LINE__);
-        if (file.Count() < 2) throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
+        io::MappedFile file;
+        if (!file.Open(path)) throw vislib::Exception("Cannot map CSV file", __FILE__, __LINE__);
 
         // 2. Determine the first row, column separator, and decimal point
         //////////////////////////////////////////////////////////////////////
-        int firstHeaRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        int firstDatRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) firstDatRow++;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) firstDatRow++;
+        const char *cursor = file.Begin();
+        size_t lineNo = 0;
+        auto peekLine = [&]() { return vislib::StringA(cursor, findLineEnd(cursor, file.End()) - cursor); };
+        auto skipLine = [&]() {
+            cursor = skipLineBreak(findLineEnd(cursor, file.End()), file.End());
+            ++lineNo;
+        };
+
+        for (int i = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value(); (i > 0) && (cursor != file.End()); --i) {
+            skipLine();
+        }
 
         auto comment = this->commentPrefixSlot.Param<core::param::StringParam>()->Value();
         if (!comment.IsEmpty()) {
                 // Skip comments at the beginning of the file.
-            while (firstHeaRow < file.Count()) {
-                if (!vislib::StringA(file[firstHeaRow]).StartsWith(comment)) {
-                    break;
-                }
-                firstHeaRow++;
-                firstDatRow++;
+            while ((cursor != file.End()) && peekLine().StartsWith(comment)) {
+                skipLine();
             }
         }
+        if (cursor == file.End()) throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
 
+        vislib::StringA headerLine = peekLine();
         vislib::StringA colSep(this->colSepSlot.Param<core::param::StringParam>()->Value());
         if (colSep.IsEmpty()) {
             // Detect column separator
             const char ColSepCanidates[] = { '\t', ';', ',', '|' };
-            vislib::StringA l1(file[firstHeaRow]);
-            vislib::StringA l2(file[firstHeaRow]);
             for (int i = 0; i < sizeof(ColSepCanidates) / sizeof(char); ++i) {
-                SIZE_T c1 = l1.Count(ColSepCanidates[i]);
-                if ((c1 > 0) && (c1 == l2.Count(ColSepCanidates[i]))) {
+                if (headerLine.Count(ColSepCanidates[i]) > 0) {
                     colSep.Append(ColSepCanidates[i]);
                     break;
                 }
@@ -221,11 +517,41 @@ void CSVDataSource::assertData(void) {
                 throw vislib::Exception("Failed to detect column separator", __FILE__, __LINE__);
             }
         }
+        const std::string sep(colSep.PeekBuffer());
+
+        // 3. Table layout is now clear... determine column headers.
+        //////////////////////////////////////////////////////////////////////
+        vislib::Array<vislib::StringA> dimNames = vislib::StringTokeniserA::Split(headerLine, colSep, false);
+        if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
+            skipLine();
+        } else {
+            for (SIZE_T i = 0; i < dimNames.Count(); ++i) {
+                dimNames[i].Format("Dim %d", static_cast<int>(i));
+            }
+        }
+        this->columns.resize(dimNames.Count());
+        this->values.clear();
+
+        size_t colCnt = static_cast<size_t>(this->columns.size());
+        std::vector<ParseType> parseTypes(colCnt, ParseType::Real);
+        std::vector<bool> typeFixed(colCnt, false);
+        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
+            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(peekLine(), colSep, false));
+            skipLine();
+            for (SIZE_T i = 0; i < dimNames.Count(); i++) {
+                typeFixed[i] = true;
+                if (tokens.Count() > i && tokens[i].Equals("CATEGORICAL", true)) {
+                    parseTypes[i] = ParseType::Category;
+                }
+            }
+        }
+        const char *dataBegin = cursor;
+        const size_t firstDatRow = lineNo;
 
         DecimalSeparator decType = static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
         if (decType == DecimalSeparator::Unknown) {
             // Detect decimal type
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstDatRow], colSep, false));
+            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(peekLine(), colSep, false));
             for (SIZE_T i = 0; i < tokens.Count(); i++) {
                 bool hasDot = tokens[i].Contains('.');
                 bool hasComma = tokens[i].Contains(',');
@@ -243,116 +569,94 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        // 3. Table layout is now clear... determine column headers.
-        //////////////////////////////////////////////////////////////////////
-        vislib::Array<vislib::StringA> dimNames;
-        if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
-            firstHeaRow++;
-        } else {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
-            for (SIZE_T i = 0; i < dimNames.Count(); ++i) {
-                dimNames[i].Format("Dim %d", static_cast<int>(i));
-            }
+        // Drop incomplete lines at the end, walking backwards from the end of the file
+        const char *dataEnd = file.End();
+        while (dataEnd != dataBegin) {
+            const char *lineStart = dataEnd;
+            while ((lineStart != dataBegin) && !isLineBreak(lineStart[-1])) --lineStart;
+            if (countFields(lineStart, dataEnd, sep, colCnt) >= colCnt) break; // the last line containing a full data set
+            dataEnd = lineStart;
+            while ((dataEnd != dataBegin) && isLineBreak(dataEnd[-1])) --dataEnd;
         }
-        this->columns.resize(dimNames.Count());
-        this->values.clear();
 
+        inferParseTypes(dataBegin, dataEnd, sep, decType, parseTypes, typeFixed);
         bool hasCatDims = false;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false));
-            for (SIZE_T i = 0; i < dimNames.Count(); i++) {
-                TableDataCall::ColumnType type = TableDataCall::ColumnType::QUANTITATIVE;
-                if (tokens.Count() > i && tokens[i].Equals("CATEGORICAL", true)) {
-                    type = TableDataCall::ColumnType::CATEGORICAL;
-                    hasCatDims = true;
-                }
-                this->columns[i].SetName(dimNames[i].PeekBuffer())
-                    .SetType(type)
-                    .SetMinimumValue(0.0f)
-                    .SetMaximumValue(1.0f);
-            }
-        } else {
-            for (SIZE_T i = 0; i < dimNames.Count(); i++) {
-                this->columns[i].SetName(dimNames[i].PeekBuffer())
-                    .SetType(TableDataCall::ColumnType::QUANTITATIVE)
-                    .SetMinimumValue(0.0f)
-                    .SetMaximumValue(1.0f);
-            }
+        for (size_t i = 0; i < colCnt; i++) {
+            const bool categorical = (parseTypes[i] == ParseType::Category);
+            hasCatDims |= categorical;
+            this->columns[i].SetName(dimNames[i].PeekBuffer())
+                .SetType(categorical ? TableDataCall::ColumnType::CATEGORICAL : TableDataCall::ColumnType::QUANTITATIVE)
+                .SetMinimumValue(0.0f)
+                .SetMaximumValue(1.0f);
         }
 
         // 4. Data format is now clear... finally parse actual data
         //////////////////////////////////////////////////////////////////////
-        size_t colCnt = static_cast<size_t>(this->columns.size());
-        size_t rowCnt = static_cast<size_t>(file.Count() - firstDatRow);
-        int colSepEnd = colSep.Length() - 1;
-
-        // Test for empty lines at the end
-        for (; rowCnt > 0; --rowCnt) {
-            const char *start = file[firstDatRow + rowCnt - 1];
-            const char *end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos]) colSepPos++; else colSepPos = 0;
-                    ++end;
-                }
-                col++;
-            }
-            if (col >= colCnt) break; // we found the last line containing a full data set
+        // Split the data into byte ranges at line starts, count their rows
+        // and parse them, both in parallel.
+        int thCnt = omp_get_max_threads();
+        const size_t dataSize = static_cast<size_t>(dataEnd - dataBegin);
+        const std::vector<const char*> chunks = splitIntoChunks(dataBegin, dataEnd,
+            std::max(minChunkSize, dataSize / (static_cast<size_t>(thCnt) * 8) + 1));
+        const long long chunkCnt = static_cast<long long>(chunks.size()) - 1;
+
+        std::vector<size_t> chunkRows(chunkCnt + 1, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long long ch = 0; ch < chunkCnt; ++ch) {
+            chunkRows[ch + 1] = countLines(chunks[ch], chunks[ch + 1]);
         }
+        std::partial_sum(chunkRows.begin(), chunkRows.end(), chunkRows.begin());
+        size_t rowCnt = chunkRows.back();
 
-        // Parse in parallel, assuming all lines will work
-        std::vector<std::map<std::string, float>> catMaps;
-        int thCnt = omp_get_max_threads();
-        catMaps.resize(colCnt * thCnt);
+        std::vector<size_t> catCols;
+        for (size_t c = 0; c < colCnt; ++c) {
+            if (parseTypes[c] == ParseType::Category) catCols.push_back(c);
+        }
+        // Categories are numbered per range first, then renumbered in the
+        // sorted order of all categories of the column
+        std::vector<std::vector<std::unordered_map<std::string_view, uint32_t>>> catMaps(chunkCnt,
+            std::vector<std::unordered_map<std::string_view, uint32_t>>(catCols.size()));
+        std::vector<float> minVals(colCnt * chunkCnt, std::numeric_limits<float>::max());
+        std::vector<float> maxVals(colCnt * chunkCnt, -std::numeric_limits<float>::max());
         values.resize(colCnt * rowCnt);
         bool hasInvalids = false;
 
-#pragma omp parallel for
-        for (long long idx = 0; idx < static_cast<long long>(rowCnt); ++idx) {
-            int thId = omp_get_thread_num();
-            const char *start = file[static_cast<size_t>(firstDatRow + idx)];
-            const char *end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                std::map<std::string, float> &catMap = catMaps[thId + col * thCnt];
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos]) colSepPos++; else colSepPos = 0;
-                    ++end;
-                }
-
-                if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
-                    if (decType == DecimalSeparator::DE) {
-                        for (char *ez = const_cast<char*>(start); ez != end; ++ez) if (*ez == ',') *ez = '.';
-                    }
-                    double value = parseValue(start, end);
-                    values[static_cast<size_t>(idx * colCnt + col)] = static_cast<float>(value);
-                    if (std::isnan(value)) {
-                        hasInvalids = true;
-                    }
-                } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
-                    assert(hasCatDims);
-                    std::map<std::string, float>::iterator cmi = catMap.find(start);
-                    if (cmi == catMap.end()) {
-                        cmi = catMap.insert(std::pair<std::string, float>(start, static_cast<float>(thId + thCnt * catMap.size()))).first;
+#pragma omp parallel for schedule(dynamic, 1) reduction(|| : hasInvalids)
+        for (long long ch = 0; ch < chunkCnt; ++ch) {
+            const char *p = chunks[ch];
+            const char *chunkEnd = chunks[ch + 1];
+            float *minVal = minVals.data() + ch * colCnt;
+            float *maxVal = maxVals.data() + ch * colCnt;
+            for (size_t row = chunkRows[ch]; p != chunkEnd; ++row) {
+                const char *lineEnd = findLineEnd(p, chunkEnd);
+                float *rowValues = values.data() + row * colCnt;
+                size_t col = 0;
+                size_t cat = 0;
+                while ((p != lineEnd) && (col < colCnt)) {
+                    const char *fieldEnd = findFieldEnd(p, lineEnd, sep);
+                    float value;
+                    if (parseTypes[col] == ParseType::Category) {
+                        assert(hasCatDims);
+                        auto &catMap = catMaps[ch][cat++];
+                        auto cmi = catMap.emplace(std::string_view(p, fieldEnd - p), static_cast<uint32_t>(catMap.size())).first;
+                        value = static_cast<float>(cmi->second);
+                    } else {
+                        value = static_cast<float>(parseField(p, fieldEnd, parseTypes[col], decType));
+                        if (std::isnan(value)) {
+                            hasInvalids = true;
+                        }
                     }
-                    values[static_cast<size_t>(idx * colCnt + col)] = cmi->second;
-                } else {
-                    assert(false);
+                    rowValues[col] = value;
+                    if (value < minVal[col]) minVal[col] = value;
+                    if (value > maxVal[col]) maxVal[col] = value;
+                    p = nextField(fieldEnd, lineEnd, sep);
+                    col++;
                 }
-
-                col++;
-                if (*end != '\0') {
-                    start = end + 1;
-                    end = start;
+                for (; col < colCnt; ++col) {
+                    rowValues[col] = std::numeric_limits<float>::quiet_NaN();
+                    hasInvalids = true;
                 }
-            }
-            for (; col < colCnt; ++col) {
-                values[static_cast<size_t>(idx * colCnt + col)] = std::numeric_limits<float>::quiet_NaN();
-                hasInvalids = true;
+                p = skipLineBreak(lineEnd, chunkEnd);
             }
         }
 
@@ -382,43 +686,49 @@ void CSVDataSource::assertData(void) {
 
         // Merge categorical data so that all `value indices` map to one `string key`
         if (hasCatDims) {
-            for (size_t c = 0; c < colCnt; ++c) {
-                if (columns[c].Type() != TableDataCall::ColumnType::CATEGORICAL) continue;
-                std::map<int, int> catRemap;
-                std::map<std::string, int> catMap;
-                for (int ci = static_cast<int>(c) * thCnt; ci < static_cast<int>(c + 1) * thCnt; ++ci) {
-                    for (const std::pair<std::string, float>& p : catMaps[ci]) {
-                        int vi = static_cast<int>(p.second + 0.49f);
-                        std::map<std::string, int>::iterator cmi = catMap.find(p.first);
-                        if (cmi == catMap.end()) {
-                            int nv = static_cast<int>(catMap.size());
-                            catMap[p.first] = nv;
-                            catRemap[vi] = nv;
-                        } else {
-                            catRemap[vi] = cmi->second;
-                        }
+            std::vector<std::vector<std::vector<float>>> catRemaps(chunkCnt, std::vector<std::vector<float>>(catCols.size()));
+            for (size_t cat = 0; cat < catCols.size(); ++cat) {
+                std::vector<std::string_view> keys;
+                for (long long ch = 0; ch < chunkCnt; ++ch) {
+                    for (const auto &p : catMaps[ch][cat]) keys.push_back(p.first);
+                }
+                std::sort(keys.begin(), keys.end());
+                keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+                for (long long ch = 0; ch < chunkCnt; ++ch) {
+                    auto &catRemap = catRemaps[ch][cat];
+                    catRemap.resize(catMaps[ch][cat].size());
+                    for (const auto &p : catMaps[ch][cat]) {
+                        catRemap[p.second] = static_cast<float>(std::lower_bound(keys.begin(), keys.end(), p.first) - keys.begin());
                     }
                 }
-
-                for (size_t r = 0; r < rowCnt; ++r) {
-                    int vi = static_cast<int>(values[r * colCnt + c] + 0.49f);
-                    values[r * colCnt + c] = static_cast<float>(catRemap[vi]);
+                if (!keys.empty()) {
+                    minVals[catCols[cat]] = 0.0f;
+                    maxVals[catCols[cat]] = static_cast<float>(keys.size() - 1);
                 }
             }
-        }
 
-        // Collect min/max
-        std::vector<float> minVals(colCnt, std::numeric_limits<float>::max());
-        std::vector<float> maxVals(colCnt, -std::numeric_limits<float>::max());
-        for (size_t r = 0; r < rowCnt; ++r) {
-            for (size_t c = 0; c < colCnt; ++c) {
-                float f = values[r * colCnt + c];
-                if (f < minVals[c]) minVals[c] = f;
-                if (f > maxVals[c]) maxVals[c] = f;
+#pragma omp parallel for schedule(dynamic, 1)
+            for (long long ch = 0; ch < chunkCnt; ++ch) {
+                for (size_t r = chunkRows[ch]; r < chunkRows[ch + 1]; ++r) {
+                    for (size_t cat = 0; cat < catCols.size(); ++cat) {
+                        float &value = values[r * colCnt + catCols[cat]];
+                        if (!std::isnan(value)) value = catRemaps[ch][cat][static_cast<size_t>(value)];
+                    }
+                }
             }
         }
+
+        // Collect min/max of all ranges
         for (size_t c = 0; c < colCnt; ++c) {
-            columns[c].SetMinimumValue(minVals[c]).SetMaximumValue(maxVals[c]);
+            float minVal = minVals[c];
+            float maxVal = maxVals[c];
+            if (parseTypes[c] != ParseType::Category) {
+                for (long long ch = 1; ch < chunkCnt; ++ch) {
+                    minVal = std::min(minVal, minVals[ch * colCnt + c]);
+                    maxVal = std::max(maxVal, maxVals[ch * colCnt + c]);
+                }
+            }
+            columns[c].SetMinimumValue(minVal).SetMaximumValue(maxVal);
         }
 
         // 5. All done... report summary
@@ -426,6 +736,10 @@ void CSVDataSource::assertData(void) {
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("Tabular data loaded: %u dimensions; %u samples\n",
             static_cast<unsigned int>(colCnt), static_cast<unsigned int>(rowCnt));
 
+        if (useCache && (cacheHeader.version == cacheVersion)) {
+            this->writeCache(cachePath, cacheHeader);
+        }
+
     } catch (const vislib::Exception& ex) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("Could not load \"%s\": %s [%s, %d]", filename.PeekBuffer(), ex.GetMsgA(), ex.GetFile(), ex.GetLine());
         this->columns.clear();
@@ -440,6 +754,7 @@ void CSVDataSource::assertData(void) {
     this->dataHash++;
 }
 
+
 void CSVDataSource::shuffleData() {
     if (!this->shuffleSlot.Param<core::param::BoolParam>()->Value()) {
                 // Do not shuffle, unless requested
@@ -458,6 +773,88 @@ void CSVDataSource::shuffleData() {
     }
 }
 
+bool CSVDataSource::readCache(const std::string& cachePath, const CacheHeader& expected) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) return false;
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader)) ||
+        std::memcmp(&header, &expected, sizeof(CacheHeader)) != 0) {
+        return false;
+    }
+
+    uint64_t colCnt = 0, rowCnt = 0;
+    file.read(reinterpret_cast<char*>(&colCnt), sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(&rowCnt), sizeof(uint64_t));
+    if (!file.good() || (colCnt == 0)) return false;
+    this->columns.resize(colCnt);
+    for (auto& column : this->columns) {
+        uint32_t type = 0, nameLength = 0;
+        float minVal = 0.0f, maxVal = 0.0f;
+        file.read(reinterpret_cast<char*>(&type), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&minVal), sizeof(float));
+        file.read(reinterpret_cast<char*>(&maxVal), sizeof(float));
+        file.read(reinterpret_cast<char*>(&nameLength), sizeof(uint32_t));
+        if (!file.good() || (nameLength > (1u << 16))) break;
+        std::string name(nameLength, '\0');
+        file.read(&name[0], nameLength);
+        column.SetName(name)
+            .SetType(static_cast<TableDataCall::ColumnType>(type))
+            .SetMinimumValue(minVal)
+            .SetMaximumValue(maxVal);
+    }
+    if (file.good()) {
+        this->values.resize(colCnt * rowCnt);
+        file.read(reinterpret_cast<char*>(this->values.data()), this->values.size() * sizeof(float));
+    }
+    if (!file.good()) {
+        this->columns.clear();
+        this->values.clear();
+        return false;
+    }
+    return true;
+}
+
+void CSVDataSource::writeCache(const std::string& cachePath, const CacheHeader& header) const {
+    // write to a temporary file first, so that concurrent loaders never see a partial cache
+    const std::string tmpPath =
+        cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return;
+
+        const uint64_t colCnt = this->columns.size();
+        const uint64_t rowCnt = (colCnt > 0) ? this->values.size() / colCnt : 0;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        file.write(reinterpret_cast<const char*>(&colCnt), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&rowCnt), sizeof(uint64_t));
+        for (const auto& column : this->columns) {
+            const uint32_t type = static_cast<uint32_t>(column.Type());
+            const float minVal = column.MinimumValue();
+            const float maxVal = column.MaximumValue();
+            const uint32_t nameLength = static_cast<uint32_t>(column.Name().size());
+            file.write(reinterpret_cast<const char*>(&type), sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(&minVal), sizeof(float));
+            file.write(reinterpret_cast<const char*>(&maxVal), sizeof(float));
+            file.write(reinterpret_cast<const char*>(&nameLength), sizeof(uint32_t));
+            file.write(column.Name().data(), nameLength);
+        }
+        file.write(reinterpret_cast<const char*>(this->values.data()), rowCnt * colCnt * sizeof(float));
+        if ((colCnt == 0) || !file.good()) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn("Could not write table cache \"%s\"", cachePath.c_str());
+    }
+}
+
 bool CSVDataSource::getDataCallback(core::Call& caller) {
     TableDataCall *tfd = dynamic_cast<TableDataCall*>(&caller);
     if (tfd == nullptr) return false;
@@ -14,6 +14,8 @@
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmstd_datatools/table/TableDataCall.h"
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace megamol {
@@ -31,6 +33,16 @@ namespace table {
         CSVDataSource(void);
         virtual ~CSVDataSource(void);
 
+        /**
+         * The file is parsed by the callbacks only, so they may be re-issued from
+         * a prefetch thread of the graph.
+         *
+         * @return 'true'
+         */
+        bool IsThreadSafe(void) const override {
+            return true;
+        }
+
     protected:
 
         virtual bool create(void);
@@ -45,6 +57,43 @@ namespace table {
         bool clearData(core::param::ParamSlot& caller);
         void shuffleData();
 
+#pragma pack(push, 1)
+        /**
+         * Header of the table cache file.
+         *
+         * The header is followed by the column and row count (both uint64_t),
+         * the column infos (type as uint32_t, minimum and maximum as float,
+         * name length as uint32_t and the name) and finally the row-major
+         * values.
+         */
+        struct CacheHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerSize;
+            uint64_t sourceSize;
+            int64_t sourceTime;
+            uint64_t settingsHash;
+        };
+#pragma pack(pop)
+
+        /**
+         * Reads the table from a cache file.
+         *
+         * @param cachePath The path of the cache file.
+         * @param expected  The header the cache file must start with.
+         *
+         * @return true if the table was read, false if the cache is missing or outdated.
+         */
+        bool readCache(const std::string& cachePath, const CacheHeader& expected);
+
+        /**
+         * Writes the table to a cache file.
+         *
+         * @param cachePath The path of the cache file.
+         * @param header    The header identifying the CSV file and the parser settings.
+         */
+        void writeCache(const std::string& cachePath, const CacheHeader& header) const;
+
         core::param::ParamSlot filenameSlot;
 		core::param::ParamSlot skipPrefaceSlot;
 		core::param::ParamSlot headerNamesSlot;
@@ -54,6 +103,7 @@ namespace table {
         core::param::ParamSlot colSepSlot;
         core::param::ParamSlot decSepSlot;
         core::param::ParamSlot shuffleSlot;
+        core::param::ParamSlot useCacheSlot;
 
         core::CalleeSlot getDataSlot;
 
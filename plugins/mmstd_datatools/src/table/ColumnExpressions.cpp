@@ -0,0 +1,498 @@
+/*
+ * ColumnExpressions.cpp
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "ColumnExpressions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+using namespace megamol::stdplugin::datatools::table;
+
+
+/** Rows evaluated per instruction, small enough that all registers stay in cache */
+static constexpr size_t BlockSize = 1024;
+
+
+/*
+ * Recursive descent parser emitting the register program.
+ */
+class ColumnExpressions::Parser {
+public:
+    Parser(ColumnExpressions& owner, const std::string& source) : owner(owner), src(source) {}
+
+    bool Statements(std::string& error) {
+        while (true) {
+            this->skipSpace(true);
+            if (this->pos >= this->src.size()) break;
+            if (this->src[this->pos] == ';') {
+                ++this->pos;
+                continue;
+            }
+            if (this->atComment(true)) {
+                while (this->pos < this->src.size() && this->src[this->pos] != '\n') ++this->pos;
+                continue;
+            }
+            if (!this->statement()) {
+                error = this->message + " (at offset " + std::to_string(this->pos) + ")";
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool statement(void) {
+        std::string target;
+        if (!this->name(target)) return this->fail("expected column name");
+        this->skipSpace(false);
+        if (!this->accept("=")) return this->fail("expected '=' after '" + target + "'");
+        size_t value;
+        if (!this->expression(value)) return false;
+        this->skipSpace(false);
+        if (this->atComment(false)) {
+            while (this->pos < this->src.size() && this->src[this->pos] != '\n') ++this->pos;
+        }
+        if (this->pos < this->src.size() && this->src[this->pos] != '\n' && this->src[this->pos] != ';') {
+            return this->fail("unexpected character '" + std::string(1, this->src[this->pos]) + "'");
+        }
+
+        auto& cols = this->owner.outputColumns;
+        auto it = std::find(cols.begin(), cols.end(), target);
+        size_t column = std::distance(cols.begin(), it);
+        if (it == cols.end()) {
+            cols.push_back(target);
+            this->owner.derived.push_back(true);
+        } else {
+            this->owner.derived[column] = true;
+        }
+        this->owner.program.push_back(Instruction{Op::Store, 0, value, 0, 0, column, 0.0f});
+        return true;
+    }
+
+    bool expression(size_t& result) {
+        size_t lhs;
+        if (!this->additive(lhs)) return false;
+        static const std::pair<const char*, Op> comparisons[] = {{"<=", Op::LessEq}, {">=", Op::GreaterEq},
+            {"==", Op::Equal}, {"!=", Op::NotEqual}, {"<", Op::Less}, {">", Op::Greater}};
+        this->skipSpace(false);
+        for (auto& cmp : comparisons) {
+            if (this->accept(cmp.first)) {
+                size_t rhs;
+                if (!this->additive(rhs)) return false;
+                result = this->emit(cmp.second, lhs, rhs);
+                return true;
+            }
+        }
+        result = lhs;
+        return true;
+    }
+
+    bool additive(size_t& result) {
+        if (!this->multiplicative(result)) return false;
+        while (true) {
+            this->skipSpace(false);
+            Op op;
+            if (this->accept("+")) {
+                op = Op::Add;
+            } else if (this->accept("-")) {
+                op = Op::Sub;
+            } else {
+                return true;
+            }
+            size_t rhs;
+            if (!this->multiplicative(rhs)) return false;
+            result = this->emit(op, result, rhs);
+        }
+    }
+
+    bool multiplicative(size_t& result) {
+        if (!this->unary(result)) return false;
+        while (true) {
+            this->skipSpace(false);
+            Op op;
+            if (this->accept("*")) {
+                op = Op::Mul;
+            } else if (this->accept("/")) {
+                op = Op::Div;
+            } else if (this->accept("%")) {
+                op = Op::Mod;
+            } else {
+                return true;
+            }
+            size_t rhs;
+            if (!this->unary(rhs)) return false;
+            result = this->emit(op, result, rhs);
+        }
+    }
+
+    bool unary(size_t& result) {
+        this->skipSpace(false);
+        if (this->accept("-")) {
+            size_t operand;
+            if (!this->unary(operand)) return false;
+            result = this->emit(Op::Neg, operand);
+            return true;
+        }
+        if (this->accept("+")) return this->unary(result);
+        return this->power(result);
+    }
+
+    bool power(size_t& result) {
+        if (!this->primary(result)) return false;
+        this->skipSpace(false);
+        if (this->accept("^")) {
+            size_t exponent;
+            if (!this->unary(exponent)) return false; // right associative
+            result = this->emit(Op::Pow, result, exponent);
+        }
+        return true;
+    }
+
+    bool primary(size_t& result) {
+        this->skipSpace(false);
+        if (this->pos >= this->src.size()) return this->fail("unexpected end of expression");
+
+        const char c = this->src[this->pos];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* begin = this->src.c_str() + this->pos;
+            char* end = nullptr;
+            const float value = std::strtof(begin, &end);
+            if (end == begin) return this->fail("malformed number");
+            this->pos += end - begin;
+            result = this->emitConst(value);
+            return true;
+        }
+        if (this->accept("(")) {
+            if (!this->expression(result)) return false;
+            this->skipSpace(false);
+            if (!this->accept(")")) return this->fail("expected ')'");
+            return true;
+        }
+
+        const bool quoted = (c == '[');
+        std::string id;
+        if (!this->name(id)) return this->fail("unexpected character '" + std::string(1, c) + "'");
+        this->skipSpace(false);
+
+        if (!quoted && this->accept("(")) {
+            return this->call(id, result);
+        }
+        if (!quoted && id == "pi") {
+            result = this->emitConst(3.14159265358979323846f);
+            return true;
+        }
+        if (!quoted && id == "e") {
+            result = this->emitConst(2.71828182845904523536f);
+            return true;
+        }
+
+        auto& cols = this->owner.outputColumns;
+        auto it = std::find(cols.begin(), cols.end(), id);
+        if (it == cols.end()) return this->fail("unknown column '" + id + "'");
+        result = this->owner.registerCount++;
+        this->owner.program.push_back(
+            Instruction{Op::Load, result, 0, 0, 0, static_cast<size_t>(std::distance(cols.begin(), it)), 0.0f});
+        return true;
+    }
+
+    bool call(const std::string& func, size_t& result) {
+        static const std::map<std::string, std::pair<Op, size_t>> functions = {{"sin", {Op::Sin, 1}},
+            {"cos", {Op::Cos, 1}}, {"tan", {Op::Tan, 1}}, {"asin", {Op::Asin, 1}}, {"acos", {Op::Acos, 1}},
+            {"atan", {Op::Atan, 1}}, {"sinh", {Op::Sinh, 1}}, {"cosh", {Op::Cosh, 1}}, {"tanh", {Op::Tanh, 1}},
+            {"sqrt", {Op::Sqrt, 1}}, {"abs", {Op::Abs, 1}}, {"exp", {Op::Exp, 1}}, {"log", {Op::Log, 1}},
+            {"log10", {Op::Log10, 1}}, {"floor", {Op::Floor, 1}}, {"ceil", {Op::Ceil, 1}},
+            {"round", {Op::Round, 1}}, {"sign", {Op::Sign, 1}}, {"atan2", {Op::Atan2, 2}}, {"pow", {Op::Pow, 2}},
+            {"min", {Op::Min, 2}}, {"max", {Op::Max, 2}}, {"fmod", {Op::Mod, 2}}, {"clamp", {Op::Clamp, 3}},
+            {"select", {Op::Select, 3}}};
+
+        auto f = functions.find(func);
+        if (f == functions.end()) return this->fail("unknown function '" + func + "'");
+
+        size_t args[3] = {0, 0, 0};
+        for (size_t i = 0; i < f->second.second; ++i) {
+            if (i > 0) {
+                this->skipSpace(false);
+                if (!this->accept(",")) return this->fail("expected ',' in call of '" + func + "'");
+            }
+            if (!this->expression(args[i])) return false;
+        }
+        this->skipSpace(false);
+        if (!this->accept(")")) return this->fail("expected ')' after arguments of '" + func + "'");
+        result = this->emit(f->second.first, args[0], args[1], args[2]);
+        return true;
+    }
+
+    bool name(std::string& id) {
+        this->skipSpace(false);
+        if (this->pos >= this->src.size()) return false;
+        if (this->src[this->pos] == '[') {
+            const auto end = this->src.find(']', this->pos + 1);
+            if (end == std::string::npos) return false;
+            id = this->src.substr(this->pos + 1, end - this->pos - 1);
+            this->pos = end + 1;
+            return !id.empty();
+        }
+        const size_t begin = this->pos;
+        while (this->pos < this->src.size()) {
+            const auto c = static_cast<unsigned char>(this->src[this->pos]);
+            if (!(std::isalnum(c) || c == '_' || (c == '.' && this->pos > begin))) break;
+            ++this->pos;
+        }
+        if (this->pos == begin || std::isdigit(static_cast<unsigned char>(this->src[begin]))) {
+            this->pos = begin;
+            return false;
+        }
+        id = this->src.substr(begin, this->pos - begin);
+        return true;
+    }
+
+    /**
+     * '#' starts a comment anywhere. '--' only does at the start of a
+     * statement, elsewhere it is a minus followed by a unary minus.
+     */
+    bool atComment(bool statementStart) const {
+        return (this->pos < this->src.size()) &&
+               (this->src[this->pos] == '#' || (statementStart && this->src.compare(this->pos, 2, "--") == 0));
+    }
+
+    void skipSpace(bool newlines) {
+        while (this->pos < this->src.size()) {
+            const char c = this->src[this->pos];
+            if (c == ' ' || c == '\t' || c == '\r' || (newlines && c == '\n')) {
+                ++this->pos;
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool accept(const char* token) {
+        const size_t len = std::char_traits<char>::length(token);
+        if (this->src.compare(this->pos, len, token) != 0) return false;
+        // do not mistake '<=' for '<' or '==' for an assignment
+        if (len == 1 && (token[0] == '<' || token[0] == '>' || token[0] == '=') && this->pos + 1 < this->src.size() &&
+            this->src[this->pos + 1] == '=') {
+            return false;
+        }
+        this->pos += len;
+        return true;
+    }
+
+    size_t emit(Op op, size_t a, size_t b = 0, size_t c = 0) {
+        const size_t dst = this->owner.registerCount++;
+        this->owner.program.push_back(Instruction{op, dst, a, b, c, 0, 0.0f});
+        return dst;
+    }
+
+    size_t emitConst(float value) {
+        const size_t dst = this->owner.registerCount++;
+        this->owner.program.push_back(Instruction{Op::Const, dst, 0, 0, 0, 0, value});
+        return dst;
+    }
+
+    bool fail(const std::string& msg) {
+        if (this->message.empty()) this->message = msg;
+        return false;
+    }
+
+    ColumnExpressions& owner;
+    const std::string& src;
+    size_t pos = 0;
+    std::string message;
+};
+
+
+/*
+ * ColumnExpressions::Compile
+ */
+bool ColumnExpressions::Compile(
+    const std::string& source, const std::vector<std::string>& inputColumns, std::string& error) {
+    this->inputCount = inputColumns.size();
+    this->outputColumns = inputColumns;
+    this->derived.assign(inputColumns.size(), false);
+    this->program.clear();
+    this->registerCount = 0;
+
+    Parser parser(*this, source);
+    if (!parser.Statements(error)) {
+        this->outputColumns = inputColumns;
+        this->derived.assign(inputColumns.size(), false);
+        this->program.clear();
+        this->registerCount = 0;
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * ColumnExpressions::IsDerived
+ */
+bool ColumnExpressions::IsDerived(size_t column) const {
+    return (column < this->derived.size()) && this->derived[column];
+}
+
+
+/*
+ * ColumnExpressions::Evaluate
+ */
+void ColumnExpressions::Evaluate(const float* in, size_t rows, float* out) const {
+    const size_t inCols = this->inputCount;
+    const size_t outCols = this->outputColumns.size();
+    const int64_t blocks = static_cast<int64_t>((rows + BlockSize - 1) / BlockSize);
+
+#pragma omp parallel
+    {
+        std::vector<float> registers(std::max<size_t>(this->registerCount, 1) * BlockSize);
+        auto reg = [&registers](size_t idx) { return registers.data() + idx * BlockSize; };
+
+#pragma omp for schedule(static)
+        for (int64_t block = 0; block < blocks; ++block) {
+            const size_t first = static_cast<size_t>(block) * BlockSize;
+            const size_t n = std::min(BlockSize, rows - first);
+            const float* src = in + first * inCols;
+            float* dst = out + first * outCols;
+
+            for (size_t r = 0; r < n; ++r) {
+                std::copy(src + r * inCols, src + (r + 1) * inCols, dst + r * outCols);
+            }
+
+            // the table is row-major: Load and Store gather and scatter one column of the block with a stride of
+            // outCols, all other instructions run over the contiguous registers
+
+            for (const auto& ins : this->program) {
+                float* d = reg(ins.dst);
+                const float* a = reg(ins.a);
+                const float* b = reg(ins.b);
+                const float* c = reg(ins.c);
+                switch (ins.op) {
+                case Op::Load:
+                    for (size_t i = 0; i < n; ++i) d[i] = dst[i * outCols + ins.column];
+                    break;
+                case Op::Store:
+                    for (size_t i = 0; i < n; ++i) dst[i * outCols + ins.column] = a[i];
+                    break;
+                case Op::Const:
+                    std::fill(d, d + n, ins.value);
+                    break;
+                case Op::Add:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] + b[i];
+                    break;
+                case Op::Sub:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] - b[i];
+                    break;
+                case Op::Mul:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] * b[i];
+                    break;
+                case Op::Div:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] / b[i];
+                    break;
+                case Op::Mod:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::fmod(a[i], b[i]);
+                    break;
+                case Op::Pow:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::pow(a[i], b[i]);
+                    break;
+                case Op::Neg:
+                    for (size_t i = 0; i < n; ++i) d[i] = -a[i];
+                    break;
+                case Op::Less:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] < b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::LessEq:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] <= b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::Greater:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] > b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::GreaterEq:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] >= b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::Equal:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] == b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::NotEqual:
+                    for (size_t i = 0; i < n; ++i) d[i] = a[i] != b[i] ? 1.0f : 0.0f;
+                    break;
+                case Op::Sin:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::sin(a[i]);
+                    break;
+                case Op::Cos:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::cos(a[i]);
+                    break;
+                case Op::Tan:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::tan(a[i]);
+                    break;
+                case Op::Asin:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::asin(a[i]);
+                    break;
+                case Op::Acos:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::acos(a[i]);
+                    break;
+                case Op::Atan:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::atan(a[i]);
+                    break;
+                case Op::Sinh:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::sinh(a[i]);
+                    break;
+                case Op::Cosh:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::cosh(a[i]);
+                    break;
+                case Op::Tanh:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::tanh(a[i]);
+                    break;
+                case Op::Sqrt:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::sqrt(a[i]);
+                    break;
+                case Op::Abs:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::abs(a[i]);
+                    break;
+                case Op::Exp:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::exp(a[i]);
+                    break;
+                case Op::Log:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::log(a[i]);
+                    break;
+                case Op::Log10:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::log10(a[i]);
+                    break;
+                case Op::Floor:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::floor(a[i]);
+                    break;
+                case Op::Ceil:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::ceil(a[i]);
+                    break;
+                case Op::Round:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::round(a[i]);
+                    break;
+                case Op::Sign:
+                    for (size_t i = 0; i < n; ++i) d[i] = static_cast<float>((a[i] > 0.0f) - (a[i] < 0.0f));
+                    break;
+                case Op::Atan2:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::atan2(a[i], b[i]);
+                    break;
+                case Op::Min:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::min(a[i], b[i]);
+                    break;
+                case Op::Max:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::max(a[i], b[i]);
+                    break;
+                case Op::Clamp:
+                    for (size_t i = 0; i < n; ++i) d[i] = std::min(std::max(a[i], b[i]), c[i]);
+                    break;
+                case Op::Select:
+                    for (size_t i = 0; i < n; ++i) d[i] = (a[i] != 0.0f) ? b[i] : c[i];
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * ColumnExpressions.h
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNEXPRESSIONS_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_COLUMNEXPRESSIONS_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+namespace table {
+
+/**
+ * Derived table columns defined by arithmetic expressions over named columns.
+ *
+ * The source consists of statements "name = expression", separated by
+ * newlines or ';'. '#' starts a comment up to the end of the line, so does
+ * '--' at the start of a statement (elsewhere 'a--b' means a - (-b)).
+ * Expressions support + - * / % ^, comparisons (yielding 0 or 1), unary
+ * minus, parentheses, the constants pi and e, and the functions sin, cos,
+ * tan, asin, acos, atan, sinh, cosh, tanh, sqrt, abs, exp, log, log10,
+ * floor, ceil, round, sign, atan2, pow, min, max, fmod, clamp and
+ * select(condition, a, b). Columns are referenced by name, names that are
+ * no identifiers can be written as [some name].
+ *
+ * Statements are compiled once into a register program which is evaluated
+ * in blocks of rows. A register holds one value per row of the block, so
+ * each instruction is a tight loop over contiguous registers, except for
+ * loading and storing columns, which are strided accesses into the
+ * row-major table. Blocks are distributed over OpenMP threads.
+ */
+class ColumnExpressions {
+public:
+    /**
+     * Compiles the statements against the given input columns.
+     *
+     * A statement assigning to an existing column replaces its values,
+     * otherwise a new column is appended. Later statements can use columns
+     * defined by earlier ones.
+     *
+     * @param source       The statements.
+     * @param inputColumns Names of the incoming columns.
+     * @param error        Receives a description of the first syntax error.
+     *
+     * @return true on success.
+     */
+    bool Compile(const std::string& source, const std::vector<std::string>& inputColumns, std::string& error);
+
+    /** Answer the names of all output columns (inputs first). */
+    inline const std::vector<std::string>& OutputColumns(void) const {
+        return this->outputColumns;
+    }
+
+    /** Answer whether the statement at output column idx was (re)computed. */
+    bool IsDerived(size_t column) const;
+
+    /**
+     * Computes the output table.
+     *
+     * @param in   Row-major input of rows x inputColumns.size() values.
+     * @param rows The number of rows.
+     * @param out  Row-major output of rows x OutputColumns().size() values.
+     */
+    void Evaluate(const float* in, size_t rows, float* out) const;
+
+private:
+    enum class Op {
+        Load, // dst = column
+        Const,
+        Store, // column = register a
+        Add, Sub, Mul, Div, Mod, Pow, Neg,
+        Less, LessEq, Greater, GreaterEq, Equal, NotEqual,
+        Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, Sqrt, Abs, Exp, Log, Log10, Floor, Ceil, Round, Sign,
+        Atan2, Min, Max, Clamp, Select
+    };
+
+    struct Instruction {
+        Op op;
+        size_t dst;
+        size_t a;
+        size_t b;
+        size_t c;
+        size_t column;
+        float value;
+    };
+
+    class Parser;
+
+    size_t inputCount = 0;
+
+    std::vector<std::string> outputColumns;
+
+    std::vector<bool> derived;
+
+    std::vector<Instruction> program;
+
+    size_t registerCount = 0;
+};
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_TABLE_COLUMNEXPRESSIONS_H_INCLUDED */
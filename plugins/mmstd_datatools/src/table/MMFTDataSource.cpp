@@ -6,9 +6,19 @@
 
 #include "MMFTDataSource.h"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <omp.h>
+
+#include "MMFTFormat.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/StringParam.h"
 
 using namespace megamol::stdplugin::datatools::table;
 using namespace megamol;
@@ -46,6 +56,161 @@ std::string read_string(std::istream& stream, std::size_t size, bool trim_null =
     return str;
 }
 
+std::vector<std::string> split_names(const std::string& str) {
+    std::vector<std::string> names;
+    std::size_t start = 0;
+    while (start <= str.size()) {
+        std::size_t end = std::min(str.find(';', start), str.size());
+        std::size_t first = str.find_first_not_of(" \t", start);
+        std::size_t last = str.find_last_not_of(" \t", end == 0 ? 0 : end - 1);
+        if (first < end && last != std::string::npos && last >= first) {
+            names.push_back(str.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return names;
+}
+
+/** Reads the values of a version 0 file, which can only be read as a whole */
+void read_plain(std::istream& stream, uint32_t colCount, uint64_t rowCount, const std::vector<uint32_t>& selected,
+    int64_t filterCol, float filterMin, float filterMax, std::vector<float>& values) {
+    auto all = read_vector<float>(stream, rowCount * colCount);
+    bool identity = (filterCol < 0) && (selected.size() == colCount);
+    for (std::size_t s = 0; identity && (s < selected.size()); ++s) {
+        identity = (selected[s] == s);
+    }
+    if (identity) {
+        values = std::move(all);
+        return;
+    }
+    values.clear();
+    for (uint64_t r = 0; r < rowCount; ++r) {
+        const float* row = all.data() + r * colCount;
+        if ((filterCol >= 0) && !((row[filterCol] >= filterMin) && (row[filterCol] <= filterMax))) continue;
+        for (auto c : selected) {
+            values.push_back(row[c]);
+        }
+    }
+}
+
+/**
+ * Reads the chunks of the given columns in the given groups and passes them
+ * decoded to fn(groupIdx, columnIdx, values, rows), where the indices refer
+ * to 'groups' and 'columns'. The chunks are read in batches of about 256 MB
+ * in file order, each batch is decoded in parallel.
+ */
+template<typename Fn>
+void for_each_chunk(std::istream& stream, const std::vector<mmft::ChunkInfo>& index, uint32_t colCount,
+    uint32_t chunkRows, uint64_t rowCount, const std::vector<uint64_t>& groups, const std::vector<uint32_t>& columns,
+    Fn&& fn) {
+    const std::size_t taskCount = groups.size() * columns.size();
+    const uint64_t batchBytes = 256ull << 20;
+    std::vector<std::vector<char>> encoded;
+    for (std::size_t first = 0; first < taskCount;) {
+        std::size_t last = first;
+        uint64_t bytes = 0;
+        encoded.clear();
+        while ((last < taskCount) && ((last == first) || (bytes < batchBytes))) {
+            const auto& info = index[groups[last / columns.size()] * colCount + columns[last % columns.size()]];
+            encoded.emplace_back(info.size);
+            stream.seekg(info.offset);
+            stream.read(encoded.back().data(), info.size);
+            if (!stream.good()) {
+                throw std::runtime_error("Error reading from stream!");
+            }
+            bytes += info.size;
+            ++last;
+        }
+
+        std::atomic<bool> corrupt(false);
+        const auto batch = static_cast<long long>(last - first);
+#pragma omp parallel
+        {
+            std::vector<float> decoded;
+            std::vector<char> scratch;
+#pragma omp for schedule(dynamic, 1)
+            for (long long t = 0; t < batch; ++t) {
+                const std::size_t g = (first + t) / columns.size();
+                const std::size_t c = (first + t) % columns.size();
+                const auto& info = index[groups[g] * colCount + columns[c]];
+                const uint64_t rows = std::min<uint64_t>(chunkRows, rowCount - groups[g] * chunkRows);
+                decoded.resize(rows);
+                if (!mmft::DecodeChunk(encoded[t].data(), encoded[t].size(), static_cast<mmft::Codec>(info.codec),
+                        decoded.data(), rows, scratch)) {
+                    corrupt = true;
+                    continue;
+                }
+                fn(g, c, decoded.data(), rows);
+            }
+        }
+        if (corrupt) {
+            throw std::runtime_error("Corrupt chunk in MMFT file!");
+        }
+        first = last;
+    }
+}
+
+/**
+ * Reads the values of a version 1 file. Only the chunks of the selected
+ * columns and the filter column are read, and groups whose filter column
+ * range does not intersect [filterMin, filterMax] are skipped entirely.
+ */
+void read_chunked(std::istream& stream, uint32_t colCount, uint64_t rowCount, const std::vector<uint32_t>& selected,
+    int64_t filterCol, float filterMin, float filterMax, std::vector<float>& values) {
+    const auto chunkRows = read<uint32_t>(stream);
+    const auto indexOffset = read<uint64_t>(stream);
+    if (chunkRows == 0) {
+        throw std::runtime_error("Invalid chunk size!");
+    }
+    const uint64_t groupCount = (rowCount + chunkRows - 1) / chunkRows;
+    stream.seekg(indexOffset);
+    const auto index = read_vector<mmft::ChunkInfo>(stream, groupCount * colCount);
+
+    std::vector<uint64_t> groups;
+    for (uint64_t g = 0; g < groupCount; ++g) {
+        if (filterCol >= 0) {
+            const auto& info = index[g * colCount + filterCol];
+            if ((info.maxValue < filterMin) || (info.minValue > filterMax)) continue;
+        }
+        groups.push_back(g);
+    }
+
+    // the filter column decides which rows of the remaining groups are kept
+    std::vector<std::vector<uint8_t>> keep(groups.size());
+    std::vector<uint64_t> offsets(groups.size() + 1, 0);
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        offsets[g + 1] = std::min<uint64_t>(chunkRows, rowCount - groups[g] * chunkRows);
+    }
+    if (filterCol >= 0) {
+        for_each_chunk(stream, index, colCount, chunkRows, rowCount, groups,
+            std::vector<uint32_t>(1, static_cast<uint32_t>(filterCol)),
+            [&](std::size_t g, std::size_t, const float* data, uint64_t rows) {
+                keep[g].resize(rows);
+                uint64_t kept = 0;
+                for (uint64_t r = 0; r < rows; ++r) {
+                    keep[g][r] = (data[r] >= filterMin) && (data[r] <= filterMax);
+                    kept += keep[g][r];
+                }
+                offsets[g + 1] = kept;
+            });
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    const std::size_t selCount = selected.size();
+    values.resize(offsets.back() * selCount);
+    for_each_chunk(stream, index, colCount, chunkRows, rowCount, groups, selected,
+        [&](std::size_t g, std::size_t c, const float* data, uint64_t rows) {
+            float* out = values.data() + offsets[g] * selCount + c;
+            const auto& k = keep[g];
+            for (uint64_t r = 0; r < rows; ++r) {
+                if (k.empty() || k[r]) {
+                    *out = data[r];
+                    out += selCount;
+                }
+            }
+        });
+}
+
 } // namespace
 
 MMFTDataSource::MMFTDataSource()
@@ -53,6 +218,12 @@ MMFTDataSource::MMFTDataSource()
         , getDataSlot_("getData", "Slot providing the data")
         , filenameSlot_("filename", "The file name")
         , reloadSlot_("reload", "Reload file")
+        , columnsSlot_("columns", "Loads only the columns with these names, separated by \";\" (all columns if empty)")
+        , filterColumnSlot_("filterColumn",
+              "Loads only the rows whose value in this column lies in [filterMin, filterMax] (no filter if empty). "
+              "Chunks of MMFT version 1 files outside the range are not read at all.")
+        , filterMinSlot_("filterMin", "Lower bound of the row filter")
+        , filterMaxSlot_("filterMax", "Upper bound of the row filter")
         , dataHash_(0)
         , reload_(false)
         , columns_()
@@ -63,6 +234,14 @@ MMFTDataSource::MMFTDataSource()
     reloadSlot_ << new core::param::ButtonParam();
     reloadSlot_.SetUpdateCallback(this, &MMFTDataSource::reloadCallback);
     MakeSlotAvailable(&reloadSlot_);
+    columnsSlot_ << new core::param::StringParam("");
+    MakeSlotAvailable(&columnsSlot_);
+    filterColumnSlot_ << new core::param::StringParam("");
+    MakeSlotAvailable(&filterColumnSlot_);
+    filterMinSlot_ << new core::param::FloatParam(-std::numeric_limits<float>::max());
+    MakeSlotAvailable(&filterMinSlot_);
+    filterMaxSlot_ << new core::param::FloatParam(std::numeric_limits<float>::max());
+    MakeSlotAvailable(&filterMaxSlot_);
 
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetData", &MMFTDataSource::getDataCallback);
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetHash", &MMFTDataSource::getHashCallback);
@@ -86,11 +265,16 @@ void MMFTDataSource::release() {
 void MMFTDataSource::assertData() {
     using namespace std::string_literals;
 
-    if (!filenameSlot_.IsDirty() && !reload_) {
+    if (!filenameSlot_.IsDirty() && !reload_ && !columnsSlot_.IsDirty() && !filterColumnSlot_.IsDirty() &&
+        !filterMinSlot_.IsDirty() && !filterMaxSlot_.IsDirty()) {
         return; // nothing to do
     }
 
     filenameSlot_.ResetDirty();
+    columnsSlot_.ResetDirty();
+    filterColumnSlot_.ResetDirty();
+    filterMinSlot_.ResetDirty();
+    filterMaxSlot_.ResetDirty();
     reload_ = false;
 
     columns_.clear();
@@ -109,15 +293,15 @@ void MMFTDataSource::assertData() {
         }
 
         auto version = read<uint16_t>(file);
-        if (version != 0) {
+        if (version != mmft::PlainVersion && version != mmft::ChunkedVersion) {
             throw std::runtime_error("Wrong file format version number");
         }
 
         auto colCount = read<uint32_t>(file);
-        columns_.resize(colCount);
+        std::vector<TableDataCall::ColumnInfo> fileColumns(colCount);
 
         for (uint32_t c = 0; c < colCount; ++c) {
-            TableDataCall::ColumnInfo& ci = columns_[c];
+            TableDataCall::ColumnInfo& ci = fileColumns[c];
             auto nameLen = read<uint16_t>(file);
             ci.SetName(read_string(file, nameLen));
             auto type = read<uint8_t>(file);
@@ -128,7 +312,56 @@ void MMFTDataSource::assertData() {
 
         auto rowCount = read<uint64_t>(file);
 
-        values_ = read_vector<float>(file, rowCount * colCount);
+        auto findColumn = [&fileColumns](const std::string& name) -> int64_t {
+            auto it = std::find_if(fileColumns.begin(), fileColumns.end(),
+                [&name](const TableDataCall::ColumnInfo& ci) { return ci.Name() == name; });
+            return (it != fileColumns.end()) ? (it - fileColumns.begin()) : -1;
+        };
+
+        std::vector<uint32_t> selected;
+        auto names = split_names(std::string(columnsSlot_.Param<core::param::StringParam>()->Value().PeekBuffer()));
+        for (const auto& name : names) {
+            auto c = findColumn(name);
+            if (c < 0) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn("Column \"%s\" not found.", name.c_str());
+            } else {
+                selected.push_back(static_cast<uint32_t>(c));
+            }
+        }
+        if (names.empty()) {
+            selected.resize(colCount);
+            std::iota(selected.begin(), selected.end(), 0);
+        } else if (selected.empty()) {
+            throw std::runtime_error("None of the selected columns found!");
+        }
+
+        int64_t filterCol = -1;
+        std::string filterName(filterColumnSlot_.Param<core::param::StringParam>()->Value().PeekBuffer());
+        if (!filterName.empty()) {
+            filterCol = findColumn(filterName);
+            if (filterCol < 0) {
+                throw std::runtime_error("Filter column \""s + filterName + "\" not found!");
+            }
+        }
+        const float filterMin = filterMinSlot_.Param<core::param::FloatParam>()->Value();
+        const float filterMax = filterMaxSlot_.Param<core::param::FloatParam>()->Value();
+
+        if (version == mmft::PlainVersion) {
+            read_plain(file, colCount, rowCount, selected, filterCol, filterMin, filterMax, values_);
+        } else {
+            read_chunked(file, colCount, rowCount, selected, filterCol, filterMin, filterMax, values_);
+        }
+
+        columns_.resize(selected.size());
+        for (std::size_t s = 0; s < selected.size(); ++s) {
+            columns_[s] = fileColumns[selected[s]];
+        }
+
+        // a file without columns yields an empty table
+        const std::size_t loadedRows = columns_.empty() ? 0 : values_.size() / columns_.size();
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("Loaded %zu of %u columns and %zu of %llu rows from \"%s\"",
+            columns_.size(), colCount, loadedRows, static_cast<unsigned long long>(rowCount),
+            filename.c_str());
 
         dataHash_++;
 
@@ -150,7 +383,7 @@ bool MMFTDataSource::getDataCallback(core::Call& caller) {
 
     tfd->SetDataHash(dataHash_);
     tfd->SetFrameCount(1);
-    if (values_.empty()) {
+    if (values_.empty() || columns_.empty()) {
         tfd->Set(0, 0, nullptr, nullptr);
     } else {
         assert((values_.size() % columns_.size()) == 0);
@@ -32,6 +32,16 @@ public:
     MMFTDataSource();
     ~MMFTDataSource() override;
 
+    /**
+     * The file is read by the callbacks only, so they may be re-issued from a
+     * prefetch thread of the graph.
+     *
+     * @return 'true'
+     */
+    bool IsThreadSafe(void) const override {
+        return true;
+    }
+
 protected:
     bool create() override;
     void release() override;
@@ -47,6 +57,10 @@ private:
 
     core::param::ParamSlot filenameSlot_;
     core::param::ParamSlot reloadSlot_;
+    core::param::ParamSlot columnsSlot_;
+    core::param::ParamSlot filterColumnSlot_;
+    core::param::ParamSlot filterMinSlot_;
+    core::param::ParamSlot filterMaxSlot_;
 
     std::size_t dataHash_;
     bool reload_;
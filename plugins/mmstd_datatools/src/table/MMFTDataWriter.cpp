@@ -8,23 +8,47 @@
 #include "stdafx.h"
 #include "MMFTDataWriter.h"
 
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
 
+#include "MMFTFormat.h"
 #include "mmcore/utility/log/Log.h"
 #include "vislib/sys/FastFile.h"
 #include "vislib/String.h"
 
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+#include <vector>
+
 using namespace megamol::stdplugin::datatools;
 using namespace megamol::stdplugin::datatools::table;
 using namespace megamol;
 
 MMFTDataWriter::MMFTDataWriter(void) : core::AbstractDataWriter(),
         filenameSlot("filename", "The path to the MMFT file to be written"),
+        versionSlot("version", "The MMFT version to be written"),
+        chunkRowsSlot("chunkRows", "The number of rows per column chunk (chunked version only)"),
+        compressSlot("compress", "Compresses the column chunks (chunked version only)"),
         dataSlot("data", "The slot requesting the data to be written") {
 
     this->filenameSlot << new core::param::FilePathParam("");
     this->MakeSlotAvailable(&this->filenameSlot);
 
+    core::param::EnumParam *ep = new core::param::EnumParam(mmft::PlainVersion);
+    ep->SetTypePair(mmft::PlainVersion, "0 (row-major)");
+    ep->SetTypePair(mmft::ChunkedVersion, "1 (column chunks)");
+    this->versionSlot << ep;
+    this->MakeSlotAvailable(&this->versionSlot);
+
+    this->chunkRowsSlot << new core::param::IntParam(1 << 16, 1);
+    this->MakeSlotAvailable(&this->chunkRowsSlot);
+
+    this->compressSlot << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->compressSlot);
+
     this->dataSlot.SetCompatibleCall<TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataSlot);
 }
@@ -83,7 +107,7 @@ bool MMFTDataWriter::run(void) {
 
     vislib::StringA magicID("MMFTD");
     ASSERT_WRITEOUT(magicID.PeekBuffer(), 6);
-    uint16_t version = 0;
+    uint16_t version = static_cast<uint16_t>(this->versionSlot.Param<core::param::EnumParam>()->Value());
     ASSERT_WRITEOUT(&version, 2);
 
     uint32_t colCnt = static_cast<uint32_t>(cftd->GetColumnsCount());
@@ -105,7 +129,66 @@ bool MMFTDataWriter::run(void) {
     uint64_t rowCnt = static_cast<uint64_t>(cftd->GetRowsCount());
     ASSERT_WRITEOUT(&rowCnt, 8);
 
-    ASSERT_WRITEOUT(cftd->GetData(), rowCnt * colCnt * 4);
+    if (version == mmft::PlainVersion) {
+        ASSERT_WRITEOUT(cftd->GetData(), rowCnt * colCnt * 4);
+        return true;
+    }
+
+    uint32_t chunkRows = static_cast<uint32_t>(this->chunkRowsSlot.Param<core::param::IntParam>()->Value());
+    ASSERT_WRITEOUT(&chunkRows, 4);
+    // the index offset is patched once all chunks are written
+    const vislib::sys::File::FileSize indexOffsetPos = file.Tell();
+    uint64_t indexOffset = 0;
+    ASSERT_WRITEOUT(&indexOffset, 8);
+
+    const mmft::Codec codec = this->compressSlot.Param<core::param::BoolParam>()->Value()
+        ? mmft::Codec::ShuffledSnappy : mmft::Codec::Raw;
+    const uint64_t groupCnt = (rowCnt + chunkRows - 1) / chunkRows;
+    std::vector<mmft::ChunkInfo> index(groupCnt * colCnt);
+
+    // chunks are encoded in parallel, as many groups at once as fit into about 256 MB
+    const uint64_t groupBytes = std::max<uint64_t>(static_cast<uint64_t>(colCnt) * chunkRows * sizeof(float), 1);
+    const uint64_t batchGroups = std::max<uint64_t>((256ull << 20) / groupBytes, 1);
+    std::vector<std::vector<char>> encoded(std::min(batchGroups, groupCnt) * colCnt);
+    const float *data = cftd->GetData();
+
+    for (uint64_t firstGroup = 0; firstGroup < groupCnt; firstGroup += batchGroups) {
+        const uint64_t groups = std::min(batchGroups, groupCnt - firstGroup);
+        const long long taskCnt = static_cast<long long>(groups * colCnt);
+#pragma omp parallel
+        {
+            std::vector<float> column;
+            std::vector<char> scratch;
+#pragma omp for schedule(dynamic, 1)
+            for (long long t = 0; t < taskCnt; ++t) {
+                const uint64_t group = firstGroup + t / colCnt;
+                const uint32_t c = static_cast<uint32_t>(t % colCnt);
+                const uint64_t firstRow = group * chunkRows;
+                const uint64_t rows = std::min<uint64_t>(chunkRows, rowCnt - firstRow);
+                mmft::ChunkInfo &info = index[group * colCnt + c];
+                info.minValue = std::numeric_limits<float>::max();
+                info.maxValue = -std::numeric_limits<float>::max();
+                column.resize(rows);
+                for (uint64_t r = 0; r < rows; ++r) {
+                    const float v = data[(firstRow + r) * colCnt + c];
+                    column[r] = v;
+                    if (v < info.minValue) info.minValue = v;
+                    if (v > info.maxValue) info.maxValue = v;
+                }
+                info.codec = static_cast<uint8_t>(mmft::EncodeChunk(column.data(), rows, codec, encoded[t], scratch));
+                info.size = encoded[t].size();
+            }
+        }
+        for (long long t = 0; t < taskCnt; ++t) {
+            index[firstGroup * colCnt + t].offset = file.Tell();
+            ASSERT_WRITEOUT(encoded[t].data(), encoded[t].size());
+        }
+    }
+
+    indexOffset = file.Tell();
+    ASSERT_WRITEOUT(index.data(), index.size() * sizeof(mmft::ChunkInfo));
+    file.Seek(indexOffsetPos);
+    ASSERT_WRITEOUT(&indexOffset, 8);
 
     return true;
 }
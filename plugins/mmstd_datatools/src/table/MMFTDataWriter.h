@@ -103,6 +103,15 @@ namespace table {
         /** The file name of the file to be written */
         core::param::ParamSlot filenameSlot;
 
+        /** The MMFT version to be written */
+        core::param::ParamSlot versionSlot;
+
+        /** The number of rows per chunk of the chunked version */
+        core::param::ParamSlot chunkRowsSlot;
+
+        /** Whether the chunks of the chunked version are compressed */
+        core::param::ParamSlot compressSlot;
+
         /** The slot asking for data */
         core::CallerSlot dataSlot;
 
@@ -0,0 +1,67 @@
+/*
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "MMFTFormat.h"
+
+#include <cstring>
+
+#include "snappy.h"
+
+using namespace megamol::stdplugin::datatools::table;
+
+mmft::Codec mmft::EncodeChunk(
+    const float* values, std::size_t count, Codec codec, std::vector<char>& out, std::vector<char>& scratch) {
+    const std::size_t bytes = count * sizeof(float);
+    if (codec == Codec::ShuffledSnappy) {
+        // neighbouring floats mostly differ in their low bytes, storing the bytes by significance
+        // gives snappy long runs of equal exponents to work with
+        const auto* src = reinterpret_cast<const unsigned char*>(values);
+        scratch.resize(bytes);
+        for (std::size_t b = 0; b < sizeof(float); ++b) {
+            char* plane = scratch.data() + b * count;
+            for (std::size_t i = 0; i < count; ++i) {
+                plane[i] = static_cast<char>(src[i * sizeof(float) + b]);
+            }
+        }
+        out.resize(snappy::MaxCompressedLength(bytes));
+        std::size_t compressed = 0;
+        snappy::RawCompress(scratch.data(), bytes, out.data(), &compressed);
+        if (compressed < bytes) {
+            out.resize(compressed);
+            return Codec::ShuffledSnappy;
+        }
+    }
+    out.resize(bytes);
+    std::memcpy(out.data(), values, bytes);
+    return Codec::Raw;
+}
+
+bool mmft::DecodeChunk(
+    const char* data, std::size_t size, Codec codec, float* values, std::size_t count, std::vector<char>& scratch) {
+    const std::size_t bytes = count * sizeof(float);
+    switch (codec) {
+    case Codec::Raw:
+        if (size != bytes) return false;
+        std::memcpy(values, data, bytes);
+        return true;
+    case Codec::ShuffledSnappy: {
+        std::size_t length = 0;
+        if (!snappy::GetUncompressedLength(data, size, &length) || (length != bytes)) return false;
+        scratch.resize(bytes);
+        if (!snappy::RawUncompress(data, size, scratch.data())) return false;
+        auto* dst = reinterpret_cast<unsigned char*>(values);
+        for (std::size_t b = 0; b < sizeof(float); ++b) {
+            const char* plane = scratch.data() + b * count;
+            for (std::size_t i = 0; i < count; ++i) {
+                dst[i * sizeof(float) + b] = static_cast<unsigned char>(plane[i]);
+            }
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
+#define MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Shared definitions of the MMFT file versions.
+ *
+ * Both versions start with the magic ID "MMFTD\0", the version (uint16_t),
+ * the column count (uint32_t), the column infos (name length as uint16_t,
+ * name, type as uint8_t, minimum and maximum as float) and the row count
+ * (uint64_t).
+ *
+ * Version 0 continues with all values in row-major order.
+ *
+ * Version 1 continues with the number of rows per chunk (uint32_t) and the
+ * file offset of the chunk index (uint64_t). The rows are split into groups
+ * of that many rows, and every group stores one chunk per column holding
+ * the values of this column, optionally compressed. The chunk index at the
+ * end of the file holds one ChunkInfo per group and column, group-major, so
+ * readers can load single columns and skip groups by their value range.
+ */
+namespace megamol::stdplugin::datatools::table::mmft {
+
+constexpr uint16_t PlainVersion = 0;
+
+constexpr uint16_t ChunkedVersion = 1;
+
+/** Encoding of a chunk */
+enum class Codec : uint8_t {
+    Raw = 0,           //< plain floats
+    ShuffledSnappy = 1 //< floats split into byte planes, compressed with snappy
+};
+
+#pragma pack(push, 1)
+/** Entry of the chunk index */
+struct ChunkInfo {
+    uint64_t offset;
+    uint64_t size;
+    uint8_t codec;
+    float minValue; //< smallest non-NaN value, FLT_MAX if there is none
+    float maxValue; //< largest non-NaN value, -FLT_MAX if there is none
+};
+#pragma pack(pop)
+
+/**
+ * Encodes a chunk of values.
+ *
+ * @param values  The values of the chunk.
+ * @param count   The number of values.
+ * @param codec   The requested codec. Raw is used instead if compression does not pay off.
+ * @param out     Receives the encoded chunk.
+ * @param scratch Temporary buffer, can be reused between calls.
+ *
+ * @return The codec actually used.
+ */
+Codec EncodeChunk(const float* values, std::size_t count, Codec codec, std::vector<char>& out,
+    std::vector<char>& scratch);
+
+/**
+ * Decodes a chunk of values.
+ *
+ * @param data    The encoded chunk.
+ * @param size    The size of the encoded chunk in bytes.
+ * @param codec   The codec of the chunk.
+ * @param values  Receives the 'count' values.
+ * @param count   The number of values in the chunk.
+ * @param scratch Temporary buffer, can be reused between calls.
+ *
+ * @return false if the chunk is corrupt.
+ */
+bool DecodeChunk(const char* data, std::size_t size, Codec codec, float* values, std::size_t count,
+    std::vector<char>& scratch);
+
+} // namespace megamol::stdplugin::datatools::table::mmft
+
+#endif // MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
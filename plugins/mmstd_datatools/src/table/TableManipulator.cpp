@@ -8,9 +8,14 @@
 #include "stdafx.h"
 #include "TableManipulator.h"
 
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/StringParam.h"
 
+#include "ColumnExpressions.h"
+
+#include <algorithm>
 #include <limits>
+#include "omp.h"
 #include "vislib/StringTokeniser.h"
 #include "mmcore/utility/log/Log.h"
 
@@ -22,11 +27,15 @@ std::string TableManipulator::ModuleName = std::string("TableManipulator");
 
 std::string TableManipulator::defaultScript = "";
 
+enum ManipulatorMode : int { LuaScript = 0, Expressions = 1 };
+
 TableManipulator::TableManipulator(void)
     : core::Module()
     , dataOutSlot("dataOut", "Output")
     , dataInSlot("dataIn", "Input")
     , scriptSlot("script", "script to execute on incoming table data")
+    , modeSlot("mode", "run the Lua script or evaluate the column expressions")
+    , expressionsSlot("expressions", "one 'column = expression' per line, computed for all rows in parallel")
     , frameID(-1)
     , in_datahash(std::numeric_limits<unsigned long>::max())
     , out_datahash(0)
@@ -88,6 +97,18 @@ TableManipulator::TableManipulator(void)
         "    mmSetOutputColumnRange(c, mins[c], maxes[c])\n"
         "end\n");
     this->MakeSlotAvailable(&this->scriptSlot);
+
+    auto* mode = new core::param::EnumParam(ManipulatorMode::LuaScript);
+    mode->SetTypePair(ManipulatorMode::LuaScript, "Lua script");
+    mode->SetTypePair(ManipulatorMode::Expressions, "Expressions");
+    this->modeSlot << mode;
+    this->MakeSlotAvailable(&this->modeSlot);
+
+    this->expressionsSlot << new core::param::StringParam(
+        "# example deriving columns, input columns are referenced by name or as [column name]\n"
+        "# r = sqrt(x^2 + y^2 + z^2)\n"
+        "# phi = atan2(y, x)\n");
+    this->MakeSlotAvailable(&this->expressionsSlot);
 }
 
 TableManipulator::~TableManipulator(void) { this->Release(); }
@@ -128,10 +149,13 @@ bool TableManipulator::processData(core::Call& c) {
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)()) return false;
 
-        if (this->in_datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID() || this->scriptSlot.IsDirty()) {
+        if (this->in_datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID() ||
+            this->scriptSlot.IsDirty() || this->modeSlot.IsDirty() || this->expressionsSlot.IsDirty()) {
             this->in_datahash = inCall->DataHash();
             this->frameID = inCall->GetFrameID();
             this->scriptSlot.ResetDirty();
+            this->modeSlot.ResetDirty();
+            this->expressionsSlot.ResetDirty();
             this->out_datahash++;
 
             column_count = inCall->GetColumnsCount();
@@ -139,18 +163,23 @@ bool TableManipulator::processData(core::Call& c) {
             row_count = inCall->GetRowsCount();
             in_data = inCall->GetData();
 
-            const std::string scriptString = std::string(this->scriptSlot.Param<core::param::StringParam>()->Value());
+            if (this->modeSlot.Param<core::param::EnumParam>()->Value() == ManipulatorMode::Expressions) {
+                this->runExpressions();
+            } else {
+                const std::string scriptString =
+                    std::string(this->scriptSlot.Param<core::param::StringParam>()->Value());
 
-            this->info.clear();
-            this->info.reserve(column_count);
-            this->data.clear();
-            this->data.reserve(column_count * row_count);
+                this->info.clear();
+                this->info.reserve(column_count);
+                this->data.clear();
+                this->data.reserve(column_count * row_count);
 
-            std::string res;
-            const bool ok = theLua.RunString(scriptString, res);
+                std::string res;
+                const bool ok = theLua.RunString(scriptString, res);
 
-            if (!ok) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError("TableManipulator: Lua execution is NOT OK and returned '%s'", res.c_str());
+                if (!ok) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError("TableManipulator: Lua execution is NOT OK and returned '%s'", res.c_str());
+                }
             }
         }
 
@@ -172,6 +201,75 @@ bool TableManipulator::processData(core::Call& c) {
     return true;
 }
 
+void TableManipulator::runExpressions(void) {
+    std::vector<std::string> names;
+    names.reserve(column_count);
+    for (size_t c = 0; c < column_count; ++c) {
+        names.push_back(column_infos[c].Name());
+    }
+
+    ColumnExpressions expressions;
+    std::string error;
+    if (!expressions.Compile(
+            std::string(this->expressionsSlot.Param<core::param::StringParam>()->Value()), names, error)) {
+        // pass the input through unchanged
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "TableManipulator: cannot parse expressions: %s", error.c_str());
+    }
+
+    const auto& outNames = expressions.OutputColumns();
+    const size_t outCols = outNames.size();
+    this->data.resize(outCols * row_count);
+    expressions.Evaluate(in_data, row_count, this->data.data());
+
+    this->info.resize(outCols);
+    std::vector<size_t> derived;
+    for (size_t c = 0; c < outCols; ++c) {
+        if (c < column_count) {
+            this->info[c] = column_infos[c];
+        } else {
+            this->info[c].SetName(outNames[c]);
+            this->info[c].SetType(TableDataCall::ColumnType::QUANTITATIVE);
+        }
+        if (expressions.IsDerived(c)) derived.push_back(c);
+    }
+    if (derived.empty()) return;
+
+    // value ranges of the derived columns, one range per thread that are merged afterwards
+    const size_t numDerived = derived.size();
+    const int threads = omp_get_max_threads();
+    std::vector<float> minVals(threads * numDerived, std::numeric_limits<float>::max());
+    std::vector<float> maxVals(threads * numDerived, std::numeric_limits<float>::lowest());
+    const int64_t rows = static_cast<int64_t>(row_count);
+#pragma omp parallel
+    {
+        float* localMin = minVals.data() + omp_get_thread_num() * numDerived;
+        float* localMax = maxVals.data() + omp_get_thread_num() * numDerived;
+#pragma omp for
+        for (int64_t r = 0; r < rows; ++r) {
+            const float* row = this->data.data() + r * outCols;
+            for (size_t d = 0; d < numDerived; ++d) {
+                const float v = row[derived[d]];
+                localMin[d] = std::min(localMin[d], v);
+                localMax[d] = std::max(localMax[d], v);
+            }
+        }
+    }
+    for (size_t d = 0; d < numDerived; ++d) {
+        float minVal = minVals[d];
+        float maxVal = maxVals[d];
+        for (int t = 1; t < threads; ++t) {
+            minVal = std::min(minVal, minVals[t * numDerived + d]);
+            maxVal = std::max(maxVal, maxVals[t * numDerived + d]);
+        }
+        if (row_count == 0) {
+            minVal = maxVal = 0.0f;
+        }
+        this->info[derived[d]].SetMinimumValue(minVal);
+        this->info[derived[d]].SetMaximumValue(maxVal);
+    }
+}
+
 bool TableManipulator::getExtent(core::Call& c) {
     try {
         TableDataCall* outCall = dynamic_cast<TableDataCall*>(&c);
@@ -88,6 +88,9 @@ private:
     /** Data callback */
     bool processData(core::Call& c);
 
+    /** Computes the output table from the column expressions */
+    void runExpressions(void);
+
     bool getExtent(core::Call& c);
 
     /** Data output slot */
@@ -99,6 +102,12 @@ private:
     /** Parameter slot for column selection */
     core::param::ParamSlot scriptSlot;
 
+    /** Parameter slot selecting Lua script or column expressions */
+    core::param::ParamSlot modeSlot;
+
+    /** Parameter slot for the column expressions */
+    core::param::ParamSlot expressionsSlot;
+
     /** ID of the current frame */
     int frameID;
 
@@ -33,6 +33,16 @@ namespace table {
          */
         virtual ~TableProcessorBase(void) = default;
 
+        /**
+         * Table processors compute from their input table only, so the callbacks
+         * may be re-issued from a prefetch thread of the graph.
+         *
+         * @return 'true'
+         */
+        bool IsThreadSafe(void) const override {
+            return true;
+        }
+
     protected:
 
         typedef megamol::stdplugin::datatools::table::TableDataCall::ColumnInfo
@@ -62,6 +62,16 @@ namespace datatools {
          */
         virtual ~TableToParticles(void);
 
+        /**
+         * The particles are computed from the input table only, so the callbacks
+         * may be re-issued from a prefetch thread of the graph.
+         *
+         * @return 'true'
+         */
+        bool IsThreadSafe(void) const override {
+            return true;
+        }
+
     protected:
 
         /**
@@ -0,0 +1,21 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testhelper.h"
+#include "testdbscan.h"
+#include "testradixsort.h"
+
+
+/* all available tests:
+ * Add your tests here
+ */
+TestEntry tests[] = {
+    { "DBSCAN", ::TestDBSCAN, "Compares the parallel DBSCAN with the sequential one" },
+    { "RadixSort", ::TestRadixSort, "Compares the parallel radix sort and gather with serial ones" },
+    // end guard. Do not remove. Must be last entry.
+    {NULL, NULL, NULL}
+};
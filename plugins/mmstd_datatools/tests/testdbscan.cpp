@@ -0,0 +1,136 @@
+/*
+ * testdbscan.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testdbscan.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "clustering/DBSCAN.h"
+
+using namespace megamol::stdplugin::datatools;
+using namespace megamol::stdplugin::datatools::clustering;
+
+namespace {
+
+/** Answers the bounding box of 'points' in the layout of genericPointcloud */
+template<int DIM>
+std::array<float, 2 * DIM> boundsOf(std::vector<float> const& points) {
+    std::array<float, 2 * DIM> bbox;
+    for (int d = 0; d < DIM; ++d) {
+        bbox[d * 2] = 0.0f;
+        bbox[d * 2 + 1] = 0.0f;
+    }
+    for (size_t i = 0; i < points.size(); i += DIM) {
+        for (int d = 0; d < DIM; ++d) {
+            bbox[d * 2] = (i == 0) ? points[i + d] : std::min(bbox[d * 2], points[i + d]);
+            bbox[d * 2 + 1] = (i == 0) ? points[i + d] : std::max(bbox[d * 2 + 1], points[i + d]);
+        }
+    }
+    return bbox;
+}
+
+/** Answers whether both variants yield the same labels for 'points', with squared 'eps' */
+template<int DIM>
+bool sameClusters(std::vector<float> const& points, std::array<float, DIM> const& weights, float eps, index_t minPts) {
+    genericPointcloud<float, DIM> cloud(points, boundsOf<DIM>(points), weights);
+    auto tree = std::make_shared<kd_tree_t<float, DIM>>(DIM, cloud, nanoflann::KDTreeSingleIndexAdaptorParams());
+    tree->buildIndex();
+
+    auto const sequential = DBSCAN(tree, eps, minPts);
+    auto const parallel = DBSCAN_parallel(cloud, eps, minPts);
+    return sequential == parallel;
+}
+
+/**
+ * Two clusters of five points each, whose centres share the border point
+ * between them. The border point has three neighbours and is no core point
+ * for minPts = 4. 'order' permutes the points.
+ */
+std::vector<float> sharedBorder(std::vector<size_t> const& order) {
+    std::vector<std::array<float, 3>> const pts = {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {2.0f, 1.0f, 0.0f},
+        {2.0f, -1.0f, 0.0f}, {2.0f, 0.0f, 1.0f}, {2.0f, 0.0f, -1.0f}};
+    std::vector<float> points;
+    for (auto const idx : order) {
+        points.insert(points.end(), pts[idx].begin(), pts[idx].end());
+    }
+    return points;
+}
+
+/** Answers 'cnt' random points, snapped to multiples of 'step' to provoke distances equal to eps */
+template<int DIM>
+std::vector<float> randomPoints(size_t cnt, float extent, float step, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, extent);
+    std::vector<float> points(cnt * DIM);
+    for (auto& p : points) {
+        p = (step > 0.0f) ? std::floor(dist(rng) / step) * step : dist(rng);
+    }
+    return points;
+}
+
+} // namespace
+
+
+void TestDBSCAN(void) {
+    std::array<float, 3> const unit = {1.0f, 1.0f, 1.0f};
+    float const r = 1.05f;
+
+    // the border point must join the cluster found first, whatever the input order
+    std::vector<size_t> order(11);
+    std::iota(order.begin(), order.end(), 0);
+    AssertTrue("Shared border, in input order", sameClusters<3>(sharedBorder(order), unit, r * r, 4));
+    std::reverse(order.begin(), order.end());
+    AssertTrue("Shared border, reversed", sameClusters<3>(sharedBorder(order), unit, r * r, 4));
+    order = {5, 7, 0, 8, 1, 9, 2, 10, 3, 6, 4};
+    AssertTrue("Shared border, border point first", sameClusters<3>(sharedBorder(order), unit, r * r, 4));
+    std::mt19937 rng(42);
+    for (int i = 0; i < 8; ++i) {
+        std::shuffle(order.begin(), order.end(), rng);
+        AssertTrue("Shared border, shuffled", sameClusters<3>(sharedBorder(order), unit, r * r, 4));
+    }
+    {
+        genericPointcloud<float, 3> cloud(sharedBorder(order), boundsOf<3>(sharedBorder(order)), unit);
+        auto const labels = DBSCAN_parallel(cloud, r * r, 4);
+        index_t const noise = static_cast<cluster_type_ut>(cluster_type::NOISE);
+        AssertEqual("Shared border yields two clusters", *std::max_element(labels.begin(), labels.end()), noise + 2);
+        AssertEqual("Shared border leaves no noise",
+            static_cast<size_t>(std::count(labels.begin(), labels.end(), noise)), static_cast<size_t>(0));
+    }
+
+    // every point is a core point, clusters are the connected components
+    auto const sparse = randomPoints<3>(2000, 10.0f, 0.0f, 1);
+    AssertTrue("minPts = 1", sameClusters<3>(sparse, unit, 0.3f * 0.3f, 1));
+    AssertTrue("minPts = 1, larger eps", sameClusters<3>(sparse, unit, 0.6f * 0.6f, 1));
+
+    // the radius search is exclusive, so nothing is found and everything is noise
+    auto const snapped = randomPoints<3>(2000, 4.0f, 0.25f, 2);
+    AssertTrue("eps = 0", sameClusters<3>(snapped, unit, 0.0f, 1));
+    AssertTrue("eps = 0, minPts = 3", sameClusters<3>(snapped, unit, 0.0f, 3));
+
+    // duplicates and neighbours exactly at eps
+    for (index_t minPts = 2; minPts <= 6; ++minPts) {
+        AssertTrue("Snapped points, eps on the lattice", sameClusters<3>(snapped, unit, 0.25f * 0.25f, minPts));
+        AssertTrue("Snapped points, eps between lattice distances", sameClusters<3>(snapped, unit, 0.3f, minPts));
+    }
+
+    // the layout of ParticleIColClustering, a weighted colour dimension and a dimension without weight
+    std::array<float, 4> const icol = {0.5f, 0.5f, 0.5f, 0.5f};
+    std::array<float, 4> const flat = {1.0f, 1.0f, 0.0f, 1.0f};
+    auto const points4 = randomPoints<4>(3000, 1.0f, 0.0f, 3);
+    for (index_t minPts = 1; minPts <= 8; minPts += 3) {
+        AssertTrue("Four dimensions, weighted", sameClusters<4>(points4, icol, 0.1f * 0.1f, minPts));
+        AssertTrue("Four dimensions, one without weight", sameClusters<4>(points4, flat, 0.05f * 0.05f, minPts));
+    }
+}
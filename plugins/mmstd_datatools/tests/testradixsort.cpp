@@ -0,0 +1,151 @@
+/*
+ * testradixsort.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testradixsort.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ParticleRadixSort.h"
+
+using namespace megamol::stdplugin::datatools;
+
+namespace {
+
+/** Enough keys for several blocks of the parallel passes */
+constexpr size_t manyKeys = 300000;
+
+/**
+ * Answers whether the radix sort of 'keys' yields the same keys and values
+ * as a serial stable sort. The values are the input positions, so equal
+ * keys must keep their order.
+ */
+bool sortsLikeStableSort(std::vector<uint64_t> keys) {
+    std::vector<uint64_t> values(keys.size());
+    std::iota(values.begin(), values.end(), 0);
+
+    std::vector<std::pair<uint64_t, uint64_t>> expected(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        expected[i] = std::make_pair(keys[i], values[i]);
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+        [](std::pair<uint64_t, uint64_t> const& l, std::pair<uint64_t, uint64_t> const& r) {
+            return l.first < r.first;
+        });
+
+    RadixSort(keys, values);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] != expected[i].first || values[i] != expected[i].second) return false;
+    }
+    return true;
+}
+
+/** Answers 'cnt' random keys of at most 'bits' bits, shifted left by 'shift' and or-ed with 'common' */
+std::vector<uint64_t> randomKeys(
+    size_t cnt, unsigned int bits, unsigned int shift, uint64_t common, unsigned int seed) {
+    std::mt19937_64 rng(seed);
+    uint64_t const mask = (bits >= 64) ? ~uint64_t(0) : ((uint64_t(1) << bits) - 1);
+    std::vector<uint64_t> keys(cnt);
+    for (auto& k : keys) {
+        k = ((rng() & mask) << shift) | common;
+    }
+    return keys;
+}
+
+/** Answers whether GatherStreams packs the same records as a serial copy */
+bool gathersLikeSerialCopy(uint32_t const* perm, size_t cnt) {
+    // xyzr positions with a padded stride, rgba colours and 64-bit IDs
+    size_t const srcCnt = manyKeys;
+    std::vector<float> pos(srcCnt * 5);
+    std::vector<unsigned char> col(srcCnt * 4);
+    std::vector<uint64_t> ids(srcCnt);
+    for (size_t i = 0; i < srcCnt; ++i) {
+        for (size_t c = 0; c < 5; ++c) pos[i * 5 + c] = static_cast<float>(i * 5 + c);
+        for (size_t c = 0; c < 4; ++c) col[i * 4 + c] = static_cast<unsigned char>(i + c);
+        ids[i] = (uint64_t(1) << 40) | i;
+    }
+    size_t const stride = 16 + 4 + 8;
+    std::vector<GatherStream> const streams = {
+        {pos.data(), 5 * sizeof(float), 16, 0}, {col.data(), 4, 4, 16}, {ids.data(), 8, 8, 20}};
+
+    std::vector<char> expected(cnt * stride);
+    for (size_t i = 0; i < cnt; ++i) {
+        size_t const sidx = (perm != nullptr) ? perm[i] : i;
+        ::memcpy(expected.data() + i * stride, pos.data() + sidx * 5, 16);
+        ::memcpy(expected.data() + i * stride + 16, col.data() + sidx * 4, 4);
+        ::memcpy(expected.data() + i * stride + 20, ids.data() + sidx, 8);
+    }
+
+    std::vector<char> gathered(cnt * stride);
+    GatherStreams(gathered.data(), stride, streams, perm, cnt);
+    return gathered == expected;
+}
+
+} // namespace
+
+
+void TestRadixSort(void) {
+    AssertTrue("Radix sort of no keys", sortsLikeStableSort(std::vector<uint64_t>()));
+    AssertTrue("Radix sort of one key", sortsLikeStableSort(std::vector<uint64_t>(1, 42)));
+    AssertTrue("Radix sort of equal keys", sortsLikeStableSort(std::vector<uint64_t>(manyKeys, 0x1234)));
+    AssertTrue("Radix sort of zero keys", sortsLikeStableSort(std::vector<uint64_t>(manyKeys, 0)));
+
+    std::vector<uint64_t> ascending(manyKeys);
+    std::iota(ascending.begin(), ascending.end(), 0);
+    AssertTrue("Radix sort of sorted keys", sortsLikeStableSort(ascending));
+    std::vector<uint64_t> descending(ascending.rbegin(), ascending.rend());
+    AssertTrue("Radix sort of reversed keys", sortsLikeStableSort(descending));
+
+    // unique IDs, as ParticleIdentitySort sorted them with std::sort before
+    std::vector<uint64_t> shuffled(ascending);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+    AssertTrue("Radix sort of shuffled IDs", sortsLikeStableSort(shuffled));
+
+    AssertTrue("Radix sort of few small keys", sortsLikeStableSort(randomKeys(1000, 8, 0, 0, 2)));
+    AssertTrue("Radix sort of many duplicates", sortsLikeStableSort(randomKeys(manyKeys, 4, 0, 0, 3)));
+    AssertTrue("Radix sort of 32-bit keys", sortsLikeStableSort(randomKeys(manyKeys, 32, 0, 0, 4)));
+    AssertTrue("Radix sort of 64-bit keys", sortsLikeStableSort(randomKeys(manyKeys, 64, 0, 0, 5)));
+    AssertTrue("Radix sort of keys in the top digits", sortsLikeStableSort(randomKeys(manyKeys, 12, 52, 0, 6)));
+    AssertTrue("Radix sort of keys sharing middle digits",
+        sortsLikeStableSort(randomKeys(manyKeys, 8, 0, (uint64_t(0xab) << 16) | (uint64_t(0xcd) << 24), 7)));
+    AssertTrue(
+        "Radix sort of keys sharing low digits", sortsLikeStableSort(randomKeys(manyKeys, 16, 16, 0x5a5a, 8)));
+
+    AssertTrue("IsSorted of no keys", IsSorted(std::vector<uint64_t>()));
+    AssertTrue("IsSorted of sorted keys", IsSorted(ascending));
+    AssertFalse("IsSorted of reversed keys", IsSorted(descending));
+    AssertTrue("IsSorted of equal keys", IsSorted(std::vector<uint64_t>(manyKeys, 7)));
+    // a single descent anywhere, including the boundaries of the blocks checked in parallel
+    for (size_t pos = 1; pos < manyKeys; pos += manyKeys / 97) {
+        std::vector<uint64_t> keys(ascending);
+        std::swap(keys[pos - 1], keys[pos]);
+        if (!AssertFalse("IsSorted finds a single descent", IsSorted(keys))) break;
+    }
+    for (size_t blocks = 2; blocks <= 16; ++blocks) {
+        for (size_t b = 1; b < blocks; ++b) {
+            std::vector<uint64_t> keys(ascending);
+            size_t const boundary = manyKeys * b / blocks;
+            std::swap(keys[boundary - 1], keys[boundary]);
+            AssertFalse("IsSorted finds a descent at a block boundary", IsSorted(keys));
+        }
+    }
+
+    std::vector<uint32_t> perm(manyKeys);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(9));
+    AssertTrue("GatherStreams through a permutation", gathersLikeSerialCopy(perm.data(), perm.size()));
+    AssertTrue("GatherStreams of a prefix", gathersLikeSerialCopy(nullptr, manyKeys / 3));
+    std::vector<uint32_t> repeated(1000, 17);
+    AssertTrue("GatherStreams of a repeated index", gathersLikeSerialCopy(repeated.data(), repeated.size()));
+    AssertTrue("GatherStreams of no records", gathersLikeSerialCopy(nullptr, 0));
+}
@@ -0,0 +1,16 @@
+/*
+ * testradixsort.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLSTEST_TESTRADIXSORT_H_INCLUDED
+#define MMSTD_DATATOOLSTEST_TESTRADIXSORT_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+void TestRadixSort(void);
+
+#endif /* MMSTD_DATATOOLSTEST_TESTRADIXSORT_H_INCLUDED */
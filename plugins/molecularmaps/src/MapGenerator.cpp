@@ -3042,34 +3042,49 @@ void MapGenerator::processTopologyOutput(std::vector<Cut>& p_cuts, uint& p_tunne
         }
     }
 
-#pragma omp parallel for
-    for (int i = 0; i < p_voronoi_vertices.size(); i++) {
-        // Initialise the ao value and the position of the voronoi vertex.
-        float ao_val = 0.0f;
-        vec3f origin = vec3f(static_cast<float>(p_voronoi_vertices[i].vertex.GetX()),
-            static_cast<float>(p_voronoi_vertices[i].vertex.GetY()),
-            static_cast<float>(p_voronoi_vertices[i].vertex.GetZ()));
-        for (size_t j = 0; j < ray_dirs.size(); j++) {
-            // Initialise the ray from the voronoi vertex and the current direction.
-            Ray ray = Ray(ray_dirs[j], origin);
-
-            // Intersect the Octree to find the first face we intersect and use one of it's vertex IDs.
-            uint face_id;
-            auto retval = voronoiOctree.IntersectOctree(this->faces_rebuild, ray, this->vertices_rebuild, face_id);
-            if (retval != -1) {
-                // There was an intersection with a face of the mesh, increase the AO sum and remember the face.
-                ao_val++;
-                voro_faces[i].push_back(face_id);
+    // Intersect the rays of a block of voronoi vertices with the Octree in one batch, the rays of
+    // one voronoi vertex are consecutive.
+    const size_t block_size = 4096;
+    std::vector<Ray> rays;
+    std::vector<int> hits;
+    std::vector<uint> hit_faces;
+    for (size_t block = 0; block < p_voronoi_vertices.size(); block += block_size) {
+        size_t block_end = std::min(block + block_size, p_voronoi_vertices.size());
+        rays.clear();
+        rays.reserve((block_end - block) * ray_dirs.size());
+        for (size_t i = block; i < block_end; i++) {
+            // Initialise the rays from the voronoi vertex and all directions.
+            vec3f origin = vec3f(static_cast<float>(p_voronoi_vertices[i].vertex.GetX()),
+                static_cast<float>(p_voronoi_vertices[i].vertex.GetY()),
+                static_cast<float>(p_voronoi_vertices[i].vertex.GetZ()));
+            for (size_t j = 0; j < ray_dirs.size(); j++) {
+                rays.emplace_back(ray_dirs[j], origin);
             }
         }
-        ao_val /= static_cast<float>(ray_dirs.size());
-
-        // Check if the voronoi vertex is on the surface.
-        if (ao_val > 0.9f) {
-            // The AO value is higher than the threshold so remember the voronoi vertex and set the visited flag
-            // of the ID to false.
-            potential_vertices.push_back(std::make_pair(i, p_voronoi_vertices[i]));
-            voronoi_tunnel[i] = true;
+
+        // Intersect the Octree to find the first face each ray intersects.
+        voronoiOctree.IntersectOctree(this->faces_rebuild, rays, this->vertices_rebuild, hits, hit_faces);
+
+        for (size_t i = block; i < block_end; i++) {
+            // Sum up the AO value and remember the faces.
+            float ao_val = 0.0f;
+            size_t first = (i - block) * ray_dirs.size();
+            for (size_t j = first; j < first + ray_dirs.size(); j++) {
+                if (hits[j] != -1) {
+                    // There was an intersection with a face of the mesh, increase the AO sum and remember the face.
+                    ao_val++;
+                    voro_faces[i].push_back(hit_faces[j]);
+                }
+            }
+            ao_val /= static_cast<float>(ray_dirs.size());
+
+            // Check if the voronoi vertex is on the surface.
+            if (ao_val > 0.9f) {
+                // The AO value is higher than the threshold so remember the voronoi vertex and set the visited flag
+                // of the ID to false.
+                potential_vertices.push_back(std::make_pair(i, p_voronoi_vertices[i]));
+                voronoi_tunnel[i] = true;
+            }
         }
     }
 #endif
@@ -3138,19 +3153,21 @@ void MapGenerator::processTopologyOutput(std::vector<Cut>& p_cuts, uint& p_tunne
     // Get the faces from the radius search in the Octree and add them to the faces from
     // the AO intersection tests.
     double epsilon = 0.275;
-#pragma omp parallel for
-    for (int i = 0; i < potential_vertices.size(); i++) {
+    std::vector<vec4d> query_spheres;
+    std::vector<std::vector<uint>> res;
+    query_spheres.reserve(potential_vertices.size());
+    for (size_t i = 0; i < potential_vertices.size(); i++) {
         // Initialise the query by adding an epsilon value to the radius of the voronoi vertex.
-        std::vector<uint> res;
         vec4d querySphere = potential_vertices[i].second.vertex;
         querySphere.SetW(querySphere.GetW() + epsilon);
+        query_spheres.push_back(querySphere);
+    }
 
-        // Get the faces from the Octree and add them to the faces from the AO intersections.
-        voronoiOctree.RadiusSearch(this->faces_rebuild, querySphere, this->vertices_rebuild, res);
-        for (size_t j = 0; j < res.size(); j++) {
-            uint face_id = res[j];
-            voro_faces[potential_vertices[i].first].push_back(face_id);
-        }
+    // Get the faces from the Octree and add them to the faces from the AO intersections.
+    voronoiOctree.RadiusSearch(this->faces_rebuild, query_spheres, this->vertices_rebuild, res);
+    for (size_t i = 0; i < potential_vertices.size(); i++) {
+        auto& faces = voro_faces[potential_vertices[i].first];
+        faces.insert(faces.end(), res[i].begin(), res[i].end());
     }
 
     // Create the groups based on the DFS. Add the faces from the voronoi vertices that belong
@@ -7,10 +7,104 @@
 #include "stdafx.h"
 #include "Octree.h"
 
+#include <numeric>
+#include <omp.h>
+
 using namespace megamol;
 using namespace megamol::molecularmaps;
 
 
+namespace {
+/** The number of rays that are traversed together through the Octree. */
+constexpr uint packet_size = 8;
+
+/** The rays of a packet in a structure of arrays layout. */
+struct RayPacket {
+    float origin[3][packet_size];
+    float dir[3][packet_size];
+    float inv_dir[3][packet_size];
+};
+
+/**
+ * Test which rays of the packet intersect the bounding box, like
+ * BoundingBox::RayIntersection.
+ *
+ * @param p_packet the rays
+ * @param p_bbox the bounding box
+ *
+ * @return the bit mask of the rays that intersect
+ */
+inline uint packetBoxIntersection(const RayPacket& p_packet, const BoundingBox& p_bbox) {
+    bool hit[packet_size];
+    for (uint l = 0; l < packet_size; l++) {
+        float t1 = (p_bbox.min.x - p_packet.origin[0][l]) * p_packet.inv_dir[0][l];
+        float t2 = (p_bbox.max.x - p_packet.origin[0][l]) * p_packet.inv_dir[0][l];
+        float t3 = (p_bbox.min.y - p_packet.origin[1][l]) * p_packet.inv_dir[1][l];
+        float t4 = (p_bbox.max.y - p_packet.origin[1][l]) * p_packet.inv_dir[1][l];
+        float t5 = (p_bbox.min.z - p_packet.origin[2][l]) * p_packet.inv_dir[2][l];
+        float t6 = (p_bbox.max.z - p_packet.origin[2][l]) * p_packet.inv_dir[2][l];
+
+        float tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+        float tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+
+        hit[l] = tmax > std::max(tmin, 0.0f);
+    }
+    uint mask = 0;
+    for (uint l = 0; l < packet_size; l++) {
+        mask |= static_cast<uint>(hit[l]) << l;
+    }
+    return mask;
+}
+
+/**
+ * Test which rays of the packet intersect the triangle, like
+ * Octree::rayTriangleIntersection.
+ *
+ * @param p_packet the rays
+ * @param p_v0 the first vertex of the triangle
+ * @param p_v1 the second vertex of the triangle
+ * @param p_v2 the third vertex of the triangle
+ *
+ * @return the bit mask of the rays that intersect
+ */
+inline uint packetTriangleIntersection(
+    const RayPacket& p_packet, const float* p_v0, const float* p_v1, const float* p_v2) {
+    const float e1[3] = {p_v1[0] - p_v0[0], p_v1[1] - p_v0[1], p_v1[2] - p_v0[2]};
+    const float e2[3] = {p_v2[0] - p_v0[0], p_v2[1] - p_v0[1], p_v2[2] - p_v0[2]};
+    bool hit[packet_size];
+    for (uint l = 0; l < packet_size; l++) {
+        const float dx = p_packet.dir[0][l];
+        const float dy = p_packet.dir[1][l];
+        const float dz = p_packet.dir[2][l];
+        const float rx = dy * e2[2] - dz * e2[1];
+        const float ry = dz * e2[0] - dx * e2[2];
+        const float rz = dx * e2[1] - dy * e2[0];
+        const float sx = p_packet.origin[0][l] - p_v0[0];
+        const float sy = p_packet.origin[1][l] - p_v0[1];
+        const float sz = p_packet.origin[2][l] - p_v0[2];
+        const float denom = e1[0] * rx + e1[1] * ry + e1[2] * rz;
+        const float f = 1.0f / denom;
+        const float qx = sy * e1[2] - sz * e1[1];
+        const float qy = sz * e1[0] - sx * e1[2];
+        const float qz = sx * e1[1] - sy * e1[0];
+        const float u = sx * rx + sy * ry + sz * rz;
+        const float v = dx * qx + dy * qy + dz * qz;
+        const float t = f * (e2[0] * qx + e2[1] * qy + e2[2] * qz);
+
+        const bool inside = (denom > 1e-5)
+                                ? (!(u < 0.0f) && !(u > denom) && !(v < 0.0f) && !((u + v) > denom))
+                                : (!(u > 0.0f) && !(u < denom) && !(v > 0.0f) && !((u + v) < denom));
+        hit[l] = !(std::abs(denom) < 1e-5) && inside && (t > 1e-5);
+    }
+    uint mask = 0;
+    for (uint l = 0; l < packet_size; l++) {
+        mask |= static_cast<uint>(hit[l]) << l;
+    }
+    return mask;
+}
+} // namespace
+
+
 /*
  * Octree::~Octree
  */
@@ -28,26 +122,13 @@ size_t Octree::ConvertToCUDAOctree(
     // Convert the Octree nodes.
     p_octree_nodes = std::vector<CudaOctreeNode>(this->cuda_node_cnt + 1);
     p_node_faces = std::vector<std::vector<uint>>(this->cuda_node_cnt + 1);
-    std::vector<const OctreeNode*> queue = std::vector<const OctreeNode*>(this->node_cnt);
-    size_t queue_idx = 0;
-    queue[queue_idx++] = &this->root;
 
-    // Get every node on the tree and copy it to the CUDA representation.
-    while (queue_idx != 0) {
-        // Get the current node.
-        auto curr = queue[--queue_idx];
-
-        // Create the node in CUDA representation.
-        p_octree_nodes[curr->cuda_idx] = CudaOctreeNode(CudaBoundingBox(curr->bounding_box.max, curr->bounding_box.min),
-            static_cast<uint>(curr->children.size()), static_cast<uint>(curr->faces.size()));
-
-        // Add the faces to the node.
-        p_node_faces[curr->cuda_idx] = curr->faces;
-
-        // Add the children of the current node to the queue.
-        for (const auto& node : curr->children) {
-            queue[queue_idx++] = &node;
-        }
+    // Copy every node of the tree to the CUDA representation.
+    for (const auto& node : this->nodes) {
+        p_octree_nodes[node.cuda_idx] = CudaOctreeNode(
+            CudaBoundingBox(node.bounding_box.max, node.bounding_box.min), node.child_cnt, node.face_cnt);
+        p_node_faces[node.cuda_idx].assign(this->node_faces.begin() + node.first_face,
+            this->node_faces.begin() + node.first_face + node.face_cnt);
     }
 
     // Return the number of nodes in the Octree.
@@ -59,110 +140,118 @@ size_t Octree::ConvertToCUDAOctree(
  * Octree::createFaceBoundingBoxes
  */
 void Octree::createFaceBoundingBoxes(const std::vector<uint>& p_faces, const std::vector<float>& p_vertices) {
-    uint3 face_idxs;
-    size_t size;
-    std::vector<float3> vertices;
-
     // Initialise the bounding boxes.
-    size = p_faces.size() / 3;
-    this->face_bboxs.erase(this->face_bboxs.begin(), this->face_bboxs.end());
-    this->face_bboxs.clear();
-    this->face_bboxs.reserve(size);
+    int size = static_cast<int>(p_faces.size() / 3);
+    this->face_bboxs = std::vector<BoundingBox>(size);
 
     // Get the vertices of each face an determine the bounding box of these vertices.
-    vertices = std::vector<float3>(3);
-    for (size_t i = 0; i < size; i++) {
-        face_idxs = make_uint3(p_faces[i * 3], p_faces[i * 3 + 1], p_faces[i * 3 + 2]);
-        vertices[0] =
-            make_float3(p_vertices[face_idxs.x * 3], p_vertices[face_idxs.x * 3 + 1], p_vertices[face_idxs.x * 3 + 2]);
-        vertices[1] =
-            make_float3(p_vertices[face_idxs.y * 3], p_vertices[face_idxs.y * 3 + 1], p_vertices[face_idxs.y * 3 + 2]);
-        vertices[2] =
-            make_float3(p_vertices[face_idxs.z * 3], p_vertices[face_idxs.z * 3 + 1], p_vertices[face_idxs.z * 3 + 2]);
-        this->face_bboxs.push_back(BoundingBox(vertices));
+#pragma omp parallel
+    {
+        std::vector<float3> vertices = std::vector<float3>(3);
+#pragma omp for
+        for (int i = 0; i < size; i++) {
+            uint3 face_idxs = make_uint3(p_faces[i * 3], p_faces[i * 3 + 1], p_faces[i * 3 + 2]);
+            vertices[0] = make_float3(
+                p_vertices[face_idxs.x * 3], p_vertices[face_idxs.x * 3 + 1], p_vertices[face_idxs.x * 3 + 2]);
+            vertices[1] = make_float3(
+                p_vertices[face_idxs.y * 3], p_vertices[face_idxs.y * 3 + 1], p_vertices[face_idxs.y * 3 + 2]);
+            vertices[2] = make_float3(
+                p_vertices[face_idxs.z * 3], p_vertices[face_idxs.z * 3 + 1], p_vertices[face_idxs.z * 3 + 2]);
+            this->face_bboxs[i] = BoundingBox(vertices);
+        }
     }
-    this->face_bboxs.shrink_to_fit();
 }
 
 
 /*
  * Octree::createOctree
  */
-void Octree::createOctree(const float3& p_min_dim, OctreeNode& p_node) {
-    float3 center, dim, half, max, min, zero;
-    std::vector<BoundingBox> octant;
-    std::vector<std::vector<uint>> node_faces;
-    std::vector<bool> to_delete;
-    size_t idx;
-
-    // Increase the cuda node count.
-    if (p_node.cuda_idx > this->cuda_node_cnt) {
-        this->cuda_node_cnt = p_node.cuda_idx;
-    }
-
-    // If the node does not contain more than one face it is a leaf.
-    if (p_node.faces.size() <= 1) {
-        return;
-    }
-
-    // Determine the bounding box of the current node.
-    zero.x = 0.0f;
-    zero.y = 0.0f;
-    zero.z = 0.0f;
-
-    max = p_node.bounding_box.max;
-    min = p_node.bounding_box.min;
-    dim = max - min;
-    // The bounding box of the node is too small, therefor the node is a leaf.
-    if (dim.x == zero.x && dim.y == zero.y && dim.z == zero.z) {
-        return;
-    }
-    if (dim.x <= p_min_dim.x && dim.y <= p_min_dim.y && dim.z <= p_min_dim.z) {
-        return;
-    }
+void Octree::createOctree(const float3& p_min_dim, const BoundingBox& p_bounding_box, size_t p_face_cnt) {
+    // Initialise the root node, it contains all faces.
+    Node root;
+    root.bounding_box = p_bounding_box;
+    root.cuda_idx = 0;
+    root.first_child = 0;
+    root.child_cnt = 0;
+    root.first_face = 0;
+    root.face_cnt = 0;
+    this->nodes.clear();
+    this->nodes.push_back(root);
+    this->node_faces.clear();
+    this->node_faces.reserve(p_face_cnt);
+    this->max_depth = 0;
+
+    // The faces of the nodes on the current level that are not yet distributed.
+    std::vector<std::vector<uint>> level_faces = std::vector<std::vector<uint>>(1);
+    level_faces[0].resize(p_face_cnt);
+    std::iota(level_faces[0].begin(), level_faces[0].end(), 0);
+
+    size_t level_begin = 0;
+    while (level_begin < this->nodes.size()) {
+        size_t level_end = this->nodes.size();
+        int level_cnt = static_cast<int>(level_end - level_begin);
+        std::vector<std::array<BoundingBox, 8>> octants = std::vector<std::array<BoundingBox, 8>>(level_cnt);
+        std::vector<std::array<std::vector<uint>, 8>> octant_faces =
+            std::vector<std::array<std::vector<uint>, 8>>(level_cnt);
+        std::vector<char> split = std::vector<char>(level_cnt, 0);
+
+        // Split the nodes of the level. The upper levels have fewer nodes than threads, so their
+        // faces are distributed in parallel instead.
+        if (level_cnt < omp_get_max_threads()) {
+            for (int i = 0; i < level_cnt; i++) {
+                split[i] = this->splitNode(p_min_dim, this->nodes[level_begin + i].bounding_box, level_faces[i],
+                    octants[i], octant_faces[i], true);
+            }
+        } else {
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int i = 0; i < level_cnt; i++) {
+                split[i] = this->splitNode(p_min_dim, this->nodes[level_begin + i].bounding_box, level_faces[i],
+                    octants[i], octant_faces[i], false);
+            }
+        }
 
-    // Create new bounding boxes for each child node.
-    half = dim / 2.0f;
-    center = min + half;
-    octant = std::vector<BoundingBox>(8);
-    octant[0] = BoundingBox(center, min);
-    octant[1] = BoundingBox(make_float3(max.x, center.y, center.z), make_float3(center.x, min.y, min.z));
-    octant[2] = BoundingBox(make_float3(max.x, center.y, max.z), make_float3(center.x, min.y, center.z));
-    octant[3] = BoundingBox(make_float3(center.x, center.y, max.z), make_float3(min.x, min.y, center.z));
-    octant[4] = BoundingBox(make_float3(center.x, max.y, center.z), make_float3(min.x, center.y, min.z));
-    octant[5] = BoundingBox(make_float3(max.x, max.y, center.z), make_float3(center.x, center.y, min.z));
-    octant[6] = BoundingBox(max, center);
-    octant[7] = BoundingBox(make_float3(center.x, max.y, max.z), make_float3(min.x, center.y, center.z));
-
-    // Add the faces to the correct child node.
-    node_faces = std::vector<std::vector<uint>>(8);
-    for (uint i = 0; i < 8; i++) {
-        node_faces[i].reserve(p_node.faces.size());
-    }
-    to_delete = std::vector<bool>(p_node.faces.size() + 1, false);
-
-    idx = 0;
-    for (const auto face : p_node.faces) {
-        for (size_t i = 0; i < octant.size(); i++) {
-            if (this->face_bboxs[face].IsContained(octant[i])) {
-                node_faces[i].push_back(face);
-                to_delete[idx] = true;
-                break;
+        // Store the faces that stay in the nodes and add the children as the next level.
+        std::vector<std::vector<uint>> next_faces;
+        for (int i = 0; i < level_cnt; i++) {
+            size_t node_idx = level_begin + i;
+            this->nodes[node_idx].first_face = static_cast<uint>(this->node_faces.size());
+            this->nodes[node_idx].face_cnt = static_cast<uint>(level_faces[i].size());
+            this->node_faces.insert(this->node_faces.end(), level_faces[i].begin(), level_faces[i].end());
+            level_faces[i].clear();
+            level_faces[i].shrink_to_fit();
+
+            if (split[i]) {
+                this->nodes[node_idx].first_child = static_cast<uint>(this->nodes.size());
+                this->nodes[node_idx].child_cnt = 8;
+                for (uint c = 0; c < 8; c++) {
+                    Node child;
+                    child.bounding_box = octants[i][c];
+                    child.cuda_idx = (this->nodes[node_idx].cuda_idx * 8) + (c + 1);
+                    child.first_child = 0;
+                    child.child_cnt = 0;
+                    child.first_face = 0;
+                    child.face_cnt = 0;
+                    this->nodes.push_back(child);
+                    next_faces.push_back(std::move(octant_faces[i][c]));
+                }
             }
         }
-        idx++;
-    }
 
-    // Remove the faces from the current node.
-    p_node.RemoveFaces(to_delete);
+        level_faces = std::move(next_faces);
+        level_begin = level_end;
+        if (level_begin < this->nodes.size()) {
+            this->max_depth++;
+        }
+    }
+    this->nodes.shrink_to_fit();
 
-    // Add the new node as a child to the current node.
-    OctreeNode new_node;
-    for (uint i = 0; i < 8; i++) {
-        new_node = OctreeNode(octant[i], (p_node.cuda_idx * 8) + (i + 1), node_faces[i]);
-        p_node.children.push_back(new_node);
-        this->node_cnt++;
-        createOctree(p_min_dim, p_node.children[i]);
+    // Get the number of nodes.
+    this->node_cnt = this->nodes.size();
+    this->cuda_node_cnt = 1;
+    for (const auto& node : this->nodes) {
+        if (node.cuda_idx > this->cuda_node_cnt) {
+            this->cuda_node_cnt = node.cuda_idx;
+        }
     }
 }
 
@@ -172,16 +261,11 @@ void Octree::createOctree(const float3& p_min_dim, OctreeNode& p_node) {
  */
 void Octree::CreateOctreeRootNode(const std::vector<uint>& p_faces, const float3& p_max, const float3& p_min,
     const float3& p_min_dim, const std::vector<float>& p_vertices) {
-    // Create the root node, it contains all faces.
-    this->root = OctreeNode(BoundingBox(p_max, p_min), 0, p_faces.size() / 3);
-
     // Compute the bounding boxes for all faces of the surface.
     createFaceBoundingBoxes(p_faces, p_vertices);
 
     // Compute the full Octree.
-    this->node_cnt = 1;
-    this->cuda_node_cnt = 1;
-    createOctree(p_min_dim, this->root);
+    createOctree(p_min_dim, BoundingBox(p_max, p_min), p_faces.size() / 3);
 }
 
 
@@ -189,22 +273,26 @@ void Octree::CreateOctreeRootNode(const std::vector<uint>& p_faces, const float3
  * Octree::IntersectOctree
  */
 int Octree::IntersectOctree(const std::vector<uint>& p_faces, const Ray& p_ray, const std::vector<float>& p_vertices) {
-    // Initialise the queue for the intersection tests.
+    if (this->nodes.empty()) return -1;
+
+    // Initialise the stack for the intersection tests.
     vec3ui face_idxs;
-    std::vector<const OctreeNode*> queue = std::vector<const OctreeNode*>(this->node_cnt);
+    std::vector<uint> stack;
     std::vector<vec3f> vertices;
-    size_t queue_idx = 0;
 
-    // Add the root to the queue.
-    queue[queue_idx++] = &this->root;
+    // Add the root to the stack.
+    stack.reserve(7 * this->max_depth + 1);
+    stack.push_back(0);
     vertices = std::vector<vec3f>(3);
 
-    // Get the current Octree node from the queue and test for intersections.
-    while (queue_idx != 0) {
-        auto curr = queue[--queue_idx];
+    // Get the current Octree node from the stack and test for intersections.
+    while (!stack.empty()) {
+        const Node& curr = this->nodes[stack.back()];
+        stack.pop_back();
 
         // Check all faces that belong to the current node.
-        for (const auto face : curr->faces) {
+        for (uint f = curr.first_face; f < curr.first_face + curr.face_cnt; f++) {
+            uint face = this->node_faces[f];
             face_idxs = vec3ui(p_faces[face * 3], p_faces[face * 3 + 1], p_faces[face * 3 + 2]);
             vertices[0] = vec3f(p_vertices[face_idxs.GetX() * 3], p_vertices[face_idxs.GetX() * 3 + 1],
                 p_vertices[face_idxs.GetX() * 3 + 2]);
@@ -218,10 +306,10 @@ int Octree::IntersectOctree(const std::vector<uint>& p_faces, const Ray& p_ray,
             }
         }
 
-        // Add all children of the current node to the queue if the ray intersects their bounding box.
-        for (const auto& node : curr->children) {
-            if (node.bounding_box.RayIntersection(p_ray)) {
-                queue[queue_idx++] = &node;
+        // Add all children of the current node to the stack if the ray intersects their bounding box.
+        for (uint c = curr.first_child; c < curr.first_child + curr.child_cnt; c++) {
+            if (this->nodes[c].bounding_box.RayIntersection(p_ray)) {
+                stack.push_back(c);
             }
         }
     }
@@ -236,24 +324,28 @@ int Octree::IntersectOctree(const std::vector<uint>& p_faces, const Ray& p_ray,
  */
 int Octree::IntersectOctree(
     const std::vector<uint>& p_faces, const Ray& p_ray, const std::vector<float>& p_vertices, uint& p_face_id) {
-    // Initialise the queue for the intersection tests.
+    if (this->nodes.empty()) return -1;
+
+    // Initialise the stack for the intersection tests.
     vec3ui face_idxs;
-    std::vector<const OctreeNode*> queue = std::vector<const OctreeNode*>(this->node_cnt);
+    std::vector<uint> stack;
     std::vector<vec3f> vertices;
-    size_t queue_idx = 0;
     int retval = -1;
     float min_dist = std::numeric_limits<float>::max();
 
-    // Add the root to the queue.
-    queue[queue_idx++] = &this->root;
+    // Add the root to the stack.
+    stack.reserve(7 * this->max_depth + 1);
+    stack.push_back(0);
     vertices = std::vector<vec3f>(3);
 
-    // Get the current Octree node from the queue and test for intersections.
-    while (queue_idx != 0) {
-        auto curr = queue[--queue_idx];
+    // Get the current Octree node from the stack and test for intersections.
+    while (!stack.empty()) {
+        const Node& curr = this->nodes[stack.back()];
+        stack.pop_back();
 
         // Check all faces that belong to the current node.
-        for (const auto face : curr->faces) {
+        for (uint f = curr.first_face; f < curr.first_face + curr.face_cnt; f++) {
+            uint face = this->node_faces[f];
             face_idxs = vec3ui(p_faces[face * 3], p_faces[face * 3 + 1], p_faces[face * 3 + 2]);
             vertices[0] = vec3f(p_vertices[face_idxs.GetX() * 3], p_vertices[face_idxs.GetX() * 3 + 1],
                 p_vertices[face_idxs.GetX() * 3 + 2]);
@@ -276,10 +368,10 @@ int Octree::IntersectOctree(
             }
         }
 
-        // Add all children of the current node to the queue if the ray intersects their bounding box.
-        for (const auto& node : curr->children) {
-            if (node.bounding_box.RayIntersection(p_ray)) {
-                queue[queue_idx++] = &node;
+        // Add all children of the current node to the stack if the ray intersects their bounding box.
+        for (uint c = curr.first_child; c < curr.first_child + curr.child_cnt; c++) {
+            if (this->nodes[c].bounding_box.RayIntersection(p_ray)) {
+                stack.push_back(c);
             }
         }
     }
@@ -289,36 +381,142 @@ int Octree::IntersectOctree(
 }
 
 
+/*
+ * Octree::IntersectOctree
+ */
+void Octree::IntersectOctree(const std::vector<uint>& p_faces, const std::vector<Ray>& p_rays,
+    const std::vector<float>& p_vertices, std::vector<int>& p_results, std::vector<uint>& p_face_ids) {
+    p_results = std::vector<int>(p_rays.size(), -1);
+    p_face_ids.resize(p_rays.size());
+    if (this->nodes.empty()) return;
+
+    int packet_cnt = static_cast<int>((p_rays.size() + packet_size - 1) / packet_size);
+#pragma omp parallel
+    {
+        // Every stack entry holds a node and the mask of the rays that intersect its bounding box.
+        std::vector<std::pair<uint, uint>> stack;
+        stack.reserve(7 * this->max_depth + 1);
+
+#pragma omp for schedule(dynamic, 1)
+        for (int p = 0; p < packet_cnt; p++) {
+            // Fill the packet, unused lanes repeat the last ray and are masked out.
+            size_t first = static_cast<size_t>(p) * packet_size;
+            uint lane_cnt = static_cast<uint>(std::min<size_t>(packet_size, p_rays.size() - first));
+            RayPacket packet;
+            for (uint l = 0; l < packet_size; l++) {
+                const Ray& ray = p_rays[first + std::min(l, lane_cnt - 1)];
+                for (uint d = 0; d < 3; d++) {
+                    packet.origin[d][l] = ray.origin[d];
+                    packet.dir[d][l] = ray.dir[d];
+                    packet.inv_dir[d][l] = ray.inv_dir[d];
+                }
+            }
+            float min_dist[packet_size];
+            std::fill(min_dist, min_dist + packet_size, std::numeric_limits<float>::max());
+
+            // Traverse the Octree with all rays, every ray visits its nodes in the same order as a single ray.
+            stack.clear();
+            stack.emplace_back(0, (1u << lane_cnt) - 1);
+            while (!stack.empty()) {
+                const Node& curr = this->nodes[stack.back().first];
+                uint mask = stack.back().second;
+                stack.pop_back();
+
+                // Check all faces that belong to the current node.
+                for (uint f = curr.first_face; f < curr.first_face + curr.face_cnt; f++) {
+                    uint face = this->node_faces[f];
+                    const float* v0 = &p_vertices[p_faces[face * 3] * 3];
+                    const float* v1 = &p_vertices[p_faces[face * 3 + 1] * 3];
+                    const float* v2 = &p_vertices[p_faces[face * 3 + 2] * 3];
+                    uint hits = packetTriangleIntersection(packet, v0, v1, v2) & mask;
+                    for (uint l = 0; hits != 0; l++, hits >>= 1) {
+                        if ((hits & 1) == 0) continue;
+                        float x = v0[0] - packet.origin[0][l];
+                        float y = v0[1] - packet.origin[1][l];
+                        float z = v0[2] - packet.origin[2][l];
+                        float dist = x * x + y * y + z * z;
+                        if (dist < min_dist[l]) {
+                            min_dist[l] = dist;
+                            p_face_ids[first + l] = face;
+                            p_results[first + l] = static_cast<int>(p_faces[face * 3]);
+                        }
+                    }
+                }
+
+                // Add all children that are intersected by at least one of the rays.
+                for (uint c = curr.first_child; c < curr.first_child + curr.child_cnt; c++) {
+                    uint child_mask = mask & packetBoxIntersection(packet, this->nodes[c].bounding_box);
+                    if (child_mask != 0) {
+                        stack.emplace_back(c, child_mask);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 /*
  * Octree::Octree
  */
-Octree::Octree() {
+Octree::Octree() : cuda_node_cnt(0), node_cnt(0), max_depth(0) {
     this->face_bboxs = std::vector<BoundingBox>(0);
-    this->root = OctreeNode();
 }
 
+
 /*
  * Octree::RadiusSearch
  */
 bool Octree::RadiusSearch(const std::vector<uint>& p_faces, const vec4d& p_querySphere,
     const std::vector<float>& p_vertices, std::vector<uint>& p_resultFaceIndices) {
-    // Initialise the queue for the intersection tests.
+    std::vector<uint> stack;
+    this->radiusSearch(p_faces, p_querySphere, p_vertices, p_resultFaceIndices, stack);
+    return (p_resultFaceIndices.size() > 0);
+}
+
+
+/*
+ * Octree::RadiusSearch
+ */
+void Octree::RadiusSearch(const std::vector<uint>& p_faces, const std::vector<vec4d>& p_querySpheres,
+    const std::vector<float>& p_vertices, std::vector<std::vector<uint>>& p_resultFaceIndices) {
+    p_resultFaceIndices.resize(p_querySpheres.size());
+    int query_cnt = static_cast<int>(p_querySpheres.size());
+#pragma omp parallel
+    {
+        std::vector<uint> stack;
+#pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < query_cnt; i++) {
+            this->radiusSearch(p_faces, p_querySpheres[i], p_vertices, p_resultFaceIndices[i], stack);
+        }
+    }
+}
+
+
+/*
+ * Octree::radiusSearch
+ */
+void Octree::radiusSearch(const std::vector<uint>& p_faces, const vec4d& p_querySphere,
+    const std::vector<float>& p_vertices, std::vector<uint>& p_resultFaceIndices, std::vector<uint>& p_stack) {
+    // Initialise the stack for the intersection tests.
     vec3ui face_idxs;
-    std::vector<const OctreeNode*> queue = std::vector<const OctreeNode*>(this->node_cnt);
     std::vector<vec3f> vertices;
-    size_t queue_idx = 0;
 
-    // TODO check memory allocation to speed this up
     p_resultFaceIndices.clear();
+    if (this->nodes.empty()) return;
 
-    queue[queue_idx++] = &this->root;
+    p_stack.clear();
+    p_stack.reserve(7 * this->max_depth + 1);
+    p_stack.push_back(0);
     vertices = std::vector<vec3f>(3);
 
-    while (queue_idx != 0) {
-        auto curr = queue[--queue_idx];
+    while (!p_stack.empty()) {
+        const Node& curr = this->nodes[p_stack.back()];
+        p_stack.pop_back();
 
         // Check all faces that belong to the current node.
-        for (const auto face : curr->faces) {
+        for (uint f = curr.first_face; f < curr.first_face + curr.face_cnt; f++) {
+            uint face = this->node_faces[f];
             face_idxs = vec3ui(p_faces[face * 3], p_faces[face * 3 + 1], p_faces[face * 3 + 2]);
             vertices[0] = vec3f(p_vertices[face_idxs.GetX() * 3], p_vertices[face_idxs.GetX() * 3 + 1],
                 p_vertices[face_idxs.GetX() * 3 + 2]);
@@ -331,15 +529,13 @@ bool Octree::RadiusSearch(const std::vector<uint>& p_faces, const vec4d& p_query
                 p_resultFaceIndices.push_back(face);
             }
         }
-        // Add all children of the current node to the queue if the sphere intersects their bounding box.
-        for (const auto& node : curr->children) {
-            if (node.bounding_box.SphereIntersection(p_querySphere)) {
-                queue[queue_idx++] = &node;
+        // Add all children of the current node to the stack if the sphere intersects their bounding box.
+        for (uint c = curr.first_child; c < curr.first_child + curr.child_cnt; c++) {
+            if (this->nodes[c].bounding_box.SphereIntersection(p_querySphere)) {
+                p_stack.push_back(c);
             }
         }
     }
-
-    return (p_resultFaceIndices.size() > 0);
 }
 
 
@@ -396,3 +592,73 @@ bool Octree::sphereTriangleIntersection(const vec4d& p_sphere, const std::vector
     }
     return false;
 }
+
+
+/*
+ * Octree::splitNode
+ */
+bool Octree::splitNode(const float3& p_min_dim, const BoundingBox& p_bounding_box, std::vector<uint>& p_faces,
+    std::array<BoundingBox, 8>& p_octants, std::array<std::vector<uint>, 8>& p_octant_faces, bool p_parallel) {
+    float3 center, dim, half, max, min, zero;
+
+    // If the node does not contain more than one face it is a leaf.
+    if (p_faces.size() <= 1) {
+        return false;
+    }
+
+    // Determine the bounding box of the current node.
+    zero.x = 0.0f;
+    zero.y = 0.0f;
+    zero.z = 0.0f;
+
+    max = p_bounding_box.max;
+    min = p_bounding_box.min;
+    dim = max - min;
+    // The bounding box of the node is too small, therefor the node is a leaf.
+    if (dim.x == zero.x && dim.y == zero.y && dim.z == zero.z) {
+        return false;
+    }
+    if (dim.x <= p_min_dim.x && dim.y <= p_min_dim.y && dim.z <= p_min_dim.z) {
+        return false;
+    }
+
+    // Create new bounding boxes for each child node.
+    half = dim / 2.0f;
+    center = min + half;
+    p_octants[0] = BoundingBox(center, min);
+    p_octants[1] = BoundingBox(make_float3(max.x, center.y, center.z), make_float3(center.x, min.y, min.z));
+    p_octants[2] = BoundingBox(make_float3(max.x, center.y, max.z), make_float3(center.x, min.y, center.z));
+    p_octants[3] = BoundingBox(make_float3(center.x, center.y, max.z), make_float3(min.x, min.y, center.z));
+    p_octants[4] = BoundingBox(make_float3(center.x, max.y, center.z), make_float3(min.x, center.y, min.z));
+    p_octants[5] = BoundingBox(make_float3(max.x, max.y, center.z), make_float3(center.x, center.y, min.z));
+    p_octants[6] = BoundingBox(max, center);
+    p_octants[7] = BoundingBox(make_float3(center.x, max.y, max.z), make_float3(min.x, center.y, center.z));
+
+    // Find the first octant that contains each face, 8 if there is none.
+    int face_cnt = static_cast<int>(p_faces.size());
+    std::vector<unsigned char> octant_ids = std::vector<unsigned char>(face_cnt);
+#pragma omp parallel for if (p_parallel)
+    for (int i = 0; i < face_cnt; i++) {
+        unsigned char id = 8;
+        for (unsigned char o = 0; o < 8; o++) {
+            if (this->face_bboxs[p_faces[i]].IsContained(p_octants[o])) {
+                id = o;
+                break;
+            }
+        }
+        octant_ids[i] = id;
+    }
+
+    // Move the faces to the octants, keeping their order.
+    size_t last = 0;
+    for (int i = 0; i < face_cnt; i++) {
+        if (octant_ids[i] < 8) {
+            p_octant_faces[octant_ids[i]].push_back(p_faces[i]);
+        } else {
+            p_faces[last++] = p_faces[i];
+        }
+    }
+    p_faces.resize(last);
+
+    return true;
+}
@@ -78,6 +78,22 @@ namespace molecularmaps {
         int IntersectOctree(
             const std::vector<uint>& p_faces, const Ray& p_ray, const std::vector<float>& p_vertices, uint& p_face_id);
 
+        /**
+         * Find the faces that are hitten by the given rays. The rays are traversed
+         * in packets through the Octree, every ray gets the same result as the single
+         * ray version that finds the closest intersection.
+         *
+         * @param p_faces the faces of the surface
+         * @param p_rays the rays with an origin and direction
+         * @param p_vertices the vertices of the surface
+         * @param p_results will contain the vertex ID of the closest intersection for
+         * every ray, or -1 if no intersection was found
+         * @param p_face_ids will contain the face that is intersected for every ray
+         * that found an intersection
+         */
+        void IntersectOctree(const std::vector<uint>& p_faces, const std::vector<Ray>& p_rays,
+            const std::vector<float>& p_vertices, std::vector<int>& p_results, std::vector<uint>& p_face_ids);
+
         /**
          * Initialises an empty instance.
          */
@@ -98,7 +114,44 @@ namespace molecularmaps {
         bool RadiusSearch(const std::vector<uint>& p_faces, const vec4d& p_querySphere,
             const std::vector<float>& p_vertices, std::vector<uint>& p_resultFaceIndices);
 
+        /**
+         * Find all faces that that lie in or intersect the given spheres. The
+         * queries are answered in parallel.
+         *
+         * @param p_faces The faces of the surface
+         * @param p_querySpheres The spheres which radius and position are used for the queries
+         * @param p_vertices The vertices of the surface
+         * @param p_resultFaceIndices Will contain the indices of the found faces for every sphere
+         */
+        void RadiusSearch(const std::vector<uint>& p_faces, const std::vector<vec4d>& p_querySpheres,
+            const std::vector<float>& p_vertices, std::vector<std::vector<uint>>& p_resultFaceIndices);
+
     private:
+        /**
+         * A node of the flattened Octree. The children of a node are stored next to
+         * each other, the faces of a node are a range in the face list of the Octree.
+         */
+        struct Node {
+            /** The bounding box of the node. */
+            BoundingBox bounding_box;
+
+            /** The index of the node in the CUDA vector. */
+            uint cuda_idx;
+
+            /** The index of the first child node. */
+            uint first_child;
+
+            /** The number of child nodes, either zero or eight. */
+            uint child_cnt;
+
+            /** The index of the first face in the face list. */
+            uint first_face;
+
+            /** The number of faces that belong to the node. */
+            uint face_cnt;
+        };
+
+
         /**
          * Create the bounding boxes for each face.
          *
@@ -108,14 +161,44 @@ namespace molecularmaps {
         void createFaceBoundingBoxes(const std::vector<uint>& p_faces, const std::vector<float>& p_vertices);
 
         /**
-         * Create the Octree based on the faces of the new surface.
+         * Create the Octree based on the faces of the new surface. The Octree is
+         * built level by level, the nodes of a level are split in parallel.
          *
          * @param p_min_dim the minimum dimension of the bounding box, if the
          * bounding box of a node is smaller it is a leaf node
-         * @param p_cuda_node the current node in the Octree in the CUDA format
-         * @param p_node the current node in the Octree
+         * @param p_bounding_box the bounding box of the root node
+         * @param p_face_cnt the number of faces of the surface
+         */
+        void createOctree(const float3& p_min_dim, const BoundingBox& p_bounding_box, size_t p_face_cnt);
+
+        /**
+         * Find the faces that lie in or intersect the given sphere.
+         *
+         * @param p_faces The faces of the surface
+         * @param p_querySphere The sphere which radius and position are used for the query
+         * @param p_vertices The vertices of the surface
+         * @param p_resultFaceIndices Vector containing the indices of the found faces
+         * @param p_stack The traversal stack, can be reused between queries
          */
-        void createOctree(const float3& p_min_dim, OctreeNode& p_node);
+        void radiusSearch(const std::vector<uint>& p_faces, const vec4d& p_querySphere,
+            const std::vector<float>& p_vertices, std::vector<uint>& p_resultFaceIndices, std::vector<uint>& p_stack);
+
+        /**
+         * Split a node into its eight octants, unless it is a leaf. Every face that
+         * is contained in an octant is moved to the face list of the first such
+         * octant, the other faces stay in the node.
+         *
+         * @param p_min_dim the minimum dimension of the bounding box
+         * @param p_bounding_box the bounding box of the node
+         * @param p_faces the faces of the node, will contain the faces that stay
+         * @param p_octants will contain the bounding boxes of the octants
+         * @param p_octant_faces will contain the faces of the octants
+         * @param p_parallel distribute the faces in parallel
+         *
+         * @return true if the node was split, false if it is a leaf
+         */
+        bool splitNode(const float3& p_min_dim, const BoundingBox& p_bounding_box, std::vector<uint>& p_faces,
+            std::array<BoundingBox, 8>& p_octants, std::array<std::vector<uint>, 8>& p_octant_faces, bool p_parallel);
 
         /**
          * Check if the ray intersects the triangle based on the vertices.
@@ -146,8 +229,14 @@ namespace molecularmaps {
         /** The number of nodes in the Octree. */
         size_t node_cnt;
 
-        /** The root node of the Octree. */
-        OctreeNode root;
+        /** The number of levels below the root node. */
+        size_t max_depth;
+
+        /** The nodes of the Octree level by level, the root node comes first. */
+        std::vector<Node> nodes;
+
+        /** The faces of all nodes, the faces of a node are stored next to each other. */
+        std::vector<uint> node_faces;
     };
 
 } /* end namespace molecularmaps */
@@ -7,6 +7,8 @@
 #include "stdafx.h"
 #include "VoronoiChannelCalculator.h"
 
+#include <unordered_map>
+
 using namespace megamol::core;
 using namespace megamol::molecularmaps;
 using namespace megamol::protein_calls;
@@ -28,11 +30,10 @@ VoronoiChannelCalculator::VoronoiChannelCalculator(void) : AbstractLocalRenderer
  * VoronoiChannelCalculator::checkVertexValidity
  */
 void VoronoiChannelCalculator::checkVertexAndGateValidity(MolecularDataCall* mdc) {
-    // Initialise the valid vertices flag to be valid for all vertices.
-    this->gateValidFlags.resize(this->voronoi_edges.size(), true);
-    this->gateValidFlags.assign(gateValidFlags.size(), true);
-    this->vertexValidFlags.resize(this->voronoi_vertices.size(), true);
-    this->vertexValidFlags.assign(vertexValidFlags.size(), true);
+    // Initialise the valid vertices flag to be valid for all vertices. The flags are written by several threads,
+    // so they are stored as bytes.
+    this->gateValidFlags.assign(this->voronoi_edges.size(), true);
+    this->vertexValidFlags.assign(this->voronoi_vertices.size(), true);
     size_t filtered_inf_vertices = 0, filtered_radius_vertices = 0, filtered_convex_hull_vertices = 0, i = 0;
     std::vector<std::pair<size_t, vec4d>> valid_vertices;
     valid_vertices.reserve(this->voronoi_vertices.size());
@@ -62,20 +63,6 @@ void VoronoiChannelCalculator::checkVertexAndGateValidity(MolecularDataCall* mdc
     // megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO, "Filtered %d
     // voronoi infinity vertices", filtered_inf_vertices);
 
-    // Initialise the threads to test if the vertices are inside or outside of the convex hull.
-    size_t core_num = Concurrency::details::_CurrentScheduler::_GetNumberOfVirtualProcessors();
-    size_t items_per_thread = std::max(static_cast<size_t>(1), valid_vertices.size() / core_num);
-    this->stopThreads();
-
-    // If the last thread has less than items_per_thread vertices to process, we need more than core_num threads in
-    // total.
-    if (valid_vertices.size() % core_num == 0) {
-        this->voronoi_threads = std::vector<std::thread>(core_num);
-
-    } else {
-        this->voronoi_threads = std::vector<std::thread>(core_num + 1);
-    }
-
     // Convert the atoms to a vec3f representation.
     std::vector<vec3f> atomData(mdc->AtomCount());
     auto ptr = mdc->AtomPositions();
@@ -86,32 +73,16 @@ void VoronoiChannelCalculator::checkVertexAndGateValidity(MolecularDataCall* mdc
 #define CONVEX_HULL_FILTERING
 #ifdef CONVEX_HULL_FILTERING
     // Check for all vertices that are still valid if they lie inside the convex hull if not, filter them.
-    size_t begin_index;
-    size_t end_index;
-    for (size_t i = 0; i < this->voronoi_threads.size(); i++) {
-        // Determine the begin and end index for the current thread.
-        if (i < this->voronoi_threads.size() - 1) {
-            begin_index = i * items_per_thread;
-            end_index = (i + 1) * items_per_thread;
-
-        } else {
-            begin_index = i * items_per_thread;
-            end_index = valid_vertices.size();
+    // Every thread has its own direction buffer.
+    std::vector<std::vector<vec3f>> directions = std::vector<std::vector<vec3f>>(this->threadCount());
+    this->runThreads(valid_vertices.size(), 64, [&](size_t p_thread, size_t p_idx) {
+        if (directions[p_thread].size() != atomData.size()) {
+            directions[p_thread].resize(atomData.size());
         }
-
-        // Start the thread with the current begin and end index.
-        this->voronoi_threads[i] = std::thread([&valid_vertices, this, &atomData, begin_index, end_index] {
-            std::vector<vec3f> directions = std::vector<vec3f>(atomData.size());
-            for (size_t a = begin_index; a < end_index; a++) {
-                size_t idx = valid_vertices[a].first;
-                this->vertexValidFlags[idx] =
-                    Computations::LiesInsideConvexHull(atomData, valid_vertices[a].second, directions);
-            }
-        });
-    }
-
-    // Wait for the threads to finish.
-    this->stopThreads();
+        size_t idx = valid_vertices[p_idx].first;
+        this->vertexValidFlags[idx] =
+            Computations::LiesInsideConvexHull(atomData, valid_vertices[p_idx].second, directions[p_thread]);
+    });
 #endif /* #ifdef CONVEX_HULL_FILTERING */
 
     std::vector<std::pair<size_t, vec4d>> valid_gates;
@@ -127,40 +98,49 @@ void VoronoiChannelCalculator::checkVertexAndGateValidity(MolecularDataCall* mdc
         i++;
     }
 
-    items_per_thread = std::max(static_cast<size_t>(1), valid_gates.size() / core_num);
-
-    if (valid_gates.size() % core_num == 0) {
-        this->voronoi_threads = std::vector<std::thread>(core_num);
-    } else {
-        this->voronoi_threads = std::vector<std::thread>(core_num + 1);
-    }
-
 #ifdef CONVEX_HULL_FILTERING
-    for (size_t i = 0; i < this->voronoi_threads.size(); i++) {
-        // Determine the begin and end index for the current thread.
-        if (i < this->voronoi_threads.size() - 1) {
-            begin_index = i * items_per_thread;
-            end_index = (i + 1) * items_per_thread;
-
-        } else {
-            begin_index = i * items_per_thread;
-            end_index = valid_gates.size();
+    this->runThreads(valid_gates.size(), 64, [&](size_t p_thread, size_t p_idx) {
+        if (directions[p_thread].size() != atomData.size()) {
+            directions[p_thread].resize(atomData.size());
         }
-
-        // Start the thread with the current begin and end index.
-        this->voronoi_threads[i] = std::thread([&valid_gates, this, &atomData, begin_index, end_index] {
-            std::vector<vec3f> directions = std::vector<vec3f>(atomData.size());
-            for (size_t a = begin_index; a < end_index; a++) {
-                size_t idx = valid_gates[a].first;
-                this->gateValidFlags[idx] =
-                    Computations::LiesInsideConvexHull(atomData, valid_gates[a].second, directions);
-            }
-        });
-    }
-    this->stopThreads();
+        size_t idx = valid_gates[p_idx].first;
+        this->gateValidFlags[idx] =
+            Computations::LiesInsideConvexHull(atomData, valid_gates[p_idx].second, directions[p_thread]);
+    });
 #endif /* #ifdef CONVEX_HULL_FILTERING */
 }
 
+/*
+ * VoronoiChannelCalculator::computeEndVertices
+ */
+void VoronoiChannelCalculator::computeEndVertices() {
+    this->gateEndIndices.resize(this->gatesToTest.size());
+    this->gateEndVertices.resize(this->gatesToTest.size());
+
+    // Every gate is processed independently, the results are stored per gate so the caller can merge
+    // them in the order of the gates.
+    this->runThreads(this->gatesToTest.size(), 16, [this](size_t p_thread, size_t p_idx) {
+        std::array<vec3d, 2> circles{vec3d(), vec3d()};
+        std::array<vec4d, 2> gateCenter{vec4d(), vec4d()};
+        std::array<vec4d, 2> incircle{vec4d(), vec4d()};
+        const Gate& gate = this->gatesToTest[p_idx];
+
+        // Create the vector that contains all three gate spheres.
+        std::array<vec4d, 4> gateVector{this->searchGrid.GetAtoms()[gate.second[0]],
+            this->searchGrid.GetAtoms()[gate.second[1]], this->searchGrid.GetAtoms()[gate.second[2]], vec4d()};
+
+        // Get the gate centers, we only need the first one, i.e. the one with the smaller radius.
+        Computations::ComputeGateCenter(gateVector, gateCenter, incircle, circles);
+
+        // Compute the pivot point of the current gate.
+        vec3d pivot = Computations::ComputePivot(gateVector);
+
+        // Compute the next voronoi vertex.
+        EndVertexParams params = EndVertexParams(gate, gateCenter, gateVector, pivot);
+        this->gateEndIndices[p_idx] = this->searchGrid.GetEndVertex(params, this->gateEndVertices[p_idx]);
+    });
+}
+
 /*
  * VoronoiChannelCalculator::constructVoronoiDiagram
  */
@@ -176,8 +156,7 @@ bool VoronoiChannelCalculator::constructVoronoiDiagram(MolecularDataCall* mdc) {
     this->voronoi_edges.clear();
 
     // Remove the remaining gates in the queue.
-    this->gatesToTest_one.clear();
-    this->gatesToTest_two.clear();
+    this->gatesToTest.clear();
 
     // Get the true bounding box of the molecule. Then shrink the bounding box by 3 A
     // in each direction to fit tightly
@@ -250,49 +229,48 @@ bool VoronoiChannelCalculator::constructVoronoiDiagram(MolecularDataCall* mdc) {
     std::pair<vec4d, std::array<uint, 5>> g3(centroid, {s1Idx, s3Idx, s4Idx, s2Idx, 0});
     std::pair<vec4d, std::array<uint, 5>> g4(centroid, {s1Idx, s2Idx, s4Idx, s3Idx, 0});
 
-    // Gate definition: 1 start voronoi sphere as vec4d + 3 gate sphere indices followed
-    // by the index of the fourth vertex stored in an array. The fifth value is the
-    // Voronoi vertex ID this can be ignored for now. Initialise the start gates.
-    this->gatesToTest_one.reserve(2 * this->searchGrid.GetAtoms().size());
-    this->gatesToTest_two.reserve(2 * this->searchGrid.GetAtoms().size());
-    this->active_gates = 0;
-    this->gatesToTest_one.push_back(g4);
-    this->gatesToTest_one.push_back(g3);
-    this->gatesToTest_one.push_back(g2);
-    this->gatesToTest_one.push_back(g1);
+    // Initialise the start gates.
+    this->gatesToTest.reserve(2 * this->searchGrid.GetAtoms().size());
+    this->gatesToTest.push_back(g4);
+    this->gatesToTest.push_back(g3);
+    this->gatesToTest.push_back(g2);
+    this->gatesToTest.push_back(g1);
 
     // Initialise the loop that looks for the initial Voronoi Vertex.
     this->initVertexFound = false;
 
-    // This loop processes each element in the queue and tries to find a corresponding
-    // end vertex for each of them. If the end vertex is only defined by "real" atoms,
-    // we have found the initial voronoi vertex, if not we add three new gates to the
-    // queue.
-    size_t core_num = Concurrency::details::_CurrentScheduler::_GetNumberOfVirtualProcessors();
-    this->stopThreads();
-    this->voronoi_threads = std::vector<std::thread>(core_num);
-    uint stop = 0;
-    while (stop != 2) {
-        // Compute the active gates and push the new gates to the inactive queue.
-        stop = 0;
-        for (size_t i = 0; i < this->voronoi_threads.size(); i++) {
-            this->voronoi_threads[i] = std::thread(std::bind(&VoronoiChannelCalculator::nextVoronoiVertexInit, this));
-        }
-
-        // Wait for all threads to finish and swap the active an inactive queue.
-        this->stopThreads();
-        this->active_gates = (this->active_gates + 1) % 2;
-
-        // Stop if either both gate queues are empty or if the initial vertex is found.
-        if (this->gatesToTest_one.empty()) {
-            stop++;
-        }
-        if (this->gatesToTest_two.empty()) {
-            stop++;
-        }
-        if (this->initVertexFound) {
-            stop = 2;
+    // This loop processes all gates of a level and tries to find a corresponding end vertex
+    // for each of them. If the end vertex is only defined by "real" atoms, we have found the
+    // initial voronoi vertex, if not we add three new gates to the next level. The first gate
+    // of the level that ends in a "real" vertex is used, so the result does not depend on the
+    // threads.
+    uint thresh = static_cast<uint>(this->searchGrid.GetAtoms().size() - 4);
+    std::vector<Gate> nextGates;
+    while (!this->gatesToTest.empty() && !this->initVertexFound) {
+        this->computeEndVertices();
+        nextGates.clear();
+        for (size_t i = 0; i < this->gatesToTest.size(); i++) {
+            const Gate& gate = this->gatesToTest[i];
+            int minIdx = this->gateEndIndices[i];
+            if (minIdx < 0) {
+                continue;
+            }
+            const vec4d& edgeEndResult = this->gateEndVertices[i];
+            if (gate.second[0] < thresh && gate.second[1] < thresh && gate.second[2] < thresh &&
+                static_cast<uint>(minIdx) < thresh) {
+                this->initVertexFound = true;
+                this->initVertexBorder = vec4ui(gate.second[0], gate.second[1], gate.second[2], minIdx);
+                this->initVertex = edgeEndResult;
+                break;
+            }
+            nextGates.push_back(
+                Gate(edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[2], gate.second[1], 0}));
+            nextGates.push_back(
+                Gate(edgeEndResult, {static_cast<uint>(minIdx), gate.second[1], gate.second[2], gate.second[0], 0}));
+            nextGates.push_back(
+                Gate(edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[1], gate.second[2], 0}));
         }
+        this->gatesToTest.swap(nextGates);
     }
 
     if (!this->initVertexFound) {
@@ -303,8 +281,7 @@ bool VoronoiChannelCalculator::constructVoronoiDiagram(MolecularDataCall* mdc) {
     }
 
     // Remove the remaining gates in the queue.
-    this->gatesToTest_one.clear();
-    this->gatesToTest_two.clear();
+    this->gatesToTest.clear();
 
     // Remove the start spheres from the list of atoms.
     this->searchGrid.RemoveStartSpheres();
@@ -323,45 +300,81 @@ bool VoronoiChannelCalculator::constructVoronoiDiagram(MolecularDataCall* mdc) {
     g4.first = this->initVertex;
     g4.second = {s1Idx, s2Idx, s4Idx, s3Idx, 0};
 
-    // Put the gate in the active queue.
-    this->active_gates = 0;
-    this->gatesToTest_one.push_back(g4);
-    this->gatesToTest_one.push_back(g3);
-    this->gatesToTest_one.push_back(g2);
-    this->gatesToTest_one.push_back(g1);
+    // Put the gate in the queue.
+    this->gatesToTest.push_back(g4);
+    this->gatesToTest.push_back(g3);
+    this->gatesToTest.push_back(g2);
+    this->gatesToTest.push_back(g1);
 
     // Initialise the list of Voronoi vertices and edges.
     this->voronoi_edges.reserve(20 * this->searchGrid.GetAtoms().size());
     this->vertices.reserve(20 * this->searchGrid.GetAtoms().size());
 
+    // The Voronoi vertices by ID and a hash table that maps the atoms of a vertex to its ID. The
+    // table is only accessed while merging the results of a level, so it needs no lock.
+    std::vector<VoronoiVertex> vertexList;
+    std::unordered_map<uint64_t, uint> vertexIds;
+    vertexList.reserve(20 * this->searchGrid.GetAtoms().size());
+    vertexIds.reserve(20 * this->searchGrid.GetAtoms().size());
+
     // Convert the intial Voronoi vertex to a Voronoi vertex and add it to the list.
-    this->voronoi_id = 0;
-    auto vertex = VoronoiVertex(initVertexBorder, this->voronoi_id++);
-    this->voronoi_vertices.insert(std::pair<uint64_t, VoronoiVertex>(vertex.vertex_hash, vertex));
+    vertexList.push_back(VoronoiVertex(initVertexBorder, 0));
+    vertexIds.emplace(vertexList.back().vertex_hash, 0);
     this->vertices.push_back(this->initVertex);
 
-    // Use the threadpool to compute all Voronoi vertices.
-    this->stopThreads();
-    this->voronoi_threads = std::vector<std::thread>(core_num);
-    stop = 0;
-    while (stop != 2) {
-        // Compute the active gates and push the new gates to the inactive queue.
-        stop = 0;
-        for (size_t i = 0; i < this->voronoi_threads.size(); i++) {
-            this->voronoi_threads[i] = std::thread(std::bind(&VoronoiChannelCalculator::nextVoronoiVertex, this));
-        }
+    // Compute all Voronoi vertices level by level. The end vertices of all gates of a level are
+    // computed in parallel, afterwards the results are merged in the order of the gates so the
+    // vertex IDs do not depend on the scheduling of the threads.
+    while (!this->gatesToTest.empty()) {
+        this->computeEndVertices();
+        nextGates.clear();
+        for (size_t i = 0; i < this->gatesToTest.size(); i++) {
+            const Gate& gate = this->gatesToTest[i];
+            int minIdx = this->gateEndIndices[i];
+
+            // Did we find a result for the currently processed gate?
+            if (minIdx >= 0) {
+                // Check if the new Voronoi vertex already exists.
+                vec4ui atoms = vec4ui(gate.second[0], gate.second[1], gate.second[2], minIdx);
+                auto it = vertexIds.find(VoronoiVertex::ComputeHash(atoms));
+                if (it == vertexIds.end()) {
+                    // The vertex is new so add it to the list and create the edge between the vertex we came from
+                    // and the new vertex.
+                    uint id = static_cast<uint>(vertexList.size());
+                    const vec4d& edgeEndResult = this->gateEndVertices[i];
+                    vertexList.push_back(VoronoiVertex(atoms, id));
+                    vertexIds.emplace(vertexList.back().vertex_hash, id);
+                    this->voronoi_edges.push_back(VoronoiEdge(id, gate.first, gate.second[4]));
+                    this->vertices.push_back(edgeEndResult);
+
+                    // Create the three new gates for the next level.
+                    nextGates.push_back(Gate(
+                        edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[2], gate.second[1], id}));
+                    nextGates.push_back(Gate(
+                        edgeEndResult, {static_cast<uint>(minIdx), gate.second[1], gate.second[2], gate.second[0], id}));
+                    nextGates.push_back(Gate(
+                        edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[1], gate.second[2], id}));
 
-        // Wait for all threads to finish and swap the active an inactive queue.
-        this->stopThreads();
-        this->active_gates = (this->active_gates + 1) % 2;
+                } else {
+                    // The vertex already exists so create the edge.
+                    this->voronoi_edges.push_back(VoronoiEdge(it->second, gate.first, gate.second[4]));
+                }
 
-        // If both queues are empty we found all vertices.
-        if (this->gatesToTest_one.empty()) {
-            stop++;
-        }
-        if (this->gatesToTest_two.empty()) {
-            stop++;
+            } else {
+                // Increase the infinity counter of the vertex the gate starts from.
+                auto it = vertexIds.find(VoronoiVertex::ComputeHash(
+                    vec4ui(gate.second[0], gate.second[1], gate.second[2], gate.second[3])));
+                if (it != vertexIds.end()) {
+                    vertexList[it->second].infinity_count++;
+                }
+            }
         }
+        this->gatesToTest.swap(nextGates);
+    }
+
+    // Store the Voronoi vertices ordered by their hash.
+    for (const auto& vertex : vertexList) {
+        this->voronoi_vertices.insert(std::pair<uint64_t, VoronoiVertex>(vertex.vertex_hash, vertex));
     }
 
     // Clear the search grid and free all used memory.
@@ -372,221 +385,97 @@ bool VoronoiChannelCalculator::constructVoronoiDiagram(MolecularDataCall* mdc) {
 }
 
 /*
- * VoronoiChannelCalculator::nextVoronoiVertex
+ * VoronoiChannelCalculator::processChunks
  */
-void VoronoiChannelCalculator::nextVoronoiVertex() {
-    std::array<vec3d, 2> circles{vec3d(), vec3d()};
-    std::pair<vec4d, std::array<uint, 5>> gate;
-    std::array<vec4d, 2> gateCenter{vec4d(), vec4d()};
-    std::array<vec4d, 2> incircle{vec4d(), vec4d()};
-    std::array<vec4d, 2> sphereVec{vec4d(), vec4d()};
-    bool stop = false;
-    while (!stop) {
-        // Get the gate and remove it from the queue.
-        this->voronoi_mutex.lock();
-        if (this->active_gates == 0) {
-            // If the thread waited so long that the active queue is now empty we can stop it.
-            if (this->gatesToTest_one.empty()) {
-                this->voronoi_mutex.unlock();
-                break;
-            }
-
-            // Get the last element from the queue and process it.
-            gate = this->gatesToTest_one.back();
-            this->gatesToTest_one.pop_back();
-
-        } else {
-            // If the thread waited so long that the active queue is now empty we can stop it.
-            if (this->gatesToTest_two.empty()) {
-                this->voronoi_mutex.unlock();
-                break;
-            }
-
-            // Get the last element from the queue and process it.
-            gate = this->gatesToTest_two.back();
-            this->gatesToTest_two.pop_back();
-        }
-        this->voronoi_mutex.unlock();
-
-        // Create the vector that contains all three gate spheres.
-        std::array<vec4d, 4> gateVector{this->searchGrid.GetAtoms()[gate.second[0]],
-            this->searchGrid.GetAtoms()[gate.second[1]], this->searchGrid.GetAtoms()[gate.second[2]], vec4d()};
-
-        // Get the gate centers, we only need the first one, i.e. the one with the smaller radius.
-        auto gateCenter_cnt = Computations::ComputeGateCenter(gateVector, gateCenter, incircle, circles);
-
-        // Compute the pivot point of the current gate.
-        vec3d pivot = Computations::ComputePivot(gateVector);
-
-        // Compute the next voronoi vertex.
-        EndVertexParams params = EndVertexParams(gate, gateCenter, gateVector, pivot);
-        vec4d edgeEndResult;
-        int minIdx = this->searchGrid.GetEndVertex(params, edgeEndResult);
-
-        // Did we find a result for the currently processed gate?
-        if (minIdx >= 0) {
-            // Create the new Voronoi vertex and check if it already exists.
-            this->voronoi_mutex.lock();
-            VoronoiVertex possible_vertex =
-                VoronoiVertex(vec4ui(gate.second[0], gate.second[1], gate.second[2], minIdx), 0);
-            auto it = this->voronoi_vertices.find(possible_vertex.vertex_hash);
-            if (it == this->voronoi_vertices.end()) {
-                // The vertex is new so add it to the list and create the edge between the vertex we came from and the
-                // new vertex.
-                possible_vertex.id = this->voronoi_id++;
-                this->voronoi_vertices.insert(
-                    std::pair<uint64_t, VoronoiVertex>(possible_vertex.vertex_hash, possible_vertex));
-                this->voronoi_edges.push_back(VoronoiEdge(possible_vertex.id, gate.first, gate.second[4]));
-                this->vertices.push_back(edgeEndResult);
-                this->voronoi_mutex.unlock();
-
-                // Create the three new gates.
-                std::pair<vec4d, std::array<uint, 5>> new1(edgeEndResult,
-                    {static_cast<uint>(minIdx), gate.second[0], gate.second[1], gate.second[2], possible_vertex.id});
-                std::pair<vec4d, std::array<uint, 5>> new2(edgeEndResult,
-                    {static_cast<uint>(minIdx), gate.second[1], gate.second[2], gate.second[0], possible_vertex.id});
-                std::pair<vec4d, std::array<uint, 5>> new3(edgeEndResult,
-                    {static_cast<uint>(minIdx), gate.second[0], gate.second[2], gate.second[1], possible_vertex.id});
-
-                // Add the new gates to the inactive queue.
-                this->voronoi_mutex.lock();
-                if (this->active_gates == 0) {
-                    this->gatesToTest_two.push_back(new3);
-                    this->gatesToTest_two.push_back(new2);
-                    this->gatesToTest_two.push_back(new1);
-
-                } else {
-                    this->gatesToTest_one.push_back(new3);
-                    this->gatesToTest_one.push_back(new2);
-                    this->gatesToTest_one.push_back(new1);
-                }
-                this->voronoi_mutex.unlock();
-
-            } else {
-                // The vertex already exists so create the edge.
-                this->voronoi_edges.push_back(VoronoiEdge(it->second.id, gate.first, gate.second[4]));
-                this->voronoi_mutex.unlock();
-            }
-
-        } else {
-            // Compute the hash value of the voronoi vertex and increase the infinity counter.
-            this->voronoi_mutex.lock();
-            auto vertex_hash =
-                VoronoiVertex::ComputeHash(vec4ui(gate.second[0], gate.second[1], gate.second[2], gate.second[3]));
-            auto it = this->voronoi_vertices.find(vertex_hash);
-            if (it != this->voronoi_vertices.end()) {
-                it->second.infinity_count++;
-            }
-            this->voronoi_mutex.unlock();
-        }
-
-        // Check if we need to stop the thread because all gates have been processed.
-        if (this->active_gates == 0) {
-            stop = this->gatesToTest_one.empty();
-
-        } else {
-            stop = this->gatesToTest_two.empty();
+void VoronoiChannelCalculator::processChunks(size_t p_thread) {
+    // The threads take the next chunk from the shared counter as soon as they are done with
+    // their last one, so expensive items do not leave the other threads idle.
+    size_t begin;
+    while ((begin = this->pool_next.fetch_add(this->pool_chunk)) < this->pool_cnt) {
+        size_t end = std::min(begin + this->pool_chunk, this->pool_cnt);
+        for (size_t i = begin; i < end; i++) {
+            (*this->pool_work)(p_thread, i);
         }
     }
 }
 
 /*
- * VoronoiChannelCalculator::nextVoronoiVertexInit
+ * VoronoiChannelCalculator::runThreads
  */
-void VoronoiChannelCalculator::nextVoronoiVertexInit() {
-    std::array<vec3d, 2> circles{vec3d(), vec3d()};
-    std::pair<vec4d, std::array<uint, 5>> gate;
-    std::array<vec4d, 2> gateCenter{vec4d(), vec4d()};
-    std::array<vec4d, 2> incircle{vec4d(), vec4d()};
-    std::array<vec4d, 2> sphereVec{vec4d(), vec4d()};
-    bool stop = false;
-    while (!stop && !this->initVertexFound) {
-        // Get the gate and remove it from the queue.
-        this->voronoi_mutex.lock();
-        if (this->active_gates == 0) {
-            // If the thread waited so long that the active queue is now empty we can stop it.
-            if (this->gatesToTest_one.empty()) {
-                this->voronoi_mutex.unlock();
-                break;
-            }
-
-            // Get the last element from the queue and process it.
-            gate = this->gatesToTest_one.back();
-            this->gatesToTest_one.pop_back();
-
-        } else {
-            // If the thread waited so long that the active queue is now empty we can stop it.
-            if (this->gatesToTest_two.empty()) {
-                this->voronoi_mutex.unlock();
-                break;
-            }
-
-            // Get the last element from the queue and process it.
-            gate = this->gatesToTest_two.back();
-            this->gatesToTest_two.pop_back();
-        }
-        this->voronoi_mutex.unlock();
-
-        // Create the vector that contains all three gate spheres.
-        std::array<vec4d, 4> gateVector{this->searchGrid.GetAtoms()[gate.second[0]],
-            this->searchGrid.GetAtoms()[gate.second[1]], this->searchGrid.GetAtoms()[gate.second[2]], vec4d()};
-
-        // Get the gate centers, we only need the first one, i.e. the one with the smaller radius.
-        auto gateCenter_cnt = Computations::ComputeGateCenter(gateVector, gateCenter, incircle, circles);
-
-        // Compute the pivot point of the current gate.
-        vec3d pivot = Computations::ComputePivot(gateVector);
-
-        // Compute the next voronoi vertex.
-        EndVertexParams params = EndVertexParams(gate, gateCenter, gateVector, pivot);
-        vec4d edgeEndResult;
-        int minIdx = this->searchGrid.GetEndVertex(params, edgeEndResult);
-
-        // Did we find a result for the currently processed gate?
-        if (minIdx >= 0) {
-            // Check if all 4 surrounding vertices of our voronoi vertex are "real" atoms. If all of them are real,
-            // we have found our start vertex and can exit. If at least one is one of the four start vertices, add
-            // the three new gates to the queue and process the next gate.
-            this->voronoi_mutex.lock();
-            uint thresh = static_cast<uint>(this->searchGrid.GetAtoms().size() - 4);
-            if (gate.second[0] < thresh && gate.second[1] < thresh && gate.second[2] < thresh &&
-                static_cast<uint>(minIdx) < thresh) {
-                this->initVertexFound = true;
-                this->initVertexBorder = vec4ui(gate.second[0], gate.second[1], gate.second[2], minIdx);
-                this->initVertex = edgeEndResult;
-
-            } else {
-                std::pair<vec4d, std::array<uint, 5>> new1(
-                    edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[1], gate.second[2], 0});
-                std::pair<vec4d, std::array<uint, 5>> new2(
-                    edgeEndResult, {static_cast<uint>(minIdx), gate.second[1], gate.second[2], gate.second[0], 0});
-                std::pair<vec4d, std::array<uint, 5>> new3(
-                    edgeEndResult, {static_cast<uint>(minIdx), gate.second[0], gate.second[2], gate.second[1], 0});
-                if (this->active_gates == 0) {
-                    this->gatesToTest_two.push_back(new3);
-                    this->gatesToTest_two.push_back(new2);
-                    this->gatesToTest_two.push_back(new1);
+void VoronoiChannelCalculator::runThreads(
+    size_t p_cnt, size_t p_chunk, const std::function<void(size_t, size_t)>& p_work) {
+    if (p_cnt == 0) {
+        return;
+    }
 
-                } else {
-                    this->gatesToTest_one.push_back(new3);
-                    this->gatesToTest_one.push_back(new2);
-                    this->gatesToTest_one.push_back(new1);
+    // The workers are started once and then wait for the next job, so a level of the search does
+    // not pay for creating and joining threads. The calling thread works as thread 0.
+    if (this->voronoi_threads.empty()) {
+        this->pool_stop = false;
+        const size_t first_generation = this->pool_generation;
+        for (size_t t = 1; t < this->threadCount(); t++) {
+            this->voronoi_threads.emplace_back([this, t, first_generation] {
+                size_t generation = first_generation;
+                std::unique_lock<std::mutex> lock(this->pool_mutex);
+                while (true) {
+                    this->pool_start.wait(
+                        lock, [this, generation] { return this->pool_stop || this->pool_generation != generation; });
+                    if (this->pool_stop) {
+                        return;
+                    }
+                    generation = this->pool_generation;
+                    lock.unlock();
+                    this->processChunks(t);
+                    lock.lock();
+                    if (--this->pool_busy == 0) {
+                        this->pool_done.notify_one();
+                    }
                 }
-            }
-            this->voronoi_mutex.unlock();
+            });
         }
     }
+
+    {
+        std::lock_guard<std::mutex> lock(this->pool_mutex);
+        this->pool_work = &p_work;
+        this->pool_cnt = p_cnt;
+        this->pool_chunk = p_chunk;
+        this->pool_next = 0;
+        this->pool_busy = this->voronoi_threads.size();
+        this->pool_generation++;
+    }
+    this->pool_start.notify_all();
+    this->processChunks(0);
+
+    // Wait for the workers to finish their last chunk.
+    std::unique_lock<std::mutex> lock(this->pool_mutex);
+    this->pool_done.wait(lock, [this] { return this->pool_busy == 0; });
+    this->pool_work = nullptr;
 }
 
 /*
  * VoronoiChannelCalculator::stopThreads
  */
 void VoronoiChannelCalculator::stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(this->pool_mutex);
+        this->pool_stop = true;
+    }
+    this->pool_start.notify_all();
     for (size_t i = 0; i < this->voronoi_threads.size(); i++) {
         if (this->voronoi_threads[i].joinable()) {
             this->voronoi_threads[i].join();
         }
     }
+    this->voronoi_threads.clear();
+}
+
+/*
+ * VoronoiChannelCalculator::threadCount
+ */
+size_t VoronoiChannelCalculator::threadCount() const {
+    return std::max(static_cast<size_t>(1),
+        static_cast<size_t>(Concurrency::details::_CurrentScheduler::_GetNumberOfVirtualProcessors()));
 }
 
 /*
@@ -20,6 +20,12 @@
 
 #include <Eigen/Dense>
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace megamol {
 namespace molecularmaps {
 
@@ -76,22 +82,48 @@ namespace molecularmaps {
         void convexHullThread();
 
         /**
-         * Computes the next Voronoi vertices until the thread is stopped.
+         * Computes the end vertices of all gates in the gatesToTest list in parallel
+         * and stores them in gateEndIndices and gateEndVertices.
          */
-        void nextVoronoiVertex();
+        void computeEndVertices();
 
         /**
-         * Computes the next Voronoi vertices until the thread is stopped.
+         * Processes chunks of the current job of the thread pool until all items are taken.
+         *
+         * @param p_thread The index of the calling thread
          */
-        void nextVoronoiVertexInit();
+        void processChunks(size_t p_thread);
 
         /**
-         * Stops all threads in the threadpool.
+         * Processes the items 0 to p_cnt - 1 with the thread pool. The threads take
+         * chunks of p_chunk items from a shared atomic counter until all items are
+         * processed, the function returns after all threads are finished. The pool
+         * is started on the first call and kept until stopThreads is called.
+         *
+         * @param p_cnt The number of items
+         * @param p_chunk The number of items that are taken at once
+         * @param p_work The function that processes an item, it gets the index of the
+         * thread and the index of the item
+         */
+        void runThreads(size_t p_cnt, size_t p_chunk, const std::function<void(size_t, size_t)>& p_work);
+
+        /**
+         * Stops and joins all threads in the threadpool.
          */
         void stopThreads();
 
-        /** Indicates the active queue for the Voronoi threads. */
-        uint active_gates;
+        /**
+         * Answer the number of threads in the thread pool.
+         *
+         * @return The number of threads
+         */
+        size_t threadCount() const;
+
+        /**
+         * Gate definition: 1 start voronoi sphere as vec4d + 3 gate sphere indices followed
+         * by the index of the fourth vertex and the ID of the start Voronoi vertex.
+         */
+        typedef std::pair<vec4d, std::array<uint, 5>> Gate;
 
         /** List of neighbouring particle indices per edge */
         std::vector<vislib::math::Vector<int, 3>> edge_neighbours;
@@ -99,12 +131,17 @@ namespace molecularmaps {
         /** List of all gate vertices, one for each edge */
         std::vector<vislib::math::Vector<float, 4>> gates;
 
-        /** Queue of all gate vertices that need to be processed. */
-        std::vector<std::pair<vec4d, std::array<uint, 5>>> gatesToTest_one;
-        std::vector<std::pair<vec4d, std::array<uint, 5>>> gatesToTest_two;
+        /** The gates of the current level that need to be processed. */
+        std::vector<Gate> gatesToTest;
+
+        /** The index of the atom that ends each gate of the current level, -1 for no end vertex. */
+        std::vector<int> gateEndIndices;
+
+        /** The end vertex of each gate of the current level. */
+        std::vector<vec4d> gateEndVertices;
 
         /** Validity flags for all gates. Non-valid gates are not initialized and do not belong to cavities. */
-        std::vector<bool> gateValidFlags;
+        std::vector<char> gateValidFlags;
 
         /** The initial vertex. */
         vec4d initVertex;
@@ -128,7 +165,7 @@ namespace molecularmaps {
         std::vector<int> vertexMap;
 
         /** validity flags of all vertices */
-        std::vector<bool> vertexValidFlags;
+        std::vector<char> vertexValidFlags;
 
         /** List of all voronoi vertex positions. */
         std::vector<vislib::math::Vector<float, 4>> vertices;
@@ -136,15 +173,37 @@ namespace molecularmaps {
         /** List of all voronoi edges. */
         std::vector<VoronoiEdge> voronoi_edges;
 
-        /** The ID of the next voronoi vertex. */
-        uint voronoi_id;
-
-        /** The mutex that locks access to the local variables for the threads. */
-        std::mutex voronoi_mutex;
-
         /** Thread pool that computes the voronoi edges. */
         std::vector<std::thread> voronoi_threads;
 
+        /** Guards the job of the thread pool and the counters below. */
+        std::mutex pool_mutex;
+
+        /** Signals a new job or the stop to the thread pool. */
+        std::condition_variable pool_start;
+
+        /** Signals that all threads of the pool are done with the job. */
+        std::condition_variable pool_done;
+
+        /** The function of the current job of the thread pool. */
+        const std::function<void(size_t, size_t)>* pool_work = nullptr;
+
+        /** The number of items and the chunk size of the current job. */
+        size_t pool_cnt = 0;
+        size_t pool_chunk = 1;
+
+        /** The first item of the current job that no thread has taken yet. */
+        std::atomic<size_t> pool_next{0};
+
+        /** Counts the jobs, a new value starts the threads of the pool. */
+        size_t pool_generation = 0;
+
+        /** The number of threads of the pool still working on the current job. */
+        size_t pool_busy = 0;
+
+        /** Flag that makes the threads of the pool return. */
+        bool pool_stop = false;
+
         /** List of all voronoi vertices. */
         std::map<uint64_t, VoronoiVertex> voronoi_vertices;
     };
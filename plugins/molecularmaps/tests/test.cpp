@@ -0,0 +1,19 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testhelper.h"
+#include "testoctree.h"
+
+
+/* all available tests:
+ * Add your tests here
+ */
+TestEntry tests[] = {
+    { "Octree", ::TestOctree, "Compares the parallel Octree build and the batched queries with the serial ones" },
+    // end guard. Do not remove. Must be last entry.
+    {NULL, NULL, NULL}
+};
@@ -0,0 +1,382 @@
+/*
+ * testoctree.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testoctree.h"
+#include "testhelper.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <omp.h>
+
+#include "stdafx.h"
+#include "Octree.h"
+
+using namespace megamol::molecularmaps;
+
+namespace {
+
+/**
+ * The recursive Octree MolecularMaps used before the level by level build,
+ * together with its serial queries. The new Octree must answer exactly the
+ * same.
+ */
+class SerialOctree {
+public:
+    void Create(const std::vector<uint>& p_faces, const float3& p_max, const float3& p_min, const float3& p_min_dim,
+        const std::vector<float>& p_vertices) {
+        this->root = OctreeNode(BoundingBox(p_max, p_min), 0, p_faces.size() / 3);
+        this->face_bboxs.clear();
+        std::vector<float3> vertices(3);
+        for (size_t i = 0; i < p_faces.size() / 3; i++) {
+            for (size_t v = 0; v < 3; v++) {
+                const uint idx = p_faces[i * 3 + v];
+                vertices[v] = make_float3(p_vertices[idx * 3], p_vertices[idx * 3 + 1], p_vertices[idx * 3 + 2]);
+            }
+            this->face_bboxs.push_back(BoundingBox(vertices));
+        }
+        this->node_cnt = 1;
+        this->cuda_node_cnt = 1;
+        this->createOctree(p_min_dim, this->root);
+    }
+
+    size_t ConvertToCUDAOctree(
+        std::vector<CudaOctreeNode>& p_octree_nodes, std::vector<std::vector<uint>>& p_node_faces) const {
+        p_octree_nodes = std::vector<CudaOctreeNode>(this->cuda_node_cnt + 1);
+        p_node_faces = std::vector<std::vector<uint>>(this->cuda_node_cnt + 1);
+        std::vector<const OctreeNode*> queue(1, &this->root);
+        while (!queue.empty()) {
+            auto curr = queue.back();
+            queue.pop_back();
+            p_octree_nodes[curr->cuda_idx] =
+                CudaOctreeNode(CudaBoundingBox(curr->bounding_box.max, curr->bounding_box.min),
+                    static_cast<uint>(curr->children.size()), static_cast<uint>(curr->faces.size()));
+            p_node_faces[curr->cuda_idx] = curr->faces;
+            for (const auto& node : curr->children) {
+                queue.push_back(&node);
+            }
+        }
+        return this->node_cnt;
+    }
+
+    /** Answers the first vertex of the first face hit, or of the closest one if 'p_face_id' is given */
+    int IntersectOctree(
+        const std::vector<uint>& p_faces, const Ray& p_ray, const std::vector<float>& p_vertices, uint* p_face_id) {
+        std::vector<const OctreeNode*> queue(1, &this->root);
+        std::vector<vec3f> vertices(3);
+        int retval = -1;
+        float min_dist = std::numeric_limits<float>::max();
+        while (!queue.empty()) {
+            auto curr = queue.back();
+            queue.pop_back();
+            for (const auto face : curr->faces) {
+                for (size_t v = 0; v < 3; v++) {
+                    const uint idx = p_faces[face * 3 + v];
+                    vertices[v] = vec3f(p_vertices[idx * 3], p_vertices[idx * 3 + 1], p_vertices[idx * 3 + 2]);
+                }
+                if (!rayTriangleIntersection(p_ray, vertices)) continue;
+                if (p_face_id == nullptr) return static_cast<int>(p_faces[face * 3]);
+                const vec3f d = vertices[0] - p_ray.origin;
+                const float dist = d.GetX() * d.GetX() + d.GetY() * d.GetY() + d.GetZ() * d.GetZ();
+                if (dist < min_dist) {
+                    min_dist = dist;
+                    *p_face_id = face;
+                    retval = static_cast<int>(p_faces[face * 3]);
+                }
+            }
+            for (const auto& node : curr->children) {
+                if (node.bounding_box.RayIntersection(p_ray)) queue.push_back(&node);
+            }
+        }
+        return retval;
+    }
+
+    std::vector<uint> RadiusSearch(
+        const std::vector<uint>& p_faces, const vec4d& p_querySphere, const std::vector<float>& p_vertices) const {
+        std::vector<uint> result;
+        std::vector<const OctreeNode*> queue(1, &this->root);
+        std::vector<vec3f> vertices(3);
+        while (!queue.empty()) {
+            auto curr = queue.back();
+            queue.pop_back();
+            for (const auto face : curr->faces) {
+                for (size_t v = 0; v < 3; v++) {
+                    const uint idx = p_faces[face * 3 + v];
+                    vertices[v] = vec3f(p_vertices[idx * 3], p_vertices[idx * 3 + 1], p_vertices[idx * 3 + 2]);
+                }
+                if (sphereTriangleIntersection(p_querySphere, vertices)) result.push_back(face);
+            }
+            for (const auto& node : curr->children) {
+                if (node.bounding_box.SphereIntersection(p_querySphere)) queue.push_back(&node);
+            }
+        }
+        return result;
+    }
+
+private:
+    void createOctree(const float3& p_min_dim, OctreeNode& p_node) {
+        if (p_node.cuda_idx > this->cuda_node_cnt) {
+            this->cuda_node_cnt = p_node.cuda_idx;
+        }
+        if (p_node.faces.size() <= 1) return;
+
+        const float3 max = p_node.bounding_box.max;
+        const float3 min = p_node.bounding_box.min;
+        const float3 dim = max - min;
+        if (dim.x == 0.0f && dim.y == 0.0f && dim.z == 0.0f) return;
+        if (dim.x <= p_min_dim.x && dim.y <= p_min_dim.y && dim.z <= p_min_dim.z) return;
+
+        const float3 center = min + dim / 2.0f;
+        std::vector<BoundingBox> octant(8);
+        octant[0] = BoundingBox(center, min);
+        octant[1] = BoundingBox(make_float3(max.x, center.y, center.z), make_float3(center.x, min.y, min.z));
+        octant[2] = BoundingBox(make_float3(max.x, center.y, max.z), make_float3(center.x, min.y, center.z));
+        octant[3] = BoundingBox(make_float3(center.x, center.y, max.z), make_float3(min.x, min.y, center.z));
+        octant[4] = BoundingBox(make_float3(center.x, max.y, center.z), make_float3(min.x, center.y, min.z));
+        octant[5] = BoundingBox(make_float3(max.x, max.y, center.z), make_float3(center.x, center.y, min.z));
+        octant[6] = BoundingBox(max, center);
+        octant[7] = BoundingBox(make_float3(center.x, max.y, max.z), make_float3(min.x, center.y, center.z));
+
+        std::vector<std::vector<uint>> node_faces(8);
+        std::vector<bool> to_delete(p_node.faces.size() + 1, false);
+        for (size_t f = 0; f < p_node.faces.size(); f++) {
+            for (size_t i = 0; i < octant.size(); i++) {
+                if (this->face_bboxs[p_node.faces[f]].IsContained(octant[i])) {
+                    node_faces[i].push_back(p_node.faces[f]);
+                    to_delete[f] = true;
+                    break;
+                }
+            }
+        }
+        p_node.RemoveFaces(to_delete);
+
+        for (uint i = 0; i < 8; i++) {
+            p_node.children.push_back(OctreeNode(octant[i], (p_node.cuda_idx * 8) + (i + 1), node_faces[i]));
+            this->node_cnt++;
+            this->createOctree(p_min_dim, p_node.children[i]);
+        }
+    }
+
+    static bool rayTriangleIntersection(const Ray& p_ray, const std::vector<vec3f>& p_vertices) {
+        vec3f e2 = p_vertices[2] - p_vertices[0];
+        vec3f e1 = p_vertices[1] - p_vertices[0];
+        vec3f r = p_ray.dir.Cross(e2);
+        vec3f s = p_ray.origin - p_vertices[0];
+        float denom = e1.Dot(r);
+        if (std::abs(denom) < 1e-5) return false;
+        float f = 1.0f / denom;
+        vec3f q = s.Cross(e1);
+        float u = s.Dot(r);
+        if (denom > 1e-5) {
+            if (u < 0.0f || u > denom) return false;
+            float v = p_ray.dir.Dot(q);
+            if (v < 0.0f || (u + v) > denom) return false;
+        } else {
+            if (u > 0.0f || u < denom) return false;
+            float v = p_ray.dir.Dot(q);
+            if (v > 0.0f || (u + v) < denom) return false;
+        }
+        return f * e2.Dot(q) > 1e-5;
+    }
+
+    static bool sphereTriangleIntersection(const vec4d& p_sphere, const std::vector<vec3f>& p_vertices) {
+        double radiusSquared = p_sphere[3] * p_sphere[3];
+        for (const auto& vert : p_vertices) {
+            double squaredDist = (p_sphere.GetX() - vert.GetX()) * (p_sphere.GetX() - vert.GetX()) +
+                                 (p_sphere.GetY() - vert.GetY()) * (p_sphere.GetY() - vert.GetY()) +
+                                 (p_sphere.GetZ() - vert.GetZ()) * (p_sphere.GetZ() - vert.GetZ());
+            if (squaredDist <= radiusSquared) return true;
+        }
+        return false;
+    }
+
+    size_t cuda_node_cnt = 0;
+    std::vector<BoundingBox> face_bboxs;
+    size_t node_cnt = 0;
+    OctreeNode root;
+};
+
+/** A surface: a triangulated sphere around the centre of the box and a soup of small triangles */
+struct TestSurface {
+    TestSurface(uint p_soup_cnt, unsigned int p_seed) {
+        const uint rings = 24;
+        const uint segments = 48;
+        const float pi = 3.14159265f;
+        const float radius = 8.0f;
+        for (uint r = 0; r <= rings; r++) {
+            const float theta = pi * r / rings;
+            for (uint s = 0; s < segments; s++) {
+                const float phi = 2.0f * pi * s / segments;
+                this->vertices.push_back(10.0f + radius * std::sin(theta) * std::cos(phi));
+                this->vertices.push_back(10.0f + radius * std::sin(theta) * std::sin(phi));
+                this->vertices.push_back(10.0f + radius * std::cos(theta));
+            }
+        }
+        for (uint r = 0; r < rings; r++) {
+            for (uint s = 0; s < segments; s++) {
+                const uint a = r * segments + s;
+                const uint b = r * segments + (s + 1) % segments;
+                const uint c = a + segments;
+                const uint d = b + segments;
+                this->faces.insert(this->faces.end(), {a, c, b, b, c, d});
+            }
+        }
+
+        std::mt19937 rng(p_seed);
+        std::uniform_real_distribution<float> box(1.0f, 19.0f);
+        std::uniform_real_distribution<float> edge(-0.6f, 0.6f);
+        for (uint i = 0; i < p_soup_cnt; i++) {
+            const uint first = static_cast<uint>(this->vertices.size() / 3);
+            const float corner[3] = {box(rng), box(rng), box(rng)};
+            for (uint v = 0; v < 3; v++) {
+                for (uint d = 0; d < 3; d++) {
+                    this->vertices.push_back(corner[d] + ((v == 0) ? 0.0f : edge(rng)));
+                }
+            }
+            this->faces.insert(this->faces.end(), {first, first + 1, first + 2});
+        }
+    }
+
+    std::vector<uint> faces;
+    std::vector<float> vertices;
+};
+
+/** Random rays, some of them starting in the centre of the sphere */
+std::vector<Ray> randomRays(size_t p_cnt, unsigned int p_seed) {
+    std::mt19937 rng(p_seed);
+    std::uniform_real_distribution<float> box(0.5f, 19.5f);
+    std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+    std::vector<Ray> rays;
+    for (size_t i = 0; i < p_cnt; i++) {
+        const vec3f origin = (i % 4 == 0) ? vec3f(10.0f, 10.0f, 10.0f) : vec3f(box(rng), box(rng), box(rng));
+        rays.push_back(Ray(vec3f(dir(rng), dir(rng), dir(rng)), origin));
+    }
+    return rays;
+}
+
+/** Random query spheres, from empty ones to ones covering large parts of the surface */
+std::vector<vec4d> randomSpheres(size_t p_cnt, unsigned int p_seed) {
+    std::mt19937 rng(p_seed);
+    std::uniform_real_distribution<double> box(0.0, 20.0);
+    std::uniform_real_distribution<double> radius(0.0, 3.0);
+    std::vector<vec4d> spheres;
+    for (size_t i = 0; i < p_cnt; i++) {
+        spheres.push_back(vec4d(box(rng), box(rng), box(rng), (i % 16 == 0) ? 9.0 : radius(rng)));
+    }
+    return spheres;
+}
+
+bool sameFloat3(const float3& l, const float3& r) {
+    return l.x == r.x && l.y == r.y && l.z == r.z;
+}
+
+/** Answers whether both CUDA representations have the same nodes with the same faces */
+bool sameCUDAOctree(Octree& p_octree, const SerialOctree& p_serial) {
+    std::vector<CudaOctreeNode> nodes, serial_nodes;
+    std::vector<std::vector<uint>> node_faces, serial_node_faces;
+    const size_t node_cnt = p_octree.ConvertToCUDAOctree(nodes, node_faces);
+    if (node_cnt != p_serial.ConvertToCUDAOctree(serial_nodes, serial_node_faces)) return false;
+    if (nodes.size() != serial_nodes.size() || node_faces != serial_node_faces) return false;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (!sameFloat3(nodes[i].bounding_box.max, serial_nodes[i].bounding_box.max) ||
+            !sameFloat3(nodes[i].bounding_box.min, serial_nodes[i].bounding_box.min) ||
+            nodes[i].child_cnt != serial_nodes[i].child_cnt || nodes[i].face_cnt != serial_nodes[i].face_cnt) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Builds the Octree of 'p_surface' with 'p_threads' threads and compares the
+ * tree and all queries with the serial Octree.
+ */
+void compareWithSerial(const TestSurface& p_surface, float p_min_dim, int p_threads) {
+    const float3 max = make_float3(20.0f);
+    const float3 min = make_float3(0.0f);
+    const float3 min_dim = make_float3(p_min_dim);
+    const std::vector<Ray> rays = randomRays(2001, 1);
+    const std::vector<vec4d> spheres = randomSpheres(1001, 2);
+
+    SerialOctree serial;
+    serial.Create(p_surface.faces, max, min, min_dim, p_surface.vertices);
+
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(p_threads);
+    Octree octree;
+    octree.CreateOctreeRootNode(p_surface.faces, max, min, min_dim, p_surface.vertices);
+    std::vector<int> results;
+    std::vector<uint> face_ids;
+    octree.IntersectOctree(p_surface.faces, rays, p_surface.vertices, results, face_ids);
+    std::vector<std::vector<uint>> spheres_faces;
+    octree.RadiusSearch(p_surface.faces, spheres, p_surface.vertices, spheres_faces);
+    omp_set_num_threads(maxThreads);
+
+    AssertTrue("The Octree is the same as the serial one", sameCUDAOctree(octree, serial));
+
+    bool sameFirst = true, sameClosest = true, sameBatched = (results.size() == rays.size());
+    size_t hits = 0;
+    for (size_t i = 0; i < rays.size(); i++) {
+        uint serial_face = 0, face = 0;
+        const int serial_result = serial.IntersectOctree(p_surface.faces, rays[i], p_surface.vertices, &serial_face);
+        const int result = octree.IntersectOctree(p_surface.faces, rays[i], p_surface.vertices, face);
+        sameFirst = sameFirst && (octree.IntersectOctree(p_surface.faces, rays[i], p_surface.vertices) ==
+                                     serial.IntersectOctree(p_surface.faces, rays[i], p_surface.vertices, nullptr));
+        sameClosest = sameClosest && (result == serial_result) && (result == -1 || face == serial_face);
+        sameBatched = sameBatched && (results[i] == serial_result) && (results[i] == -1 || face_ids[i] == serial_face);
+        hits += (serial_result != -1) ? 1 : 0;
+    }
+    AssertTrue("Some rays hit the surface", hits > rays.size() / 4);
+    AssertTrue("The first intersection is the same as the serial one", sameFirst);
+    AssertTrue("The closest intersection is the same as the serial one", sameClosest);
+    AssertTrue("The ray packets find the same intersections as the serial Octree", sameBatched);
+
+    bool sameRadius = true, sameBatchedRadius = (spheres_faces.size() == spheres.size());
+    std::vector<uint> found;
+    for (size_t i = 0; i < spheres.size(); i++) {
+        const std::vector<uint> expected = serial.RadiusSearch(p_surface.faces, spheres[i], p_surface.vertices);
+        const bool any = octree.RadiusSearch(p_surface.faces, spheres[i], p_surface.vertices, found);
+        sameRadius = sameRadius && (found == expected) && (any == !expected.empty());
+        sameBatchedRadius = sameBatchedRadius && (spheres_faces[i] == expected);
+    }
+    AssertTrue("The radius search finds the same faces as the serial one", sameRadius);
+    AssertTrue("The batched radius search finds the same faces as the serial one", sameBatchedRadius);
+}
+
+} // namespace
+
+
+void TestOctree(void) {
+    const TestSurface sphere(0, 1);
+    const TestSurface soup(6000, 2);
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        compareWithSerial(sphere, 0.5f, threads);
+        compareWithSerial(soup, 0.5f, threads);
+        compareWithSerial(soup, 2.0f, threads);
+    }
+    // a single leaf, the queries test every face
+    compareWithSerial(soup, 100.0f, 4);
+
+    // no faces at all
+    Octree octree;
+    const std::vector<uint> faces;
+    const std::vector<float> vertices;
+    octree.CreateOctreeRootNode(faces, make_float3(1.0f), make_float3(0.0f), make_float3(0.1f), vertices);
+    std::vector<CudaOctreeNode> nodes;
+    std::vector<std::vector<uint>> node_faces;
+    AssertEqual("An empty Octree has a root node", octree.ConvertToCUDAOctree(nodes, node_faces), size_t(1));
+    const std::vector<Ray> rays = randomRays(10, 3);
+    std::vector<int> results;
+    std::vector<uint> face_ids;
+    octree.IntersectOctree(faces, rays, vertices, results, face_ids);
+    AssertTrue("An empty Octree is never hit", results == std::vector<int>(rays.size(), -1));
+    std::vector<uint> found;
+    AssertFalse(
+        "An empty Octree finds nothing", octree.RadiusSearch(faces, vec4d(0.5, 0.5, 0.5, 2.0), vertices, found));
+}
@@ -0,0 +1,16 @@
+/*
+ * testoctree.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MOLECULARMAPSTEST_TESTOCTREE_H_INCLUDED
+#define MOLECULARMAPSTEST_TESTOCTREE_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+void TestOctree(void);
+
+#endif /* MOLECULARMAPSTEST_TESTOCTREE_H_INCLUDED */
@@ -7,6 +7,7 @@
 
 #include "stdafx.h"
 #include "AggregatedDensity.h"
+#include "MolecularTrajectory.h"
 #include "mmcore/AbstractGetData3DCall.h"
 #include <climits>
 #include <cfloat>
@@ -170,29 +171,43 @@ bool megamol::protein::AggregatedDensity::aggregate() {
 
 // this number must remain constant!
 	unsigned int n_atoms = mol->AtomCount();
-
-	float * pos0 = new float[mol->AtomCount() * 3];
-	float * vel  = new float[mol->AtomCount() * 3];
-	memcpy( pos0, mol->AtomPositions(), mol->AtomCount() * 3 * sizeof( float));
-
-	for (unsigned int frame=0; frame < mol->FrameCount(); frame++) {
-		mol->SetFrameID(frame);
-		if (!(*mol)(megamol::protein_calls::MolecularDataCall::CallForGetData)) return false;
-		if (mol->AtomCount()!=n_atoms) {
-			delete[] pos0, vel;
-			return false;
-		}
-    	const float* pos_new = mol->AtomPositions();
-
+	unsigned int n_frames = mol->FrameCount();
+	unsigned int n_bins = xbins*ybins*zbins;
+	mol->Unlock();
+
+	// frames are loaded in order, so the loader can difference consecutive frames
+	struct Frame {
+		std::vector<float> pos, vel;
+	};
+	std::vector<float> pos0;
+	if (!LoadAtomPositions(*mol, 0, n_atoms, pos0)) return false;
+	auto load = [&](unsigned int frame, Frame& f) {
+		if (!LoadAtomPositions(*mol, frame, n_atoms, f.pos)) return false;
+		f.vel.resize(3*n_atoms);
 		for (unsigned int i = 0; i<3*n_atoms; i++) {
-			vel[i] =  pos_new[i] - pos0[i];
+			f.vel[i] = f.pos[i] - pos0[i];
 		}
-		memcpy( pos0, mol->AtomPositions(), mol->AtomCount() * 3 * sizeof( float));
-        this->aggregate_frame(pos0, vel, n_atoms);
-        framecounter++;
+		pos0 = f.pos;
+		return true;
+	};
+	// a single worker adds the frames while the calling thread loads the next one, the worker itself splats
+	// in parallel straight into the bins, so there are no per-thread copies of them
+	auto accumulate = [&](unsigned int, const Frame& f, unsigned int& frames) {
+		this->aggregate_frame(f.pos.data(), f.vel.data(), n_atoms, this->density, this->velocity);
+		frames++;
+	};
+	auto merge = [](unsigned int& result, const unsigned int& partial) {
+		result += partial;
+	};
+	core::utility::TrajectoryReducer<Frame, unsigned int> reducer(1);
+	reducer.SetProgressCallback(LogTrajectoryProgress("AggregatedDensity", 100));
+	unsigned int frames = 0;
+	if (reducer.Run(0, n_frames, load, accumulate, merge, 0u, frames) !=
+		core::utility::TrajectoryReducer<Frame, unsigned int>::Result::Finished) {
+		return false;
 	}
+	framecounter += frames;
 
-	delete[] pos0, vel;
     is_aggregated = true;
     float maxdensity=0;
     float minvelocity=FLT_MAX;
@@ -215,88 +230,52 @@ bool megamol::protein::AggregatedDensity::aggregate() {
     return true;
 }
 
-bool megamol::protein::AggregatedDensity::aggregate_frame(float* pos, float* vel, unsigned int n_atoms) {
-	float x, y, z, dx, dy, dz;
-	unsigned int X,Y,Z;
-	float weight;
-	unsigned int linear_index;
-	for (unsigned int i = 0; i<3*n_atoms; i++) {
-		x=(pos[3*i+0]-origin_x)/res; // in lattice constants
-		X=static_cast<unsigned int>(floor(x));
-		dx=x-X;
-		y=(pos[3*i+1]-origin_y)/res; // in lattice constants
-		Y=static_cast<unsigned int>(floor(y));
-		dy=y-Y;
-		z=(pos[3*i+2]-origin_z)/res; // in lattice constants
-		Z=static_cast<unsigned int>(floor(z));
-		dz=z-Z;
-
-		if (X>0 && X<xbins-1 && Y>0 && Y<ybins-1 && Z>0 && Z<zbins-1  ) {
-          //weight=1;
-          //density[X+xbins*Y+xbins*ybins*Z]+=weight;
-  		  weight=(1-dx)*(1-dy)*(1-dz);
-          linear_index = (X+0) + (Y+0)*xbins + (Z+0)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-		  weight=(1-dx)*(1-dy)*(dz);
-          linear_index = (X+0) + (Y+0)*xbins + (Z+1)*xbins*ybins;
-		  		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-		  
-		  weight=(1-dx)*(dy)*(1-dz);
-          linear_index = (X+0) + (Y+1)*xbins + (Z+0)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-		  weight=(1-dx)*(dy)*(dz);
-          linear_index = (X+0) + (Y+1)*xbins + (Z+1)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-		  weight=(dx)*(1-dy)*(1-dz);
-          linear_index = (X+1) + (Y+0)*xbins + (Z+0)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-		  weight=(dx)*(1-dy)*(dz);
-          linear_index = (X+1) + (Y+0)*xbins + (Z+1)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-		  
-		  weight=(dx)*(dy)*(1-dz);
-          linear_index = (X+1) + (Y+1)*xbins + (Z+0)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-		  weight=(dx)*(dy)*(dz);
-          linear_index = (X+1) + (Y+1)*xbins + (Z+1)*xbins*ybins;
-		  density[linear_index]+=weight;
-		  velocity[3*linear_index+0]+=weight*vel[3*i+0];
-		  velocity[3*linear_index+1]+=weight*vel[3*i+1];
-		  velocity[3*linear_index+2]+=weight*vel[3*i+2];
-
-
-
+bool megamol::protein::AggregatedDensity::aggregate_frame(
+	const float* pos, const float* vel, unsigned int n_atoms, float* density, float* velocity) {
+	// every thread owns a range of z slices and only adds the corners falling into it. Each bin thus
+	// receives the atoms in order, like in serial, without atomics or per-thread copies of the bins.
+#pragma omp parallel
+	{
+		const unsigned int n_threads = static_cast<unsigned int>(omp_get_num_threads());
+		const unsigned int thread = static_cast<unsigned int>(omp_get_thread_num());
+		const unsigned int z_begin = static_cast<unsigned int>(static_cast<unsigned long long>(zbins) * thread / n_threads);
+		const unsigned int z_end = static_cast<unsigned int>(static_cast<unsigned long long>(zbins) * (thread + 1) / n_threads);
+
+		float x, y, z, dx, dy, dz;
+		unsigned int X,Y,Z;
+		float weight;
+		unsigned int linear_index;
+		for (unsigned int i = 0; i<n_atoms; i++) {
+			z=(pos[3*i+2]-origin_z)/res; // in lattice constants
+			Z=static_cast<unsigned int>(floor(z));
+			if (Z+1<z_begin || Z>=z_end) continue;
+			dz=z-Z;
+			x=(pos[3*i+0]-origin_x)/res; // in lattice constants
+			X=static_cast<unsigned int>(floor(x));
+			dx=x-X;
+			y=(pos[3*i+1]-origin_y)/res; // in lattice constants
+			Y=static_cast<unsigned int>(floor(y));
+			dy=y-Y;
+
+			if (X>0 && X<xbins-1 && Y>0 && Y<ybins-1 && Z>0 && Z<zbins-1  ) {
+				for (unsigned int cz = 0; cz < 2; cz++) {
+					if (Z+cz<z_begin || Z+cz>=z_end) continue;
+					const float wz = cz ? dz : (1-dz);
+					for (unsigned int cy = 0; cy < 2; cy++) {
+						const float wy = cy ? dy : (1-dy);
+						for (unsigned int cx = 0; cx < 2; cx++) {
+							const float wx = cx ? dx : (1-dx);
+							weight=wx*wy*wz;
+							linear_index = (X+cx) + (Y+cy)*xbins + (Z+cz)*xbins*ybins;
+							density[linear_index]+=weight;
+							velocity[3*linear_index+0]+=weight*vel[3*i+0];
+							velocity[3*linear_index+1]+=weight*vel[3*i+1];
+							velocity[3*linear_index+2]+=weight*vel[3*i+2];
+						}
+					}
+				}
+			}
 		}
-
-
-
-
 	}
 	return true;
 }
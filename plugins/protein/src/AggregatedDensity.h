@@ -62,7 +62,7 @@ class AggregatedDensity : public megamol::core::Module {
     protected:
 
 		bool aggregate();
-		bool aggregate_frame(float* pos, float* vel, unsigned int n_atoms);
+		bool aggregate_frame(const float* pos, const float* vel, unsigned int n_atoms, float* density, float* velocity);
 
         /**
          * Implementation of 'Create'.
@@ -7,7 +7,6 @@
 
 #include "stdafx.h"
 #include "HydroBondFilter.h"
-#include "GridNeighbourFinder.h"
 
 #include "protein_calls/MolecularDataCall.h"
 
@@ -227,7 +226,8 @@ bool HydroBondFilter::isValidHBond(unsigned int donorIndex, unsigned int accepto
 	vislib::math::Vector<float, 3> DToA(acceptorPos - donorPos);
 
 	// the distance between acceptor and donator has to be below a threshold 
-	return DToA.Length() <= this->hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
+	const float maxDist = this->hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
+	return DToA.SquareLength() <= maxDist * maxDist;
 }
 
 /*
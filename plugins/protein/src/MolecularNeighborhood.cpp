@@ -13,7 +13,6 @@
 #include "vislib/math/Point.h"
 #include "mmcore/utility/log/Log.h"
 
-#include "GridNeighbourFinder.h"
 
 #include <iostream>
 #include <chrono>
@@ -132,16 +131,16 @@ bool MolecularNeighborhood::getExtent(core::Call& call) {
  *	MolecularNeighborhood::findNeighborhoods
  */
 void MolecularNeighborhood::findNeighborhoods(MolecularDataCall& call, float radius) {
-	GridNeighbourFinder<float> finder;
-	finder.SetPointData(call.AtomPositions(), call.AtomCount(), call.AccessBoundingBoxes().ObjectSpaceBBox(), radius);
+	this->finder.Build(call.AtomPositions(), call.AtomCount(), call.AccessBoundingBoxes().ObjectSpaceBBox(), radius);
 	neighborhood.clear();
 	neighborhood.resize(call.AtomCount());
 	neighborhoodSizes.clear();
 	neighborhoodSizes.resize(call.AtomCount());
 	dataPointers.clear();
 	dataPointers.resize(call.AtomCount());
-	for (unsigned int i = 0; i < call.AtomCount(); i++) {
-		finder.FindNeighboursInRange(&call.AtomPositions()[i * 3], radius, neighborhood[i]);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < static_cast<int>(call.AtomCount()); i++) {
+		this->finder.FindNeighboursInRange(&call.AtomPositions()[i * 3], radius, neighborhood[i]);
 		neighborhoodSizes[i] = static_cast<unsigned int>(neighborhood[i].Count());
 		dataPointers[i] = neighborhood[i].PeekElements();
 	}
@@ -13,6 +13,7 @@
 #include "mmcore/CalleeSlot.h"
 #include "protein_calls/MolecularDataCall.h"
 #include "mmcore/param/ParamSlot.h"
+#include "NeighbourCellList.h"
 #include <vector>
 
 namespace megamol {
@@ -103,6 +104,9 @@ namespace protein {
 		/** The last data set hash that was sent to the render */
 		SIZE_T lastHashSent;
 
+		/** Cell list over the atom positions, kept across frames */
+		NeighbourCellList finder;
+
 		/** Vector containing the neighborhood for each atom as array of atom indices */
 		std::vector<vislib::Array<unsigned int>> neighborhood;
 
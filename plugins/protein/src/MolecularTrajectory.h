@@ -0,0 +1,71 @@
+/*
+ * MolecularTrajectory.h
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOLPROTEIN_MOLECULARTRAJECTORY_H_INCLUDED
+#define MEGAMOLPROTEIN_MOLECULARTRAJECTORY_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#    pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mmcore/utility/TrajectoryReducer.h"
+#include "mmcore/utility/log/Log.h"
+#include "protein_calls/MolecularDataCall.h"
+
+namespace megamol {
+namespace protein {
+
+/** Reducer over the atom positions of a MolecularDataCall trajectory */
+template <typename Partial>
+using AtomTrajectoryReducer = core::utility::TrajectoryReducer<std::vector<float>, Partial>;
+
+/**
+ * Copies the atom positions of one frame out of a MolecularDataCall. Meant as
+ * the load function of a TrajectoryReducer, which calls it from a single
+ * thread.
+ *
+ * @param mol       The call to load from.
+ * @param frameID   The frame to load.
+ * @param atomCount The expected number of atoms.
+ * @param positions Receives the positions (xyzxyz...).
+ *
+ * @return false if the frame could not be loaded or its atom count differs.
+ */
+inline bool LoadAtomPositions(protein_calls::MolecularDataCall& mol, unsigned int frameID, unsigned int atomCount,
+    std::vector<float>& positions) {
+    mol.SetFrameID(frameID, true);
+    if (!mol(protein_calls::MolecularDataCall::CallForGetData)) return false;
+    bool const ok = mol.AtomCount() == atomCount;
+    if (ok) {
+        positions.assign(mol.AtomPositions(), mol.AtomPositions() + static_cast<size_t>(atomCount) * 3);
+    }
+    mol.Unlock();
+    return ok;
+}
+
+/**
+ * Answers a progress callback logging every 'step' frames.
+ */
+inline std::function<bool(unsigned int, unsigned int)> LogTrajectoryProgress(const char* what, unsigned int step) {
+    auto next = std::make_shared<unsigned int>(0);
+    return [what, step, next](unsigned int done, unsigned int count) {
+        if (done >= *next) {
+            core::utility::log::Log::DefaultLog.WriteInfo("%s: %u of %u frames", what, done, count);
+            *next = done + std::max(step, 1u);
+        }
+        return true;
+    };
+}
+
+} // namespace protein
+} // namespace megamol
+
+#endif /* MEGAMOLPROTEIN_MOLECULARTRAJECTORY_H_INCLUDED */
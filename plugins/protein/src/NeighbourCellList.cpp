@@ -0,0 +1,112 @@
+/*
+ * NeighbourCellList.cpp
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "stdafx.h"
+#include "NeighbourCellList.h"
+
+#include <cstdint>
+
+using namespace megamol;
+using namespace megamol::protein;
+
+namespace {
+/** Upper bound for the number of cells of very sparse or degenerate point sets */
+constexpr uint64_t maxCellCount = 1 << 24;
+} // namespace
+
+/*
+ * NeighbourCellList::NeighbourCellList
+ */
+NeighbourCellList::NeighbourCellList(void) : requestedCellSize(0.0f), resorted(false) {
+    for (int i = 0; i < 3; ++i) {
+        this->origin[i] = 0.0f;
+        this->invCellSize[i] = 0.0f;
+        this->resolution[i] = 0;
+    }
+}
+
+/*
+ * NeighbourCellList::Build
+ */
+void NeighbourCellList::Build(const float* positions, unsigned int count,
+    const vislib::math::Cuboid<float>& boundingBox, float cellSize, const int* filter) {
+    bool geometryChanged = this->cellStart.empty() || cellSize != this->requestedCellSize ||
+                           !(this->bbox.Contains(boundingBox.GetLeftBottomBack(), -1) &&
+                               this->bbox.Contains(boundingBox.GetRightTopFront(), -1));
+
+    if (geometryChanged) {
+        this->bbox = boundingBox;
+        this->requestedCellSize = cellSize;
+        auto const dim = this->bbox.GetSize();
+        float edge = std::max(cellSize, 1.0e-6f);
+        uint64_t cells = 0;
+        do {
+            cells = 1;
+            for (int i = 0; i < 3; ++i) {
+                this->resolution[i] = std::max(1u, static_cast<unsigned int>(std::floor(dim[i] / edge)));
+                cells *= this->resolution[i];
+            }
+            edge *= 2.0f;
+        } while (cells > maxCellCount);
+        auto const bboxOrigin = this->bbox.GetOrigin();
+        for (int i = 0; i < 3; ++i) {
+            this->origin[i] = bboxOrigin[i];
+            this->invCellSize[i] = dim[i] > 0.0f ? static_cast<float>(this->resolution[i]) / dim[i] : 0.0f;
+        }
+        this->cellStart.assign(static_cast<size_t>(cells) + 1, 0);
+    }
+
+    // assign the points to cells and check whether any of them moved to another cell
+    bool const sameCount = this->cellOfPoint.size() == count;
+    this->cellOfPoint.resize(count);
+    int changed = (geometryChanged || !sameCount) ? 1 : 0;
+    int* cellOfPointPtr = this->cellOfPoint.data();
+#pragma omp parallel for reduction(| : changed)
+    for (int i = 0; i < static_cast<int>(count); ++i) {
+        int cell = -1;
+        if (filter == nullptr || filter[i] != -1) {
+            const float* p = &positions[static_cast<size_t>(i) * 3];
+            cell = static_cast<int>(this->cellIndex(this->clampCell(0, (p[0] - this->origin[0]) * this->invCellSize[0]),
+                this->clampCell(1, (p[1] - this->origin[1]) * this->invCellSize[1]),
+                this->clampCell(2, (p[2] - this->origin[2]) * this->invCellSize[2])));
+        }
+        if (cellOfPointPtr[i] != cell) {
+            cellOfPointPtr[i] = cell;
+            changed |= 1;
+        }
+    }
+
+    this->resorted = changed != 0;
+    if (this->resorted) {
+        // counting sort by cell, stable in point order
+        std::fill(this->cellStart.begin(), this->cellStart.end(), 0);
+        for (unsigned int i = 0; i < count; ++i) {
+            if (this->cellOfPoint[i] >= 0) ++this->cellStart[this->cellOfPoint[i] + 1];
+        }
+        for (size_t c = 1; c < this->cellStart.size(); ++c) {
+            this->cellStart[c] += this->cellStart[c - 1];
+        }
+        this->sortedIndex.resize(this->cellStart.back());
+        std::vector<unsigned int> cursor(this->cellStart.begin(), this->cellStart.end() - 1);
+        for (unsigned int i = 0; i < count; ++i) {
+            if (this->cellOfPoint[i] >= 0) this->sortedIndex[cursor[this->cellOfPoint[i]]++] = i;
+        }
+        this->sortedX.resize(this->sortedIndex.size());
+        this->sortedY.resize(this->sortedIndex.size());
+        this->sortedZ.resize(this->sortedIndex.size());
+    }
+
+    // refresh the coordinate copies
+    auto const sortedCount = static_cast<int>(this->sortedIndex.size());
+#pragma omp parallel for
+    for (int j = 0; j < sortedCount; ++j) {
+        const float* p = &positions[static_cast<size_t>(this->sortedIndex[j]) * 3];
+        this->sortedX[j] = p[0];
+        this->sortedY[j] = p[1];
+        this->sortedZ[j] = p[2];
+    }
+}
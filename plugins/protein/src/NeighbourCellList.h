@@ -0,0 +1,135 @@
+/*
+ * NeighbourCellList.h
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOLPROTEIN_NEIGHBOURCELLLIST_H_INCLUDED
+#define MEGAMOLPROTEIN_NEIGHBOURCELLLIST_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#    pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "vislib/Array.h"
+#include "vislib/math/Cuboid.h"
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Fixed-radius neighbour search on a regular grid of cells.
+ *
+ * All points are counting-sorted by cell into one contiguous index array with
+ * per-cell offsets, their coordinates are copied into separate x, y and z
+ * arrays in the same order. As cells along x are adjacent in memory, a query
+ * tests one contiguous run of points per (y, z) row of its stencil.
+ *
+ * Rebuilding for the next frame of a trajectory keeps the grid if the
+ * bounding box still fits, and if no point changed its cell only the
+ * coordinates are refreshed.
+ */
+class NeighbourCellList {
+public:
+    NeighbourCellList(void);
+
+    /**
+     * Sorts the points into the grid.
+     *
+     * @param positions   Point coordinates (xyzxyz...).
+     * @param count       The number of points.
+     * @param boundingBox Box containing all points, points outside are clamped to the border cells.
+     * @param cellSize    Minimal edge length of the cells, usually the search distance.
+     * @param filter      Optional, points with filter[i] == -1 are left out.
+     */
+    void Build(const float* positions, unsigned int count, const vislib::math::Cuboid<float>& boundingBox,
+        float cellSize, const int* filter = nullptr);
+
+    /**
+     * Calls fn(index) for every point within 'distance' of 'point'.
+     */
+    template <typename Fn>
+    inline void ForEachNeighbour(const float* point, float distance, Fn&& fn) const {
+        if (this->cellStart.empty()) return;
+        int lo[3], hi[3];
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = this->clampCell(i, (point[i] - distance - this->origin[i]) * this->invCellSize[i]);
+            hi[i] = this->clampCell(i, (point[i] + distance - this->origin[i]) * this->invCellSize[i]);
+        }
+        float const px = point[0];
+        float const py = point[1];
+        float const pz = point[2];
+        float const dist2 = distance * distance;
+        const float* xs = this->sortedX.data();
+        const float* ys = this->sortedY.data();
+        const float* zs = this->sortedZ.data();
+        for (int z = lo[2]; z <= hi[2]; ++z) {
+            for (int y = lo[1]; y <= hi[1]; ++y) {
+                // the cells lo[0]..hi[0] of this row hold one contiguous run of points
+                unsigned int const row = this->cellIndex(0, y, z);
+                unsigned int const begin = this->cellStart[row + lo[0]];
+                unsigned int const end = this->cellStart[row + hi[0] + 1];
+                for (unsigned int j = begin; j < end; ++j) {
+                    float const dx = xs[j] - px;
+                    float const dy = ys[j] - py;
+                    float const dz = zs[j] - pz;
+                    if (dx * dx + dy * dy + dz * dz <= dist2) fn(this->sortedIndex[j]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Appends the indices of all points within 'distance' of 'point' to 'resIdx'.
+     */
+    void FindNeighboursInRange(const float* point, float distance, vislib::Array<unsigned int>& resIdx) const {
+        this->ForEachNeighbour(point, distance, [&resIdx](unsigned int idx) { resIdx.Add(idx); });
+    }
+
+    /** Answer whether the last Build had to re-sort the points */
+    inline bool WasResorted(void) const {
+        return this->resorted;
+    }
+
+private:
+    inline unsigned int cellIndex(int x, int y, int z) const {
+        return static_cast<unsigned int>(x) +
+               (static_cast<unsigned int>(y) + static_cast<unsigned int>(z) * this->resolution[1]) *
+                   this->resolution[0];
+    }
+
+    inline int clampCell(int axis, float rel) const {
+        int const c = static_cast<int>(std::floor(rel));
+        return std::min(std::max(c, 0), static_cast<int>(this->resolution[axis]) - 1);
+    }
+
+    /** Grid geometry */
+    vislib::math::Cuboid<float> bbox;
+    float requestedCellSize;
+    float origin[3];
+    float invCellSize[3];
+    unsigned int resolution[3];
+
+    /** Cell of every input point, -1 for filtered points */
+    std::vector<int> cellOfPoint;
+
+    /** First sorted entry of every cell, one additional entry marks the end */
+    std::vector<unsigned int> cellStart;
+
+    /** Point indices sorted by cell */
+    std::vector<unsigned int> sortedIndex;
+
+    /** Coordinates in the order of 'sortedIndex' */
+    std::vector<float> sortedX, sortedY, sortedZ;
+
+    bool resorted;
+};
+
+} // namespace protein
+} // namespace megamol
+
+#endif /* MEGAMOLPROTEIN_NEIGHBOURCELLLIST_H_INCLUDED */
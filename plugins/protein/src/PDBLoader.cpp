@@ -761,9 +761,10 @@ PDBLoader::PDBLoader(void) : AnimDataModule(),
         calcBBoxPerFrameSlot("calcBBoxPerFrame", "Calculate the bounding box for each frame separately"),
         calcBondsSlot("calculateBonds", "Calculate covalent bonds when loading the file"),
 		recomputeStridePerFrameSlot( "recomputeSTRIDEeachFrame", "If STRIDE is used, should it be recomputed each frame?"),
+		strideCacheSizeSlot( "STRIDEcacheSize", "Memory in MB for the STRIDE results of recently used frames"),
         bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f),
         datahash(0),
-        stride( 0), secStructAvailable( false), numXTCFrames( 0),
+        secStructAvailable( false), numXTCFrames( 0),
         XTCFrameOffset( 0), xtcFileValid(false) {
 
     this->pdbFilenameSlot << new param::FilePathParam("");
@@ -800,6 +801,9 @@ PDBLoader::PDBLoader(void) : AnimDataModule(),
 	this->recomputeStridePerFrameSlot << new param::BoolParam(false);
 	this->MakeSlotAvailable(&this->recomputeStridePerFrameSlot);
 
+	this->strideCacheSizeSlot << new param::IntParam(64, 0);
+	this->MakeSlotAvailable(&this->strideCacheSizeSlot);
+
     mdd = NULL; // no mdd object
 }
 
@@ -970,15 +974,19 @@ bool PDBLoader::getData( core::Call& call) {
     dc->SetChains( static_cast<unsigned int>(this->chain.Count()),
         (MolecularDataCall::Chain*)this->chain.PeekElements());
 
-    if( (!this->secStructAvailable || this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value() )  && this->strideFlagSlot.Param<param::BoolParam>()->Value() ) {
+    if( this->strideFlagSlot.Param<param::BoolParam>()->Value() ) {
+        // without per-frame recomputation the structure of the first requested frame is kept
+        bool perFrame = this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value();
+        if( this->strideCacheSizeSlot.IsDirty() ) {
+            this->strideCacheSizeSlot.ResetDirty();
+            this->strideCache.SetCapacity( static_cast<size_t>( this->strideCacheSizeSlot.Param<param::IntParam>()->Value()) << 20);
+        }
         time_t t = clock(); // DEBUG
-        if( this->stride ) delete this->stride;
-        this->stride = new Stride( dc );
-        this->stride->WriteToInterface( dc);
+        this->strideCache.WriteToInterface( dc, perFrame ? dc->FrameID() : 0, perFrame);
         this->secStructAvailable = true;
-        Log::DefaultLog.WriteMsg( Log::LEVEL_INFO, "Secondary Structure computed via STRIDE in %f seconds.", ( double( clock() - t) / double( CLOCKS_PER_SEC))); // DEBUG
-    } else if( this->strideFlagSlot.Param<param::BoolParam>()->Value() ) {
-        this->stride->WriteToInterface( dc);
+        if( this->strideCache.LastCallComputed() ) {
+            Log::DefaultLog.WriteMsg( Log::LEVEL_INFO, "Secondary Structure computed via STRIDE in %f seconds.", ( double( clock() - t) / double( CLOCKS_PER_SEC))); // DEBUG
+        }
     }
 
     // Set the filter array for the molecular data call
@@ -1051,8 +1059,6 @@ void PDBLoader::release(void) {
 	for (int i = 0; i < (int)this->residue.Count(); i++)
         delete residue[i];
     this->residue.Clear();
-
-    delete stride;
 }
 
 
@@ -2071,8 +2077,7 @@ void PDBLoader::resetAllData() {
     this->molecule.Clear();
     this->chain.Clear();
     this->connectivity.Clear();
-    delete stride;
-    this->stride = 0;
+    this->strideCache.Clear();
     secStructAvailable = false;
     this->chainFirstRes.Clear();
     this->chainResCount.Clear();
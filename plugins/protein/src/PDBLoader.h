@@ -21,6 +21,7 @@
 #include "protein_calls/MolecularDataCall.h"
 #include "ForceDataCall.h"
 #include "Stride.h"
+#include "StrideCache.h"
 #include "mmcore/view/AnimDataModule.h"
 #include "MDDriverConnector.h"
 #include <fstream>
@@ -653,6 +654,8 @@ namespace protein {
         core::param::ParamSlot calcBondsSlot;
 		/** Determine whether to recompute STRIDE each frame */
 		core::param::ParamSlot recomputeStridePerFrameSlot;
+		/** The memory for cached per-frame STRIDE results in MB */
+		core::param::ParamSlot strideCacheSizeSlot;
 
         /** The data */
         vislib::Array<Frame*> data;
@@ -706,8 +709,8 @@ namespace protein {
         /** Stores the current molecule count while loading */
         unsigned int molIdx;
 
-        /** Stride secondary structure computation */
-        Stride *stride;
+        /** Stride secondary structure per frame */
+        StrideCache strideCache;
         /** Flag whether secondary structure is available */
         bool secStructAvailable;
 
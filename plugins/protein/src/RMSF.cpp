@@ -1,9 +1,8 @@
 #include "stdafx.h"
 #include "protein/RMSF.h"
+#include "MolecularTrajectory.h"
 #include <cmath>
 #include "mmcore/utility/log/Log.h"
-#include "vislib/Array.h"
-#include "vislib/math/ShallowVector.h"
 #include <fstream>
 #include <cfloat>
 #include <climits>
@@ -28,62 +27,60 @@ bool megamol::protein::computeRMSF(protein_calls::MolecularDataCall *mol) {
 
 	// no frames available -> false
 	if (mol->FrameCount() < 2) return false;
-	
-	// allocate mem
-	vislib::Array<float> meanPos;
-	meanPos.SetCount(mol->AtomCount() * 3);
-	float *rmsf;
-	rmsf = new float[mol->AtomCount()];
-	// initialize rmsf to zero
-	for (unsigned int i = 0; i < mol->AtomCount(); i++) {
-		rmsf[i] = 0;
-	}
 
-	// get atom pos of first frame
-	for (unsigned int atomIdx = 0; atomIdx < mol->AtomCount(); atomIdx++) {
-		meanPos[atomIdx * 3 + 0] = mol->AtomPositions()[atomIdx * 3 + 0];
-		meanPos[atomIdx * 3 + 1] = mol->AtomPositions()[atomIdx * 3 + 1];
-		meanPos[atomIdx * 3 + 2] = mol->AtomPositions()[atomIdx * 3 + 2];
-	}
+	const unsigned int atomCount = mol->AtomCount();
+	const unsigned int frameCount = mol->FrameCount();
+	mol->Unlock();
+
+	// frames are loaded sequentially while the previous ones are accumulated in parallel
+	AtomTrajectoryReducer<std::vector<float>> reducer;
+	reducer.SetProgressCallback(LogTrajectoryProgress("RMSF", 100));
+	auto load = [mol, atomCount](unsigned int frameID, std::vector<float>& pos) {
+		return LoadAtomPositions(*mol, frameID, atomCount, pos);
+	};
+	auto add = [](std::vector<float>& result, const std::vector<float>& partial) {
+		for (size_t i = 0; i < result.size(); i++) {
+			result[i] += partial[i];
+		}
+	};
 
 	// sum up all atom positions
-	for (unsigned int i = 1; i < mol->FrameCount(); i++) {
-		// load frame
-		mol->SetFrameID(i, true);
-		if (!(*mol)(MolecularDataCall::CallForGetData)) return false;
-		// add atom pos
-		for (unsigned int atomIdx = 0; atomIdx < mol->AtomCount(); atomIdx++) {
-			meanPos[atomIdx*3+0] += mol->AtomPositions()[atomIdx*3+0];
-			meanPos[atomIdx*3+1] += mol->AtomPositions()[atomIdx*3+1];
-			meanPos[atomIdx*3+2] += mol->AtomPositions()[atomIdx*3+2];
+	std::vector<float> meanPos;
+	auto sumPos = [](unsigned int, const std::vector<float>& pos, std::vector<float>& sum) {
+		for (size_t i = 0; i < pos.size(); i++) {
+			sum[i] += pos[i];
 		}
+	};
+	if (reducer.Run(0, frameCount, load, sumPos, add, std::vector<float>(atomCount * 3, 0.0f), meanPos) !=
+		AtomTrajectoryReducer<std::vector<float>>::Result::Finished) {
+		return false;
 	}
 	// compute average pos
-	for (unsigned int i = 0; i < meanPos.Count(); i++) {
-		meanPos[i] /= static_cast<float>(mol->FrameCount());
+	for (unsigned int i = 0; i < meanPos.size(); i++) {
+		meanPos[i] /= static_cast<float>(frameCount);
 	}
 
 	// compute RMSF
-	vislib::math::Vector<float, 3> tmpVec;
-	float len;
-	for (unsigned int i = 0; i < mol->FrameCount(); i++) {
-		// load frame
-		mol->SetFrameID(i, true);
-		if (!(*mol)(MolecularDataCall::CallForGetData)) return false;
+	std::vector<float> sqDev;
+	auto sumSqDev = [&meanPos](unsigned int, const std::vector<float>& pos, std::vector<float>& dev) {
 		// get deviation from mean pos for current atom pos
-		for (unsigned int atomIdx = 0; atomIdx < mol->AtomCount(); atomIdx++) {
-			 tmpVec.SetX( mol->AtomPositions()[atomIdx * 3 + 0] - meanPos[atomIdx * 3 + 0]);
-			 tmpVec.SetY( mol->AtomPositions()[atomIdx * 3 + 1] - meanPos[atomIdx * 3 + 1]);
-			 tmpVec.SetZ( mol->AtomPositions()[atomIdx * 3 + 2] - meanPos[atomIdx * 3 + 2]);
-			 len = tmpVec.Length();
-			 rmsf[atomIdx] += len * len;
+		for (size_t atomIdx = 0; atomIdx < dev.size(); atomIdx++) {
+			const float dx = pos[atomIdx * 3 + 0] - meanPos[atomIdx * 3 + 0];
+			const float dy = pos[atomIdx * 3 + 1] - meanPos[atomIdx * 3 + 1];
+			const float dz = pos[atomIdx * 3 + 2] - meanPos[atomIdx * 3 + 2];
+			dev[atomIdx] += dx * dx + dy * dy + dz * dz;
 		}
+	};
+	if (reducer.Run(0, frameCount, load, sumSqDev, add, std::vector<float>(atomCount, 0.0f), sqDev) !=
+		AtomTrajectoryReducer<std::vector<float>>::Result::Finished) {
+		return false;
 	}
 
-	// compute average pos
+	float *rmsf;
+	rmsf = new float[atomCount];
 	float minRMSF = FLT_MAX, maxRMSF = 0.0f;
-	for (unsigned int i = 0; i < mol->AtomCount(); i++) {
-		rmsf[i] = sqrtf( rmsf[i] / static_cast<float>(mol->FrameCount()));
+	for (unsigned int i = 0; i < atomCount; i++) {
+		rmsf[i] = sqrtf( sqDev[i] / static_cast<float>(frameCount));
 		minRMSF = rmsf[i] < minRMSF ? rmsf[i] : minRMSF;
 		maxRMSF = rmsf[i] > maxRMSF ? rmsf[i] : maxRMSF;
 	}
@@ -150,16 +150,11 @@ void ReducedSurface::ComputeReducedSurface() {
 	// set voxel lenght --> diameter of the probe + maximum atom diameter
 	this->voxelLength = 2 * this->probeRadius + 2 * 3.0f;
 	unsigned int tmpSize = (unsigned int)ceilf( this->bBox.Width() / this->voxelLength);
-	this->voxelMap.clear();
 	this->voxelMapProbes.clear();
-	this->voxelMap.resize( tmpSize);
 	this->voxelMapProbes.resize( tmpSize);
-	for( cnt1 = 0; cnt1 < this->voxelMap.size(); ++cnt1 ) {
-		this->voxelMap[cnt1].resize( (unsigned int)ceilf( this->bBox.Height() / this->voxelLength) );
+	for( cnt1 = 0; cnt1 < this->voxelMapProbes.size(); ++cnt1 ) {
 		this->voxelMapProbes[cnt1].resize( (unsigned int)ceilf( this->bBox.Height() / this->voxelLength) );
-		for( cnt2 = 0; cnt2 < this->voxelMap[cnt1].size(); ++cnt2 ) {
-			this->voxelMap[cnt1][cnt2].resize(
-				(unsigned int)ceilf( this->bBox.Depth() / this->voxelLength) );
+		for( cnt2 = 0; cnt2 < this->voxelMapProbes[cnt1].size(); ++cnt2 ) {
 			this->voxelMapProbes[cnt1][cnt2].resize(
 				(unsigned int)ceilf( this->bBox.Depth() / this->voxelLength) );
 		}
@@ -169,6 +164,7 @@ void ReducedSurface::ComputeReducedSurface() {
 	t = clock();
 	
 	// get all molecule atom positions
+	this->maxAtomRadius = 0.0f;
 	for( cnt1 = firstAtomIdx; cnt1 < ( firstAtomIdx + numberOfAtoms); ++cnt1 ) {
 		// get position of current atom
         tmpVec1.SetX( this->atoms[4*cnt1+0]);
@@ -180,19 +176,10 @@ void ReducedSurface::ComputeReducedSurface() {
 
 		// add new RS-vertex to the list
 		this->rsVertex.push_back( new RSVertex( tmpVec1, radius, cnt1));
-		
-		// add RS-vertex to voxel map cell
-		this->voxelMap[(unsigned int)std::min( (unsigned int)this->voxelMap.size()-1,
-				(unsigned int)std::max( 0, (int)floorf( (tmpVec1.GetX() - bBox.Left()) / voxelLength)))]
-			[(unsigned int)std::min( (unsigned int)this->voxelMap[0].size()-1,
-				(unsigned int)std::max( 0, (int)floorf( (tmpVec1.GetY() - bBox.Bottom()) / voxelLength)))]
-			[(unsigned int)std::min( (unsigned int)this->voxelMap[0][0].size()-1,
-				(unsigned int)std::max( 0,
-				(int)floorf( (tmpVec1.GetZ() - bBox.Back()) / voxelLength)))].push_back(
-			this->rsVertex.back());
+		this->maxAtomRadius = std::max( this->maxAtomRadius, radius);
 		// if this is the first atom OR the x-value is larger than the current smallest x
 		// --> store cnt as xIdx
-		if( this->rsVertex.size() > 0 ||
+		if( this->rsVertex.size() == 1 ||
 			( this->rsVertex[xIdx]->GetPosition().GetX() - this->rsVertex[xIdx]->GetRadius()) >
 			( this->rsVertex.back()->GetPosition().GetX() - this->rsVertex.back()->GetRadius()) )
 		{
@@ -200,7 +187,7 @@ void ReducedSurface::ComputeReducedSurface() {
 		}
 		// if this is the first atom OR the y-value is larger than the current smallest y
 		// --> store cnt as yIdx
-		if( this->rsVertex.size() > 0 ||
+		if( this->rsVertex.size() == 1 ||
 			( this->rsVertex[yIdx]->GetPosition().GetY() - this->rsVertex[yIdx]->GetRadius()) >
 			( this->rsVertex.back()->GetPosition().GetY() - this->rsVertex.back()->GetRadius()) )
 		{
@@ -208,7 +195,7 @@ void ReducedSurface::ComputeReducedSurface() {
 		}
 		// if this is the first atom OR the z-value is larger than the current smallest z
 		// --> store cnt as zIdx
-		if( this->rsVertex.size() > 0 ||
+		if( this->rsVertex.size() == 1 ||
 			( this->rsVertex[zIdx]->GetPosition().GetZ() - this->rsVertex[zIdx]->GetRadius()) >
 			( this->rsVertex.back()->GetPosition().GetZ() - this->rsVertex.back()->GetRadius()) )
 		{
@@ -216,6 +203,9 @@ void ReducedSurface::ComputeReducedSurface() {
 		}
 	}
 	
+	// sort all RS-vertices into the cell list for the vicinity search
+	this->BuildAtomGrid();
+
 	std::cout << "time for reading all atoms: " <<
 		( double( clock() - t) / double( CLOCKS_PER_SEC) ) << std::endl;
 	t = clock();
@@ -223,7 +213,7 @@ void ReducedSurface::ComputeReducedSurface() {
 	// DEBUG
     /*
     for( cnt1 = 0; cnt1 < this->rsVertex.size(); ++cnt1 ) {
-        this->ComputeVicinityVertex( this->rsVertex[cnt1]);
+        this->ComputeVicinityVertex( this->rsVertex[cnt1], this->vicinity);
         if( this->vicinity.size() > 100 )
             std::cout << "atom " << cnt1 << " vicinity size ------> " << this->vicinity.size() << std::endl;
         else if( this->vicinity.size() > 70 )
@@ -245,12 +235,7 @@ void ReducedSurface::ComputeReducedSurface() {
 	t = clock();
 	
 	// for each edge of the first RS-face: find neighbours
-	cnt1 = 0;
-	while( cnt1 < this->rsEdge.size() )
-	{
-		this->ComputeRSFace( cnt1);
-		cnt1++;
-	}
+	this->ComputeRSFaces( 0);
 	
 	// remove all RS-edges with only one face from the list of RS-edges
 	std::vector<RSEdge*> tmpRSEdge;
@@ -295,10 +280,11 @@ void ReducedSurface::ComputeSingularities()
 /*
 	time_t t = clock();
 */
-	unsigned int cnt1;
 	// check number of cutting probes per edge
-	countCutEdges = 0;
-	for( cnt1 = 0; cnt1 < this->rsEdge.size(); ++cnt1 )
+	const int edgeCount = static_cast<int>( this->rsEdge.size());
+	int cutEdges = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : cutEdges)
+	for( int cnt1 = 0; cnt1 < edgeCount; ++cnt1 )
 	{
 		// check cutting probes only for spindle tori
 		if( this->rsEdge[cnt1]->GetTorusRadius() < this->probeRadius )
@@ -306,7 +292,7 @@ void ReducedSurface::ComputeSingularities()
 			WriteProbesCutEdge( this->rsEdge[cnt1]);
 			if( this->rsEdge[cnt1]->cuttingProbes.size() > 0 )
 			{
-				countCutEdges++;
+				cutEdges++;
 			}
 		}
 		else
@@ -314,6 +300,7 @@ void ReducedSurface::ComputeSingularities()
 			this->rsEdge[cnt1]->cuttingProbes.clear();
 		}
 	}
+	countCutEdges = cutEdges;
 
 /*
 	std::cout << "Number of cutted edges: " << countCutEdges << " / " << this->rsEdge.size() << " " <<
@@ -336,6 +323,52 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 	// do nothing if the edge has both faces already set or if this is a free edge
 	if( edge->GetFace2() != NULL || edge->GetFace1() == NULL )
 		return;
+	if( this->candidates.empty() )
+		this->candidates.resize( 1);
+	this->FindRSFaceCandidate( edge, this->candidates[0]);
+	this->CommitRSFace( edge, this->candidates[0]);
+}
+
+
+/*
+ * find next faces for all edges, wave by wave
+ */
+void ReducedSurface::ComputeRSFaces( unsigned int firstEdgeIdx)
+{
+	size_t begin = firstEdgeIdx;
+	while( begin < this->rsEdge.size() )
+	{
+		// the current wave consists of all edges created so far
+		const size_t end = this->rsEdge.size();
+		const int count = static_cast<int>( end - begin);
+		if( this->candidates.size() < end - begin )
+			this->candidates.resize( end - begin);
+#pragma omp parallel for schedule(dynamic, 16) if(count > 32)
+		for( int i = 0; i < count; ++i )
+		{
+			RSEdge *edge = this->rsEdge[begin+i];
+			if( edge->GetFace2() != NULL || edge->GetFace1() == NULL )
+				continue;
+			this->FindRSFaceCandidate( edge, this->candidates[i]);
+		}
+		// commit in edge order, an edge may have been closed by an earlier commit of this wave
+		for( int i = 0; i < count; ++i )
+		{
+			RSEdge *edge = this->rsEdge[begin+i];
+			if( edge->GetFace2() != NULL || edge->GetFace1() == NULL )
+				continue;
+			this->CommitRSFace( edge, this->candidates[i]);
+		}
+		begin = end;
+	}
+}
+
+
+void ReducedSurface::FindRSFaceCandidate( RSEdge *edge, FaceCandidate &candidate) const
+{
+	std::vector<RSVertex*> &vicinity = candidate.vicinity;
+	candidate.stateChanges.clear();
+	candidate.vertex = NULL;
 	unsigned int cnt;
 	int result = -1;
 	// the angle between two faces
@@ -345,11 +378,11 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 	vislib::math::Vector<float, 3> ai = edge->GetVertex1()->GetPosition();
 	vislib::math::Vector<float, 3> aj = edge->GetVertex2()->GetPosition();
 	vislib::math::Vector<float, 3> pijk0 = edge->GetFace1()->GetProbeCenter();
-	vislib::math::Vector<float, 3> ak, uik, tik, tjk, uijk, utb, bijk, pijk1;
+	vislib::math::Vector<float, 3> ak, uik, tik, uijk, utb, bijk, pijk1;
 	RSVertex *ak0Vertex;
 	vislib::math::Vector<float, 3> ak0, uijk0, bijk0;
 	float rk0;
-	float dik, djk, rk, rik, rjk, wijk, hijk;
+	float dik, djk, rk, wijk, hijk;
 	// store the face's vertex which does not belong to the edge as vertex ak0
 	if( edge->GetFace1()->GetVertex1() != edge->GetVertex1() &&
 		edge->GetFace1()->GetVertex1() != edge->GetVertex2() )
@@ -376,9 +409,9 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 	vislib::math::Vector<float, 3> bijk0Dir, bijkDir, ak0Dir, akDir;
 
 	// search all atoms that are in the vicinity of this edge
-	this->ComputeVicinityEdge( edge);
+	this->ComputeVicinityEdge( edge, vicinity);
 	// do nothing if the edge has no vicinity
-	if( this->vicinity.empty() )
+	if( vicinity.empty() )
 		return;
 
 	// d of plane defined by uijk0, ai
@@ -404,10 +437,10 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 		dir1 = 1.0f;
 
 	// loop over all atoms which are in the vicinty
-	for( cnt = 0; cnt < this->vicinity.size(); ++cnt )
+	for( cnt = 0; cnt < vicinity.size(); ++cnt )
 	{
-		ak = this->vicinity[cnt]->GetPosition();
-		rk = this->vicinity[cnt]->GetRadius();
+		ak = vicinity[cnt]->GetPosition();
+		rk = vicinity[cnt]->GetRadius();
 		dik = ( ak - ai).Length();
 		djk = ( ak - aj).Length();
 		// continue, if one or more of the distances are too large
@@ -437,7 +470,7 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 		akDir = ak - tij;
 
 		// if the face is dual to the existing face of the edge:
-		if( ak0Vertex == this->vicinity[cnt] )
+		if( ak0Vertex == vicinity[cnt] )
 		{
 			// check if the normal is the inverted normal of ak0
 			if( ( uijk + uijk0).Length() < ( uijk - uijk0).Length() )
@@ -530,17 +563,17 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 		if( alpha < epsilon )
 		{
 			// set atom with greater angle as the current angle as buried
-			this->vicinity[cnt]->SetAtomBuried( true);
+			candidate.stateChanges.push_back( std::make_pair( vicinity[cnt], FaceCandidate::BURIED));
 		}
 		else if( alpha < angle )
 		{
 			if( result > -1 )
 			{
 				// set former atom with the smallest angle as buried
-				this->vicinity[result]->SetAtomBuried( true);
+				candidate.stateChanges.push_back( std::make_pair( vicinity[result], FaceCandidate::BURIED));
 			}
 			// set atom with the current smallest angle as not burried
-			this->vicinity[cnt]->SetAtomBuried( false);
+			candidate.stateChanges.push_back( std::make_pair( vicinity[cnt], FaceCandidate::NOT_BURIED));
 			angle = alpha;
 			factor = tmpFac;
 			result = cnt;
@@ -548,229 +581,267 @@ void ReducedSurface::ComputeRSFace( unsigned int edgeIdx)
 		else
 		{
 			// set atom with greater angle as the current angle as buried
-			this->vicinity[cnt]->SetAtomBuried( true);
+			candidate.stateChanges.push_back( std::make_pair( vicinity[cnt], FaceCandidate::BURIED));
 		}
 		// set vicinity atom as treated
-		this->vicinity[cnt]->SetTreated();
+		candidate.stateChanges.push_back( std::make_pair( vicinity[cnt], FaceCandidate::TREATED));
 	}
 
-	// compute values for the result
 	if( result >= 0 )
 	{
-		edge->SetRotationAngle( angle * factor );
-		ak = this->vicinity[result]->GetPosition();
-		rk = this->vicinity[result]->GetRadius();
-		dik = ( ak - ai).Length();
-		djk = ( ak - aj).Length();
-		uik = ( ak - ai)/dik;
-		//tik = 0.5f*( ai + ak) + 0.5f*( ak - ai) * ( pow( ri + rp, 2.0f) - pow( rk + rp, 2.0f))/pow( dik, 2.0f);
-		tik = 0.5f*( ai + ak) + 0.5f*( ak - ai) * ( ( ri + rp)*( ri + rp) - ( rk + rp)*( rk + rp))/( dik*dik);
-		//tjk = 0.5f*( aj + ak) + 0.5f*( ak - aj) * ( pow( rj + rp, 2.0f) - pow( rk + rp, 2.0f))/pow( djk, 2.0f);
-		tjk = 0.5f*( aj + ak) + 0.5f*( ak - aj) * ( ( rj + rp)*( rj + rp) - ( rk + rp)*( rk + rp))/( djk*djk);
-		//rik = 0.5f*pow( pow(ri + rk + 2.0f*rp, 2.0f) - pow( dik, 2.0f), 0.5f) * ( pow( pow( dik, 2.0f) - pow( ri - rk, 2.0f), 0.5f) / dik);
-		rik = 0.5f*pow( (ri + rk + 2.0f*rp)*(ri + rk + 2.0f*rp) - dik*dik, 0.5f) * ( pow( dik*dik - ( ri - rk)*( ri - rk), 0.5f) / dik);
-		//rjk = 0.5f*pow( pow(rj + rk + 2.0f*rp, 2.0f) - pow( djk, 2.0f), 0.5f) * ( pow( pow( djk, 2.0f) - pow( rj - rk, 2.0f), 0.5f) / djk);
-		rjk = 0.5f*pow( (rj + rk + 2.0f*rp)*(rj + rk + 2.0f*rp) - djk*djk, 0.5f) * ( pow( djk*djk - ( rj - rk)*( rj - rk), 0.5f) / djk);
-		wijk = acos( uij.Dot(uik) );
-		uijk = uij.Cross( uik) / sin( wijk);
-		utb = uijk.Cross( uij);
-		//bijk = tij + utb * ( uik.Dot( tik - tij)) * pow( sin( wijk), -1.0f);
-		bijk = tij + utb * ( uik.Dot( tik - tij) / sin( wijk));
-		//hijk = pow( pow( ri + rp, 2.0f) - pow( ( bijk - ai).Length(), 2.0f), 0.5f);
-		hijk = pow( ( ri + rp)*( ri + rp) - ( ( bijk - ai).Length())*(( bijk - ai).Length()), 0.5f);
-		pijk1 = bijk + uijk * hijk * factor;
-
-		// pointer to a dual face of the new face
-		RSFace *dualFace = NULL;
-		// store the attributes of the new face
-		std::vector<RSVertex*> vertsNewFace;
-		vertsNewFace.push_back( edge->GetVertex1());
-		if( edge->GetVertex2()->GetIndex() < edge->GetVertex1()->GetIndex() )
-			vertsNewFace.insert( vertsNewFace.begin(), edge->GetVertex2());
+		candidate.vertex = vicinity[result];
+		candidate.angle = angle;
+		candidate.factor = factor;
+	}
+}
+
+
+/*
+ * Apply the state changes of a candidate and add its face to the RS
+ */
+void ReducedSurface::CommitRSFace( RSEdge *edge, const FaceCandidate &candidate)
+{
+	// apply the changes of the RS-vertex states in the order they were found
+	for( auto &change : candidate.stateChanges )
+	{
+		if( change.second == FaceCandidate::TREATED )
+			change.first->SetTreated();
+		else
+			change.first->SetAtomBuried( change.second == FaceCandidate::BURIED);
+	}
+	if( candidate.vertex == NULL )
+		return;
+
+	unsigned int cnt;
+	const float angle = candidate.angle;
+	const float factor = candidate.factor;
+	RSVertex *vertex = candidate.vertex;
+	// names of the variables according to: Connolly "Analytical Molecular Surface Calculation", 1983
+	vislib::math::Vector<float, 3> ai = edge->GetVertex1()->GetPosition();
+	vislib::math::Vector<float, 3> aj = edge->GetVertex2()->GetPosition();
+	vislib::math::Vector<float, 3> ak, uik, tik, tjk, uijk, utb, bijk, pijk1;
+	float dik, djk, rk, rik, rjk, wijk, hijk;
+	float ri = edge->GetVertex1()->GetRadius();
+	float rj = edge->GetVertex2()->GetRadius();
+	float rp = this->probeRadius;
+	float dij = ( aj - ai).Length();
+	vislib::math::Vector<float, 3> uij = ( aj - ai)/dij;
+	vislib::math::Vector<float, 3> tij = edge->GetTorusCenter();
+
+	// compute values for the result
+	edge->SetRotationAngle( angle * factor );
+	ak = vertex->GetPosition();
+	rk = vertex->GetRadius();
+	dik = ( ak - ai).Length();
+	djk = ( ak - aj).Length();
+	uik = ( ak - ai)/dik;
+	//tik = 0.5f*( ai + ak) + 0.5f*( ak - ai) * ( pow( ri + rp, 2.0f) - pow( rk + rp, 2.0f))/pow( dik, 2.0f);
+	tik = 0.5f*( ai + ak) + 0.5f*( ak - ai) * ( ( ri + rp)*( ri + rp) - ( rk + rp)*( rk + rp))/( dik*dik);
+	//tjk = 0.5f*( aj + ak) + 0.5f*( ak - aj) * ( pow( rj + rp, 2.0f) - pow( rk + rp, 2.0f))/pow( djk, 2.0f);
+	tjk = 0.5f*( aj + ak) + 0.5f*( ak - aj) * ( ( rj + rp)*( rj + rp) - ( rk + rp)*( rk + rp))/( djk*djk);
+	//rik = 0.5f*pow( pow(ri + rk + 2.0f*rp, 2.0f) - pow( dik, 2.0f), 0.5f) * ( pow( pow( dik, 2.0f) - pow( ri - rk, 2.0f), 0.5f) / dik);
+	rik = 0.5f*pow( (ri + rk + 2.0f*rp)*(ri + rk + 2.0f*rp) - dik*dik, 0.5f) * ( pow( dik*dik - ( ri - rk)*( ri - rk), 0.5f) / dik);
+	//rjk = 0.5f*pow( pow(rj + rk + 2.0f*rp, 2.0f) - pow( djk, 2.0f), 0.5f) * ( pow( pow( djk, 2.0f) - pow( rj - rk, 2.0f), 0.5f) / djk);
+	rjk = 0.5f*pow( (rj + rk + 2.0f*rp)*(rj + rk + 2.0f*rp) - djk*djk, 0.5f) * ( pow( djk*djk - ( rj - rk)*( rj - rk), 0.5f) / djk);
+	wijk = acos( uij.Dot(uik) );
+	uijk = uij.Cross( uik) / sin( wijk);
+	utb = uijk.Cross( uij);
+	//bijk = tij + utb * ( uik.Dot( tik - tij)) * pow( sin( wijk), -1.0f);
+	bijk = tij + utb * ( uik.Dot( tik - tij) / sin( wijk));
+	//hijk = pow( pow( ri + rp, 2.0f) - pow( ( bijk - ai).Length(), 2.0f), 0.5f);
+	hijk = pow( ( ri + rp)*( ri + rp) - ( ( bijk - ai).Length())*(( bijk - ai).Length()), 0.5f);
+	pijk1 = bijk + uijk * hijk * factor;
+
+	// pointer to a dual face of the new face
+	RSFace *dualFace = NULL;
+	// store the attributes of the new face
+	std::vector<RSVertex*> vertsNewFace;
+	vertsNewFace.push_back( edge->GetVertex1());
+	if( edge->GetVertex2()->GetIndex() < edge->GetVertex1()->GetIndex() )
+		vertsNewFace.insert( vertsNewFace.begin(), edge->GetVertex2());
+	else
+		vertsNewFace.push_back( edge->GetVertex2());
+	if( vertex->GetIndex() < vertsNewFace[0]->GetIndex() )
+	{
+		vertsNewFace.insert( vertsNewFace.begin(), vertex);
+	}
+	else
+	{
+		if( vertex->GetIndex() < vertsNewFace[1]->GetIndex() )
+			vertsNewFace.insert( vertsNewFace.begin()+1, vertex);
 		else
-			vertsNewFace.push_back( edge->GetVertex2());
-		if( this->vicinity[result]->GetIndex() < vertsNewFace[0]->GetIndex() )
+			vertsNewFace.push_back( vertex);
+	}
+	vislib::math::Vector<float, 3> normalNewFace = uijk * factor;
+	vislib::math::Vector<float, 3> probeCenterNewFace = pijk1;
+	// create first RS-edge
+	RSEdge *tmpEdge1 = new RSEdge( edge->GetVertex1(), vertex, tik, rik);
+	std::vector<RSEdge*> index1, index2;
+	RSFace *face = NULL;
+	for( cnt = 0; cnt < vertex->GetEdgeCount(); ++cnt )
+	{
+		if( *(vertex->GetEdge( cnt)) == *tmpEdge1 )
 		{
-			vertsNewFace.insert( vertsNewFace.begin(), this->vicinity[result]);
+			index1.push_back( vertex->GetEdge( cnt));
 		}
-		else
+	}
+
+	// check, if this face already exists for edge 1
+	for( cnt = 0; cnt < index1.size(); ++cnt )
+	{
+		if( index1[cnt]->GetFace1()->GetVertex1() == vertsNewFace[0] &&
+			index1[cnt]->GetFace1()->GetVertex2() == vertsNewFace[1] &&
+			index1[cnt]->GetFace1()->GetVertex3() == vertsNewFace[2] )
 		{
-			if( this->vicinity[result]->GetIndex() < vertsNewFace[1]->GetIndex() )
-				vertsNewFace.insert( vertsNewFace.begin()+1, this->vicinity[result]);
+			if( (index1[cnt]->GetFace1()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
+				face = index1[cnt]->GetFace1();
 			else
-				vertsNewFace.push_back( this->vicinity[result]);
+				dualFace = index1[cnt]->GetFace1();
 		}
-		vislib::math::Vector<float, 3> normalNewFace = uijk * factor;
-		vislib::math::Vector<float, 3> probeCenterNewFace = pijk1;
-		// create first RS-edge
-		RSEdge *tmpEdge1 = new RSEdge( edge->GetVertex1(), this->vicinity[result], tik, rik);
-		std::vector<RSEdge*> index1, index2;
-		RSFace *face = NULL;
-		for( cnt = 0; cnt < this->vicinity[result]->GetEdgeCount(); ++cnt )
+		else if( index1[cnt]->GetFace2() != NULL )
 		{
-			if( *(this->vicinity[result]->GetEdge( cnt)) == *tmpEdge1 )
+			if( index1[cnt]->GetFace2()->GetVertex1() == vertsNewFace[0] &&
+				index1[cnt]->GetFace2()->GetVertex2() == vertsNewFace[1] &&
+				index1[cnt]->GetFace2()->GetVertex3() == vertsNewFace[2] )
 			{
-				index1.push_back( this->vicinity[result]->GetEdge( cnt));
+				if( (index1[cnt]->GetFace2()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
+					face = index1[cnt]->GetFace2();
+				else
+					dualFace = index1[cnt]->GetFace2();
 			}
 		}
-
-		// check, if this face already exists for edge 1
-		for( cnt = 0; cnt < index1.size(); ++cnt )
+	}
+	// create second RS-edge
+	RSEdge *tmpEdge2 = new RSEdge( edge->GetVertex2(), vertex, tjk, rjk);
+	for( cnt = 0; cnt < vertex->GetEdgeCount(); ++cnt )
+	{
+		if( *(vertex->GetEdge( cnt)) == *tmpEdge2 )
 		{
-			if( index1[cnt]->GetFace1()->GetVertex1() == vertsNewFace[0] &&
-				index1[cnt]->GetFace1()->GetVertex2() == vertsNewFace[1] &&
-				index1[cnt]->GetFace1()->GetVertex3() == vertsNewFace[2] )
-			{
-				if( (index1[cnt]->GetFace1()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
-					face = index1[cnt]->GetFace1();
-				else
-					dualFace = index1[cnt]->GetFace1();
-			}
-			else if( index1[cnt]->GetFace2() != NULL )
-			{
-				if( index1[cnt]->GetFace2()->GetVertex1() == vertsNewFace[0] &&
-					index1[cnt]->GetFace2()->GetVertex2() == vertsNewFace[1] &&
-					index1[cnt]->GetFace2()->GetVertex3() == vertsNewFace[2] )
-				{
-					if( (index1[cnt]->GetFace2()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
-						face = index1[cnt]->GetFace2();
-					else
-						dualFace = index1[cnt]->GetFace2();
-				}
-			}
+			index2.push_back( vertex->GetEdge( cnt));
 		}
-		// create second RS-edge
-		RSEdge *tmpEdge2 = new RSEdge( edge->GetVertex2(), this->vicinity[result], tjk, rjk);
-		for( cnt = 0; cnt < this->vicinity[result]->GetEdgeCount(); ++cnt )
+	}
+	// check, if this face already exists for edge 2
+	for( cnt = 0; cnt < index2.size(); ++cnt )
+	{
+		if( index2[cnt]->GetFace1()->GetVertex1() == vertsNewFace[0] &&
+			index2[cnt]->GetFace1()->GetVertex2() == vertsNewFace[1] &&
+			index2[cnt]->GetFace1()->GetVertex3() == vertsNewFace[2] )
 		{
-			if( *(this->vicinity[result]->GetEdge( cnt)) == *tmpEdge2 )
-			{
-				index2.push_back( this->vicinity[result]->GetEdge( cnt));
-			}
+			if( (index2[cnt]->GetFace1()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
+				face = index2[cnt]->GetFace1();
+			else
+				dualFace = index2[cnt]->GetFace1();
 		}
-		// check, if this face already exists for edge 2
-		for( cnt = 0; cnt < index2.size(); ++cnt )
+		else if( index2[cnt]->GetFace2() != NULL )
 		{
-			if( index2[cnt]->GetFace1()->GetVertex1() == vertsNewFace[0] &&
-				index2[cnt]->GetFace1()->GetVertex2() == vertsNewFace[1] &&
-				index2[cnt]->GetFace1()->GetVertex3() == vertsNewFace[2] )
+			if( index2[cnt]->GetFace2()->GetVertex1() == vertsNewFace[0] &&
+				index2[cnt]->GetFace2()->GetVertex2() == vertsNewFace[1] &&
+				index2[cnt]->GetFace2()->GetVertex3() == vertsNewFace[2] )
 			{
-				if( (index2[cnt]->GetFace1()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
-					face = index2[cnt]->GetFace1();
+				if( (index2[cnt]->GetFace2()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
+					face = index2[cnt]->GetFace2();
 				else
-					dualFace = index2[cnt]->GetFace1();
-			}
-			else if( index2[cnt]->GetFace2() != NULL )
-			{
-				if( index2[cnt]->GetFace2()->GetVertex1() == vertsNewFace[0] &&
-					index2[cnt]->GetFace2()->GetVertex2() == vertsNewFace[1] &&
-					index2[cnt]->GetFace2()->GetVertex3() == vertsNewFace[2] )
-				{
-					if( (index2[cnt]->GetFace2()->GetFaceNormal() - normalNewFace ).Length() < this->epsilon )
-						face = index2[cnt]->GetFace2();
-					else
-						dualFace = index2[cnt]->GetFace2();
-				}
+					dualFace = index2[cnt]->GetFace2();
 			}
 		}
+	}
 
-		// the new face is NOT already existing:
-		if( face == NULL )
+	// the new face is NOT already existing:
+	if( face == NULL )
+	{
+		// add the first temporary edge to the edge list and to its vertices
+		this->rsEdge.push_back( tmpEdge1);
+		tmpEdge1->GetVertex1()->AddEdge( tmpEdge1);
+		tmpEdge1->GetVertex2()->AddEdge( tmpEdge1);
+		// add the second temporary edge to the edge list and to its vertices
+		this->rsEdge.push_back( tmpEdge2);
+		tmpEdge2->GetVertex1()->AddEdge( tmpEdge2);
+		tmpEdge2->GetVertex2()->AddEdge( tmpEdge2);
+		// create new RS-face
+		face = new RSFace( vertsNewFace[0], vertsNewFace[1], vertsNewFace[2], 
+			edge, tmpEdge1, tmpEdge2, normalNewFace, probeCenterNewFace);
+		this->rsFace.push_back( face);
+		// add new RS-face to its edges
+		edge->SetRSFace( face);
+		tmpEdge1->SetRSFace( face);
+		tmpEdge2->SetRSFace( face);
+		if( dualFace != NULL )
 		{
-			// add the first temporary edge to the edge list and to its vertices
-			this->rsEdge.push_back( tmpEdge1);
-			tmpEdge1->GetVertex1()->AddEdge( tmpEdge1);
-			tmpEdge1->GetVertex2()->AddEdge( tmpEdge1);
-			// add the second temporary edge to the edge list and to its vertices
-			this->rsEdge.push_back( tmpEdge2);
-			tmpEdge2->GetVertex1()->AddEdge( tmpEdge2);
-			tmpEdge2->GetVertex2()->AddEdge( tmpEdge2);
-			// create new RS-face
-			face = new RSFace( vertsNewFace[0], vertsNewFace[1], vertsNewFace[2], 
-				edge, tmpEdge1, tmpEdge2, normalNewFace, probeCenterNewFace);
-			this->rsFace.push_back( face);
-			// add new RS-face to its edges
-			edge->SetRSFace( face);
-			tmpEdge1->SetRSFace( face);
-			tmpEdge2->SetRSFace( face);
-			if( dualFace != NULL )
-			{
-				dualFace->SetDualFace( face);
-				face->SetDualFace( dualFace);
-			}	
-			// add probe position to voxel map cell
-			face->SetProbeIndex(
-				std::min( (unsigned int)this->voxelMapProbes.size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetX() - bBox.Left()) / voxelLength))),
-				std::min( (unsigned int)this->voxelMapProbes[0].size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetY() - bBox.Bottom()) / voxelLength))),
-				std::min( (unsigned int)this->voxelMapProbes[0][0].size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetZ() - bBox.Back()) / voxelLength))));
-			this->voxelMapProbes[face->GetProbeIndex().GetX()][face->GetProbeIndex().GetY()][face->GetProbeIndex().GetZ()].push_back( face);
-		}
-		else
+			dualFace->SetDualFace( face);
+			face->SetDualFace( dualFace);
+		}	
+		// add probe position to voxel map cell
+		face->SetProbeIndex(
+			std::min( (unsigned int)this->voxelMapProbes.size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetX() - bBox.Left()) / voxelLength))),
+			std::min( (unsigned int)this->voxelMapProbes[0].size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetY() - bBox.Bottom()) / voxelLength))),
+			std::min( (unsigned int)this->voxelMapProbes[0][0].size()-1, (unsigned int)std::max(0, (int)floorf( ( probeCenterNewFace.GetZ() - bBox.Back()) / voxelLength))));
+		this->voxelMapProbes[face->GetProbeIndex().GetX()][face->GetProbeIndex().GetY()][face->GetProbeIndex().GetZ()].push_back( face);
+	}
+	else
+	{
+		// delete temporary edges
+		delete tmpEdge1;
+		delete tmpEdge2;
+		// set the first face of the current edge as adjacent face to the already existing face
+		if( *(face->GetEdge1()) == *edge )
 		{
-			// delete temporary edges
-			delete tmpEdge1;
-			delete tmpEdge2;
-			// set the first face of the current edge as adjacent face to the already existing face
-			if( *(face->GetEdge1()) == *edge )
+			if( face->GetEdge1()->SetRSFace( edge->GetFace1()) )
 			{
-				if( face->GetEdge1()->SetRSFace( edge->GetFace1()) )
-				{
-					face->GetEdge1()->SetRotationAngle( angle * (-factor));
-					if( edge->GetFace1()->GetEdge1() == edge )
-						edge->GetFace1()->SetEdge1( face->GetEdge1());
-					else if( edge->GetFace1()->GetEdge2() == edge )
-						edge->GetFace1()->SetEdge2( face->GetEdge1());
-					else
-						edge->GetFace1()->SetEdge3( face->GetEdge1());
-				}
+				face->GetEdge1()->SetRotationAngle( angle * (-factor));
+				if( edge->GetFace1()->GetEdge1() == edge )
+					edge->GetFace1()->SetEdge1( face->GetEdge1());
+				else if( edge->GetFace1()->GetEdge2() == edge )
+					edge->GetFace1()->SetEdge2( face->GetEdge1());
 				else
-				{
-					edge->SetRSFace( face);
-					//std::cout << "error1 " << std::endl;
-				}
+					edge->GetFace1()->SetEdge3( face->GetEdge1());
 			}
-			else if( *(face->GetEdge2()) == *edge )
+			else
 			{
-				if( face->GetEdge2()->SetRSFace( edge->GetFace1()) )
-				{
-					face->GetEdge2()->SetRotationAngle( angle * (-factor));
-					if( edge->GetFace1()->GetEdge1() == edge )
-						edge->GetFace1()->SetEdge1( face->GetEdge2());
-					else if( edge->GetFace1()->GetEdge2() == edge )
-						edge->GetFace1()->SetEdge2( face->GetEdge2());
-					else
-						edge->GetFace1()->SetEdge3( face->GetEdge2());
-				}
+				edge->SetRSFace( face);
+				//std::cout << "error1 " << std::endl;
+			}
+		}
+		else if( *(face->GetEdge2()) == *edge )
+		{
+			if( face->GetEdge2()->SetRSFace( edge->GetFace1()) )
+			{
+				face->GetEdge2()->SetRotationAngle( angle * (-factor));
+				if( edge->GetFace1()->GetEdge1() == edge )
+					edge->GetFace1()->SetEdge1( face->GetEdge2());
+				else if( edge->GetFace1()->GetEdge2() == edge )
+					edge->GetFace1()->SetEdge2( face->GetEdge2());
 				else
-				{
-					edge->SetRSFace( face);
-					//std::cout << "error2 " << std::endl;
-				}
+					edge->GetFace1()->SetEdge3( face->GetEdge2());
 			}
 			else
 			{
-				if( face->GetEdge3()->SetRSFace( edge->GetFace1()) )
-				{
-					face->GetEdge3()->SetRotationAngle( angle * (-factor));
-					if( edge->GetFace1()->GetEdge1() == edge )
-						edge->GetFace1()->SetEdge1( face->GetEdge3());
-					else if( edge->GetFace1()->GetEdge2() == edge )
-						edge->GetFace1()->SetEdge2( face->GetEdge3());
-					else
-						edge->GetFace1()->SetEdge3( face->GetEdge3());
-				}
+				edge->SetRSFace( face);
+				//std::cout << "error2 " << std::endl;
+			}
+		}
+		else
+		{
+			if( face->GetEdge3()->SetRSFace( edge->GetFace1()) )
+			{
+				face->GetEdge3()->SetRotationAngle( angle * (-factor));
+				if( edge->GetFace1()->GetEdge1() == edge )
+					edge->GetFace1()->SetEdge1( face->GetEdge3());
+				else if( edge->GetFace1()->GetEdge2() == edge )
+					edge->GetFace1()->SetEdge2( face->GetEdge3());
 				else
-				{
-					edge->SetRSFace( face);
-					//std::cout << "error3 " << std::endl;
-				}
+					edge->GetFace1()->SetEdge3( face->GetEdge3());
 			}
-			if( dualFace != NULL )
+			else
 			{
-				dualFace->SetDualFace( face);
-				face->SetDualFace( dualFace);
+				edge->SetRSFace( face);
+				//std::cout << "error3 " << std::endl;
 			}
 		}
+		if( dualFace != NULL )
+		{
+			dualFace->SetDualFace( face);
+			face->SetDualFace( dualFace);
+		}
 	}
 
 }
@@ -935,187 +1006,90 @@ bool ReducedSurface::ComputeFirstFixedProbePos( RSVertex *vI, RSVertex *vJ, RSVe
 
 /*
  * Compute vicinity for an atom at position 'm' with radius 'rad'
- * TODO: this could be implemented faster!!!
  */
 void ReducedSurface::ComputeVicinity( vislib::math::Vector<float, 3> m, float rad)
 {
-	unsigned int cnt, xId, yId, zId, maxXId, maxYId, maxZId;
-	//maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
-	//maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
-	//maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-	maxXId = (unsigned int)this->voxelMap.size()-1;
-	maxYId = (unsigned int)this->voxelMap[0].size()-1;
-	maxZId = (unsigned int)this->voxelMap[0][0].size()-1;
-	int cntX, cntY, cntZ;
-
-	xId = (unsigned int)std::max(0, (int)floorf( ( m.GetX() - bBox.Left()) / voxelLength));
-	xId = (unsigned int)std::min( maxXId, xId);
-	yId = (unsigned int)std::max(0, (int)floorf( ( m.GetY() - bBox.Bottom()) / voxelLength));
-	yId = (unsigned int)std::min( maxYId, yId);
-	zId = (unsigned int)std::max(0, (int)floorf( ( m.GetZ() - bBox.Back()) / voxelLength));
-	zId = (unsigned int)std::min( maxZId, zId);
-
-	float distance;
-	//float threshold;
-	// clear old vicinity indices
-	this->vicinity.clear();
-	// loop over all atoms to find vicinity
-	for( cntX = ((xId > 0)?(-1):0); cntX < ((xId < maxXId)?2:1); ++cntX )
-	{
-		for( cntY = ((yId > 0)?(-1):0); cntY < ((yId < maxYId)?2:1); ++cntY )
-		{
-			for( cntZ = ((zId > 0)?(-1):0); cntZ < ((zId < maxZId)?2:1); ++cntZ )
-			{
-				for( cnt = 0; cnt < this->voxelMap[xId+cntX][yId+cntY][zId+cntZ].size(); ++cnt )
-				{
-					// compute distance
-					distance = (this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetPosition() - 
-						m).Length();
-					// don't check self --> continue if distance is zero
-					if( distance < epsilon )
-						continue;
-					// compute threshold
-					//threshold = this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetRadius() + rad + 2.0f*this->probeRadius;
-					// if distance < threshold --> add atom 'cnt' to vicinity
-					//if( distance <= threshold )
-					//{
-					//	this->vicinity.push_back( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]);
-					//}
-					this->vicinity.push_back( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]);
-				}
-			}
-		}
-	}
-	/*
-	unsigned int cnt;
-	float distance, threshold;
 	// clear old vicinity indices
 	this->vicinity.clear();
-	// loop over all atoms to find vicinity
-	for( cnt = 0; cnt < this->rsVertex.size(); cnt++ )
-	{
-		// compute distance
-		distance = (this->rsVertex[cnt]->GetPosition() - m).Length();
+	const float maxDist = rad + this->maxAtomRadius + 2.0f*this->probeRadius;
+	this->atomGrid.ForEachNeighbour( m.PeekComponents(), maxDist, [&]( unsigned int idx) {
+		RSVertex *v = this->rsVertex[idx];
 		// don't check self --> continue if distance is zero
-		if( distance < epsilon ) continue;
-		// compute threshold
-		threshold = this->rsVertex[cnt]->GetRadius() + rad + 2.0f*this->probeRadius;
-		// if distance < threshold --> add atom 'cnt' to vicinity
-		if( distance <= threshold )
-		{
-			this->vicinity.push_back( cnt);
-		}
-	}
-	*/
+		if( ( v->GetPosition() - m).Length() < epsilon )
+			return;
+		// if distance < threshold --> add atom to vicinity
+		if( ( v->GetPosition() - m).Length() <= v->GetRadius() + rad + 2.0f*this->probeRadius )
+			this->vicinity.push_back( v);
+	});
+	std::sort( this->vicinity.begin(), this->vicinity.end(),
+		[]( const RSVertex *l, const RSVertex *r) { return l->GetIndex() < r->GetIndex(); });
 }
 
 
 /*
  * Compute vicinity for the torus around edge 'idx'
- * TODO: this could be implemented faster!!!
  */
-void ReducedSurface::ComputeVicinityEdge( RSEdge *edge)
+void ReducedSurface::ComputeVicinityEdge( RSEdge *edge, std::vector<RSVertex*> &vic) const
 {
-	unsigned int cnt, xId, yId, zId, maxXId, maxYId, maxZId;
-	
-	maxXId = (unsigned int)this->voxelMap.size()-1;
-	maxYId = (unsigned int)this->voxelMap[0].size()-1;
-	maxZId = (unsigned int)this->voxelMap[0][0].size()-1;
-	int cntX, cntY, cntZ;
-
-	xId = std::min( maxXId,
-		(unsigned int)std::max( 0, (int)floorf( (edge->GetTorusCenter().GetX() - bBox.Left()) / voxelLength)));
-	yId = std::min( maxYId,
-		(unsigned int)std::max( 0, (int)floorf( (edge->GetTorusCenter().GetY() - bBox.Bottom()) / voxelLength)));
-	zId = std::min( maxZId,
-		(unsigned int)std::max( 0, (int)floorf( (edge->GetTorusCenter().GetZ() - bBox.Back()) / voxelLength)));
-
-	float distance, threshold;
+	const vislib::math::Vector<float, 3> &center = edge->GetTorusCenter();
+	const float maxDist = this->maxAtomRadius + edge->GetTorusRadius() + this->probeRadius;
 	// clear old vicinity indices
-	this->vicinity.clear();
-	// loop over all atoms to find vicinity
-	for( cntX = ((xId > 0)?(-1):0); cntX < ((xId < maxXId)?2:1); ++cntX )
-	{
-		for( cntY = ((yId > 0)?(-1):0); cntY < ((yId < maxYId)?2:1); ++cntY )
-		{
-			for( cntZ = ((zId > 0)?(-1):0); cntZ < ((zId < maxZId)?2:1); ++cntZ )
-			{
-				for( cnt = 0; cnt < this->voxelMap[xId+cntX][yId+cntY][zId+cntZ].size(); ++cnt )
-				{
-					// don't check vertices of the edge --> continue
-					if( *(this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]) == *(edge->GetVertex1()) ||
-						*(this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]) == *(edge->GetVertex2()) ) 
-						continue;
-					// --> the following is not necessary, because real vicinity is checked when RS-face is computed
-					// --> but it results in a considerable speedup!
-					// compute distance
-					distance = (this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetPosition() - 
-						edge->GetTorusCenter()).Length();
-					// compute threshold
-					threshold = this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetRadius() + 
-						edge->GetTorusRadius() + this->probeRadius;
-					// if distance < threshold --> add atom 'cnt' to vicinity
-					if( distance <= threshold )
-					{
-						this->vicinity.push_back( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]);
-					}
-				}
-			}
-		}
-	}
+	vic.clear();
+	this->atomGrid.ForEachNeighbour( center.PeekComponents(), maxDist, [&]( unsigned int idx) {
+		RSVertex *v = this->rsVertex[idx];
+		// don't check vertices of the edge --> continue
+		if( *v == *(edge->GetVertex1()) || *v == *(edge->GetVertex2()) )
+			return;
+		// --> the following is not necessary, because real vicinity is checked when RS-face is computed
+		// --> but it results in a considerable speedup!
+		// if distance < threshold --> add atom to vicinity
+		if( ( v->GetPosition() - center).Length() <= v->GetRadius() + edge->GetTorusRadius() + this->probeRadius )
+			vic.push_back( v);
+	});
+	// the cell order depends on the grid, the atom order does not
+	std::sort( vic.begin(), vic.end(),
+		[]( const RSVertex *l, const RSVertex *r) { return l->GetIndex() < r->GetIndex(); });
 }
 
 
 /*
  * Compute vicinity for atom 'idx'
- * TODO: this could be implemented faster!!!
  */
-void ReducedSurface::ComputeVicinityVertex( RSVertex *vertex)
+void ReducedSurface::ComputeVicinityVertex( RSVertex *vertex, std::vector<RSVertex*> &vic) const
 {
-	unsigned int cnt, xId, yId, zId, maxXId, maxYId, maxZId;
-	//maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
-	//maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
-	//maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-	maxXId = (unsigned int)this->voxelMap.size()-1;
-	maxYId = (unsigned int)this->voxelMap[0].size()-1;
-	maxZId = (unsigned int)this->voxelMap[0][0].size()-1;
-	int cntX, cntY, cntZ;
+	const vislib::math::Vector<float, 3> pos = vertex->GetPosition();
+	const float maxDist = this->maxAtomRadius + vertex->GetRadius() + 2.0f*this->probeRadius;
+	// clear old vicinity indices
+	vic.clear();
+	this->atomGrid.ForEachNeighbour( pos.PeekComponents(), maxDist, [&]( unsigned int idx) {
+		RSVertex *v = this->rsVertex[idx];
+		// don't check the vertex itself --> continue
+		if( v->GetIndex() == vertex->GetIndex() )
+			return;
+		// if distance < threshold --> add atom to vicinity
+		if( ( v->GetPosition() - pos).Length() <= v->GetRadius() + vertex->GetRadius() + 2.0f*this->probeRadius )
+			vic.push_back( v);
+	});
+	std::sort( vic.begin(), vic.end(),
+		[]( const RSVertex *l, const RSVertex *r) { return l->GetIndex() < r->GetIndex(); });
+}
 
-	xId = (unsigned int)std::max( 0, (int)floorf( ( vertex->GetPosition().GetX() - bBox.Left()) / voxelLength));
-	xId = (unsigned int)std::min( maxXId, xId);
-	yId = (unsigned int)std::max( 0, (int)floorf( ( vertex->GetPosition().GetY() - bBox.Bottom()) / voxelLength));
-	yId = (unsigned int)std::min( maxYId, yId);
-	zId = (unsigned int)std::max( 0, (int)floorf( ( vertex->GetPosition().GetZ() - bBox.Back()) / voxelLength));
-	zId = (unsigned int)std::min( maxZId, zId);
 
-	float distance, threshold;
-	// clear old vicinity indices
-	this->vicinity.clear();
-	// loop over all atoms to find vicinity
-	for( cntX = ((xId > 0)?(-1):0); cntX < ((xId < maxXId)?2:1); ++cntX )
+/*
+ * Sort the RS-vertices into the atom cell list
+ */
+void ReducedSurface::BuildAtomGrid()
+{
+	this->atomGridPositions.resize( this->rsVertex.size() * 3);
+	for( size_t i = 0; i < this->rsVertex.size(); ++i )
 	{
-		for( cntY = ((yId > 0)?(-1):0); cntY < ((yId < maxYId)?2:1); ++cntY )
-		{
-			for( cntZ = ((zId > 0)?(-1):0); cntZ < ((zId < maxZId)?2:1); ++cntZ )
-			{
-				for( cnt = 0; cnt < this->voxelMap[xId+cntX][yId+cntY][zId+cntZ].size(); ++cnt )
-				{
-					// don't check vertices of the edge --> continue
-					if( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetIndex() == vertex->GetIndex() )
-						continue;
-					// compute distance
-					distance = (this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetPosition() - vertex->GetPosition()).Length();
-					// compute threshold
-					threshold = this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]->GetRadius() + vertex->GetRadius() + 2.0f*this->probeRadius;
-					// if distance < threshold --> add atom 'cnt' to vicinity
-					if( distance <= threshold )
-					{
-						this->vicinity.push_back( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]);
-					}
-				}
-			}
-		}
+		this->atomGridPositions[3*i+0] = this->rsVertex[i]->GetPosition().GetX();
+		this->atomGridPositions[3*i+1] = this->rsVertex[i]->GetPosition().GetY();
+		this->atomGridPositions[3*i+2] = this->rsVertex[i]->GetPosition().GetZ();
 	}
+	// cells of about one probe plus atom radius keep the query boxes tight
+	this->atomGrid.Build( this->atomGridPositions.data(), static_cast<unsigned int>( this->rsVertex.size()),
+		this->bBox, this->maxAtomRadius + this->probeRadius);
 }
 
 
@@ -1256,9 +1230,9 @@ void ReducedSurface::ComputeProbeCutVertex( RSVertex *vertex)
 	//maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
 	//maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
 	//maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-	maxXId = (unsigned int)this->voxelMap.size()-1;
-	maxYId = (unsigned int)this->voxelMap[0].size()-1;
-	maxZId = (unsigned int)this->voxelMap[0][0].size()-1;
+	maxXId = (unsigned int)this->voxelMapProbes.size()-1;
+	maxYId = (unsigned int)this->voxelMapProbes[0].size()-1;
+	maxZId = (unsigned int)this->voxelMapProbes[0][0].size()-1;
 	int cntX, cntY, cntZ;
 
 	vislib::math::Vector<float, 3> v1, probe;
@@ -1323,7 +1297,7 @@ bool ReducedSurface::FindFirstRSFace( RSVertex* vertex)
 {
 	unsigned int cnt1, cnt2;
 	// get vicinity for atom with the given index
-	this->ComputeVicinityVertex( vertex);
+	this->ComputeVicinityVertex( vertex, this->vicinity);
 	vertex->SetTreated();
 	// search for possible RS-vertices
 	for( cnt1 = 0; cnt1 < this->vicinity.size(); ++cnt1 )
@@ -1376,8 +1350,7 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 	unsigned int yIdx = 0;
 	unsigned int zIdx = 0;
 	// indices of voxel map entries
-	unsigned int oldVoxelMapIdxX, oldVoxelMapIdxY, oldVoxelMapIdxZ, 
-		newVoxelMapIdxX, newVoxelMapIdxY, newVoxelMapIdxZ;
+	unsigned int oldVoxelMapIdxX, oldVoxelMapIdxY, oldVoxelMapIdxZ;
 	// difference between the current and the subsequent atom position
 	float difference;
 	// temporary vector for RS-edges
@@ -1427,33 +1400,6 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 		{
 			// the lower threshold is exceeded
 			lowerThresholdExceeded = true;
-			// compute old voxel map index
-			oldVoxelMapIdxX = (unsigned int)std::max( 0, (int)floorf( (this->rsVertex[cnt3]->GetPosition().GetX() - bBox.Left()) / voxelLength));
-			oldVoxelMapIdxX = std::min( oldVoxelMapIdxX, (unsigned int)this->voxelMap.size()-1);
-			oldVoxelMapIdxY = (unsigned int)std::max( 0, (int)floorf( (this->rsVertex[cnt3]->GetPosition().GetY() - bBox.Bottom()) / voxelLength));
-			oldVoxelMapIdxY = std::min( oldVoxelMapIdxY, (unsigned int)this->voxelMap[oldVoxelMapIdxX].size()-1);
-			oldVoxelMapIdxZ = (unsigned int)std::max( 0, (int)floorf( (this->rsVertex[cnt3]->GetPosition().GetZ() - bBox.Back()) / voxelLength));
-			oldVoxelMapIdxZ = std::min( oldVoxelMapIdxZ, (unsigned int)this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY].size()-1);
-			// compute new voxel map index --> make sure the index is within bounds
-			newVoxelMapIdxX = (unsigned int)std::max( 0, (int)floorf( (tmpVec1.GetX() - bBox.Left()) / this->voxelLength));
-			newVoxelMapIdxX = std::min( newVoxelMapIdxX, (unsigned int)this->voxelMap.size()-1);
-			newVoxelMapIdxY = (unsigned int)std::max( 0, (int)floorf( (tmpVec1.GetY() - bBox.Bottom()) / this->voxelLength));
-			newVoxelMapIdxY = std::min( newVoxelMapIdxY, (unsigned int)this->voxelMap[newVoxelMapIdxX].size()-1);
-			newVoxelMapIdxZ = (unsigned int)std::max( 0, (int)floorf( (tmpVec1.GetZ() - bBox.Back()) / this->voxelLength));
-			newVoxelMapIdxZ = std::min( newVoxelMapIdxZ, (unsigned int)this->voxelMap[newVoxelMapIdxX][newVoxelMapIdxY].size()-1);
-			// if the new atom position lies in another voxel --> remove old and add new position
-			if( ( oldVoxelMapIdxX != newVoxelMapIdxX ) ||
-			    ( oldVoxelMapIdxY != newVoxelMapIdxY ) ||
-			    ( oldVoxelMapIdxZ != newVoxelMapIdxZ ) )
-			{
-				// add the rsVertex-pointer to the new voxel
-				this->voxelMap[newVoxelMapIdxX][newVoxelMapIdxY][newVoxelMapIdxZ].push_back( this->rsVertex[cnt3]);
-				// remove the rsVertex-pointer from the old voxel
-				this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].erase(
-					std::find( this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].begin(),
-						this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].end(),
-						this->rsVertex[cnt3]));
-			}
 			// set new atom position
 			this->rsVertex[cnt3]->SetPosition( tmpVec1);
 			// set RS-vertex as not buried
@@ -1486,6 +1432,8 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 	{
 		return false;
 	}
+	// move the changed RS-vertices in the cell list (only refreshes positions if no cell changed)
+	this->BuildAtomGrid();
 	
 	// find all RS-edges and -faces that have contact to at least one changed RS-vertex
 	std::set<RSVertex*>::iterator itVertex;
@@ -1517,6 +1465,8 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 		}
 	}
 	this->cutFaces.clear();
+	// an edge without a second face adds NULL above, which is no face that has to be removed
+	changedRSFaces.erase( NULL);
 	
 	//std::cout << "INFO: marked RS-faces (" << changedRSFaces.size() << ") and RS-edges (" << changedRSEdges.size() << ")" << std::endl;
 	//std::cout << "INFO: total number of RS-faces (" << this->rsFace.size() << ") and RS-edges (" << this->rsEdge.size() << ")" << std::endl;
@@ -1601,41 +1551,40 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 			}
 		}
 		
-		// delete RS-face
-		itProbe = std::find( this->rsFace.begin(), this->rsFace.end(), (*itFace));
-		if( itProbe != this->rsFace.end() )
-		{
-			delete (*itProbe);
-			this->rsFace.erase( itProbe);
-		}
-		else
-		{
-			std::cout << "ERROR: RS-Face not found in list of RS-faces!" << std::endl;
-		}
+		// mark RS-face for deletion
+		(*itFace)->toDelete = true;
+	}
+	// delete all marked RS-faces in one pass over the list of RS-faces
+	size_t deletedFaces = 0;
+	this->rsFace.erase( std::remove_if( this->rsFace.begin(), this->rsFace.end(), [&deletedFaces]( RSFace *f) {
+		if( !f->toDelete )
+			return false;
+		delete f;
+		++deletedFaces;
+		return true;
+	}), this->rsFace.end());
+	if( deletedFaces != changedRSFaces.size() )
+	{
+		std::cout << "ERROR: RS-Face not found in list of RS-faces!" << std::endl;
 	}
 	
 	//std::cout << "INFO: deleted RS-faces" << std::endl;
 	
 	// remove all changed RS-edges from the list of RS-edges
 	std::set<RSEdge*>::iterator itEdge;
-	std::vector<RSEdge*>::iterator itDelEdge;
 	for( itEdge = changedRSEdges.begin(); itEdge != changedRSEdges.end(); ++itEdge )
 	{
 		// remove RS-edge from its two RS-vertices
 		(*itEdge)->GetVertex1()->RemoveEdge( (*itEdge));
 		(*itEdge)->GetVertex2()->RemoveEdge( (*itEdge));
-		// delete RS-edge
-		itDelEdge = std::find( this->rsEdge.begin(), this->rsEdge.end(), (*itEdge));
-		if( itDelEdge != this->rsEdge.end() )
-		{
-			delete (*itDelEdge);
-			this->rsEdge.erase( itDelEdge);
-		}
-		else
-		{
-			//std::cout << "ERROR: RS-edge not found in list of RS-edges!" << std::endl;
-		}
 	}
+	// delete RS-edges in one pass over the list of RS-edges
+	this->rsEdge.erase( std::remove_if( this->rsEdge.begin(), this->rsEdge.end(), [&changedRSEdges]( RSEdge *e) {
+		if( changedRSEdges.count( e) == 0 )
+			return false;
+		delete e;
+		return true;
+	}), this->rsEdge.end());
 	//std::cout << "INFO: number of RS-edges after deletion: " << this->rsEdge.size() << std::endl;
 	
 	//std::cout << "INFO: new number of RS-faces (" << this->rsFace.size() << ") and RS-edges (" << this->rsEdge.size() << ")" << std::endl;
@@ -1661,12 +1610,7 @@ bool ReducedSurface::UpdateData( const float lowerThreshold, const float upperTh
 		//std::cout << "INFO: computing new RS-faces from old RS-edges..." << std::endl;
 		
 		// for each edge: find neighbours
-		cnt1 = 0;
-		while( cnt1 < this->rsEdge.size() )
-		{
-			this->ComputeRSFace( cnt1);
-			cnt1++;
-		}
+		this->ComputeRSFaces( 0);
 		
 		//std::cout << "INFO: computed new RS-faces from old RS-edges" << std::endl;
 		
@@ -12,6 +12,7 @@
 
 #include "protein_calls/MolecularDataCall.h"
 #include "vislib/math/Quaternion.h"
+#include "NeighbourCellList.h"
 #include <vector>
 #include <set>
 #include <algorithm>
@@ -316,15 +317,17 @@ namespace protein {
 		 * Write the indices of all atoms that can be touched by the torus 
 		 * definded a probe rotating around an edge to the vicinity vector.
 		 * @param edge The pointer to the edge.
+		 * @param vic  Receives the RS-vertices, sorted by atom index.
 		 */
-		void ComputeVicinityEdge( RSEdge *edge);
+		void ComputeVicinityEdge( RSEdge *edge, std::vector<RSVertex*> &vic) const;
 
 		/** 
 		 * Write the indices of all atoms within the probe range relative to an
 		 * RS-vertex.
 		 * @param vertex The pointer to the RS-vertex.
+		 * @param vic    Receives the RS-vertices, sorted by atom index.
 		 */
-		void ComputeVicinityVertex( RSVertex *vertex);
+		void ComputeVicinityVertex( RSVertex *vertex, std::vector<RSVertex*> &vic) const;
 		
 		/** 
 		 * Get the positions of all probes which cut a specific RS-edge.
@@ -371,6 +374,20 @@ namespace protein {
 		 */
 		void ComputeRSFace( unsigned int edgeIdx);
 
+		/**
+		 * Compute the next RS-faces for all edges starting at 'firstEdgeIdx',
+		 * including the edges created on the way.
+		 *
+		 * The edges are processed in waves: the candidates of all edges of a
+		 * wave are searched in parallel, then committed in edge order. As a
+		 * candidate only depends on its edge, the result is the same as
+		 * calling ComputeRSFace for every edge in turn, for any number of
+		 * threads.
+		 *
+		 * @param firstEdgeIdx The index of the first edge.
+		 */
+		void ComputeRSFaces( unsigned int firstEdgeIdx);
+
 		/**
 		 * Compute the rotation angle between two probe positions for a given direction
 		 * of rotation.
@@ -401,6 +418,42 @@ namespace protein {
 		void ComputeProbeCutVertex( RSVertex *vertex);
 				
 	private:
+		/**
+		 * The result of rotating the probe around an RS-edge, which is
+		 * committed to the RS later on.
+		 */
+		struct FaceCandidate {
+			/** Changes of the RS-vertex states, in the order they were found */
+			enum StateChange { NOT_BURIED, BURIED, TREATED };
+			std::vector<std::pair<RSVertex*, StateChange> > stateChanges;
+			/** The RS-vertex of the new face, NULL if none was found */
+			RSVertex *vertex;
+			float angle;
+			float factor;
+			/** Auxiliary vicinity array */
+			std::vector<RSVertex*> vicinity;
+		};
+
+		/**
+		 * Rotate the probe around the edge and find the first atom it hits.
+		 * Does not modify the RS, so it can run concurrently for many edges.
+		 *
+		 * @param edge      The edge, which must have one face assigned.
+		 * @param candidate Receives the result.
+		 */
+		void FindRSFaceCandidate( RSEdge *edge, FaceCandidate &candidate) const;
+
+		/**
+		 * Apply the state changes of a candidate and add its face to the RS.
+		 *
+		 * @param edge      The edge the candidate was computed for.
+		 * @param candidate The candidate.
+		 */
+		void CommitRSFace( RSEdge *edge, const FaceCandidate &candidate);
+
+		/** Sort the RS-vertices into the atom cell list */
+		void BuildAtomGrid();
+
 		// The pointer to the protein data interface
 		megamol::protein_calls::MolecularDataCall *molecule;
 		
@@ -435,8 +488,14 @@ namespace protein {
 		// the RS-face list
 		std::vector<RSFace*> rsFace;
 
-		// vector for the voxel map for RS-vertex positions
-		std::vector<std::vector<std::vector<std::vector<RSVertex*> > > > voxelMap;
+		// cell list of the RS-vertex positions (indices into rsVertex)
+		NeighbourCellList atomGrid;
+		// RS-vertex positions for the cell list
+		std::vector<float> atomGridPositions;
+		// the largest atom radius
+		float maxAtomRadius;
+		// candidates for the current wave of RS-edges
+		std::vector<FaceCandidate> candidates;
 		// vector for the voxel map for probe positions
 		std::vector<std::vector<std::vector<std::vector<RSFace*> > > > voxelMapProbes;
 		// float voxel length
@@ -7,6 +7,7 @@
 */
 #include "stdafx.h"
 #include "SolventCounter.h"
+#include "MolecularTrajectory.h"
 #include "vislib/assert.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/param/FloatParam.h"
@@ -136,35 +137,53 @@ bool SolventCounter::getDataCallback(core::Call& call) {
         }
         this->minValue = FLT_MAX;
         this->maxValue = FLT_MIN;
-        // loop over all frames
-        vislib::math::Vector<float, 3> molAtomPos, solAtomPos;
-        for (unsigned int fID = 0; fID < frameCount; fID++) {
-            if ( fID % 100 == 0 )
-                megamol::core::utility::log::Log::DefaultLog.WriteInfo("Computing Frame %i", fID);
-            mol->SetFrameID(fID);
-            if (!(*mol)(MolecularDataCall::CallForGetData)) return false;
-            sol->SetFrameID(fID);
-            if (!(*sol)(MolecularDataCall::CallForGetData)) return false;
+        const unsigned int molAtomCount = mol->AtomCount();
+        const unsigned int solAtomCount = sol->AtomCount();
+        const float radius = this->radiusParam.Param<param::FloatParam>()->Value();
+        this->datahash = mol->DataHash();
+        mol->Unlock();
+        sol->Unlock();
+        // load both trajectories frame by frame, count the frames in parallel
+        struct Frame {
+            std::vector<float> molPos, solPos;
+        };
+        auto load = [&](unsigned int fID, Frame& f) {
+            return LoadAtomPositions(*mol, fID, molAtomCount, f.molPos) &&
+                   LoadAtomPositions(*sol, fID, solAtomCount, f.solPos);
+        };
+        auto count = [&](unsigned int, const Frame& f, std::vector<float>& counts) {
             // loop over all molecule atoms and check for neighboring solvent atoms
-            for (unsigned int i = 0; i < mol->AtomCount(); i++) {
-                molAtomPos.Set(mol->AtomPositions()[3 * i],
-                    mol->AtomPositions()[3 * i + 1], mol->AtomPositions()[3 * i + 2]);
-                for (unsigned int j = 0; j < sol->AtomCount(); j++) {
-                    solAtomPos.Set(sol->AtomPositions()[3 * j],
-                        sol->AtomPositions()[3 * j + 1], sol->AtomPositions()[3 * j + 2]);
+            vislib::math::Vector<float, 3> molAtomPos, solAtomPos;
+            for (unsigned int i = 0; i < molAtomCount; i++) {
+                molAtomPos.Set(f.molPos[3 * i], f.molPos[3 * i + 1], f.molPos[3 * i + 2]);
+                for (unsigned int j = 0; j < solAtomCount; j++) {
+                    solAtomPos.Set(f.solPos[3 * j], f.solPos[3 * j + 1], f.solPos[3 * j + 2]);
                     // increase counter if the current solvent atom is within the given radius
-                    if ((molAtomPos - solAtomPos).Length() <= this->radiusParam.Param<param::FloatParam>()->Value()) {
-                        this->solvent[i] += 1.0f;
+                    if ((molAtomPos - solAtomPos).Length() <= radius) {
+                        counts[i] += 1.0f;
                         break;
                     }
                 }
             }
-            this->datahash = mol->DataHash();
-            mol->Unlock();
-            sol->Unlock();
+        };
+        auto merge = [](std::vector<float>& result, const std::vector<float>& partial) {
+            for (size_t i = 0; i < result.size(); i++) {
+                result[i] += partial[i];
+            }
+        };
+        core::utility::TrajectoryReducer<Frame, std::vector<float>> reducer;
+        reducer.SetProgressCallback(LogTrajectoryProgress("Computing solvent neighborhood", 100));
+        std::vector<float> counts;
+        if (reducer.Run(0, frameCount, load, count, merge, std::vector<float>(molAtomCount, 0.0f), counts) !=
+            core::utility::TrajectoryReducer<Frame, std::vector<float>>::Result::Finished) {
+            this->solvent.Clear();
+            return false;
+        }
+        for (unsigned int i = 0; i < molAtomCount; i++) {
+            this->solvent[i] = counts[i];
         }
         // normalize values
-        for (unsigned int i = 0; i < mol->AtomCount(); i++) {
+        for (unsigned int i = 0; i < molAtomCount; i++) {
             this->solvent[i] /= static_cast<float>(frameCount);
             this->minValue = vislib::math::Min(this->minValue, this->solvent[i]);
             this->maxValue = vislib::math::Max(this->maxValue, this->solvent[i]);
@@ -71,14 +71,9 @@ megamol::protein::SolventHydroBondGenerator::SolventHydroBondGenerator() :
 
 	for(int i = 0; i < HYDROGEN_BOND_IN_CORE; i++)
 		curHBondFrame[i] = -1;
-
-	this->maxOMPThreads = omp_get_max_threads();
-	this->neighbourIndices = new vislib::Array<unsigned int>[this->maxOMPThreads];
-	//this->neighbHydrogenIndices = new vislib::Array<unsigned int>[this->maxOMPThreads];
 }
 
 megamol::protein::SolventHydroBondGenerator::~SolventHydroBondGenerator() {
-	delete [] this->neighbourIndices;
 	this->Release();
 }
 
@@ -244,7 +239,7 @@ void megamol::protein::SolventHydroBondGenerator::calcHydroBondsForCurFrame(Mole
 
 #if 0
 	float hbondDist = hBondDistance.Param<param::FloatParam>()->Value();
-	neighbourFinder.SetPointData(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(), hbondDist);
+	neighbourFinder.Build(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(), hbondDist);
 
 	// looping over residues may not be a good idea?! (index-traversal?) loop over all possible acceptors ...
 #pragma omp parallel for
@@ -274,12 +269,10 @@ Fuer meine Simulationen und alle Bio-Geschichten reicht die Annahme, dass Sauers
 Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabei ist der Wasserstoff am Donor gebunden und bildet die Bruecke zum Akzeptor.
 */
 			if (element=='N' || element=='O' /*|| element=='F' || element=='C'??*/) {
-				int ompThreadID = omp_get_thread_num();
-				neighbourIndices[ompThreadID].Clear(); // clear, keep capacity ...
-				neighbourIndices[ompThreadID].SetCapacityIncrement( 100); // set capacity increment
-				neighbourFinder.FindNeighboursInRange(&atomPositions[aIdx*3], hbondDist, neighbourIndices[ompThreadID]);
-				for(int nIdx = 0; nIdx<neighbourIndices[ompThreadID].Count(); nIdx++) {
-					int neighbIndex = neighbourIndices[ompThreadID][nIdx];
+				vislib::Array<unsigned int> neighbourIndices;
+				neighbourFinder.FindNeighboursInRange(&atomPositions[aIdx*3], hbondDist, neighbourIndices);
+				for(int nIdx = 0; nIdx<neighbourIndices.Count(); nIdx++) {
+					int neighbIndex = neighbourIndices[nIdx];
 					// atom from the current residue?
 					if (atomResidueIndices[neighbIndex]==rIdx)
 						continue;
@@ -344,7 +337,8 @@ Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabe
 	// only fill in donors/acceptors into the neighbour finder grid ...
 	float hbondDonorAcceptorDist = hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
 	float hbondDonorAcceptorAngle = hBondDonorAcceptorAngle.Param<param::FloatParam>()->Value() * static_cast<float>(vislib::math::PI_DOUBLE / 180.0);
-	neighbourFinder.SetPointData(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(), hbondDonorAcceptorDist, &donorAcceptors[0] );
+	// the cell list is kept across frames and only re-sorted when atoms change their cells
+	neighbourFinder.Build(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(), hbondDonorAcceptorDist, &donorAcceptors[0] );
 
 	const int *hydrogenConnectionsPtr = hydrogenConnections.PeekElements();
 
@@ -376,19 +370,13 @@ Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabe
 
 			// nitrogen and oxygen can be donors and acceptors here ...
 			if (donorAcceptors[atomIndex] != -1 /*element=='N' || element=='O'*/) {
-				// access a private array for this parallel thread ...
-				vislib::Array<unsigned int>& privateNeighbourIndices = neighbourIndices[omp_get_thread_num()];
-				privateNeighbourIndices.Clear(); // clear, keep capacity ...
-				privateNeighbourIndices.SetCapacityIncrement( 100); // set capacity increment
-				neighbourFinder.FindNeighboursInRange(&atomPositions[atomIndex*3], hbondDonorAcceptorDist, privateNeighbourIndices);
-
-				for (int nIdx = 0; nIdx < (int)privateNeighbourIndices.Count(); nIdx++) {
-					int neighbIndex = privateNeighbourIndices[nIdx];
+				neighbourFinder.ForEachNeighbour(&atomPositions[atomIndex*3], hbondDonorAcceptorDist, [&](unsigned int neighbIdx) {
+					int neighbIndex = static_cast<int>(neighbIdx);
 					//char elementNeighb = atomTypes[atomTypeIndices[neighbIndex]].Name()[0];
 
 					// atom from the current residue?
 					if (atomResidueIndices[neighbIndex]==rIdx)
-						continue;
+						return;
 
 					//ASSERT(donorAcceptors[neighbIndex] != -1);
 					//if ( elementNeighb=='O' || elementNeighb=='N' ) { ... }
@@ -425,7 +413,7 @@ Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabe
 						}
 						hydrogenConnIdx++;
 					}
-				}
+				});
 			}
 		}
 	}
@@ -14,7 +14,8 @@
 #include "mmcore/param/ParamSlot.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
-#include "GridNeighbourFinder.h"
+#include "NeighbourCellList.h"
+#include "vislib/math/ShallowPoint.h"
 #include "vislib/Array.h"
 #include "vislib/math/Vector.h"
 #include "vislib/math/Cuboid.h"
@@ -176,11 +177,9 @@ namespace protein {
 		vislib::Array<float> middleAtomPos;
 		vislib::Array<int> middleAtomPosHBonds;
 
-		/** our grid based neighbour finder ... */
-		GridNeighbourFinder<float> neighbourFinder;
+		/** our grid based neighbour finder, reused across frames ... */
+		NeighbourCellList neighbourFinder;
 
-		/** temporary variable to store the neighbour indices for the hydrogen-bound search ...*/
-		vislib::Array<unsigned int> *neighbourIndices;
 		//vislib::Array<unsigned int> *neighbHydrogenIndices;
 		/** store hydrogen connections per atom ... */
 		vislib::Array<int> hydrogenConnections;
@@ -188,7 +187,6 @@ namespace protein {
 		vislib::Array<unsigned int> hydrogenBondStatistics;
 		enum { MAX_HYDROGENS_PER_ATOM = 4 };
 		//enum { DONOR_ACCEPTOR_TYPE_COUNT = 2 /* only 'O' and 'N' can be donor/acceptor*/};
-		int maxOMPThreads;
 
 		/** array to check atoms already connected ... */
 		vislib::Array<int> reverseConnection;
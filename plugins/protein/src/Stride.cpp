@@ -1,8 +1,10 @@
 #include "stdafx.h"
 #include "Stride.h"
+#include "NeighbourCellList.h"
 #include <iostream>
 #include <cstdio>
 #include <algorithm>
+#include <utility>
 
 
 using namespace megamol::protein;
@@ -210,10 +212,13 @@ bool Stride::ComputeSecondaryStructure() {
     PhiPsiMapHelix = DefaultHelixMap ( StrideCmd );
     PhiPsiMapSheet = DefaultSheetMap ( StrideCmd );
 
+    // backbone angles, hydrogens and H-bond energies are computed for all chains in parallel,
+    // the assignment below stays serial as Sheet() marks residues of both chains
+#pragma omp parallel for schedule( dynamic )
     for ( Cn = 0; Cn < ProteinChainCnt; ++Cn )
         PlaceHydrogens( ProteinChain[Cn] );
 
-    if( ( HydroBondCnt = FindHydrogenBonds( ProteinChain, Cn, HydroBond, StrideCmd) ) == 0 )
+    if( ( HydroBondCnt = FindHydrogenBonds( ProteinChain, ProteinChainCnt, HydroBond, StrideCmd) ) == 0 )
     {
         //die( "No hydrogen bonds found in %s\n", StrideCmd->InputFile );
         printf( "No hydrogen bonds found.\n" );
@@ -255,60 +260,15 @@ bool Stride::ComputeSecondaryStructure() {
 
 bool Stride::WriteToInterface( MolecularDataCall *mol) {
     if( mol ) {
-        int Cn, i;
-        char type;
-        int firstRes;
-        int resCnt;
-        int idx = 0;
-        
         std::vector<MolecularDataCall::SecStructure> sec;
-        
-        if ( !ExistsSecStr( ProteinChain, ProteinChainCnt ) )
+        std::vector<unsigned int> molSec;
+        int i;
+
+        if ( !GetSecondaryStructure( mol, sec, molSec) )
             return false;
-        
-        for ( Cn = 0; Cn < ProteinChainCnt; ++Cn ) {
-            // do nothing if the current chain is not valid
-            if ( !ProteinChain[Cn]->Valid )
-                continue;
-            
-            // set initial values for first sec struct elem
-            firstRes = mol->Molecules()[Cn].FirstResidueIndex();
-            resCnt = 1;
-            type = ProteinChain[Cn]->Rsd[0]->Prop->Asn;
-            
-            for ( i = 1; i < ProteinChain[Cn]->NRes; i++ ) {
-                // update values if type did not change
-                if( ProteinChain[Cn]->Rsd[i]->Prop->Asn == type ) {
-                    resCnt++;
-                } else {
-                    // write sec struct elem to vector if new elem starts
-                    sec.push_back( MolecularDataCall::SecStructure());
-                    sec.back().SetPosition( firstRes, resCnt);
-                    if( type == 'G' || type == 'H' || type == 'I' )
-                        sec.back().SetType( MolecularDataCall::SecStructure::TYPE_HELIX);
-                    else if( type == 'E' )
-                        sec.back().SetType( MolecularDataCall::SecStructure::TYPE_SHEET);
-                    else
-                        sec.back().SetType( MolecularDataCall::SecStructure::TYPE_COIL);
-                    // start new sec struct elem
-                    firstRes = i + mol->Molecules()[Cn].FirstResidueIndex();
-                    resCnt = 1;
-                    type = ProteinChain[Cn]->Rsd[i]->Prop->Asn;
-                }
-                
-                //printf( "CHAIN %4i RES %5i ASN %c\n", Cn, i, ProteinChain[Cn]->Rsd[i]->Prop->Asn);
-            }
-            // write last sec struct elem to vector
-            sec.push_back( MolecularDataCall::SecStructure());
-            sec.back().SetPosition( firstRes, resCnt);
-            if( type == 'G' || type == 'H' || type == 'I' )
-                sec.back().SetType( MolecularDataCall::SecStructure::TYPE_HELIX);
-            else if( type == 'E' )
-                sec.back().SetType( MolecularDataCall::SecStructure::TYPE_SHEET);
-            else
-                sec.back().SetType( MolecularDataCall::SecStructure::TYPE_COIL);
-            mol->SetMoleculeSecondaryStructure( Cn, idx, (unsigned int)sec.size() - idx);
-            idx = (int)sec.size();
+
+        for ( i = 0; i < (int)molSec.size(); i += 3 ) {
+            mol->SetMoleculeSecondaryStructure( molSec[i], molSec[i+1], molSec[i+2]);
         }
         // handled all residues of current chain, copy sec struct to interface
 		mol->SetSecondaryStructureCount((unsigned int)sec.size());
@@ -325,6 +285,67 @@ bool Stride::WriteToInterface( MolecularDataCall *mol) {
     return true;
 }
 
+bool Stride::GetSecondaryStructure( MolecularDataCall *mol, std::vector<MolecularDataCall::SecStructure> &sec,
+        std::vector<unsigned int> &molSec) {
+    int Cn, i;
+    char type;
+    int firstRes;
+    int resCnt;
+    int idx = 0;
+
+    sec.clear();
+    molSec.clear();
+
+    if ( !ExistsSecStr( ProteinChain, ProteinChainCnt ) )
+        return false;
+
+    for ( Cn = 0; Cn < ProteinChainCnt; ++Cn ) {
+        // do nothing if the current chain is not valid
+        if ( !ProteinChain[Cn]->Valid )
+            continue;
+
+        // set initial values for first sec struct elem
+        firstRes = mol->Molecules()[Cn].FirstResidueIndex();
+        resCnt = 1;
+        type = ProteinChain[Cn]->Rsd[0]->Prop->Asn;
+
+        for ( i = 1; i < ProteinChain[Cn]->NRes; i++ ) {
+            // update values if type did not change
+            if( ProteinChain[Cn]->Rsd[i]->Prop->Asn == type ) {
+                resCnt++;
+            } else {
+                // write sec struct elem to vector if new elem starts
+                sec.push_back( MolecularDataCall::SecStructure());
+                sec.back().SetPosition( firstRes, resCnt);
+                if( type == 'G' || type == 'H' || type == 'I' )
+                    sec.back().SetType( MolecularDataCall::SecStructure::TYPE_HELIX);
+                else if( type == 'E' )
+                    sec.back().SetType( MolecularDataCall::SecStructure::TYPE_SHEET);
+                else
+                    sec.back().SetType( MolecularDataCall::SecStructure::TYPE_COIL);
+                // start new sec struct elem
+                firstRes = i + mol->Molecules()[Cn].FirstResidueIndex();
+                resCnt = 1;
+                type = ProteinChain[Cn]->Rsd[i]->Prop->Asn;
+            }
+        }
+        // write last sec struct elem to vector
+        sec.push_back( MolecularDataCall::SecStructure());
+        sec.back().SetPosition( firstRes, resCnt);
+        if( type == 'G' || type == 'H' || type == 'I' )
+            sec.back().SetType( MolecularDataCall::SecStructure::TYPE_HELIX);
+        else if( type == 'E' )
+            sec.back().SetType( MolecularDataCall::SecStructure::TYPE_SHEET);
+        else
+            sec.back().SetType( MolecularDataCall::SecStructure::TYPE_COIL);
+        molSec.push_back( Cn);
+        molSec.push_back( idx);
+        molSec.push_back( (unsigned int)sec.size() - idx);
+        idx = (int)sec.size();
+    }
+    return true;
+}
+
 void Stride::DefaultCmd( COMMAND *Cmd ) {
 
     Cmd->SideChainHBond    = STRIDE_NO;
@@ -468,6 +489,7 @@ int Stride::CheckChain( CHAIN *Chain, COMMAND *Cmd) {
 void Stride::BackboneAngles( CHAIN **Chain, int NChain ) {
     int Res, Cn;
 
+#pragma omp parallel for private( Res ) schedule( dynamic )
     for ( Cn=0; Cn<NChain; Cn++ )
     {
 
@@ -693,194 +715,110 @@ int Stride::FindHydrogenBonds( CHAIN **Chain, int NChain, HBOND **HBond, COMMAND
     for ( i=0; i<NAcc; i++ )
         BondedAcceptor[i] = STRIDE_NO;
 
-    for ( dc=0; dc<NDnr; dc++ )
+    // sort the acceptor atoms into a grid, only acceptors within DistCutOff of a donor can form a bond
+    std::vector<float> AccPos( static_cast<size_t>( NAcc ) * 3 );
+    vislib::math::Cuboid<float> AccBox;
+    for ( ac=0; ac<NAcc; ac++ )
     {
+        float *p = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+        std::copy( p, p + 3, &AccPos[static_cast<size_t>( ac ) * 3] );
+        if ( ac == 0 )
+            AccBox.Set( p[0], p[1], p[2], p[0], p[1], p[2] );
+        else
+            AccBox.GrowToPoint( p[0], p[1], p[2] );
+    }
+    NeighbourCellList AccGrid;
+    AccGrid.Build( AccPos.data(), NAcc, AccBox, Cmd->DistCutOff );
 
-        if ( Dnr[dc]->Group != Peptide && !Cmd->SideChainHBond ) continue;
-
-        for ( ac=0; ac<NAcc; ac++ )
+    // evaluate the donor-acceptor pairs in parallel, the bonds of every donor are kept in acceptor order
+    std::vector<std::vector<std::pair<int, HBOND> > > DnrBonds( NDnr );
+#pragma omp parallel
+    {
+        std::vector<int> Near;
+#pragma omp for schedule( dynamic, 64 )
+        for ( int d=0; d<NDnr; d++ )
         {
+            if ( Dnr[d]->Group != Peptide && !Cmd->SideChainHBond ) continue;
 
-            if ( abs ( Acc[ac]->A_Res - Dnr[dc]->D_Res ) < 2 && Acc[ac]->Chain->Id == Dnr[dc]->Chain->Id )
-                continue;
+            Near.clear();
+            // the grid query is slightly wider, EvaluateHBond applies the exact cut-off
+            AccGrid.ForEachNeighbour( Dnr[d]->Chain->Rsd[Dnr[d]->D_Res]->Coord[Dnr[d]->D_At],
+                                      Cmd->DistCutOff * 1.001f, [&Near]( unsigned int a ) { Near.push_back( a ); } );
+            std::sort( Near.begin(), Near.end() );
 
-            if ( Acc[ac]->Group != Peptide && !Cmd->SideChainHBond ) continue;
+            for ( int a : Near )
+            {
+                if ( abs ( Acc[a]->A_Res - Dnr[d]->D_Res ) < 2 && Acc[a]->Chain->Id == Dnr[d]->Chain->Id )
+                    continue;
+
+                if ( Acc[a]->Group != Peptide && !Cmd->SideChainHBond ) continue;
+
+                HBOND Bond;
+                memset( &Bond, 0, sizeof( HBOND ) );
+                if ( EvaluateHBond( Dnr[d], Acc[a], Cmd, &Bond ) )
+                    DnrBonds[d].push_back( std::make_pair( a, Bond ) );
+            }
+        }
+    }
+
+    // register the bonds in the order of the serial algorithm
+    for ( dc=0; dc<NDnr; dc++ )
+    {
+        for ( auto& Found : DnrBonds[dc] )
+        {
+            ac = Found.first;
 
             if ( hc == MAXHYDRBOND )
                 die ( "Number of hydrogen bonds exceeds current limit of %d in %s\n",
                       MAXHYDRBOND,Chain[0]->File );
             HBond[hc] = ( HBOND * ) ckalloc ( sizeof ( HBOND ) );
+            *HBond[hc] = Found.second;
 
-            HBond[hc]->ExistHydrBondRose = STRIDE_NO;
-            HBond[hc]->ExistHydrBondBaker = STRIDE_NO;
-            HBond[hc]->ExistPolarInter = STRIDE_NO;
-
-            if ( ( HBond[hc]->AccDonDist =
-                        Dist ( Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                               Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At] ) ) <=
-                    Cmd->DistCutOff )
+            HBond[hc]->Dnr = Dnr[dc];
+            HBond[hc]->Acc = Acc[ac];
+            BondedDonor[dc] = STRIDE_YES;
+            BondedAcceptor[ac] = STRIDE_YES;
+            if ( ( ccd = FindChain ( Chain,NChain,Dnr[dc]->Chain->Id ) ) != ERR )
             {
-
-
-                if ( Cmd->MainChainPolarInt && Dnr[dc]->Group == Peptide &&
-                        Acc[ac]->Group == Peptide && Dnr[dc]->H != ERR )
-                {
-                    GRID_Energy ( Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At],
-                                  Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                  Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                  Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                                  Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                  Cmd,HBond[hc] );
-
-                    if ( HBond[hc]->Energy < -10.0 &&
-                            ( ( Cmd->EnergyType == 'G' && fabs ( HBond[hc]->Et ) > Eps &&
-                                fabs ( HBond[hc]->Ep ) > Eps ) || Cmd->EnergyType != 'G' ) )
-                        HBond[hc]->ExistPolarInter = STRIDE_YES;
-                }
-
-                if ( Cmd->MainChainHBond &&
-                        ( HBond[hc]->OHDist =
-                              Dist ( Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At] ) ) <= 2.5 &&
-                        ( HBond[hc]->AngNHO =
-                              Ang ( Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                    Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                                    Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At] ) ) >= 90.0 &&
-                        HBond[hc]->AngNHO <= 180.0 &&
-                        ( HBond[hc]->AngCOH =
-                              Ang ( Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                    Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                    Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H] ) ) >= 90.0 &&
-
-                        HBond[hc]->AngCOH <= 180.0 )
-                    HBond[hc]->ExistHydrBondBaker = STRIDE_YES;
-
-                if ( Cmd->MainChainHBond &&
-                        HBond[hc]->AccDonDist <= Dnr[dc]->HB_Radius+Acc[ac]->HB_Radius )
-                {
-
-                    HBond[hc]->AccAng =
-                        Ang ( Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                              Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                              Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At] );
-
-                    if ( ( ( Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2 ) &&
-                            ( HBond[hc]->AccAng >= MINACCANG_SP2 &&
-                              HBond[hc]->AccAng <= MAXACCANG_SP2 ) ) ||
-                            ( ( Acc[ac]->Hybrid == Ssp3 ||  Acc[ac]->Hybrid == Osp3 ) &&
-                              ( HBond[hc]->AccAng >= MINACCANG_SP3 &&
-                                HBond[hc]->AccAng <= MAXACCANG_SP3 ) ) )
-                    {
-
-                        HBond[hc]->DonAng =
-                            Ang ( Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                  Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                  Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At] );
-
-                        if ( ( ( Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2 ) &&
-                                ( HBond[hc]->DonAng >= MINDONANG_SP2 &&
-                                  HBond[hc]->DonAng <= MAXDONANG_SP2 ) ) ||
-                                ( ( Dnr[dc]->Hybrid == Nsp3 || Dnr[dc]->Hybrid == Osp3 ) &&
-                                  ( HBond[hc]->DonAng >= MINDONANG_SP3 &&
-                                    HBond[hc]->DonAng <= MAXDONANG_SP3 ) ) )
-                        {
-
-                            if ( Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2 )
-                            {
-                                HBond[hc]->AccDonAng =
-                                    fabs ( Torsion ( Dnr[dc]->Chain->Rsd[Dnr[dc]->DDI_Res]->Coord[Dnr[dc]->DDI_At],
-                                                     Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                                     Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At],
-                                                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At] ) );
-
-                                if ( HBond[hc]->AccDonAng > 90.0f && HBond[hc]->AccDonAng < 270.0f )
-                                    HBond[hc]->AccDonAng = fabs( 180.0f - HBond[hc]->AccDonAng );
-
-                            }
-
-                            if ( Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2 )
-                            {
-                                HBond[hc]->DonAccAng =
-                                    fabs ( Torsion ( Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                                     Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                                     Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At] ) );
-
-                                if ( HBond[hc]->DonAccAng > 90.0f && HBond[hc]->DonAccAng < 270.0f )
-                                    HBond[hc]->DonAccAng = fabs( 180.0f - HBond[hc]->DonAccAng );
-
-                            }
-
-                            if ( ( Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 &&
-                                    Acc[ac]->Hybrid != Nsp2 && Acc[ac]->Hybrid != Osp2 ) ||
-                                    ( Acc[ac]->Hybrid != Nsp2 && Acc[ac]->Hybrid != Osp2 &&
-                                      ( Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2 ) &&
-                                      HBond[hc]->AccDonAng <= ACCDONANG ) ||
-                                    ( Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 &&
-                                      ( Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2 ) &&
-                                      HBond[hc]->DonAccAng <= DONACCANG ) ||
-                                    ( ( Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2 ) &&
-                                      ( Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2 ) &&
-                                      HBond[hc]->AccDonAng <= ACCDONANG &&
-                                      HBond[hc]->DonAccAng <= DONACCANG ) )
-                                HBond[hc]->ExistHydrBondRose = STRIDE_YES;
-                        }
-                    }
-                }
-
+                if ( Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR )
+                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->
+                    HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
+                else
+                    printf ( "Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                             Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType,
+                             Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
+                             Chain[ccd]->ChainId,
+                             MAXRESDNR,Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr );
             }
-
-            if ( ( HBond[hc]->ExistPolarInter && HBond[hc]->Energy < 0.0 )
-                    || HBond[hc]->ExistHydrBondRose || HBond[hc]->ExistHydrBondBaker )
+            if ( ( cca  = FindChain ( Chain,NChain,Acc[ac]->Chain->Id ) ) != ERR )
             {
-                HBond[hc]->Dnr = Dnr[dc];
-                HBond[hc]->Acc = Acc[ac];
-                BondedDonor[dc] = STRIDE_YES;
-                BondedAcceptor[ac] = STRIDE_YES;
-                if ( ( ccd = FindChain ( Chain,NChain,Dnr[dc]->Chain->Id ) ) != ERR )
-                {
-                    if ( Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR )
-                        Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->
-                        HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
-                    else
-                        printf ( "Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                                 Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType,
-                                 Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
-                                 Chain[ccd]->ChainId,
-                                 MAXRESDNR,Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr );
-                }
-                if ( ( cca  = FindChain ( Chain,NChain,Acc[ac]->Chain->Id ) ) != ERR )
-                {
-                    if ( Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC )
-                        Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->
-                        HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
-                    else
-                        printf ( "Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                                 Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType,
-                                 Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
-                                 Chain[cca]->ChainId,
-                                 MAXRESDNR,Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc );
-                }
-                if ( ccd != cca && ccd != ERR )
+                if ( Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC )
+                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->
+                    HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
+                else
+                    printf ( "Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                             Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType,
+                             Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
+                             Chain[cca]->ChainId,
+                             MAXRESDNR,Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc );
+            }
+            if ( ccd != cca && ccd != ERR )
+            {
+                Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                if ( HBond[hc]->ExistHydrBondRose )
                 {
-                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    if ( HBond[hc]->ExistHydrBondRose )
-                    {
-                        Chain[0]->NHydrBondInterchain++;
-                        Chain[0]->NHydrBondTotal++;
-                    }
+                    Chain[0]->NHydrBondInterchain++;
+                    Chain[0]->NHydrBondTotal++;
                 }
-                else
-                    if ( ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose )
-                    {
-                        Chain[ccd]->NHydrBond++;
-                        Chain[0]->NHydrBondTotal++;
-                    }
-                hc++;
             }
             else
-                free ( HBond[hc] );
+                if ( ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose )
+                {
+                    Chain[ccd]->NHydrBond++;
+                    Chain[0]->NHydrBondTotal++;
+                }
+            hc++;
         }
     }
     
@@ -902,15 +840,153 @@ int Stride::FindHydrogenBonds( CHAIN **Chain, int NChain, HBOND **HBond, COMMAND
     return ( hc );
 }
 
+Stride::BOOLEAN Stride::EvaluateHBond( DONOR *Dnr, ACCEPTOR *Acc, COMMAND *Cmd, HBOND *HBond ) {
+
+    HBond->ExistHydrBondRose = STRIDE_NO;
+    HBond->ExistHydrBondBaker = STRIDE_NO;
+    HBond->ExistPolarInter = STRIDE_NO;
+
+    if ( ( HBond->AccDonDist =
+                Dist ( Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                       Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At] ) ) <=
+            Cmd->DistCutOff )
+    {
+
+        if ( Cmd->MainChainPolarInt && Dnr->Group == Peptide &&
+                Acc->Group == Peptide && Dnr->H != ERR )
+        {
+            GRID_Energy ( Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At],
+                          Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                          Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                          Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                          Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                          Cmd,HBond );
+
+            if ( HBond->Energy < -10.0 &&
+                    ( ( Cmd->EnergyType == 'G' && fabs ( HBond->Et ) > Eps &&
+                        fabs ( HBond->Ep ) > Eps ) || Cmd->EnergyType != 'G' ) )
+                HBond->ExistPolarInter = STRIDE_YES;
+        }
+
+        if ( Cmd->MainChainHBond &&
+                ( HBond->OHDist =
+                      Dist ( Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At] ) ) <= 2.5 &&
+                ( HBond->AngNHO =
+                      Ang ( Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                            Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At] ) ) >= 90.0 &&
+                HBond->AngNHO <= 180.0 &&
+                ( HBond->AngCOH =
+                      Ang ( Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                            Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H] ) ) >= 90.0 &&
+
+                HBond->AngCOH <= 180.0 )
+            HBond->ExistHydrBondBaker = STRIDE_YES;
+
+        if ( Cmd->MainChainHBond &&
+                HBond->AccDonDist <= Dnr->HB_Radius+Acc->HB_Radius )
+        {
+
+            HBond->AccAng =
+                Ang ( Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                      Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                      Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At] );
+
+            if ( ( ( Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2 ) &&
+                    ( HBond->AccAng >= MINACCANG_SP2 &&
+                      HBond->AccAng <= MAXACCANG_SP2 ) ) ||
+                    ( ( Acc->Hybrid == Ssp3 ||  Acc->Hybrid == Osp3 ) &&
+                      ( HBond->AccAng >= MINACCANG_SP3 &&
+                        HBond->AccAng <= MAXACCANG_SP3 ) ) )
+            {
+
+                HBond->DonAng =
+                    Ang ( Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                          Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                          Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At] );
+
+                if ( ( ( Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2 ) &&
+                        ( HBond->DonAng >= MINDONANG_SP2 &&
+                          HBond->DonAng <= MAXDONANG_SP2 ) ) ||
+                        ( ( Dnr->Hybrid == Nsp3 || Dnr->Hybrid == Osp3 ) &&
+                          ( HBond->DonAng >= MINDONANG_SP3 &&
+                            HBond->DonAng <= MAXDONANG_SP3 ) ) )
+                {
+
+                    if ( Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2 )
+                    {
+                        HBond->AccDonAng =
+                            fabs ( Torsion ( Dnr->Chain->Rsd[Dnr->DDI_Res]->Coord[Dnr->DDI_At],
+                                             Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                                             Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At],
+                                             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At] ) );
+
+                        if ( HBond->AccDonAng > 90.0f && HBond->AccDonAng < 270.0f )
+                            HBond->AccDonAng = fabs( 180.0f - HBond->AccDonAng );
+
+                    }
+
+                    if ( Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2 )
+                    {
+                        HBond->DonAccAng =
+                            fabs ( Torsion ( Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                                             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                                             Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                                             Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At] ) );
+
+                        if ( HBond->DonAccAng > 90.0f && HBond->DonAccAng < 270.0f )
+                            HBond->DonAccAng = fabs( 180.0f - HBond->DonAccAng );
+
+                    }
+
+                    if ( ( Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 &&
+                            Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2 ) ||
+                            ( Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2 &&
+                              ( Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2 ) &&
+                              HBond->AccDonAng <= ACCDONANG ) ||
+                            ( Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 &&
+                              ( Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2 ) &&
+                              HBond->DonAccAng <= DONACCANG ) ||
+                            ( ( Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2 ) &&
+                              ( Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2 ) &&
+                              HBond->AccDonAng <= ACCDONANG &&
+                              HBond->DonAccAng <= DONACCANG ) )
+                        HBond->ExistHydrBondRose = STRIDE_YES;
+                }
+            }
+        }
+
+    }
+
+    return ( ( HBond->ExistPolarInter && HBond->Energy < 0.0 )
+             || HBond->ExistHydrBondRose || HBond->ExistHydrBondBaker );
+}
+
 int Stride::NoDoubleHBond( HBOND **HBond, int NHBond ) {
 
-    int i, j, NExcl=0;
+    int i, j, k, l, NExcl=0;
 
-    for ( i=0; i<NHBond-1; i++ )
-        for ( j=i+1; j<NHBond; j++ )
-            if ( HBond[i]->Dnr->D_Res == HBond[j]->Dnr->D_Res &&
-                    HBond[i]->Dnr->Chain->Id == HBond[j]->Dnr->Chain->Id &&
-                    HBond[i]->ExistPolarInter && HBond[j]->ExistPolarInter )
+    // only bonds of the same donor residue compete, so the pairs are tested per donor residue
+    std::vector<int> Order( NHBond );
+    for ( i=0; i<NHBond; i++ )
+        Order[i] = i;
+    std::stable_sort( Order.begin(), Order.end(), [HBond]( int a, int b ) {
+        if ( HBond[a]->Dnr->Chain->Id != HBond[b]->Dnr->Chain->Id )
+            return HBond[a]->Dnr->Chain->Id < HBond[b]->Dnr->Chain->Id;
+        return HBond[a]->Dnr->D_Res < HBond[b]->Dnr->D_Res;
+    } );
+
+    for ( k=0; k<NHBond-1; k++ )
+        for ( l=k+1; l<NHBond; l++ )
+        {
+            i = Order[k];
+            j = Order[l];
+            if ( HBond[i]->Dnr->D_Res != HBond[j]->Dnr->D_Res ||
+                    HBond[i]->Dnr->Chain->Id != HBond[j]->Dnr->Chain->Id )
+                break;
+            if ( HBond[i]->ExistPolarInter && HBond[j]->ExistPolarInter )
             {
                 if ( HBond[i]->Energy < 5.0*HBond[j]->Energy )
                 {
@@ -924,6 +1000,7 @@ int Stride::NoDoubleHBond( HBOND **HBond, int NHBond ) {
                         NExcl++;
                     }
             }
+        }
 
     return ( NExcl );
 }
@@ -932,6 +1009,7 @@ void Stride::DiscrPhiPsi( CHAIN **Chain, int NChain, COMMAND *Cmd ) {
     int i, Res, Cn;
     RESIDUE *r;
 
+#pragma omp parallel for private( i, Res, r ) schedule( dynamic )
     for ( Cn=0; Cn<NChain; Cn++ )
     {
 
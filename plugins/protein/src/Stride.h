@@ -284,6 +284,24 @@ public:
 	virtual ~Stride(void);
 
 	bool WriteToInterface(megamol::protein_calls::MolecularDataCall *mol);
+
+	/**
+	 * Answers the secondary structure elements in the layout expected by
+	 * MolecularDataCall::SetSecondaryStructure.
+	 *
+	 * @param mol    The call the structure was computed from.
+	 * @param sec    Receives the secondary structure elements.
+	 * @param molSec Receives (molecule, first element, element count) for every valid molecule.
+	 *
+	 * @return false if no secondary structure was found.
+	 */
+	bool GetSecondaryStructure(megamol::protein_calls::MolecularDataCall *mol,
+		std::vector<megamol::protein_calls::MolecularDataCall::SecStructure> &sec, std::vector<unsigned int> &molSec);
+
+	/** Answers the hydrogen bonds as (donor, acceptor) atom index pairs */
+	inline const std::vector<unsigned int> &HydrogenBonds(void) const {
+		return this->ownHydroBonds;
+	}
 	
 protected:
 
@@ -308,6 +326,7 @@ protected:
 	float **DefaultSheetMap( COMMAND *Cmd);
 	int PlaceHydrogens( CHAIN *Chain );
 	int FindHydrogenBonds( CHAIN **Chain, int NChain, HBOND **HBond, COMMAND *Cmd );
+	BOOLEAN EvaluateHBond( DONOR *Dnr, ACCEPTOR *Acc, COMMAND *Cmd, HBOND *HBond );
 	int NoDoubleHBond( HBOND **HBond, int NHBond );
 	void DiscrPhiPsi( CHAIN **Chain, int NChain, COMMAND *Cmd );
 	void Helix( CHAIN **Chain, int Cn, HBOND **HBond, COMMAND *Cmd, float **PhiPsiMap );
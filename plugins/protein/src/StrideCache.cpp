@@ -0,0 +1,140 @@
+/*
+ * StrideCache.cpp
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "stdafx.h"
+#include "StrideCache.h"
+
+#include <algorithm>
+
+#include "Stride.h"
+
+using namespace megamol;
+using namespace megamol::protein;
+using namespace megamol::protein_calls;
+
+namespace {
+/** Number of coordinates hashed per block */
+constexpr unsigned int hashBlockSize = 1 << 16;
+
+inline uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+} // namespace
+
+/*
+ * StrideCache::StrideCache
+ */
+StrideCache::StrideCache(size_t capacity)
+        : capacity(capacity), usedBytes(0), useCounter(0), lastComputed(false) {}
+
+/*
+ * StrideCache::Clear
+ */
+void StrideCache::Clear(void) {
+    this->entries.clear();
+    this->usedBytes = 0;
+    this->lastComputed = false;
+}
+
+/*
+ * StrideCache::SetCapacity
+ */
+void StrideCache::SetCapacity(size_t capacity) {
+    this->capacity = capacity;
+    this->evict();
+}
+
+/*
+ * StrideCache::WriteToInterface
+ */
+bool StrideCache::WriteToInterface(MolecularDataCall* mol, unsigned int frameID, bool checkPositions) {
+    this->lastComputed = false;
+    if (mol == nullptr) return false;
+
+    uint64_t const hash = checkPositions ? hashPositions(mol->AtomPositions(), mol->AtomCount()) : 0;
+    auto it = this->entries.find(frameID);
+    if (it != this->entries.end() && it->second.atomCount == mol->AtomCount() &&
+        (!checkPositions || it->second.positionHash == hash)) {
+        it->second.lastUse = ++this->useCounter;
+    } else {
+        if (it == this->entries.end()) {
+            it = this->entries.emplace(frameID, Entry()).first;
+        } else {
+            this->usedBytes -= entryBytes(it->second);
+        }
+        Entry& e = it->second;
+        e.positionHash = checkPositions ? hash : hashPositions(mol->AtomPositions(), mol->AtomCount());
+        e.atomCount = mol->AtomCount();
+        e.lastUse = ++this->useCounter;
+        // Stride sets the hydrogen bonds on 'mol', they are replaced by the cached copy below
+        Stride stride(mol);
+        e.valid = stride.GetSecondaryStructure(mol, e.secStructs, e.moleculeSecStructs);
+        e.hydroBonds = stride.HydrogenBonds();
+        this->lastComputed = true;
+        this->usedBytes += entryBytes(e);
+        // the new entry is the most recently used one, so it survives
+        this->evict();
+    }
+
+    Entry const& e = it->second;
+    mol->SetHydrogenBonds(e.hydroBonds.data(), static_cast<unsigned int>(e.hydroBonds.size() / 2));
+    if (!e.valid) return false;
+    for (size_t i = 0; i + 2 < e.moleculeSecStructs.size(); i += 3) {
+        mol->SetMoleculeSecondaryStructure(
+            e.moleculeSecStructs[i], e.moleculeSecStructs[i + 1], e.moleculeSecStructs[i + 2]);
+    }
+    mol->SetSecondaryStructureCount(static_cast<unsigned int>(e.secStructs.size()));
+    for (unsigned int i = 0; i < static_cast<unsigned int>(e.secStructs.size()); ++i) {
+        mol->SetSecondaryStructure(i, e.secStructs[i]);
+    }
+    return true;
+}
+
+/*
+ * StrideCache::entryBytes
+ */
+size_t StrideCache::entryBytes(const Entry& e) {
+    return sizeof(std::pair<const unsigned int, Entry>) +
+           e.secStructs.capacity() * sizeof(MolecularDataCall::SecStructure) +
+           e.moleculeSecStructs.capacity() * sizeof(unsigned int) + e.hydroBonds.capacity() * sizeof(unsigned int);
+}
+
+/*
+ * StrideCache::evict
+ */
+void StrideCache::evict(void) {
+    while (this->usedBytes > this->capacity && this->entries.size() > 1) {
+        auto lru = std::min_element(this->entries.begin(), this->entries.end(),
+            [](const std::pair<const unsigned int, Entry>& l, const std::pair<const unsigned int, Entry>& r) {
+                return l.second.lastUse < r.second.lastUse;
+            });
+        this->usedBytes -= entryBytes(lru->second);
+        this->entries.erase(lru);
+    }
+}
+
+/*
+ * StrideCache::hashPositions
+ */
+uint64_t StrideCache::hashPositions(const float* positions, unsigned int atomCount) {
+    if (positions == nullptr) return 0;
+    size_t const coordCount = static_cast<size_t>(atomCount) * 3;
+    int const blockCount = static_cast<int>((coordCount + hashBlockSize - 1) / hashBlockSize);
+    std::vector<uint64_t> blockHashes(blockCount);
+#pragma omp parallel for
+    for (int b = 0; b < blockCount; ++b) {
+        size_t const first = static_cast<size_t>(b) * hashBlockSize;
+        size_t const count = std::min<size_t>(hashBlockSize, coordCount - first);
+        blockHashes[b] = fnv1a(
+            reinterpret_cast<const unsigned char*>(positions + first), count * sizeof(float), 14695981039346656037ull);
+    }
+    return fnv1a(reinterpret_cast<const unsigned char*>(blockHashes.data()), blockHashes.size() * sizeof(uint64_t),
+        14695981039346656037ull ^ atomCount);
+}
@@ -0,0 +1,105 @@
+/*
+ * StrideCache.h
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOLPROTEIN_STRIDECACHE_H_INCLUDED
+#define MEGAMOLPROTEIN_STRIDECACHE_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#    pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "protein_calls/MolecularDataCall.h"
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Per-frame cache of STRIDE results.
+ *
+ * Every entry keeps the secondary structure elements and hydrogen bonds of
+ * one trajectory frame together with a hash of the atom positions they were
+ * computed from. STRIDE only runs again if a frame is not cached or its
+ * positions changed, e.g. because the frame was re-read from a different
+ * file. The least recently used entries are dropped once the memory they
+ * occupy exceeds the capacity. The entry of the current frame is always kept.
+ */
+class StrideCache {
+public:
+    /**
+     * Ctor.
+     *
+     * @param capacity The maximum number of bytes occupied by the cached frames.
+     */
+    explicit StrideCache(size_t capacity = size_t(64) << 20);
+
+    /** Drops all entries, e.g. after the topology changed. */
+    void Clear(void);
+
+    /**
+     * Sets the maximum number of bytes occupied by the cached frames and
+     * drops the least recently used entries exceeding it.
+     */
+    void SetCapacity(size_t capacity);
+
+    /** Answer the number of bytes occupied by the cached frames */
+    inline size_t MemoryUsage(void) const {
+        return this->usedBytes;
+    }
+
+    /**
+     * Writes the secondary structure and hydrogen bonds of the data set in
+     * 'mol' to 'mol', running STRIDE if needed.
+     *
+     * @param mol            The call holding the atoms, molecules and residues of the frame.
+     * @param frameID        The cache key.
+     * @param checkPositions If false, a cached entry is used regardless of the atom positions.
+     *
+     * @return false if STRIDE did not find any secondary structure.
+     */
+    bool WriteToInterface(protein_calls::MolecularDataCall* mol, unsigned int frameID, bool checkPositions = true);
+
+    /** Answer whether the last call to WriteToInterface had to run STRIDE */
+    inline bool LastCallComputed(void) const {
+        return this->lastComputed;
+    }
+
+private:
+    struct Entry {
+        uint64_t positionHash;
+        unsigned int atomCount;
+        bool valid;
+        std::vector<protein_calls::MolecularDataCall::SecStructure> secStructs;
+        std::vector<unsigned int> moleculeSecStructs;
+        std::vector<unsigned int> hydroBonds;
+        uint64_t lastUse;
+    };
+
+    static uint64_t hashPositions(const float* positions, unsigned int atomCount);
+
+    static size_t entryBytes(const Entry& e);
+
+    /** Drops the least recently used entries until the capacity is met, keeping at least one */
+    void evict(void);
+
+    std::map<unsigned int, Entry> entries;
+
+    size_t capacity;
+
+    size_t usedBytes;
+
+    uint64_t useCounter;
+
+    bool lastComputed;
+};
+
+} // namespace protein
+} // namespace megamol
+
+#endif /* MEGAMOLPROTEIN_STRIDECACHE_H_INCLUDED */
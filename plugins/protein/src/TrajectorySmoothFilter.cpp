@@ -25,6 +25,7 @@
 #include <GL/glu.h>
 
 #include "TrajectorySmoothFilter.h"
+#include "MolecularTrajectory.h"
 
 using namespace megamol;
 using namespace megamol::core;
@@ -117,32 +118,27 @@ bool TrajectorySmoothFilter::getData(megamol::core::Call& call) {
     }
 
     // (Re-)allocate memory and init with zero
-    this->atomPosSmoothed.Validate(molOut->AtomCount()*3);
-    memset(this->atomPosSmoothed.Peek(), 0, molOut->AtomCount()*3*sizeof(float));
+    const uint atomCount = molOut->AtomCount();
+    this->atomPosSmoothed.Validate(atomCount*3);
+    memset(this->atomPosSmoothed.Peek(), 0, atomCount*3*sizeof(float));
 
-    // Loop through all averaging frames
+    // Loop through all averaging frames, the call holds one frame at a time
     for (uint fr = 0; fr < this->nAvgFrames; ++fr) {
-        molOut->SetFrameID(molIn->FrameID()+fr, true); // Set 'force' flag
-        if (!(*molOut)(MolecularDataCall::CallForGetData)){
+        if (!LoadAtomPositions(*molOut, molIn->FrameID()+fr, atomCount, this->framePos)) {
             return false;
         }
-        molOut->Unlock();
 
         // Add positions
 #pragma omp parallel for
-        for (int at = 0; at < static_cast<int>(molOut->AtomCount()); ++at) {
-            this->atomPosSmoothed.Peek()[3*at+0] += molOut->AtomPositions()[3*at+0];
-            this->atomPosSmoothed.Peek()[3*at+1] += molOut->AtomPositions()[3*at+1];
-            this->atomPosSmoothed.Peek()[3*at+2] += molOut->AtomPositions()[3*at+2];
+        for (int i = 0; i < static_cast<int>(atomCount*3); ++i) {
+            this->atomPosSmoothed.Peek()[i] += this->framePos[i];
         }
     }
 
     // Normalize positions
 #pragma omp parallel for
-    for (int at = 0; at < static_cast<int>(molOut->AtomCount()); ++at) {
-        this->atomPosSmoothed.Peek()[3*at+0] /= static_cast<float>(this->nAvgFrames);
-        this->atomPosSmoothed.Peek()[3*at+1] /= static_cast<float>(this->nAvgFrames);
-        this->atomPosSmoothed.Peek()[3*at+2] /= static_cast<float>(this->nAvgFrames);
+    for (int i = 0; i < static_cast<int>(atomCount*3); ++i) {
+        this->atomPosSmoothed.Peek()[i] /= static_cast<float>(this->nAvgFrames);
     }
 
     // Transfer data from outgoing to incoming data call
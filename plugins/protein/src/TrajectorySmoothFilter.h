@@ -23,6 +23,8 @@
 
 #include "HostArr.h"
 
+#include <vector>
+
 typedef unsigned int uint;
 
 namespace megamol {
@@ -157,6 +159,9 @@ private:
     /// Intermediate storage for smoothed atom positions
     HostArr<float> atomPosSmoothed;
 
+    /// Atom positions of the averaging frame being added
+    std::vector<float> framePos;
+
 };
 
 
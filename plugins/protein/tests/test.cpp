@@ -0,0 +1,19 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testhelper.h"
+#include "testreducedsurface.h"
+
+
+/* all available tests:
+ * Add your tests here
+ */
+TestEntry tests[] = {
+    { "ReducedSurface", ::TestReducedSurface, "Compares the reduced surfaces built with 1, 4 and 8 threads" },
+    // end guard. Do not remove. Must be last entry.
+    {NULL, NULL, NULL}
+};
@@ -0,0 +1,164 @@
+/*
+ * testreducedsurface.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testreducedsurface.h"
+#include "testhelper.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <omp.h>
+
+#include "ReducedSurface.h"
+#include "protein_calls/MolecularDataCall.h"
+
+using namespace megamol::protein;
+using megamol::protein_calls::MolecularDataCall;
+
+namespace {
+
+/** Synthetic molecule: atoms on a jittered lattice within a sphere */
+class TestMolecule {
+public:
+    TestMolecule(float radius, float spacing, unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> jitter(-0.25f * spacing, 0.25f * spacing);
+        int const steps = static_cast<int>(std::ceil(radius / spacing));
+        for (int x = -steps; x <= steps; ++x) {
+            for (int y = -steps; y <= steps; ++y) {
+                for (int z = -steps; z <= steps; ++z) {
+                    float const pos[3] = {x * spacing, y * spacing, z * spacing};
+                    if (pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2] > radius * radius) continue;
+                    for (int d = 0; d < 3; ++d) this->positions.push_back(pos[d] + jitter(rng));
+                    this->typeIndices.push_back(static_cast<unsigned int>(this->typeIndices.size() % 3));
+                }
+            }
+        }
+        this->types.push_back(MolecularDataCall::AtomType("C", 1.7f));
+        this->types.push_back(MolecularDataCall::AtomType("N", 1.55f));
+        this->types.push_back(MolecularDataCall::AtomType("O", 1.52f));
+        this->zeros.resize(this->typeIndices.size(), 0.0f);
+        this->residues.resize(this->typeIndices.size(), 0);
+
+        this->call.SetAtoms(static_cast<unsigned int>(this->typeIndices.size()),
+            static_cast<unsigned int>(this->types.size()), this->typeIndices.data(), this->positions.data(),
+            this->types.data(), this->residues.data(), this->zeros.data(), this->zeros.data(), this->zeros.data());
+        float const ext = radius + spacing;
+        this->call.AccessBoundingBoxes().SetObjectSpaceBBox(-ext, -ext, -ext, ext, ext, ext);
+    }
+
+    /** Moves every 'step'-th atom by 'offset' along x, as a new time step */
+    void Move(unsigned int step, float offset) {
+        for (size_t i = 0; i < this->typeIndices.size(); i += step) {
+            this->positions[3 * i] += offset;
+        }
+        this->call.SetAtomPositions(this->positions.data());
+    }
+
+    MolecularDataCall call;
+
+private:
+    std::vector<float> positions;
+    std::vector<unsigned int> typeIndices;
+    std::vector<MolecularDataCall::AtomType> types;
+    std::vector<float> zeros;
+    std::vector<int> residues;
+};
+
+bool sameVector(vislib::math::Vector<float, 3> const& l, vislib::math::Vector<float, 3> const& r) {
+    return l.X() == r.X() && l.Y() == r.Y() && l.Z() == r.Z();
+}
+
+bool sameFace(ReducedSurface::RSFace const* l, ReducedSurface::RSFace const* r) {
+    if (l == NULL || r == NULL) return l == r;
+    return l->GetVertex1()->GetIndex() == r->GetVertex1()->GetIndex() &&
+           l->GetVertex2()->GetIndex() == r->GetVertex2()->GetIndex() &&
+           l->GetVertex3()->GetIndex() == r->GetVertex3()->GetIndex() &&
+           sameVector(l->GetProbeCenter(), r->GetProbeCenter()) && sameVector(l->GetFaceNormal(), r->GetFaceNormal());
+}
+
+/** Answers whether both reduced surfaces have the same vertices, edges and faces in the same order */
+bool sameSurface(ReducedSurface& l, ReducedSurface& r) {
+    if (l.GetRSVertexCount() != r.GetRSVertexCount() || l.GetRSEdgeCount() != r.GetRSEdgeCount() ||
+        l.GetRSFaceCount() != r.GetRSFaceCount() || l.GetCutRSEdgesCount() != r.GetCutRSEdgesCount()) {
+        return false;
+    }
+    for (unsigned int i = 0; i < l.GetRSVertexCount(); ++i) {
+        ReducedSurface::RSVertex const* lv = l.GetRSVertex(i);
+        ReducedSurface::RSVertex const* rv = r.GetRSVertex(i);
+        if (lv->GetIndex() != rv->GetIndex() || lv->IsBuried() != rv->IsBuried() ||
+            lv->GetEdgeCount() != rv->GetEdgeCount()) {
+            return false;
+        }
+    }
+    for (unsigned int i = 0; i < l.GetRSEdgeCount(); ++i) {
+        ReducedSurface::RSEdge const* le = l.GetRSEdge(i);
+        ReducedSurface::RSEdge const* re = r.GetRSEdge(i);
+        if (le->GetVertex1()->GetIndex() != re->GetVertex1()->GetIndex() ||
+            le->GetVertex2()->GetIndex() != re->GetVertex2()->GetIndex() ||
+            !sameVector(le->GetTorusCenter(), re->GetTorusCenter()) ||
+            le->GetRotationAngle() != re->GetRotationAngle() || !sameFace(le->GetFace1(), re->GetFace1()) ||
+            !sameFace(le->GetFace2(), re->GetFace2()) || le->cuttingProbes.size() != re->cuttingProbes.size()) {
+            return false;
+        }
+    }
+    for (unsigned int i = 0; i < l.GetRSFaceCount(); ++i) {
+        if (!sameFace(l.GetRSFace(i), r.GetRSFace(i))) return false;
+    }
+    return true;
+}
+
+/** Builds the reduced surface with 'threads' threads and updates it after moving every seventh atom */
+struct ThreadedSurface {
+    ThreadedSurface(float radius, float probeRad, unsigned int seed, int threads)
+            : mol(radius, 1.6f, seed), surface(&mol.call, probeRad), threads(threads) {
+        int const maxThreads = omp_get_max_threads();
+        omp_set_num_threads(threads);
+        this->surface.ComputeReducedSurface();
+        omp_set_num_threads(maxThreads);
+    }
+
+    bool Update(void) {
+        this->mol.Move(7, 0.4f);
+        int const maxThreads = omp_get_max_threads();
+        omp_set_num_threads(this->threads);
+        bool const updated = this->surface.UpdateData(0.1f, 10.0f);
+        omp_set_num_threads(maxThreads);
+        return updated;
+    }
+
+    TestMolecule mol;
+    ReducedSurface surface;
+    int threads;
+};
+
+/** Compares the waves with 4 and 8 threads against a single thread, for the first build and an update */
+void compareThreadCounts(float radius, float probeRad, unsigned int seed) {
+    ThreadedSurface single(radius, probeRad, seed, 1);
+    ThreadedSurface four(radius, probeRad, seed, 4);
+    ThreadedSurface eight(radius, probeRad, seed, 8);
+
+    AssertTrue("The reduced surface has faces", single.surface.GetRSFaceCount() > 0);
+    AssertTrue("4 threads build the same reduced surface as 1", sameSurface(single.surface, four.surface));
+    AssertTrue("8 threads build the same reduced surface as 1", sameSurface(single.surface, eight.surface));
+
+    bool const singleUpdated = single.Update();
+    AssertEqual("4 threads update like 1", four.Update(), singleUpdated);
+    AssertEqual("8 threads update like 1", eight.Update(), singleUpdated);
+    AssertTrue("4 threads update to the same reduced surface as 1", sameSurface(single.surface, four.surface));
+    AssertTrue("8 threads update to the same reduced surface as 1", sameSurface(single.surface, eight.surface));
+}
+
+} // namespace
+
+
+void TestReducedSurface(void) {
+    compareThreadCounts(6.0f, 1.4f, 1);
+    compareThreadCounts(9.0f, 1.4f, 2);
+    compareThreadCounts(9.0f, 3.0f, 3);
+}
@@ -0,0 +1,16 @@
+/*
+ * testreducedsurface.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef PROTEINTEST_TESTREDUCEDSURFACE_H_INCLUDED
+#define PROTEINTEST_TESTREDUCEDSURFACE_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+void TestReducedSurface(void);
+
+#endif /* PROTEINTEST_TESTREDUCEDSURFACE_H_INCLUDED */
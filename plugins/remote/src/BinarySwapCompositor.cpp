@@ -0,0 +1,217 @@
+#include "stdafx.h"
+#include "BinarySwapCompositor.h"
+
+#ifdef WITH_MPI
+
+#include <algorithm>
+#include <cstring>
+
+#include "mmcore/utility/log/Log.h"
+
+namespace {
+constexpr int bswap_tag = 4711;
+constexpr float far_depth = 1.0f;
+} // namespace
+
+
+megamol::remote::BinarySwapCompositor::BinarySwapCompositor(MPI_Comm comm) : comm_{comm} {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+}
+
+
+bool megamol::remote::BinarySwapCompositor::Composite(std::vector<char>& color, std::vector<char>& depth, int width,
+    int height, int const valid_vp[4], std::array<unsigned char, 4> const& bkgnd) {
+    auto const num_pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    if (color.size() < num_pixels * sizeof(uint32_t) || depth.size() < num_pixels * sizeof(float)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("BinarySwapCompositor: Image buffers too small\n");
+        return false;
+    }
+
+    color_ = reinterpret_cast<uint32_t*>(color.data());
+    depth_ = reinterpret_cast<float*>(depth.data());
+    width_ = width;
+    height_ = height;
+    bytes_sent_ = 0;
+
+    uint32_t bkgnd_pixel = 0;
+    std::memcpy(&bkgnd_pixel, bkgnd.data(), sizeof(uint32_t));
+
+    // pixels outside the rendered tile are background, so they never become active
+    int const vx0 = std::clamp(valid_vp[0], 0, width);
+    int const vy0 = std::clamp(valid_vp[1], 0, height);
+    int const vx1 = std::clamp(valid_vp[0] + valid_vp[2], vx0, width);
+    int const vy1 = std::clamp(valid_vp[1] + valid_vp[3], vy0, height);
+    for (int y = 0; y < height; ++y) {
+        bool const row_valid = y >= vy0 && y < vy1;
+        for (int x = 0; x < width; ++x) {
+            if (!row_valid || x < vx0 || x >= vx1) {
+                auto const idx = static_cast<size_t>(y) * width + x;
+                color_[idx] = bkgnd_pixel;
+                depth_[idx] = far_depth;
+            }
+        }
+    }
+
+    int p2 = 1;
+    while (p2 * 2 <= size_) p2 *= 2;
+
+    // fold the ranks beyond the largest power of two onto their partners
+    if (rank_ >= p2) {
+        encode(0, height_, send_buf_);
+        bytes_sent_ += send_buf_.size();
+        uint64_t send_size = send_buf_.size();
+        MPI_Send(&send_size, 1, MPI_UINT64_T, rank_ - p2, bswap_tag, comm_);
+        MPI_Send(send_buf_.data(), static_cast<int>(send_size), MPI_CHAR, rank_ - p2, bswap_tag, comm_);
+    } else if (rank_ + p2 < size_) {
+        uint64_t recv_size = 0;
+        MPI_Recv(&recv_size, 1, MPI_UINT64_T, rank_ + p2, bswap_tag, comm_, MPI_STATUS_IGNORE);
+        recv_buf_.resize(recv_size);
+        MPI_Recv(recv_buf_.data(), static_cast<int>(recv_size), MPI_CHAR, rank_ + p2, bswap_tag, comm_,
+            MPI_STATUS_IGNORE);
+        if (!decode(recv_buf_, false)) return false;
+    }
+
+    // binary swap on rows, each round halves the region a rank is responsible for
+    int y0 = 0;
+    int y1 = height_;
+    if (rank_ < p2) {
+        for (int step = 1; step < p2; step *= 2) {
+            int const partner = rank_ ^ step;
+            int const mid = y0 + (y1 - y0) / 2;
+            bool const keep_lower = (rank_ & step) == 0;
+
+            if (keep_lower) {
+                encode(mid, y1, send_buf_);
+                y1 = mid;
+            } else {
+                encode(y0, mid, send_buf_);
+                y0 = mid;
+            }
+            if (!exchange(partner, send_buf_, recv_buf_)) return false;
+            if (!decode(recv_buf_, false)) return false;
+        }
+    } else {
+        y0 = y1 = 0;
+    }
+
+    // gather the composited slices on rank 0
+    encode(y0, y1, send_buf_);
+    int const send_size = static_cast<int>(send_buf_.size());
+    std::vector<int> sizes(rank_ == 0 ? size_ : 0);
+    MPI_Gather(&send_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, comm_);
+
+    std::vector<int> displs;
+    std::vector<char> gathered;
+    if (rank_ == 0) {
+        displs.resize(size_);
+        int total = 0;
+        for (int i = 0; i < size_; ++i) {
+            displs[i] = total;
+            total += sizes[i];
+        }
+        gathered.resize(total);
+    } else {
+        bytes_sent_ += send_buf_.size();
+    }
+    MPI_Gatherv(send_buf_.data(), send_size, MPI_CHAR, gathered.data(), sizes.data(), displs.data(), MPI_CHAR, 0,
+        comm_);
+
+    if (rank_ == 0) {
+        // only the own slice of rank 0 is composited, the rest is replaced by the slices of the other ranks
+        for (int y = 0; y < height_; ++y) {
+            if (y >= y0 && y < y1) continue;
+            auto const row = static_cast<size_t>(y) * width_;
+            std::fill(color_ + row, color_ + row + width_, bkgnd_pixel);
+            std::fill(depth_ + row, depth_ + row + width_, far_depth);
+        }
+        for (int i = 1; i < size_; ++i) {
+            recv_buf_.assign(gathered.begin() + displs[i], gathered.begin() + displs[i] + sizes[i]);
+            if (!decode(recv_buf_, true)) return false;
+        }
+    }
+
+    return true;
+}
+
+
+void megamol::remote::BinarySwapCompositor::encode(int y0, int y1, std::vector<char>& out) const {
+    ActiveRect rect{width_, y1, 0, y0};
+    for (int y = y0; y < y1; ++y) {
+        float const* row = depth_ + static_cast<size_t>(y) * width_;
+        int x = 0;
+        while (x < width_ && row[x] >= far_depth) ++x;
+        if (x == width_) continue;
+        int last = width_ - 1;
+        while (row[last] >= far_depth) --last;
+        rect.x0 = std::min(rect.x0, x);
+        rect.x1 = std::max(rect.x1, last + 1);
+        rect.y0 = std::min(rect.y0, y);
+        rect.y1 = std::max(rect.y1, y + 1);
+    }
+    if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0) {
+        rect = ActiveRect{0, 0, 0, 0};
+    }
+
+    auto const rect_w = static_cast<size_t>(rect.x1 - rect.x0);
+    auto const rect_h = static_cast<size_t>(rect.y1 - rect.y0);
+    out.resize(sizeof(ActiveRect) + rect_w * rect_h * (sizeof(uint32_t) + sizeof(float)));
+    std::memcpy(out.data(), &rect, sizeof(ActiveRect));
+
+    auto col_out = out.data() + sizeof(ActiveRect);
+    auto depth_out = col_out + rect_w * rect_h * sizeof(uint32_t);
+    for (size_t r = 0; r < rect_h; ++r) {
+        auto const src = static_cast<size_t>(rect.y0 + r) * width_ + rect.x0;
+        std::memcpy(col_out + r * rect_w * sizeof(uint32_t), color_ + src, rect_w * sizeof(uint32_t));
+        std::memcpy(depth_out + r * rect_w * sizeof(float), depth_ + src, rect_w * sizeof(float));
+    }
+}
+
+
+bool megamol::remote::BinarySwapCompositor::decode(std::vector<char> const& in, bool overwrite) {
+    if (in.size() < sizeof(ActiveRect)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("BinarySwapCompositor: Received truncated region\n");
+        return false;
+    }
+    ActiveRect rect;
+    std::memcpy(&rect, in.data(), sizeof(ActiveRect));
+    auto const rect_w = static_cast<size_t>(std::max(rect.x1 - rect.x0, 0));
+    auto const rect_h = static_cast<size_t>(std::max(rect.y1 - rect.y0, 0));
+    if (rect.x0 < 0 || rect.y0 < 0 || rect.x1 > width_ || rect.y1 > height_ ||
+        in.size() < sizeof(ActiveRect) + rect_w * rect_h * (sizeof(uint32_t) + sizeof(float))) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("BinarySwapCompositor: Received invalid region\n");
+        return false;
+    }
+
+    auto col_in = reinterpret_cast<uint32_t const*>(in.data() + sizeof(ActiveRect));
+    auto depth_in = reinterpret_cast<float const*>(in.data() + sizeof(ActiveRect) + rect_w * rect_h * sizeof(uint32_t));
+    for (size_t r = 0; r < rect_h; ++r) {
+        auto const dst = static_cast<size_t>(rect.y0 + r) * width_ + rect.x0;
+        for (size_t c = 0; c < rect_w; ++c) {
+            auto const src = r * rect_w + c;
+            if (overwrite || depth_in[src] < depth_[dst + c]) {
+                color_[dst + c] = col_in[src];
+                depth_[dst + c] = depth_in[src];
+            }
+        }
+    }
+    return true;
+}
+
+
+bool megamol::remote::BinarySwapCompositor::exchange(
+    int partner, std::vector<char> const& send, std::vector<char>& recv) {
+    uint64_t send_size = send.size();
+    uint64_t recv_size = 0;
+    auto status = MPI_Sendrecv(&send_size, 1, MPI_UINT64_T, partner, bswap_tag, &recv_size, 1, MPI_UINT64_T, partner,
+        bswap_tag, comm_, MPI_STATUS_IGNORE);
+    if (status != MPI_SUCCESS) return false;
+
+    recv.resize(recv_size);
+    status = MPI_Sendrecv(send.data(), static_cast<int>(send_size), MPI_CHAR, partner, bswap_tag, recv.data(),
+        static_cast<int>(recv_size), MPI_CHAR, partner, bswap_tag, comm_, MPI_STATUS_IGNORE);
+    bytes_sent_ += send_size;
+    return status == MPI_SUCCESS;
+}
+
+#endif // WITH_MPI
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif // WITH_MPI
+
+namespace megamol {
+namespace remote {
+
+#ifdef WITH_MPI
+
+/**
+ * Sort-last depth compositing of RGBA8/float depth images across the ranks of an MPI communicator.
+ *
+ * Binary swap: in log2(p) rounds every rank exchanges half of its current image region with a partner and
+ * depth-composites the half it keeps, so each rank ends up owning a fully composited slice of rows. Only
+ * these slices are gathered on rank 0. Rank counts that are no power of two are folded onto the largest
+ * power of two beforehand.
+ *
+ * Every exchanged region is reduced to the bounding rectangle of its active pixels (depth < 1), so empty
+ * screen space is never sent or composited.
+ */
+class BinarySwapCompositor {
+public:
+    explicit BinarySwapCompositor(MPI_Comm comm);
+
+    /**
+     * Composites the images of all ranks. Collective call.
+     *
+     * @param color    RGBA8 image (width * height * 4 bytes), holds the final image on rank 0 on return.
+     * @param depth    Float depth image (width * height * 4 bytes), holds the final depth on rank 0 on return.
+     * @param width    Image width.
+     * @param height   Image height.
+     * @param valid_vp Rectangle (x, y, w, h) holding rendered pixels, everything outside counts as background.
+     * @param bkgnd    Background color for pixels no rank rendered.
+     *
+     * @return 'true' on success.
+     */
+    bool Composite(std::vector<char>& color, std::vector<char>& depth, int width, int height,
+        int const valid_vp[4], std::array<unsigned char, 4> const& bkgnd);
+
+    /** Bytes this rank sent during the last Composite call. */
+    uint64_t BytesSent() const { return bytes_sent_; }
+
+private:
+    struct ActiveRect {
+        int32_t x0, y0, x1, y1; // half-open
+    };
+
+    /** Encodes the active pixels of rows [y0, y1) */
+    void encode(int y0, int y1, std::vector<char>& out) const;
+
+    /** Depth-composites an encoded region, 'overwrite' takes all its pixels unconditionally */
+    bool decode(std::vector<char> const& in, bool overwrite);
+
+    bool exchange(int partner, std::vector<char> const& send, std::vector<char>& recv);
+
+    MPI_Comm comm_;
+
+    int rank_ = 0;
+
+    int size_ = 1;
+
+    uint32_t* color_ = nullptr;
+
+    float* depth_ = nullptr;
+
+    int width_ = 0;
+
+    int height_ = 0;
+
+    uint64_t bytes_sent_ = 0;
+
+    std::vector<char> send_buf_;
+
+    std::vector<char> recv_buf_;
+};
+
+#endif // WITH_MPI
+
+} // end namespace remote
+} // end namespace megamol
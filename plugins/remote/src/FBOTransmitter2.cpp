@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "FBOTransmitter2.h"
 
+#include <algorithm>
 #include <array>
 
 #include "glad/glad.h"
@@ -43,6 +44,7 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
     , toggle_aggregate_slot_{"aggregate", "Toggle whether to aggregate and composite FBOs prior to transmission"}
     , render_comp_img_slot_("renderCompImage", "Renders the complete composited image on the broadcast master")
+    , compositor_slot_("compositor", "Compositing used for aggregation")
 #endif // WITH_MPI
     , aggregate_{false}
     , frame_id_{0}
@@ -84,6 +86,11 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     render_comp_img_slot_ << new megamol::core::param::BoolParam{false};
     this->render_comp_img_slot_.SetUpdateCallback(&FBOTransmitter2::renderCompChanged);
     this->MakeSlotAvailable(&render_comp_img_slot_);
+    auto cp = new megamol::core::param::EnumParam(BINARY_SWAP_COMP);
+    cp->SetTypePair(ICET_COMP, "IceT");
+    cp->SetTypePair(BINARY_SWAP_COMP, "BinarySwap");
+    compositor_slot_ << cp;
+    this->MakeSlotAvailable(&compositor_slot_);
 #endif // WITH_MPI
     reconnect_slot_ << new megamol::core::param::ButtonParam{};
     reconnect_slot_.SetUpdateCallback(&FBOTransmitter2::reconnectCallback);
@@ -190,23 +197,41 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
         this->extractBkgndColor(backgroundColor);
 
         int tilevp[4] = {xoff, yoff, tile_width, tile_height}; // define current valid pixel viewport for icet
+        if (this->bswap_ != nullptr) {
+            // composited in place, rank 0 ends up with the final image in col_buf and depth_buf
+            std::array<unsigned char, 4> bkgnd;
+            for (int i = 0; i < 4; ++i) {
+                bkgnd[i] = static_cast<unsigned char>(std::clamp(backgroundColor[i], 0.0f, 1.0f) * 255.0f);
+            }
+            if (!this->bswap_->Composite(col_buf, depth_buf, width, height, tilevp, bkgnd)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOTransmitter2: Binary swap compositing failed at rank %d\n", mpiRank);
+            }
 #    if _DEBUG
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "IceT gets image with xoff: %d, yoff: %d, tile_width: %d, tile_height: %d\n", xoff, yoff, tile_width,
-            tile_height);
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "FBOTransmitter2: Binary swap done, rank %d sent %llu bytes\n", mpiRank, this->bswap_->BytesSent());
 #    endif
-        auto const icet_comp_image = icetCompositeImage(col_buf.data(), depth_buf.data(), tilevp, nullptr, nullptr,
-            static_cast<const IceTFloat*>(backgroundColor.data()));
+        } else {
 #    if _DEBUG
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - Composite Image Done\n");
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "IceT gets image with xoff: %d, yoff: %d, tile_width: %d, tile_height: %d\n", xoff, yoff, tile_width,
+                tile_height);
 #    endif
-
-        if (mpiRank == 0) {
-            icet_col_buf = icetImageGetColorub(icet_comp_image);
-            icet_depth_buf = icetImageGetDepthf(icet_comp_image);
+            auto const icet_comp_image = icetCompositeImage(col_buf.data(), depth_buf.data(), tilevp, nullptr,
+                nullptr, static_cast<const IceTFloat*>(backgroundColor.data()));
+#    if _DEBUG
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - Composite Image Done\n");
+#    endif
+            if (mpiRank == 0) {
+                icet_col_buf = icetImageGetColorub(icet_comp_image);
+                icet_depth_buf = icetImageGetDepthf(icet_comp_image);
 #    if _DEBUG
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - ImageGet Done\n");
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - ImageGet Done\n");
 #    endif
+            }
+        }
+
+        if (mpiRank == 0) {
             if (this->render_comp_img_slot_.Param<core::param::BoolParam>()->Value()) {
                 glDrawPixels(tile_width, tile_height, GL_RGBA, GL_UNSIGNED_BYTE, icet_col_buf);
             }
@@ -723,10 +748,12 @@ bool megamol::remote::FBOTransmitter2::shutdownThreads() {
     if (this->transmitter_thread_.joinable()) this->transmitter_thread_.join();
 
 #ifdef WITH_MPI
-    if (useMpi) {
+    if (icet_initialized_) {
         icetDestroyMPICommunicator(icet_comm_);
         icetDestroyContext(icet_ctx_);
+        icet_initialized_ = false;
     }
+    bswap_.reset();
 #endif // WITH_MPI
 
     connected_ = false;
@@ -768,16 +795,25 @@ void megamol::remote::FBOTransmitter2::initIceT() {
 #    if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Initializing IceT at rank %d\n", mpiRank);
 #    endif
-        // icet setup
+        auto const compositor = this->compositor_slot_.Param<megamol::core::param::EnumParam>()->Value();
+        if (compositor == BINARY_SWAP_COMP) {
+            this->bswap_ = std::make_unique<BinarySwapCompositor>(this->mpi_comm_);
+        } else {
+            this->bswap_.reset();
+        }
 
-        icet_comm_ = icetCreateMPICommunicator(this->mpi_comm_);
-        icet_ctx_ = icetCreateContext(icet_comm_);
-        icetStrategy(ICET_STRATEGY_SEQUENTIAL);
-        icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
-        icetCompositeMode(ICET_COMPOSITE_MODE_Z_BUFFER);
-        icetSetColorFormat(ICET_IMAGE_COLOR_RGBA_UBYTE);
-        icetSetDepthFormat(ICET_IMAGE_DEPTH_FLOAT);
-        icetDisable(ICET_COMPOSITE_ONE_BUFFER);
+        if (compositor == ICET_COMP && !icet_initialized_) {
+            // icet setup
+            icet_comm_ = icetCreateMPICommunicator(this->mpi_comm_);
+            icet_ctx_ = icetCreateContext(icet_comm_);
+            icetStrategy(ICET_STRATEGY_SEQUENTIAL);
+            icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
+            icetCompositeMode(ICET_COMPOSITE_MODE_Z_BUFFER);
+            icetSetColorFormat(ICET_IMAGE_COLOR_RGBA_UBYTE);
+            icetSetDepthFormat(ICET_IMAGE_DEPTH_FLOAT);
+            icetDisable(ICET_COMPOSITE_ONE_BUFFER);
+            icet_initialized_ = true;
+        }
 
         // extract viewport or get if from opengl context
         auto width = 0;
@@ -809,10 +845,12 @@ void megamol::remote::FBOTransmitter2::initIceT() {
             this->viewport[3], this->viewport[4], this->viewport[5]);
 #    endif
 
-        int displayRank = 0;
-        icetPhysicalRenderSize(width, height);
-        icetResetTiles();
-        icetAddTile(0, 0, width, height, displayRank);
+        if (icet_initialized_) {
+            int displayRank = 0;
+            icetPhysicalRenderSize(width, height);
+            icetResetTiles();
+            icetAddTile(0, 0, width, height, displayRank);
+        }
 
 #    ifdef _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Initialized IceT at rank %d\n", mpiRank);
@@ -10,6 +10,7 @@
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
 
+#include "BinarySwapCompositor.h"
 #include "FBOCommFabric.h"
 #include "FBOProto.h"
 #include "mmcore/CallerSlot.h"
@@ -125,6 +126,13 @@ private:
 
     megamol::core::param::ParamSlot render_comp_img_slot_;
 
+    megamol::core::param::ParamSlot compositor_slot_;
+
+    enum compositor_type : int { ICET_COMP = 0, BINARY_SWAP_COMP };
+
+    std::unique_ptr<BinarySwapCompositor> bswap_;
+
+    bool icet_initialized_ = false;
 
 
     bool useMpi = false;
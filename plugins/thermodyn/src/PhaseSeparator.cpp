@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include "mmcore/moldyn/MultiParticleDataCall.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
@@ -22,7 +23,10 @@ megamol::thermodyn::PhaseSeparator::PhaseSeparator()
     , interfaceColorSlot_("interfaceColor", "Color of the box representing the interface")
     , gasColorSlot_("gasColor", "Color of the box representing the gas")
     , axisSlot_("axis", "Main axis for density analysis")
-    , numSlicesSlot_("numSlices", "Number of slices for density analysis") {
+    , numSlicesSlot_("numSlices", "Number of slices for density analysis")
+    , incrementalSlot_("incremental",
+          "Keep the density histogram across frames and only update it for changed particles. All particles are "
+          "still read each frame, and 8 bytes more are stored per particle") {
     dataInSlot_.SetCompatibleCall<core::moldyn::MultiParticleDataCallDescription>();
     MakeSlotAvailable(&dataInSlot_);
 
@@ -57,6 +61,9 @@ megamol::thermodyn::PhaseSeparator::PhaseSeparator()
 
     numSlicesSlot_ << new core::param::IntParam(100, 1, std::numeric_limits<int>::max());
     MakeSlotAvailable(&numSlicesSlot_);
+
+    incrementalSlot_ << new core::param::BoolParam(false);
+    MakeSlotAvailable(&incrementalSlot_);
 }
 
 
@@ -117,7 +124,6 @@ bool megamol::thermodyn::PhaseSeparator::getDataCallback(core::Call& c) {
         auto const numSlices = numSlicesSlot_.Param<core::param::IntParam>()->Value();
 
         std::vector<float> trend(numSlices, 0.0f);
-        std::vector<size_t> cnt(numSlices, 0);
         float offset = 0.0f;
         auto diff = 1.0f;
         if (axis == 0) {
@@ -134,13 +140,27 @@ bool megamol::thermodyn::PhaseSeparator::getDataCallback(core::Call& c) {
             offset = bbox.GetBack();
         }
 
-        for (size_t pidx = 0; pidx < pc; ++pidx) {
-            auto const pos = pAcc->Get_f(pidx) - offset;
-            auto const val = iAcc->Get_f(pidx);
-            auto idx = static_cast<size_t>(std::floor(pos / diff));
-            idx = vislib::math::Clamp<size_t>(idx, 0, numSlices - 1);
-            ++cnt[idx];
-            trend[idx] += val / cnt[idx];
+        if (incrementalSlot_.Param<core::param::BoolParam>()->Value()) {
+            updateHistogram(parts, *pAcc, *iAcc, numSlices, offset, diff, inCall->DataHash());
+            for (int i = 0; i < numSlices; ++i) {
+                if (counts_[i] > 0) trend[i] = static_cast<float>(sums_[i] / static_cast<double>(counts_[i]));
+            }
+        } else {
+            cells_.clear();
+            cells_.shrink_to_fit();
+            densities_.clear();
+            densities_.shrink_to_fit();
+            histHash_ = std::numeric_limits<size_t>::max();
+
+            std::vector<size_t> cnt(numSlices, 0);
+            for (size_t pidx = 0; pidx < pc; ++pidx) {
+                auto const pos = pAcc->Get_f(pidx) - offset;
+                auto const val = iAcc->Get_f(pidx);
+                auto idx = static_cast<size_t>(std::floor(pos / diff));
+                idx = vislib::math::Clamp<size_t>(idx, 0, numSlices - 1);
+                ++cnt[idx];
+                trend[idx] += val / cnt[idx];
+            }
         }
 
         // determine interface
@@ -290,6 +310,64 @@ bool megamol::thermodyn::PhaseSeparator::getDataCallback(core::Call& c) {
 }
 
 
+void megamol::thermodyn::PhaseSeparator::updateHistogram(core::moldyn::SimpleSphericalParticles const& parts,
+    core::moldyn::Accessor const& pAcc, core::moldyn::Accessor const& iAcc, int numSlices, float offset, float diff,
+    size_t dataHash) {
+    auto const pc = static_cast<int64_t>(parts.GetCount());
+
+    if (dataHash != histHash_ || cells_.size() != static_cast<size_t>(pc) || numSlices != histSlices_ ||
+        offset != histOffset_ || diff != histDiff_ || histUpdates_ >= histRebuildInterval_) {
+        // also rebuild periodically, since adding and removing densities lets the sums drift
+        cells_.assign(pc, -1);
+        densities_.assign(pc, 0.0f);
+        sums_.assign(numSlices, 0.0);
+        counts_.assign(numSlices, 0);
+        histHash_ = dataHash;
+        histSlices_ = numSlices;
+        histOffset_ = offset;
+        histDiff_ = diff;
+        histUpdates_ = 0;
+    }
+    ++histUpdates_;
+
+    // the histogram only depends on which particles are in a slice, so every particle that kept its slice and
+    // density is skipped, no matter if the particle order is stable; changes are collected per thread
+#pragma omp parallel
+    {
+        std::vector<double> sums(numSlices, 0.0);
+        std::vector<int64_t> counts(numSlices, 0);
+        bool changed = false;
+
+#pragma omp for
+        for (int64_t pidx = 0; pidx < pc; ++pidx) {
+            auto const pos = pAcc.Get_f(pidx) - offset;
+            auto const val = iAcc.Get_f(pidx);
+            auto const cell = vislib::math::Clamp<int>(static_cast<int>(std::floor(pos / diff)), 0, numSlices - 1);
+            auto& oldCell = cells_[pidx];
+            auto& oldVal = densities_[pidx];
+            if (cell == oldCell && val == oldVal) continue;
+            if (oldCell >= 0) {
+                sums[oldCell] -= oldVal;
+                --counts[oldCell];
+            }
+            sums[cell] += val;
+            ++counts[cell];
+            oldCell = cell;
+            oldVal = val;
+            changed = true;
+        }
+
+        if (changed) {
+#pragma omp critical
+            for (int i = 0; i < numSlices; ++i) {
+                sums_[i] += sums[i];
+                counts_[i] += counts[i];
+            }
+        }
+    }
+}
+
+
 bool megamol::thermodyn::PhaseSeparator::getExtentCallback(core::Call& c) {
     auto inCall = dataInSlot_.CallAs<core::moldyn::MultiParticleDataCall>();
     if (inCall == nullptr) return false;
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <vector>
 
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
+#include "mmcore/moldyn/MultiParticleDataCall.h"
 #include "mmcore/param/ParamSlot.h"
 
 #include "thermodyn/BoxDataCall.h"
@@ -58,6 +61,14 @@ private:
 
     bool getExtentCallback(core::Call& c);
 
+    /**
+     * Brings the density histogram along the analysis axis up to date with 'parts'. Only particles whose slice
+     * or density changed since the last call are touched, unless the data set or the slicing changed or the
+     * histogram has been updated histRebuildInterval_ times. All particles are still read.
+     */
+    void updateHistogram(core::moldyn::SimpleSphericalParticles const& parts, core::moldyn::Accessor const& pAcc,
+        core::moldyn::Accessor const& iAcc, int numSlices, float offset, float diff, size_t dataHash);
+
     core::CallerSlot dataInSlot_;
 
     core::CalleeSlot dataOutSlot_;
@@ -76,11 +87,37 @@ private:
 
     core::param::ParamSlot numSlicesSlot_;
 
+    core::param::ParamSlot incrementalSlot_;
+
     size_t inDataHash_ = std::numeric_limits<size_t>::max();
 
     unsigned int frameID_ = 0;
 
     std::vector<BoxDataCall::box_entry_t> boxes_;
+
+    /** Per particle the slice it was sorted into and its density, -1 if not yet sorted */
+    std::vector<int> cells_;
+
+    std::vector<float> densities_;
+
+    /** Per slice the sum of the densities and the number of particles */
+    std::vector<double> sums_;
+
+    std::vector<int64_t> counts_;
+
+    /** The data set and slicing the histogram was built for */
+    size_t histHash_ = std::numeric_limits<size_t>::max();
+
+    int histSlices_ = 0;
+
+    float histOffset_ = 0.0f;
+
+    float histDiff_ = 0.0f;
+
+    /** Number of updates since the histogram was built, it is rebuilt after histRebuildInterval_ */
+    int histUpdates_ = 0;
+
+    static constexpr int histRebuildInterval_ = 64;
 }; // end class PhaseSeparator
 
 } // end namespace thermodyn
@@ -6,6 +6,8 @@
 
 #include "testhelper.h"
 
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 
 #include "vislib/sys/Console.h"
@@ -117,6 +119,11 @@ void OutputAssertTestSummary(void) {
 }
 
 
+unsigned int AssertTestFailCount(void) {
+    return testhelp_testFail;
+}
+
+
 void EnableAssertSuccessOutput(const bool isEnabled) {
     ::_assertTrueShowSuccess = isEnabled;
 }
@@ -124,3 +131,32 @@ void EnableAssertSuccessOutput(const bool isEnabled) {
 void EnableAssertFailureOutput(const bool isEnabled) {
     ::_assertTrueShowFailure = isEnabled;
 }
+
+
+int RunTests(const char *title, const TestEntry *tests, int argc, char **argv) {
+    printf("%s Test Application\n\n", title);
+
+    for (const TestEntry *test = tests; test->testName != NULL; test++) {
+        bool selected = (argc <= 1);
+        for (int i = 1; i < argc; i++) {
+#ifdef _WIN32
+            selected = selected || (_stricmp(argv[i], test->testName) == 0);
+#else /* _WIN32 */
+            selected = selected || (strcasecmp(argv[i], test->testName) == 0);
+#endif /* _WIN32 */
+        }
+        if (!selected) continue;
+
+        printf("Performing Test: %s\n", test->testName);
+        try {
+            test->testFunc();
+        } catch (...) {
+            printf("\nUnexpected Exception ");
+            AssertOutputFail(); // add a generic fail
+        }
+        printf("\n");
+    }
+
+    ::OutputAssertTestSummary();
+    return (::AssertTestFailCount() > 0) ? 1 : 0;
+}
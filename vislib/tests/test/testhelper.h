@@ -77,6 +77,9 @@ void AssertOutputFail(void);
 
 void OutputAssertTestSummary(void);
 
+// answers the number of assert tests failed so far, e.g. for the exit code.
+unsigned int AssertTestFailCount(void);
+
 // this succeeds if exactly the specified exception is thrown.
 // has no return value!
 #define AssertException(desc, call, exception) AssertOutput(desc); try { call; AssertOutputFail(); } catch(exception e) { AssertOutputSuccess(); } catch(...) { AssertOutputFail(); }
@@ -89,4 +92,18 @@ void EnableAssertSuccessOutput(const bool isEnabled);
 
 void EnableAssertFailureOutput(const bool isEnabled);
 
+/* type for test functions */
+typedef void (*TestFunction)(void);
+
+/* type for test tables, which end with an entry of NULLs */
+typedef struct _TestEntry_t {
+    const char *testName; // the tests name. Used as command line argument to select this test.
+    TestFunction testFunc; // the function called when this test is selected.
+    const char *testDesc; // the description of this test. Used for the online help.
+} TestEntry;
+
+// runs the tests named on the command line, or all tests of the table without arguments, and prints the summary.
+// answers 1 if any assert failed and 0 otherwise, to be used as exit code.
+int RunTests(const char *title, const TestEntry *tests, int argc, char **argv);
+
 #endif /* VISLIBTEST_TESTHELPER_H_INCLUDED */